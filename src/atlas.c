@@ -0,0 +1,307 @@
+#include "graphics.h"
+
+#define _FL "atlas.c"
+
+#define APIC static
+#define ATLAS_TEXEL_SIZE 4
+
+typedef struct atlas_image {
+    unsigned char* pixels;
+    int width;
+    int height;
+} atlas_image;
+
+APIC bool atlas_load_images(const char** fpaths, size_t count, atlas_image* images);
+APIC void atlas_free_images(atlas_image* images, size_t count);
+APIC void atlas_blit_extruded(unsigned char* layer, GLsizei layer_width, GLsizei layer_height, const atlas_image* image, GLsizei x, GLsizei y, GLsizei padding);
+APIC GLsizei atlas_align(GLsizei value, GLsizei alignment);
+APIC gl_texture_atlas* atlas_alloc(size_t count, GLenum internal_format);
+APIC bool atlas_upload(gl_texture_atlas* atlas, const unsigned char* layers);
+
+APIC bool atlas_load_images(const char** fpaths, size_t count, atlas_image* images) {
+    stbi_set_flip_vertically_on_load_thread(1);
+    for (size_t i = 0; i < count; i++) {
+        int channels;
+        images[i].pixels = stbi_load(fpaths[i], &images[i].width, &images[i].height, &channels, STBI_rgb_alpha);
+        if (!images[i].pixels) {
+            fprintf(stderr, "[%s] - Texture load failed for '%s': %s in atlas_load_images\n", _FL, fpaths[i], stbi_failure_reason());
+            atlas_free_images(images, i);
+            return false;
+        }
+    }
+    return true;
+}
+
+APIC void atlas_free_images(atlas_image* images, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        stbi_image_free(images[i].pixels);
+        images[i].pixels = NULL;
+    }
+}
+
+APIC void atlas_blit_extruded(unsigned char* layer, GLsizei layer_width, GLsizei layer_height, const atlas_image* image, GLsizei x, GLsizei y, GLsizei padding) {
+    GLsizei y_begin = y - padding > 0 ? y - padding : 0;
+    GLsizei y_end = y + image->height + padding < layer_height ? y + image->height + padding : layer_height;
+    GLsizei x_begin = x - padding > 0 ? x - padding : 0;
+    GLsizei x_end = x + image->width + padding < layer_width ? x + image->width + padding : layer_width;
+
+    for (GLsizei dy = y_begin; dy < y_end; dy++) {
+        GLsizei sy = dy - y;
+        sy = sy < 0 ? 0 : (sy >= image->height ? image->height - 1 : sy);
+        const unsigned char* src_row = image->pixels + (size_t)sy * image->width * ATLAS_TEXEL_SIZE;
+        unsigned char* dst_row = layer + (size_t)dy * layer_width * ATLAS_TEXEL_SIZE;
+        for (GLsizei dx = x_begin; dx < x_end; dx++) {
+            GLsizei sx = dx - x;
+            sx = sx < 0 ? 0 : (sx >= image->width ? image->width - 1 : sx);
+            memcpy(dst_row + (size_t)dx * ATLAS_TEXEL_SIZE, src_row + (size_t)sx * ATLAS_TEXEL_SIZE, ATLAS_TEXEL_SIZE);
+        }
+    }
+}
+
+APIC GLsizei atlas_align(GLsizei value, GLsizei alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+APIC gl_texture_atlas* atlas_alloc(size_t count, GLenum internal_format) {
+    if (internal_format != GL_RGBA8 && internal_format != GL_SRGB8_ALPHA8) {
+        fprintf(stderr, "[%s] - Unsupported atlas internal format [0x%04X] in atlas_alloc\n", _FL, internal_format);
+        return NULL;
+    }
+
+    gl_texture_atlas* atlas = (gl_texture_atlas*)calloc(1, sizeof(gl_texture_atlas));
+    if (!atlas) {
+        fprintf(stderr, "[%s] - Failure to allocate 'atlas' to heap in atlas_alloc\n", _FL);
+        return NULL;
+    }
+    atlas->rects = (gl_atlas_rect*)calloc(count ? count : 1, sizeof(gl_atlas_rect));
+    if (!atlas->rects) {
+        fprintf(stderr, "[%s] - Failure to allocate 'atlas->rects' to heap in atlas_alloc\n", _FL);
+        free(atlas);
+        return NULL;
+    }
+    atlas->rect_count = count;
+    atlas->internal_format = internal_format;
+    return atlas;
+}
+
+APIC bool atlas_upload(gl_texture_atlas* atlas, const unsigned char* layers) {
+    glGenTextures(1, &atlas->texture);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, atlas->texture);
+
+    if (GLAD_GL_ARB_texture_storage) {
+        glTexStorage3D(GL_TEXTURE_2D_ARRAY, atlas->levels, atlas->internal_format, atlas->width, atlas->height, atlas->layers);
+    } else {
+        GLsizei width = atlas->width;
+        GLsizei height = atlas->height;
+        for (GLsizei level = 0; level < atlas->levels; level++) {
+            glTexImage3D(GL_TEXTURE_2D_ARRAY, level, atlas->internal_format, width, height, atlas->layers, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+            width = width > 1 ? width / 2 : 1;
+            height = height > 1 ? height / 2 : 1;
+        }
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_BASE_LEVEL, 0);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_LEVEL, atlas->levels - 1);
+    }
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, 0, atlas->width, atlas->height, atlas->layers, GL_RGBA, GL_UNSIGNED_BYTE, layers);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    if (atlas->levels > 1)
+        glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+
+    glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+    check_gl_error("atlas_upload");
+    return atlas->texture != 0;
+}
+
+gl_texture_atlas* glapi_GenTextureArray(gl_app* app, const char** fpaths, size_t count, GLenum internal_format, unsigned int mips) {
+    gl_texture_atlas* atlas = atlas_alloc(count, internal_format);
+    if (!atlas)
+        return NULL;
+
+    atlas_image* images = (atlas_image*)calloc(count ? count : 1, sizeof(atlas_image));
+    if (!images || !atlas_load_images(fpaths, count, images)) {
+        free(images);
+        glapi_DestroyTextureAtlas(atlas);
+        return NULL;
+    }
+
+    atlas->width = 1;
+    atlas->height = 1;
+    for (size_t i = 0; i < count; i++) {
+        if (images[i].width > atlas->width)
+            atlas->width = images[i].width;
+        if (images[i].height > atlas->height)
+            atlas->height = images[i].height;
+    }
+    atlas->layers = count ? (GLsizei)count : 1;
+    atlas->levels = mips == TEXTURE_MIPS_NONE ? 1 : glapi_TextureMipLevels(atlas->width, atlas->height);
+
+    size_t layer_size = (size_t)atlas->width * atlas->height * ATLAS_TEXEL_SIZE;
+    unsigned char* layers = (unsigned char*)calloc(atlas->layers, layer_size);
+    if (!layers) {
+        fprintf(stderr, "[%s] - Failure to allocate layer pixels in glapi_GenTextureArray\n", _FL);
+        atlas_free_images(images, count);
+        free(images);
+        glapi_DestroyTextureAtlas(atlas);
+        return NULL;
+    }
+
+    GLsizei fill = atlas->width > atlas->height ? atlas->width : atlas->height;
+    for (size_t i = 0; i < count; i++) {
+        atlas_blit_extruded(layers + i * layer_size, atlas->width, atlas->height, &images[i], 0, 0, fill);
+        gl_atlas_rect* rect = &atlas->rects[i];
+        rect->layer = (GLuint)i;
+        rect->width = (GLuint)images[i].width;
+        rect->height = (GLuint)images[i].height;
+        rect->u0 = 0.0f;
+        rect->v0 = 0.0f;
+        rect->u1 = (GLfloat)images[i].width / atlas->width;
+        rect->v1 = (GLfloat)images[i].height / atlas->height;
+    }
+    atlas_free_images(images, count);
+    free(images);
+
+    bool uploaded = atlas_upload(atlas, layers);
+    free(layers);
+    if (!uploaded) {
+        glapi_DestroyTextureAtlas(atlas);
+        return NULL;
+    }
+
+    glapi_AppendOpenGLObjects(app, T{(GLuint*)atlas, TEXTURE_ATLAS});
+    return atlas;
+}
+
+gl_texture_atlas* glapi_GenTextureAtlas(gl_app* app, const char** fpaths, size_t count, GLsizei max_size, GLuint padding, GLenum internal_format, unsigned int mips) {
+    gl_texture_atlas* atlas = atlas_alloc(count, internal_format);
+    if (!atlas)
+        return NULL;
+
+    atlas_image* images = (atlas_image*)calloc(count ? count : 1, sizeof(atlas_image));
+    size_t* order = (size_t*)malloc((count ? count : 1) * sizeof(size_t));
+    if (!images || !order || !atlas_load_images(fpaths, count, images)) {
+        free(images);
+        free(order);
+        glapi_DestroyTextureAtlas(atlas);
+        return NULL;
+    }
+
+    GLsizei levels = 1;
+    if (mips != TEXTURE_MIPS_NONE) {
+        while ((GLuint)(1u << levels) <= padding)
+            levels++;
+    }
+    GLsizei alignment = 1 << (levels - 1);
+    GLsizei pad = (GLsizei)padding;
+
+    for (size_t i = 0; i < count; i++) {
+        order[i] = i;
+        if (images[i].width + 2 * pad > max_size || images[i].height + 2 * pad > max_size) {
+            fprintf(stderr, "[%s] - Image '%s' [%d x %d] does not fit atlas size [%d] in glapi_GenTextureAtlas\n", _FL, fpaths[i], images[i].width, images[i].height, max_size);
+            atlas_free_images(images, count);
+            free(images);
+            free(order);
+            glapi_DestroyTextureAtlas(atlas);
+            return NULL;
+        }
+    }
+    for (size_t i = 1; i < count; i++) {
+        size_t current = order[i];
+        size_t j = i;
+        while (j > 0 && images[order[j - 1]].height < images[current].height) {
+            order[j] = order[j - 1];
+            j--;
+        }
+        order[j] = current;
+    }
+
+    GLsizei layer = 0, shelf_x = 0, shelf_y = 0, shelf_height = 0, used_height = 0;
+    for (size_t k = 0; k < count; k++) {
+        size_t i = order[k];
+        GLsizei cell_width = atlas_align(images[i].width + 2 * pad, alignment);
+        GLsizei cell_height = atlas_align(images[i].height + 2 * pad, alignment);
+        if (shelf_x + cell_width > max_size) {
+            shelf_y += shelf_height;
+            shelf_x = 0;
+            shelf_height = 0;
+        }
+        if (shelf_y + cell_height > max_size) {
+            layer++;
+            shelf_x = 0;
+            shelf_y = 0;
+            shelf_height = 0;
+        }
+        gl_atlas_rect* rect = &atlas->rects[i];
+        rect->layer = (GLuint)layer;
+        rect->width = (GLuint)images[i].width;
+        rect->height = (GLuint)images[i].height;
+        rect->u0 = (GLfloat)(shelf_x + pad);
+        rect->v0 = (GLfloat)(shelf_y + pad);
+        shelf_x += cell_width;
+        if (cell_height > shelf_height)
+            shelf_height = cell_height;
+        if (layer == 0 && shelf_y + shelf_height > used_height)
+            used_height = shelf_y + shelf_height;
+    }
+
+    atlas->width = max_size;
+    atlas->height = layer == 0 ? atlas_align(used_height > 0 ? used_height : 1, alignment) : max_size;
+    atlas->layers = layer + 1;
+    atlas->levels = levels;
+    atlas->padding = padding;
+
+    size_t layer_size = (size_t)atlas->width * atlas->height * ATLAS_TEXEL_SIZE;
+    unsigned char* layers = (unsigned char*)calloc(atlas->layers, layer_size);
+    if (!layers) {
+        fprintf(stderr, "[%s] - Failure to allocate layer pixels in glapi_GenTextureAtlas\n", _FL);
+        atlas_free_images(images, count);
+        free(images);
+        free(order);
+        glapi_DestroyTextureAtlas(atlas);
+        return NULL;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        gl_atlas_rect* rect = &atlas->rects[i];
+        GLsizei x = (GLsizei)rect->u0;
+        GLsizei y = (GLsizei)rect->v0;
+        atlas_blit_extruded(layers + rect->layer * layer_size, atlas->width, atlas->height, &images[i], x, y, pad);
+        rect->u0 = (GLfloat)x / atlas->width;
+        rect->v0 = (GLfloat)y / atlas->height;
+        rect->u1 = (GLfloat)(x + images[i].width) / atlas->width;
+        rect->v1 = (GLfloat)(y + images[i].height) / atlas->height;
+    }
+    atlas_free_images(images, count);
+    free(images);
+    free(order);
+
+    bool uploaded = atlas_upload(atlas, layers);
+    free(layers);
+    if (!uploaded) {
+        glapi_DestroyTextureAtlas(atlas);
+        return NULL;
+    }
+
+    glapi_AppendOpenGLObjects(app, T{(GLuint*)atlas, TEXTURE_ATLAS});
+    return atlas;
+}
+
+void glapi_BindTextureAtlas(GLuint unit, gl_texture_atlas* atlas, GLuint sampler) {
+    glActiveTexture(GL_TEXTURE0 + unit);
+    glBindTexture(GL_TEXTURE_2D_ARRAY, atlas->texture);
+    glBindSampler(unit, sampler);
+}
+
+void glapi_PushTextureAtlasToShader(const char* varname, gl_texture_atlas* atlas, GLuint sampler, GLuint unit, gl_shader shader) {
+    glapi_BindTextureAtlas(unit, atlas, sampler);
+    glUseProgram(shader);
+    glUniform1i(glGetUniformLocation(shader, varname), (GLint)unit);
+    glActiveTexture(GL_TEXTURE0);
+}
+
+void glapi_DestroyTextureAtlas(gl_texture_atlas* atlas) {
+    if (atlas->texture)
+        glDeleteTextures(1, &atlas->texture);
+    free(atlas->rects);
+    free(atlas);
+}
@@ -0,0 +1,442 @@
+#include "graphics.h"
+
+#define _FL "batch.c"
+
+#define APIC static
+#define BATCH_PATH_LENGTH 1024
+
+APIC void batch_clear(gl_batch_renderer* batch);
+APIC gl_batch_program* batch_program(gl_batch_renderer* batch, GLuint program);
+APIC void batch_apply_params(gl_batch_renderer* batch, gl_render_queue* queue, const float* params);
+APIC const char* batch_npy_descr(GLenum type);
+APIC bool batch_write_npy(gl_batch_renderer* batch, const gl_batch_job* job, const char* fpath);
+APIC void batch_write(gl_batch_renderer* batch, const gl_batch_job* job);
+APIC void* batch_writer(void* arg);
+APIC bool batch_slot_busy(gl_batch_renderer* batch, GLuint slot);
+APIC void batch_dispatch(gl_batch_renderer* batch, GLuint slot);
+APIC void batch_collect(gl_batch_renderer* batch, bool wait);
+APIC void batch_release_targets(gl_batch_renderer* batch);
+APIC void batch_drain(gl_batch_renderer* batch);
+
+APIC void batch_clear(gl_batch_renderer* batch) {
+    static const GLfloat zero_f[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+    static const GLuint zero_u[4] = {0, 0, 0, 0};
+    for (GLuint i = 0; i < batch->output_count; i++) {
+        if (batch->outputs[i].readback->format == GL_RED_INTEGER)
+            glClearBufferuiv(GL_COLOR, (GLint)i, zero_u);
+        else
+            glClearBufferfv(GL_COLOR, (GLint)i, zero_f);
+    }
+    if (batch->target->desc.depth_format) {
+        GLfloat depth = 1.0f;
+        glClearBufferfv(GL_DEPTH, 0, &depth);
+    }
+}
+
+APIC gl_batch_program* batch_program(gl_batch_renderer* batch, GLuint program) {
+    gl_batch_program* entry = NULL;
+    for (GLuint i = 0; i < batch->program_count && !entry; i++)
+        if (batch->programs[i].program == program)
+            entry = &batch->programs[i];
+
+    if (!entry) {
+        if (batch->program_count == batch->program_capacity) {
+            GLuint capacity = batch->program_capacity ? batch->program_capacity * 2 : 8;
+            gl_batch_program* programs = (gl_batch_program*)realloc(batch->programs, capacity * sizeof(gl_batch_program));
+            if (!programs) {
+                fprintf(stderr, "[%s] - Failure to reallocate 'batch->programs' in batch_program\n", _FL);
+                return NULL;
+            }
+            batch->programs = programs;
+            batch->program_capacity = capacity;
+        }
+        entry = &batch->programs[batch->program_count++];
+        entry->program = program;
+        entry->uniform_count = 0;
+        entry->stamp = 0;
+    }
+    for (; entry->uniform_count < batch->uniform_count; entry->uniform_count++)
+        entry->locations[entry->uniform_count] = glGetUniformLocation(program, batch->uniforms[entry->uniform_count].name);
+    return entry;
+}
+
+APIC void batch_apply_params(gl_batch_renderer* batch, gl_render_queue* queue, const float* params) {
+    if (!queue || !params || !batch->uniform_count)
+        return;
+
+    GLuint bound = 0;
+    batch->stamp++;
+    for (size_t i = 0; i < queue->item_count; i++) {
+        GLuint program = queue->items[i].shader;
+        if (program == bound)
+            continue;
+        gl_batch_program* entry = batch_program(batch, program);
+        if (!entry || entry->stamp == batch->stamp)
+            continue;
+
+        entry->stamp = batch->stamp;
+        glUseProgram(program);
+        bound = program;
+        for (GLuint u = 0; u < batch->uniform_count; u++) {
+            GLint location = entry->locations[u];
+            const float* value = params + batch->uniforms[u].offset;
+            if (location < 0)
+                continue;
+            switch (batch->uniforms[u].type) {
+                case RENDER_UNIFORM_INT:   glUniform1i(location, (GLint)value[0]); break;
+                case RENDER_UNIFORM_FLOAT: glUniform1f(location, value[0]); break;
+                case RENDER_UNIFORM_VEC2:  glUniform2fv(location, 1, value); break;
+                case RENDER_UNIFORM_VEC3:  glUniform3fv(location, 1, value); break;
+                case RENDER_UNIFORM_VEC4:  glUniform4fv(location, 1, value); break;
+                case RENDER_UNIFORM_MAT3:  glUniformMatrix3fv(location, 1, GL_FALSE, value); break;
+                case RENDER_UNIFORM_MAT4:  glUniformMatrix4fv(location, 1, GL_FALSE, value); break;
+            }
+        }
+    }
+    if (bound)
+        glUseProgram(0);
+}
+
+APIC const char* batch_npy_descr(GLenum type) {
+    switch (type) {
+        case GL_UNSIGNED_BYTE:  return "|u1";
+        case GL_UNSIGNED_SHORT: return "<u2";
+        case GL_FLOAT:          return "<f4";
+        default:                return "<u4";
+    }
+}
+
+APIC bool batch_write_npy(gl_batch_renderer* batch, const gl_batch_job* job, const char* fpath) {
+    const gl_batch_output* output = &batch->outputs[job->output];
+    const gl_readback* readback = output->readback;
+    GLsizei width = batch->target->desc.width, height = batch->target->desc.height;
+    size_t row = (size_t)width * readback->pixel_size;
+
+    char header[128];
+    int length = snprintf(header, sizeof(header), "{'descr': '%s', 'fortran_order': False, 'shape': (%d, %d, %u), }",
+        batch_npy_descr(readback->type), height, width, readback->channels);
+    int padded = ((10 + length + 1 + 63) / 64) * 64 - 10;
+    while (length < padded - 1)
+        header[length++] = ' ';
+    header[length++] = '\n';
+
+    FILE* file = fopen(fpath, "wb");
+    if (!file)
+        return false;
+    unsigned char preamble[10] = {0x93, 'N', 'U', 'M', 'P', 'Y', 1, 0, (unsigned char)(length & 0xFF), (unsigned char)(length >> 8)};
+    bool written = fwrite(preamble, 1, sizeof(preamble), file) == sizeof(preamble) && fwrite(header, 1, (size_t)length, file) == (size_t)length;
+    const unsigned char* pixels = (const unsigned char*)job->pixels;
+    for (GLsizei y = height - 1; y >= 0 && written; y--)
+        written = fwrite(pixels + (size_t)y * row, 1, row, file) == row;
+    return fclose(file) == 0 && written;
+}
+
+APIC void batch_write(gl_batch_renderer* batch, const gl_batch_job* job) {
+    glapi_BeginCpuZone("batch write");
+    const gl_batch_output* output = &batch->outputs[job->output];
+    GLsizei height = batch->target->desc.height;
+    size_t row = (size_t)batch->target->desc.width * output->readback->pixel_size;
+    const unsigned char* pixels = (const unsigned char*)job->pixels;
+    bool failed = false;
+
+    if (output->memory) {
+        unsigned char* frame = (unsigned char*)output->memory + job->index * output->frame_size;
+        for (GLsizei y = 0; y < height; y++)
+            memcpy(frame + (size_t)y * row, pixels + (size_t)(height - 1 - y) * row, row);
+    }
+    if (batch->directory) {
+        char fpath[BATCH_PATH_LENGTH];
+        snprintf(fpath, sizeof(fpath), "%s/%07llu_%s.npy", batch->directory, (unsigned long long)job->item, output->name);
+        if (!batch_write_npy(batch, job, fpath)) {
+            fprintf(stderr, "[%s] - Failed to write '%s' in batch_write\n", _FL, fpath);
+            failed = true;
+        }
+    }
+
+    pthread_mutex_lock(&batch->lock);
+    if (failed)
+        batch->failed++;
+    else
+        batch->written++;
+    batch->slot_remaining[job->slot]--;
+    pthread_cond_broadcast(&batch->finished);
+    pthread_mutex_unlock(&batch->lock);
+    glapi_EndCpuZone();
+}
+
+APIC void* batch_writer(void* arg) {
+    gl_batch_renderer* batch = (gl_batch_renderer*)arg;
+    glapi_NameCpuThread("batch writer");
+
+    pthread_mutex_lock(&batch->lock);
+    for (;;) {
+        while (!batch->stopping && !batch->job_count)
+            pthread_cond_wait(&batch->wake, &batch->lock);
+        if (batch->stopping)
+            break;
+
+        gl_batch_job job = batch->jobs[batch->job_head];
+        batch->job_head = (batch->job_head + 1) % batch->job_capacity;
+        batch->job_count--;
+        pthread_mutex_unlock(&batch->lock);
+        batch_write(batch, &job);
+        pthread_mutex_lock(&batch->lock);
+    }
+    pthread_mutex_unlock(&batch->lock);
+    return NULL;
+}
+
+APIC bool batch_slot_busy(gl_batch_renderer* batch, GLuint slot) {
+    const gl_readback_slot* state = &batch->outputs[0].readback->slots[slot];
+    return state->pending || state->data;
+}
+
+APIC void batch_dispatch(gl_batch_renderer* batch, GLuint slot) {
+    batch->slot_remaining[slot] = batch->output_count;
+    for (GLuint i = 0; i < batch->output_count; i++) {
+        gl_batch_job job;
+        job.slot = slot;
+        job.output = i;
+        job.index = batch->slot_items[slot];
+        job.item = batch->first_item + job.index;
+        job.pixels = batch->outputs[i].readback->slots[slot].data;
+        if (!batch->writer_count) {
+            batch_write(batch, &job);
+            continue;
+        }
+        pthread_mutex_lock(&batch->lock);
+        batch->jobs[(batch->job_head + batch->job_count) % batch->job_capacity] = job;
+        batch->job_count++;
+        pthread_cond_signal(&batch->wake);
+        pthread_mutex_unlock(&batch->lock);
+    }
+}
+
+APIC void batch_collect(gl_batch_renderer* batch, bool wait) {
+    for (GLuint slot = 0; slot < batch->slot_count; slot++) {
+        if (!batch->outputs[0].readback->slots[slot].data)
+            continue;
+        pthread_mutex_lock(&batch->lock);
+        bool done = batch->slot_remaining[slot] == 0;
+        pthread_mutex_unlock(&batch->lock);
+        if (!done)
+            continue;
+        for (GLuint i = 0; i < batch->output_count; i++)
+            glapi_UnmapReadback(batch->outputs[i].readback, slot);
+    }
+
+    GLuint slot;
+    while ((slot = glapi_MapReadback(batch->outputs[0].readback, wait)) != READBACK_INVALID) {
+        GLuint mapped = 1;
+        for (; mapped < batch->output_count; mapped++) {
+            GLuint other = glapi_MapReadback(batch->outputs[mapped].readback, true);
+            if (other == slot)
+                continue;
+            if (other != READBACK_INVALID)
+                glapi_UnmapReadback(batch->outputs[mapped].readback, other);
+            break;
+        }
+        if (mapped < batch->output_count) {
+            fprintf(stderr, "[%s] - Readback rings out of step at slot [%u], dropping item [%zu] in batch_collect\n", _FL, slot, batch->first_item + batch->slot_items[slot]);
+            for (GLuint i = 0; i < mapped; i++)
+                glapi_UnmapReadback(batch->outputs[i].readback, slot);
+            pthread_mutex_lock(&batch->lock);
+            batch->failed += batch->output_count;
+            pthread_mutex_unlock(&batch->lock);
+            continue;
+        }
+        batch_dispatch(batch, slot);
+        if (!batch->writer_count) {
+            for (GLuint i = 0; i < batch->output_count; i++)
+                glapi_UnmapReadback(batch->outputs[i].readback, slot);
+        }
+    }
+}
+
+APIC void batch_release_targets(gl_batch_renderer* batch) {
+    for (GLuint i = 0; i < batch->output_count; i++)
+        glapi_DestroyReadback(batch->outputs[i].readback);
+    if (batch->target)
+        glapi_DestroyRenderTarget(batch->target);
+    batch->output_count = 0;
+    batch->target = NULL;
+}
+
+APIC void batch_drain(gl_batch_renderer* batch) {
+    batch_collect(batch, true);
+    pthread_mutex_lock(&batch->lock);
+    for (GLuint slot = 0; slot < batch->slot_count; slot++)
+        while (batch->slot_remaining[slot])
+            pthread_cond_wait(&batch->finished, &batch->lock);
+    pthread_mutex_unlock(&batch->lock);
+    batch_collect(batch, false);
+}
+
+gl_batch_renderer* glapi_GenBatchRenderer(gl_app* app, const gl_render_target_desc* desc, const char** names, GLuint slots, GLuint writers) {
+    if (!desc->color_count) {
+        fprintf(stderr, "[%s] - Batch renderer needs at least one color output in glapi_GenBatchRenderer\n", _FL);
+        return NULL;
+    }
+    gl_render_target_desc target_desc = *desc;
+    target_desc.samples = 1;
+
+    gl_batch_renderer* batch = (gl_batch_renderer*)calloc(1, sizeof(gl_batch_renderer));
+    if (!batch) {
+        fprintf(stderr, "[%s] - Failure to allocate 'batch' to heap in glapi_GenBatchRenderer\n", _FL);
+        return NULL;
+    }
+    batch->app = app;
+    batch->slot_count = slots ? slots : READBACK_SLOTS;
+    batch->target = glapi_CreateRenderTarget(&target_desc);
+    if (!batch->target) {
+        free(batch);
+        return NULL;
+    }
+    for (GLuint i = 0; i < target_desc.color_count; i++) {
+        gl_batch_output* output = &batch->outputs[i];
+        output->readback = glapi_CreateReadback(app, batch->slot_count, target_desc.color_formats[i]);
+        if (!output->readback) {
+            batch_release_targets(batch);
+            free(batch);
+            return NULL;
+        }
+        if (names && names[i])
+            snprintf(output->name, BATCH_NAME_LENGTH, "%s", names[i]);
+        else
+            snprintf(output->name, BATCH_NAME_LENGTH, "output%u", i);
+        output->frame_size = (size_t)target_desc.width * (size_t)target_desc.height * output->readback->pixel_size;
+        batch->output_count++;
+    }
+
+    batch->slot_items = (size_t*)calloc(batch->slot_count, sizeof(size_t));
+    batch->slot_remaining = (GLuint*)calloc(batch->slot_count, sizeof(GLuint));
+    batch->job_capacity = (size_t)batch->slot_count * batch->output_count;
+    batch->jobs = (gl_batch_job*)calloc(batch->job_capacity, sizeof(gl_batch_job));
+    batch->writers = writers ? (pthread_t*)calloc(writers, sizeof(pthread_t)) : NULL;
+    if (!batch->slot_items || !batch->slot_remaining || !batch->jobs || (writers && !batch->writers)) {
+        fprintf(stderr, "[%s] - Failure to allocate batch queues to heap in glapi_GenBatchRenderer\n", _FL);
+        free(batch->slot_items);
+        free(batch->slot_remaining);
+        free(batch->jobs);
+        free(batch->writers);
+        batch_release_targets(batch);
+        free(batch);
+        return NULL;
+    }
+    pthread_mutex_init(&batch->lock, NULL);
+    pthread_cond_init(&batch->wake, NULL);
+    pthread_cond_init(&batch->finished, NULL);
+    for (GLuint i = 0; i < writers; i++) {
+        if (pthread_create(&batch->writers[batch->writer_count], NULL, batch_writer, batch)) {
+            fprintf(stderr, "[%s] - Failure to start writer [%u] in glapi_GenBatchRenderer\n", _FL, i);
+            break;
+        }
+        batch->writer_count++;
+    }
+
+    glapi_AppendOpenGLObjects(app, T{(GLuint*)batch, BATCH_RENDERER});
+    return batch;
+}
+
+bool glapi_BatchRendererUniform(gl_batch_renderer* batch, const char* name, unsigned int type) {
+    static const GLuint floats[] = {1, 1, 2, 3, 4, 9, 16};
+    if (batch->uniform_count >= BATCH_MAX_UNIFORMS || type > RENDER_UNIFORM_MAT4) {
+        fprintf(stderr, "[%s] - Cannot add batch uniform '%s' in glapi_BatchRendererUniform\n", _FL, name);
+        return false;
+    }
+    gl_batch_uniform* uniform = &batch->uniforms[batch->uniform_count++];
+    snprintf(uniform->name, sizeof(uniform->name), "%s", name);
+    uniform->type = type;
+    uniform->offset = batch->param_count;
+    batch->param_count += floats[type];
+    return true;
+}
+
+bool glapi_SetBatchOutputMemory(gl_batch_renderer* batch, GLuint output, void* memory) {
+    if (output >= batch->output_count) {
+        fprintf(stderr, "[%s] - Invalid batch output [%u] in glapi_SetBatchOutputMemory\n", _FL, output);
+        return false;
+    }
+    batch->outputs[output].memory = memory;
+    return true;
+}
+
+bool glapi_SetBatchOutputDirectory(gl_batch_renderer* batch, const char* directory) {
+    free(batch->directory);
+    batch->directory = NULL;
+    if (!directory)
+        return true;
+    if (!glapi_EnsureDirectory(directory))
+        return false;
+    batch->directory = strdup(directory);
+    return batch->directory != NULL;
+}
+
+size_t glapi_BatchRender(gl_batch_renderer* batch, gl_render_queue* queue, const float* params, size_t count, size_t first_item, gl_batch_scene scene, void* user) {
+    glapi_BeginCpuZone("glapi_BatchRender");
+    gl_render_target* target = batch->target;
+    batch->first_item = first_item;
+    size_t rendered = 0;
+
+    glEnable(GL_DEPTH_TEST);
+    for (size_t index = 0; index < count; index++) {
+        GLuint slot = batch->outputs[0].readback->head;
+        while (batch_slot_busy(batch, slot)) {
+            batch_collect(batch, false);
+            if (!batch_slot_busy(batch, slot))
+                break;
+            if (!batch->outputs[0].readback->slots[slot].data) {
+                batch_collect(batch, true);
+                continue;
+            }
+            pthread_mutex_lock(&batch->lock);
+            while (batch->slot_remaining[slot])
+                pthread_cond_wait(&batch->finished, &batch->lock);
+            pthread_mutex_unlock(&batch->lock);
+        }
+
+        const float* item_params = params ? params + index * batch->param_count : NULL;
+        glBindFramebuffer(GL_FRAMEBUFFER, target->framebuffer);
+        glViewport(0, 0, target->desc.width, target->desc.height);
+        batch_clear(batch);
+        if (scene && !scene(batch, index, item_params, user))
+            break;
+        batch_apply_params(batch, queue, item_params);
+        if (queue)
+            glapi_SubmitRenderQueue(queue);
+
+        batch->slot_items[slot] = index;
+        for (GLuint i = 0; i < batch->output_count; i++)
+            glapi_ReadbackFramebuffer(batch->outputs[i].readback, target->framebuffer, i, 0, 0, target->desc.width, target->desc.height);
+        batch_collect(batch, false);
+        rendered++;
+    }
+
+    batch_drain(batch);
+    glBindFramebuffer(GL_FRAMEBUFFER, glapi_DefaultFramebuffer());
+    batch->rendered += rendered;
+    check_gl_error("glapi_BatchRender");
+    glapi_EndCpuZone();
+    return rendered;
+}
+
+void glapi_DestroyBatchRenderer(gl_batch_renderer* batch) {
+    pthread_mutex_lock(&batch->lock);
+    batch->stopping = true;
+    pthread_cond_broadcast(&batch->wake);
+    pthread_mutex_unlock(&batch->lock);
+    for (GLuint i = 0; i < batch->writer_count; i++)
+        pthread_join(batch->writers[i], NULL);
+
+    pthread_cond_destroy(&batch->finished);
+    pthread_cond_destroy(&batch->wake);
+    pthread_mutex_destroy(&batch->lock);
+    batch_release_targets(batch);
+    free(batch->programs);
+    free(batch->slot_items);
+    free(batch->slot_remaining);
+    free(batch->jobs);
+    free(batch->writers);
+    free(batch->directory);
+    free(batch);
+}
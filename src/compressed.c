@@ -0,0 +1,420 @@
+#include "graphics.h"
+
+#define _FL "compressed.c"
+
+#define APIC static
+
+#define DDS_MAGIC 0x20534444u
+#define DDS_HEADER_SIZE 128
+#define DDS_DX10_HEADER_SIZE 20
+#define DDS_PIXELFORMAT_FOURCC 0x4u
+#define DDS_PIXELFORMAT_RGB 0x40u
+#define DDS_CAPS2_CUBEMAP 0x200u
+#define DDS_FOURCC(a, b, c, d) ((uint32_t)(a) | ((uint32_t)(b) << 8) | ((uint32_t)(c) << 16) | ((uint32_t)(d) << 24))
+
+#define KTX2_HEADER_SIZE 80
+#define KTX2_LEVEL_INDEX_SIZE 24
+
+#define COMPRESSED_MAX_LEVELS 16
+
+typedef struct compressed_format {
+    uint32_t dxgi_format;
+    uint32_t vk_format;
+    GLenum internal_format;
+    size_t block_bytes;
+    bool srgb;
+    bool bgra;
+} compressed_format;
+
+typedef struct compressed_image {
+    const compressed_format* format;
+    GLsizei width;
+    GLsizei height;
+    GLsizei levels;
+    const unsigned char* level_data[COMPRESSED_MAX_LEVELS];
+    size_t level_size[COMPRESSED_MAX_LEVELS];
+} compressed_image;
+
+static const unsigned char ktx2_identifier[12] = {0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A};
+
+static const compressed_format compressed_formats[] = {
+    { 28,  37, GL_RGBA8,                                      0, false, false},
+    { 29,  43, GL_SRGB8_ALPHA8,                               0, true,  false},
+    { 87,  44, GL_RGBA8,                                      0, false, true},
+    { 91,  50, GL_SRGB8_ALPHA8,                               0, true,  true},
+    {  0, 131, GL_COMPRESSED_RGB_S3TC_DXT1_EXT,               8, false, false},
+    {  0, 132, GL_COMPRESSED_SRGB_S3TC_DXT1_EXT,              8, true,  false},
+    { 71, 133, GL_COMPRESSED_RGBA_S3TC_DXT1_EXT,              8, false, false},
+    { 72, 134, GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT,        8, true,  false},
+    { 74, 135, GL_COMPRESSED_RGBA_S3TC_DXT3_EXT,             16, false, false},
+    { 75, 136, GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT,       16, true,  false},
+    { 77, 137, GL_COMPRESSED_RGBA_S3TC_DXT5_EXT,             16, false, false},
+    { 78, 138, GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT,       16, true,  false},
+    { 80, 139, GL_COMPRESSED_RED_RGTC1,                       8, false, false},
+    { 81, 140, GL_COMPRESSED_SIGNED_RED_RGTC1,                8, false, false},
+    { 83, 141, GL_COMPRESSED_RG_RGTC2,                       16, false, false},
+    { 84, 142, GL_COMPRESSED_SIGNED_RG_RGTC2,                16, false, false},
+    { 95, 143, GL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT_ARB,    16, false, false},
+    { 96, 144, GL_COMPRESSED_RGB_BPTC_SIGNED_FLOAT_ARB,      16, false, false},
+    { 98, 145, GL_COMPRESSED_RGBA_BPTC_UNORM_ARB,            16, false, false},
+    { 99, 146, GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM_ARB,      16, true,  false},
+    {  0, 147, GL_COMPRESSED_RGB8_ETC2,                       8, false, false},
+    {  0, 148, GL_COMPRESSED_SRGB8_ETC2,                      8, true,  false},
+    {  0, 149, GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2,   8, false, false},
+    {  0, 150, GL_COMPRESSED_SRGB8_PUNCHTHROUGH_ALPHA1_ETC2,  8, true,  false},
+    {  0, 151, GL_COMPRESSED_RGBA8_ETC2_EAC,                 16, false, false},
+    {  0, 152, GL_COMPRESSED_SRGB8_ALPHA8_ETC2_EAC,          16, true,  false},
+    {  0, 153, GL_COMPRESSED_R11_EAC,                         8, false, false},
+    {  0, 154, GL_COMPRESSED_SIGNED_R11_EAC,                  8, false, false},
+    {  0, 155, GL_COMPRESSED_RG11_EAC,                       16, false, false},
+    {  0, 156, GL_COMPRESSED_SIGNED_RG11_EAC,                16, false, false}
+};
+
+APIC uint32_t read_le32(const unsigned char* bytes);
+APIC uint64_t read_le64(const unsigned char* bytes);
+APIC const compressed_format* find_format(uint32_t dxgi_format, uint32_t vk_format, GLenum internal_format);
+APIC size_t level_size(const compressed_format* format, GLsizei width, GLsizei height);
+APIC bool parse_dds(const unsigned char* file, size_t file_size, compressed_image* image);
+APIC bool parse_ktx2(const unsigned char* file, size_t file_size, compressed_image* image);
+APIC void swizzle_bgra(unsigned char* pixels, size_t texels);
+APIC GLuint compressed_upload(gl_app* app, const compressed_image* image, gl_compressed_stats* stats, GLuint* address);
+
+APIC uint32_t read_le32(const unsigned char* bytes) {
+    return (uint32_t)bytes[0] | ((uint32_t)bytes[1] << 8) | ((uint32_t)bytes[2] << 16) | ((uint32_t)bytes[3] << 24);
+}
+
+APIC uint64_t read_le64(const unsigned char* bytes) {
+    return (uint64_t)read_le32(bytes) | ((uint64_t)read_le32(bytes + 4) << 32);
+}
+
+APIC const compressed_format* find_format(uint32_t dxgi_format, uint32_t vk_format, GLenum internal_format) {
+    for (size_t i = 0; i < sizeof(compressed_formats) / sizeof(compressed_formats[0]); i++) {
+        const compressed_format* format = &compressed_formats[i];
+        if ((dxgi_format && format->dxgi_format == dxgi_format) ||
+            (vk_format && format->vk_format == vk_format) ||
+            (internal_format && format->internal_format == internal_format && format->block_bytes))
+            return format;
+    }
+    return NULL;
+}
+
+APIC size_t level_size(const compressed_format* format, GLsizei width, GLsizei height) {
+    if (!format->block_bytes)
+        return (size_t)width * height * 4;
+    return (size_t)((width + 3) / 4) * ((height + 3) / 4) * format->block_bytes;
+}
+
+APIC bool parse_dds(const unsigned char* file, size_t file_size, compressed_image* image) {
+    if (file_size < DDS_HEADER_SIZE || read_le32(file + 4) != 124) {
+        fprintf(stderr, "[%s] - Truncated DDS header in parse_dds\n", _FL);
+        return false;
+    }
+
+    image->height = (GLsizei)read_le32(file + 12);
+    image->width = (GLsizei)read_le32(file + 16);
+    uint32_t mip_count = read_le32(file + 28);
+    uint32_t pf_flags = read_le32(file + 80);
+    uint32_t fourcc = read_le32(file + 84);
+    uint32_t rgb_bits = read_le32(file + 88);
+    uint32_t red_mask = read_le32(file + 92);
+    uint32_t caps2 = read_le32(file + 112);
+    size_t offset = DDS_HEADER_SIZE;
+
+    if (caps2 & DDS_CAPS2_CUBEMAP) {
+        fprintf(stderr, "[%s] - DDS cubemaps are not supported in parse_dds\n", _FL);
+        return false;
+    }
+
+    if (pf_flags & DDS_PIXELFORMAT_FOURCC) {
+        GLenum internal_format = 0;
+        uint32_t dxgi_format = 0;
+        switch (fourcc) {
+            case DDS_FOURCC('D', 'X', 'T', '1'): internal_format = GL_COMPRESSED_RGBA_S3TC_DXT1_EXT; break;
+            case DDS_FOURCC('D', 'X', 'T', '2'):
+            case DDS_FOURCC('D', 'X', 'T', '3'): internal_format = GL_COMPRESSED_RGBA_S3TC_DXT3_EXT; break;
+            case DDS_FOURCC('D', 'X', 'T', '4'):
+            case DDS_FOURCC('D', 'X', 'T', '5'): internal_format = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT; break;
+            case DDS_FOURCC('A', 'T', 'I', '1'):
+            case DDS_FOURCC('B', 'C', '4', 'U'): internal_format = GL_COMPRESSED_RED_RGTC1; break;
+            case DDS_FOURCC('B', 'C', '4', 'S'): internal_format = GL_COMPRESSED_SIGNED_RED_RGTC1; break;
+            case DDS_FOURCC('A', 'T', 'I', '2'):
+            case DDS_FOURCC('B', 'C', '5', 'U'): internal_format = GL_COMPRESSED_RG_RGTC2; break;
+            case DDS_FOURCC('B', 'C', '5', 'S'): internal_format = GL_COMPRESSED_SIGNED_RG_RGTC2; break;
+            case DDS_FOURCC('D', 'X', '1', '0'):
+                if (file_size < DDS_HEADER_SIZE + DDS_DX10_HEADER_SIZE) {
+                    fprintf(stderr, "[%s] - Truncated DX10 header in parse_dds\n", _FL);
+                    return false;
+                }
+                dxgi_format = read_le32(file + DDS_HEADER_SIZE);
+                if (read_le32(file + DDS_HEADER_SIZE + 12) > 1) {
+                    fprintf(stderr, "[%s] - DDS texture arrays are not supported in parse_dds\n", _FL);
+                    return false;
+                }
+                offset += DDS_DX10_HEADER_SIZE;
+                break;
+            default:
+                break;
+        }
+        image->format = find_format(dxgi_format, 0, internal_format);
+    } else if ((pf_flags & DDS_PIXELFORMAT_RGB) && rgb_bits == 32) {
+        image->format = find_format(red_mask == 0x00FF0000u ? 87 : 28, 0, 0);
+    }
+
+    if (!image->format) {
+        fprintf(stderr, "[%s] - Unsupported DDS pixel format [0x%08X] in parse_dds\n", _FL, fourcc);
+        return false;
+    }
+
+    image->levels = mip_count ? (GLsizei)mip_count : 1;
+    if (image->levels > COMPRESSED_MAX_LEVELS)
+        image->levels = COMPRESSED_MAX_LEVELS;
+
+    GLsizei width = image->width, height = image->height;
+    for (GLsizei level = 0; level < image->levels; level++) {
+        size_t size = level_size(image->format, width, height);
+        if (offset > file_size || size > file_size - offset) {
+            fprintf(stderr, "[%s] - Truncated DDS level [%d] in parse_dds\n", _FL, level);
+            return false;
+        }
+        image->level_data[level] = file + offset;
+        image->level_size[level] = size;
+        offset += size;
+        width = width > 1 ? width / 2 : 1;
+        height = height > 1 ? height / 2 : 1;
+    }
+    return true;
+}
+
+APIC bool parse_ktx2(const unsigned char* file, size_t file_size, compressed_image* image) {
+    if (file_size < KTX2_HEADER_SIZE) {
+        fprintf(stderr, "[%s] - Truncated KTX2 header in parse_ktx2\n", _FL);
+        return false;
+    }
+
+    uint32_t vk_format = read_le32(file + 12);
+    image->width = (GLsizei)read_le32(file + 20);
+    image->height = (GLsizei)read_le32(file + 24);
+    uint32_t depth = read_le32(file + 28);
+    uint32_t layers = read_le32(file + 32);
+    uint32_t faces = read_le32(file + 36);
+    uint32_t level_count = read_le32(file + 40);
+    uint32_t supercompression = read_le32(file + 44);
+
+    if (depth > 1 || layers > 1 || faces != 1) {
+        fprintf(stderr, "[%s] - Only single 2D KTX2 images are supported in parse_ktx2\n", _FL);
+        return false;
+    }
+    if (supercompression) {
+        fprintf(stderr, "[%s] - KTX2 supercompression scheme [%u] is not supported in parse_ktx2\n", _FL, supercompression);
+        return false;
+    }
+
+    image->format = find_format(0, vk_format, 0);
+    if (!image->format) {
+        fprintf(stderr, "[%s] - Unsupported KTX2 vkFormat [%u] in parse_ktx2\n", _FL, vk_format);
+        return false;
+    }
+
+    image->levels = level_count ? (GLsizei)level_count : 1;
+    if (image->levels > COMPRESSED_MAX_LEVELS)
+        image->levels = COMPRESSED_MAX_LEVELS;
+    if (KTX2_HEADER_SIZE + (size_t)image->levels * KTX2_LEVEL_INDEX_SIZE > file_size) {
+        fprintf(stderr, "[%s] - Truncated KTX2 level index in parse_ktx2\n", _FL);
+        return false;
+    }
+
+    GLsizei width = image->width, height = image->height;
+    for (GLsizei level = 0; level < image->levels; level++) {
+        const unsigned char* entry = file + KTX2_HEADER_SIZE + (size_t)level * KTX2_LEVEL_INDEX_SIZE;
+        uint64_t offset = read_le64(entry);
+        uint64_t length = read_le64(entry + 8);
+        size_t size = level_size(image->format, width, height);
+        if (length < size || offset > file_size || size > file_size - offset) {
+            fprintf(stderr, "[%s] - Invalid KTX2 level [%d] in parse_ktx2\n", _FL, level);
+            return false;
+        }
+        image->level_data[level] = file + offset;
+        image->level_size[level] = size;
+        width = width > 1 ? width / 2 : 1;
+        height = height > 1 ? height / 2 : 1;
+    }
+    return true;
+}
+
+APIC void swizzle_bgra(unsigned char* pixels, size_t texels) {
+    for (size_t i = 0; i < texels; i++) {
+        unsigned char blue = pixels[i * 4];
+        pixels[i * 4] = pixels[i * 4 + 2];
+        pixels[i * 4 + 2] = blue;
+    }
+}
+
+bool glapi_IsCompressedFormatSupported(GLenum format) {
+    switch (format) {
+        case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+        case GL_COMPRESSED_RGBA_S3TC_DXT1_EXT:
+        case GL_COMPRESSED_RGBA_S3TC_DXT3_EXT:
+        case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
+            return GLAD_GL_EXT_texture_compression_s3tc;
+        case GL_COMPRESSED_SRGB_S3TC_DXT1_EXT:
+        case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT:
+        case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT:
+        case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT:
+            return GLAD_GL_EXT_texture_compression_s3tc && GLAD_GL_EXT_texture_sRGB;
+        case GL_COMPRESSED_RED_RGTC1:
+        case GL_COMPRESSED_SIGNED_RED_RGTC1:
+        case GL_COMPRESSED_RG_RGTC2:
+        case GL_COMPRESSED_SIGNED_RG_RGTC2:
+            return true;
+        case GL_COMPRESSED_RGBA_BPTC_UNORM_ARB:
+        case GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM_ARB:
+        case GL_COMPRESSED_RGB_BPTC_SIGNED_FLOAT_ARB:
+        case GL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT_ARB:
+            return GLAD_GL_ARB_texture_compression_bptc;
+        case GL_COMPRESSED_RGB8_ETC2:
+        case GL_COMPRESSED_SRGB8_ETC2:
+        case GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2:
+        case GL_COMPRESSED_SRGB8_PUNCHTHROUGH_ALPHA1_ETC2:
+        case GL_COMPRESSED_RGBA8_ETC2_EAC:
+        case GL_COMPRESSED_SRGB8_ALPHA8_ETC2_EAC:
+        case GL_COMPRESSED_R11_EAC:
+        case GL_COMPRESSED_SIGNED_R11_EAC:
+        case GL_COMPRESSED_RG11_EAC:
+        case GL_COMPRESSED_SIGNED_RG11_EAC:
+            return GLAD_GL_ARB_ES3_compatibility;
+        default:
+            return false;
+    }
+}
+
+APIC GLuint compressed_upload(gl_app* app, const compressed_image* image, gl_compressed_stats* stats, GLuint* address) {
+    const compressed_format* format = image->format;
+    bool compressed = format->block_bytes != 0;
+    bool transcode = compressed && !glapi_IsCompressedFormatSupported(format->internal_format);
+    if (transcode && !glapi_CanDecodeCompressedFormat(format->internal_format)) {
+        fprintf(stderr, "[%s] - Format [0x%04X] is unsupported by the driver and has no software decoder in compressed_upload\n", _FL, format->internal_format);
+        return 0;
+    }
+
+    GLenum storage_format = format->internal_format;
+    if (transcode)
+        storage_format = format->srgb ? GL_SRGB8_ALPHA8 : GL_RGBA8;
+
+    unsigned char* scratch = NULL;
+    if (transcode || format->bgra) {
+        scratch = (unsigned char*)malloc((size_t)image->width * image->height * 4);
+        if (!scratch) {
+            fprintf(stderr, "[%s] - Failure to allocate decode buffer to heap in compressed_upload\n", _FL);
+            return 0;
+        }
+    }
+
+    GLuint texture;
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    if (GLAD_GL_ARB_texture_storage)
+        glTexStorage2D(GL_TEXTURE_2D, image->levels, storage_format, image->width, image->height);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+    size_t gpu_bytes = 0;
+    GLsizei width = image->width, height = image->height;
+    for (GLsizei level = 0; level < image->levels; level++) {
+        const void* pixels = image->level_data[level];
+        if (transcode) {
+            glapi_DecodeCompressedImage(format->internal_format, pixels, width, height, scratch);
+            pixels = scratch;
+        } else if (format->bgra) {
+            memcpy(scratch, pixels, image->level_size[level]);
+            swizzle_bgra(scratch, (size_t)width * height);
+            pixels = scratch;
+        }
+
+        if (compressed && !transcode) {
+            if (GLAD_GL_ARB_texture_storage)
+                glCompressedTexSubImage2D(GL_TEXTURE_2D, level, 0, 0, width, height, storage_format, (GLsizei)image->level_size[level], pixels);
+            else
+                glCompressedTexImage2D(GL_TEXTURE_2D, level, storage_format, width, height, 0, (GLsizei)image->level_size[level], pixels);
+            gpu_bytes += image->level_size[level];
+        } else {
+            if (GLAD_GL_ARB_texture_storage)
+                glTexSubImage2D(GL_TEXTURE_2D, level, 0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+            else
+                glTexImage2D(GL_TEXTURE_2D, level, storage_format, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+            gpu_bytes += (size_t)width * height * 4;
+        }
+        width = width > 1 ? width / 2 : 1;
+        height = height > 1 ? height / 2 : 1;
+    }
+
+    if (!GLAD_GL_ARB_texture_storage) {
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, image->levels - 1);
+    }
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    check_gl_error("compressed_upload");
+
+    if (stats) {
+        stats->internal_format = format->internal_format;
+        stats->storage_format = storage_format;
+        stats->width = image->width;
+        stats->height = image->height;
+        stats->levels = image->levels;
+        stats->gpu_bytes = gpu_bytes;
+        stats->transcoded = transcode;
+        stats->cache_hit = false;
+    }
+
+    free(scratch);
+    glapi_AppendTextureObject(app, texture, address);
+    return texture;
+}
+
+GLuint glapi_GenCompressedTextureFromFpath(gl_app* app, const char* fpath, gl_compressed_stats* stats, GLuint* address) {
+    size_t file_size = 0;
+    unsigned char* file = glapi_ReadFile(fpath, &file_size);
+    if (!file)
+        return 0;
+
+    compressed_image image;
+    memset(&image, 0, sizeof(compressed_image));
+    bool parsed;
+    if (file_size >= 4 && read_le32(file) == DDS_MAGIC) {
+        parsed = parse_dds(file, file_size, &image);
+    } else if (file_size >= sizeof(ktx2_identifier) && !memcmp(file, ktx2_identifier, sizeof(ktx2_identifier))) {
+        parsed = parse_ktx2(file, file_size, &image);
+    } else {
+        fprintf(stderr, "[%s] - '%s' is neither DDS nor KTX2 in glapi_GenCompressedTextureFromFpath\n", _FL, fpath);
+        parsed = false;
+    }
+    if (!parsed || image.width <= 0 || image.height <= 0) {
+        free(file);
+        return 0;
+    }
+    if (image.levels > glapi_TextureMipLevels(image.width, image.height))
+        image.levels = glapi_TextureMipLevels(image.width, image.height);
+
+    GLuint texture = compressed_upload(app, &image, stats, address);
+    free(file);
+    return texture;
+}
+
+GLuint glapi_GenCompressedTexture(gl_app* app, GLenum internal_format, GLsizei width, GLsizei height, GLsizei levels, unsigned char* const* level_data, const size_t* level_size, gl_compressed_stats* stats, GLuint* address) {
+    compressed_image image;
+    memset(&image, 0, sizeof(compressed_image));
+    image.format = find_format(0, 0, internal_format);
+    if (!image.format || width <= 0 || height <= 0 || levels <= 0) {
+        fprintf(stderr, "[%s] - Invalid compressed image [0x%04X, %d x %d, %d levels] in glapi_GenCompressedTexture\n", _FL, internal_format, width, height, levels);
+        return 0;
+    }
+    image.width = width;
+    image.height = height;
+    image.levels = levels < glapi_TextureMipLevels(width, height) ? levels : glapi_TextureMipLevels(width, height);
+    if (image.levels > COMPRESSED_MAX_LEVELS)
+        image.levels = COMPRESSED_MAX_LEVELS;
+    for (GLsizei level = 0; level < image.levels; level++) {
+        image.level_data[level] = level_data[level];
+        image.level_size[level] = level_size[level];
+    }
+    return compressed_upload(app, &image, stats, address);
+}
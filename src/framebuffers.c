@@ -0,0 +1,510 @@
+#include "graphics.h"
+
+#define _FL "framebuffers.c"
+
+#define APIC static
+
+APIC bool target_format(GLenum internal_format, GLenum* format, GLenum* type, GLenum* attachment);
+APIC gl_texture target_texture(GLenum internal_format, GLsizei width, GLsizei height, GLenum format, GLenum type, GLint filter);
+APIC GLuint target_renderbuffer(GLenum internal_format, GLsizei samples, GLsizei width, GLsizei height);
+APIC bool target_complete(gl_framebuffer framebuffer, const char* name);
+APIC void target_draw_buffers(GLuint count);
+APIC gl_render_target* target_create(const gl_render_target_desc* desc, gl_texture borrowed_color);
+APIC GLuint readback_components(GLenum format);
+APIC void readback_retire(gl_readback_slot* slot);
+APIC GLuint readback_oldest(gl_readback* readback);
+
+APIC bool target_format(GLenum internal_format, GLenum* format, GLenum* type, GLenum* attachment) {
+    *attachment = GL_COLOR_ATTACHMENT0;
+    switch (internal_format) {
+        case GL_R8:                 *format = GL_RED;  *type = GL_UNSIGNED_BYTE; return true;
+        case GL_RG8:                *format = GL_RG;   *type = GL_UNSIGNED_BYTE; return true;
+        case GL_RGB8:               *format = GL_RGB;  *type = GL_UNSIGNED_BYTE; return true;
+        case GL_RGBA8:
+        case GL_SRGB8_ALPHA8:       *format = GL_RGBA; *type = GL_UNSIGNED_BYTE; return true;
+        case GL_RG16:               *format = GL_RG;   *type = GL_UNSIGNED_SHORT; return true;
+        case GL_RGBA16:             *format = GL_RGBA; *type = GL_UNSIGNED_SHORT; return true;
+        case GL_RGB10_A2:           *format = GL_RGBA; *type = GL_UNSIGNED_INT_2_10_10_10_REV; return true;
+        case GL_R11F_G11F_B10F:     *format = GL_RGB;  *type = GL_UNSIGNED_INT_10F_11F_11F_REV; return true;
+        case GL_R16F:
+        case GL_R32F:               *format = GL_RED;  *type = GL_FLOAT; return true;
+        case GL_RG16F:
+        case GL_RG32F:              *format = GL_RG;   *type = GL_FLOAT; return true;
+        case GL_RGBA16F:
+        case GL_RGBA32F:            *format = GL_RGBA; *type = GL_FLOAT; return true;
+        case GL_R8UI:               *format = GL_RED_INTEGER; *type = GL_UNSIGNED_BYTE; return true;
+        case GL_R16UI:              *format = GL_RED_INTEGER; *type = GL_UNSIGNED_SHORT; return true;
+        case GL_R32UI:              *format = GL_RED_INTEGER; *type = GL_UNSIGNED_INT; return true;
+        default:
+            break;
+    }
+    *attachment = GL_DEPTH_ATTACHMENT;
+    switch (internal_format) {
+        case GL_DEPTH_COMPONENT16:
+        case GL_DEPTH_COMPONENT24:  *format = GL_DEPTH_COMPONENT; *type = GL_UNSIGNED_INT; return true;
+        case GL_DEPTH_COMPONENT32F: *format = GL_DEPTH_COMPONENT; *type = GL_FLOAT; return true;
+        default:
+            break;
+    }
+    *attachment = GL_DEPTH_STENCIL_ATTACHMENT;
+    switch (internal_format) {
+        case GL_DEPTH24_STENCIL8:   *format = GL_DEPTH_STENCIL; *type = GL_UNSIGNED_INT_24_8; return true;
+        case GL_DEPTH32F_STENCIL8:  *format = GL_DEPTH_STENCIL; *type = GL_FLOAT_32_UNSIGNED_INT_24_8_REV; return true;
+        default:
+            return false;
+    }
+}
+
+APIC gl_texture target_texture(GLenum internal_format, GLsizei width, GLsizei height, GLenum format, GLenum type, GLint filter) {
+    gl_texture texture;
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    if (GLAD_GL_ARB_texture_storage) {
+        glTexStorage2D(GL_TEXTURE_2D, 1, internal_format, width, height);
+    } else {
+        glTexImage2D(GL_TEXTURE_2D, 0, internal_format, width, height, 0, format, type, NULL);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+    }
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    return texture;
+}
+
+APIC GLuint target_renderbuffer(GLenum internal_format, GLsizei samples, GLsizei width, GLsizei height) {
+    GLuint renderbuffer;
+    glGenRenderbuffers(1, &renderbuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, renderbuffer);
+    if (samples > 1)
+        glRenderbufferStorageMultisample(GL_RENDERBUFFER, samples, internal_format, width, height);
+    else
+        glRenderbufferStorage(GL_RENDERBUFFER, internal_format, width, height);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+    return renderbuffer;
+}
+
+APIC bool target_complete(gl_framebuffer framebuffer, const char* name) {
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    if (status != GL_FRAMEBUFFER_COMPLETE) {
+        fprintf(stderr, "[%s] - Incomplete %s framebuffer [0x%04X] in target_create\n", _FL, name, status);
+        return false;
+    }
+    return true;
+}
+
+APIC void target_draw_buffers(GLuint count) {
+    GLenum buffers[RENDER_TARGET_MAX_COLOR];
+    for (GLuint i = 0; i < count; i++)
+        buffers[i] = GL_COLOR_ATTACHMENT0 + i;
+    if (count) {
+        glDrawBuffers((GLsizei)count, buffers);
+        glReadBuffer(GL_COLOR_ATTACHMENT0);
+    } else {
+        glDrawBuffer(GL_NONE);
+        glReadBuffer(GL_NONE);
+    }
+}
+
+APIC gl_render_target* target_create(const gl_render_target_desc* desc, gl_texture borrowed_color) {
+    if (desc->width <= 0 || desc->height <= 0) {
+        fprintf(stderr, "[%s] - Invalid render target size [%d x %d] in target_create\n", _FL, desc->width, desc->height);
+        return NULL;
+    }
+    if (desc->color_count > RENDER_TARGET_MAX_COLOR) {
+        fprintf(stderr, "[%s] - Too many color attachments [%u] in target_create\n", _FL, desc->color_count);
+        return NULL;
+    }
+    if (!desc->color_count && !desc->depth_format) {
+        fprintf(stderr, "[%s] - Render target without attachments in target_create\n", _FL);
+        return NULL;
+    }
+
+    GLenum formats[RENDER_TARGET_MAX_COLOR], types[RENDER_TARGET_MAX_COLOR], attachment;
+    for (GLuint i = 0; i < desc->color_count; i++) {
+        if (!target_format(desc->color_formats[i], &formats[i], &types[i], &attachment) || attachment != GL_COLOR_ATTACHMENT0) {
+            fprintf(stderr, "[%s] - Unsupported color format [0x%04X] at attachment [%u] in target_create\n", _FL, desc->color_formats[i], i);
+            return NULL;
+        }
+    }
+    GLenum depth_format = 0, depth_type = 0, depth_attachment = 0;
+    if (desc->depth_format && (!target_format(desc->depth_format, &depth_format, &depth_type, &depth_attachment) || depth_attachment == GL_COLOR_ATTACHMENT0)) {
+        fprintf(stderr, "[%s] - Unsupported depth format [0x%04X] in target_create\n", _FL, desc->depth_format);
+        return NULL;
+    }
+
+    gl_render_target* target = (gl_render_target*)calloc(1, sizeof(gl_render_target));
+    if (!target) {
+        fprintf(stderr, "[%s] - Failure to allocate 'target' to heap in target_create\n", _FL);
+        return NULL;
+    }
+    target->desc = *desc;
+    target->borrowed_color = borrowed_color != 0;
+
+    GLint max_samples = 1;
+    glGetIntegerv(GL_MAX_SAMPLES, &max_samples);
+    if (target->desc.samples > max_samples)
+        target->desc.samples = max_samples;
+    if (target->desc.samples < 1)
+        target->desc.samples = 1;
+    GLsizei samples = target->desc.samples;
+    GLsizei width = desc->width;
+    GLsizei height = desc->height;
+
+    for (GLuint i = 0; i < desc->color_count; i++) {
+        if (i == 0 && borrowed_color)
+            target->color_textures[i] = borrowed_color;
+        else
+            target->color_textures[i] = target_texture(desc->color_formats[i], width, height, formats[i], types[i], formats[i] == GL_RED_INTEGER ? GL_NEAREST : GL_LINEAR);
+        if (samples > 1)
+            target->color_buffers[i] = target_renderbuffer(desc->color_formats[i], samples, width, height);
+    }
+    if (desc->depth_format) {
+        if (desc->depth_texture)
+            target->depth_texture = target_texture(desc->depth_format, width, height, depth_format, depth_type, GL_NEAREST);
+        if (!desc->depth_texture || samples > 1)
+            target->depth_buffer = target_renderbuffer(desc->depth_format, samples, width, height);
+    }
+
+    glGenFramebuffers(1, &target->framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, target->framebuffer);
+    for (GLuint i = 0; i < desc->color_count; i++) {
+        if (samples > 1)
+            glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + i, GL_RENDERBUFFER, target->color_buffers[i]);
+        else
+            glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + i, GL_TEXTURE_2D, target->color_textures[i], 0);
+    }
+    if (target->depth_buffer)
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, depth_attachment, GL_RENDERBUFFER, target->depth_buffer);
+    else if (target->depth_texture)
+        glFramebufferTexture2D(GL_FRAMEBUFFER, depth_attachment, GL_TEXTURE_2D, target->depth_texture, 0);
+    target_draw_buffers(desc->color_count);
+    bool complete = target_complete(target->framebuffer, "render");
+
+    if (complete && samples > 1) {
+        glGenFramebuffers(1, &target->resolve_framebuffer);
+        glBindFramebuffer(GL_FRAMEBUFFER, target->resolve_framebuffer);
+        for (GLuint i = 0; i < desc->color_count; i++)
+            glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + i, GL_TEXTURE_2D, target->color_textures[i], 0);
+        if (target->depth_texture)
+            glFramebufferTexture2D(GL_FRAMEBUFFER, depth_attachment, GL_TEXTURE_2D, target->depth_texture, 0);
+        target_draw_buffers(desc->color_count);
+        complete = target_complete(target->resolve_framebuffer, "resolve");
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, glapi_DefaultFramebuffer());
+    check_gl_error("target_create");
+    if (!complete) {
+        glapi_DestroyRenderTarget(target);
+        return NULL;
+    }
+    return target;
+}
+
+GLenum glapi_RenderTargetAttachment(GLenum internal_format) {
+    GLenum format, type, attachment;
+    if (!target_format(internal_format, &format, &type, &attachment))
+        return GL_NONE;
+    return attachment;
+}
+
+gl_texture glapi_CreateRenderTexture(GLenum internal_format, GLsizei width, GLsizei height) {
+    GLenum format, type, attachment;
+    if (!target_format(internal_format, &format, &type, &attachment)) {
+        fprintf(stderr, "[%s] - Unsupported render texture format [0x%04X] in glapi_CreateRenderTexture\n", _FL, internal_format);
+        return 0;
+    }
+    return target_texture(internal_format, width, height, format, type, attachment == GL_COLOR_ATTACHMENT0 ? GL_LINEAR : GL_NEAREST);
+}
+
+gl_render_target* glapi_CreateRenderTarget(const gl_render_target_desc* desc) {
+    return target_create(desc, 0);
+}
+
+gl_render_target* glapi_GenRenderTarget(gl_app* app, const gl_render_target_desc* desc) {
+    gl_render_target* target = target_create(desc, 0);
+    if (target)
+        glapi_AppendOpenGLObjects(app, T{(GLuint*)target, RENDER_TARGET});
+    return target;
+}
+
+GLuint glapi_GenFrameBuffer(gl_app* app, gl_texture output_tex, GLuint* address, uint16_t width, uint16_t height) {
+    glBindTexture(GL_TEXTURE_2D, output_tex);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB8, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, NULL);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    gl_render_target_desc desc;
+    memset(&desc, 0, sizeof(gl_render_target_desc));
+    desc.width = width;
+    desc.height = height;
+    desc.samples = 1;
+    desc.color_count = 1;
+    desc.color_formats[0] = GL_RGB8;
+    desc.depth_format = GL_DEPTH_COMPONENT24;
+
+    gl_render_target* target = target_create(&desc, output_tex);
+    if (!target) {
+        fprintf(stderr, "[%s] - Failure to generate framebuffer in 'glapi_GenFrameBuffer'\n", _FL);
+        return 0;
+    }
+
+    glapi_AppendOpenGLObjects(app, T{(GLuint*)target, RENDER_TARGET});
+    if (address)
+        *address = target->framebuffer;
+    return target->framebuffer;
+}
+
+void glapi_BindRenderTarget(gl_render_target* target) {
+    glBindFramebuffer(GL_FRAMEBUFFER, target->framebuffer);
+    glViewport(0, 0, target->desc.width, target->desc.height);
+}
+
+void glapi_UnbindRenderTarget(gl_app* app) {
+    int width = app->window->window_width, height = app->window->window_height;
+    glBindFramebuffer(GL_FRAMEBUFFER, glapi_DefaultFramebuffer());
+    if (!app->window->headless)
+        glfwGetFramebufferSize(app->window->pointer, &width, &height);
+    glViewport(0, 0, width, height);
+}
+
+void glapi_ResolveRenderTarget(gl_render_target* target) {
+    if (!target->resolve_framebuffer)
+        return;
+    GLsizei width = target->desc.width;
+    GLsizei height = target->desc.height;
+
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, target->framebuffer);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, target->resolve_framebuffer);
+    GLenum buffers[RENDER_TARGET_MAX_COLOR];
+    for (GLuint i = 0; i < target->desc.color_count; i++) {
+        for (GLuint j = 0; j < i; j++)
+            buffers[j] = GL_NONE;
+        buffers[i] = GL_COLOR_ATTACHMENT0 + i;
+        glReadBuffer(GL_COLOR_ATTACHMENT0 + i);
+        glDrawBuffers((GLsizei)i + 1, buffers);
+        glBlitFramebuffer(0, 0, width, height, 0, 0, width, height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+    }
+    if (target->depth_texture) {
+        GLbitfield mask = GL_DEPTH_BUFFER_BIT;
+        if (target->desc.depth_format == GL_DEPTH24_STENCIL8 || target->desc.depth_format == GL_DEPTH32F_STENCIL8)
+            mask |= GL_STENCIL_BUFFER_BIT;
+        glBlitFramebuffer(0, 0, width, height, 0, 0, width, height, mask, GL_NEAREST);
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, target->resolve_framebuffer);
+    target_draw_buffers(target->desc.color_count);
+    glBindFramebuffer(GL_FRAMEBUFFER, target->framebuffer);
+    target_draw_buffers(target->desc.color_count);
+    glBindFramebuffer(GL_FRAMEBUFFER, glapi_DefaultFramebuffer());
+}
+
+void glapi_BlitRenderTarget(gl_render_target* target, GLuint attachment, gl_framebuffer destination, GLsizei width, GLsizei height) {
+    if (attachment >= target->desc.color_count) {
+        fprintf(stderr, "[%s] - Invalid color attachment [%u] in glapi_BlitRenderTarget\n", _FL, attachment);
+        return;
+    }
+    gl_framebuffer source = target->resolve_framebuffer ? target->resolve_framebuffer : target->framebuffer;
+    GLenum filter = width == target->desc.width && height == target->desc.height ? GL_NEAREST : GL_LINEAR;
+
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, source);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, destination ? destination : glapi_DefaultFramebuffer());
+    glReadBuffer(GL_COLOR_ATTACHMENT0 + attachment);
+    glBlitFramebuffer(0, 0, target->desc.width, target->desc.height, 0, 0, width, height, GL_COLOR_BUFFER_BIT, filter);
+    glReadBuffer(GL_COLOR_ATTACHMENT0);
+    glBindFramebuffer(GL_FRAMEBUFFER, glapi_DefaultFramebuffer());
+}
+
+void glapi_DestroyRenderTarget(gl_render_target* target) {
+    if (target->framebuffer)
+        glDeleteFramebuffers(1, &target->framebuffer);
+    if (target->resolve_framebuffer)
+        glDeleteFramebuffers(1, &target->resolve_framebuffer);
+    for (GLuint i = 0; i < target->desc.color_count; i++) {
+        if (target->color_buffers[i])
+            glDeleteRenderbuffers(1, &target->color_buffers[i]);
+        if (target->color_textures[i] && !(i == 0 && target->borrowed_color))
+            glDeleteTextures(1, &target->color_textures[i]);
+    }
+    if (target->depth_buffer)
+        glDeleteRenderbuffers(1, &target->depth_buffer);
+    if (target->depth_texture)
+        glDeleteTextures(1, &target->depth_texture);
+    free(target);
+}
+
+APIC GLuint readback_components(GLenum format) {
+    switch (format) {
+        case GL_RG:   return 2;
+        case GL_RGB:  return 3;
+        case GL_RGBA: return 4;
+        default:      return 1;
+    }
+}
+
+APIC void readback_retire(gl_readback_slot* slot) {
+    if (slot->fence)
+        glDeleteSync(slot->fence);
+    slot->fence = NULL;
+    slot->pending = false;
+}
+
+APIC GLuint readback_oldest(gl_readback* readback) {
+    GLuint oldest = READBACK_INVALID;
+    for (GLuint i = 0; i < readback->slot_count; i++) {
+        gl_readback_slot* slot = &readback->slots[i];
+        if (slot->pending && !slot->data && (oldest == READBACK_INVALID || slot->frame < readback->slots[oldest].frame))
+            oldest = i;
+    }
+    return oldest;
+}
+
+gl_readback* glapi_GenReadback(gl_app* app, GLuint slots, GLuint channels) {
+    switch (channels) {
+        case 1: return glapi_GenReadbackFormat(app, slots, GL_R8);
+        case 3: return glapi_GenReadbackFormat(app, slots, GL_RGB8);
+        case 4: return glapi_GenReadbackFormat(app, slots, GL_RGBA8);
+        default:
+            fprintf(stderr, "[%s] - Unsupported channel count [%u] in glapi_GenReadback\n", _FL, channels);
+            return NULL;
+    }
+}
+
+gl_readback* glapi_GenReadbackFormat(gl_app* app, GLuint slots, GLenum internal_format) {
+    gl_readback* readback = glapi_CreateReadback(app, slots, internal_format);
+    if (readback)
+        glapi_AppendOpenGLObjects(app, T{(GLuint*)readback, READBACK});
+    return readback;
+}
+
+gl_readback* glapi_CreateReadback(gl_app* app, GLuint slots, GLenum internal_format) {
+    GLenum format, type, attachment;
+    if (!target_format(internal_format, &format, &type, &attachment) || attachment != GL_COLOR_ATTACHMENT0) {
+        fprintf(stderr, "[%s] - Unsupported readback format [0x%04X] in glapi_CreateReadback\n", _FL, internal_format);
+        return NULL;
+    }
+
+    gl_readback* readback = (gl_readback*)calloc(1, sizeof(gl_readback));
+    if (!readback) {
+        fprintf(stderr, "[%s] - Failure to allocate 'readback' to heap in glapi_CreateReadback\n", _FL);
+        return NULL;
+    }
+    readback->slot_count = slots ? slots : READBACK_SLOTS;
+    readback->slots = (gl_readback_slot*)calloc(readback->slot_count, sizeof(gl_readback_slot));
+    if (!readback->slots) {
+        fprintf(stderr, "[%s] - Failure to allocate 'readback->slots' to heap in glapi_CreateReadback\n", _FL);
+        free(readback);
+        return NULL;
+    }
+    readback->app = app;
+    readback->internal_format = internal_format;
+    readback->format = format;
+    readback->type = type;
+    bool packed = type != GL_UNSIGNED_BYTE && type != GL_UNSIGNED_SHORT && type != GL_UNSIGNED_INT && type != GL_FLOAT;
+    readback->channels = packed ? 1 : readback_components(format);
+    readback->pixel_size = packed ? 4 : readback->channels * (type == GL_UNSIGNED_BYTE ? 1 : type == GL_UNSIGNED_SHORT ? 2 : 4);
+    for (GLuint i = 0; i < readback->slot_count; i++)
+        glGenBuffers(1, &readback->slots[i].pbo);
+    check_gl_error("glapi_CreateReadback");
+    return readback;
+}
+
+bool glapi_ReadbackFramebuffer(gl_readback* readback, gl_framebuffer framebuffer, GLuint attachment, GLint x, GLint y, GLsizei width, GLsizei height) {
+    if (width <= 0 || height <= 0) {
+        fprintf(stderr, "[%s] - Invalid readback size [%i x %i] in glapi_ReadbackFramebuffer\n", _FL, width, height);
+        return false;
+    }
+    gl_readback_slot* slot = &readback->slots[readback->head];
+    if (slot->data) {
+        readback->skipped++;
+        return false;
+    }
+    if (slot->pending) {
+        readback_retire(slot);
+        readback->dropped++;
+    }
+
+    size_t size = (size_t)width * (size_t)height * readback->pixel_size;
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot->pbo);
+    if (size > slot->capacity) {
+        glBufferData(GL_PIXEL_PACK_BUFFER, (GLsizeiptr)size, NULL, GL_STREAM_READ);
+        slot->capacity = size;
+    }
+
+    GLint previous;
+    glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &previous);
+    gl_framebuffer source = framebuffer ? framebuffer : glapi_DefaultFramebuffer();
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, source);
+    glReadBuffer(source ? GL_COLOR_ATTACHMENT0 + attachment : GL_BACK);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(x, y, width, height, readback->format, readback->type, (void*)0);
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+    if (source)
+        glReadBuffer(GL_COLOR_ATTACHMENT0);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, (GLuint)previous);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    slot->fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    slot->width = width;
+    slot->height = height;
+    slot->size = size;
+    slot->frame = readback->frame_number++;
+    slot->pending = true;
+    readback->head = (readback->head + 1) % readback->slot_count;
+    readback->issued++;
+    check_gl_error("glapi_ReadbackFramebuffer");
+    return true;
+}
+
+GLuint glapi_MapReadback(gl_readback* readback, bool wait) {
+    GLuint index = readback_oldest(readback);
+    if (index == READBACK_INVALID)
+        return READBACK_INVALID;
+
+    gl_readback_slot* slot = &readback->slots[index];
+    GLenum status = glClientWaitSync(slot->fence, wait ? GL_SYNC_FLUSH_COMMANDS_BIT : 0, wait ? GL_TIMEOUT_IGNORED : 0);
+    if (status == GL_TIMEOUT_EXPIRED)
+        return READBACK_INVALID;
+    if (status == GL_WAIT_FAILED) {
+        fprintf(stderr, "[%s] - Fence wait failed in glapi_MapReadback\n", _FL);
+        readback_retire(slot);
+        return READBACK_INVALID;
+    }
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot->pbo);
+    slot->data = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, (GLsizeiptr)slot->size, GL_MAP_READ_BIT);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    if (!slot->data) {
+        fprintf(stderr, "[%s] - Failed to map readback buffer in glapi_MapReadback\n", _FL);
+        readback_retire(slot);
+        return READBACK_INVALID;
+    }
+    glDeleteSync(slot->fence);
+    slot->fence = NULL;
+    readback->completed++;
+    return index;
+}
+
+void glapi_UnmapReadback(gl_readback* readback, GLuint index) {
+    if (index >= readback->slot_count || !readback->slots[index].data)
+        return;
+    gl_readback_slot* slot = &readback->slots[index];
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot->pbo);
+    glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    slot->data = NULL;
+    readback_retire(slot);
+}
+
+void glapi_DestroyReadback(gl_readback* readback) {
+    for (GLuint i = 0; i < readback->slot_count; i++) {
+        glapi_UnmapReadback(readback, i);
+        readback_retire(&readback->slots[i]);
+        glDeleteBuffers(1, &readback->slots[i].pbo);
+    }
+    free(readback->slots);
+    free(readback);
+}
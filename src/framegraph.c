@@ -0,0 +1,535 @@
+#include "graphics.h"
+
+#define _FL "framegraph.c"
+
+#define APIC static
+#define FRAME_GRAPH_APPEND_AMOUNT 16
+#define FRAME_GRAPH_EDGE_DATA 1
+#define FRAME_GRAPH_EDGE_ORDER 2
+
+APIC char* graph_copy_name(const char* name);
+APIC size_t graph_texel_size(GLenum format);
+APIC GLsizei graph_extent(GLsizei size, float scale);
+APIC void graph_release_targets(gl_frame_graph* graph);
+APIC void graph_release_pool(gl_frame_graph* graph);
+APIC bool graph_writes(const gl_graph_pass* pass, uint32_t resource);
+APIC bool graph_reads(const gl_graph_pass* pass, uint32_t resource);
+APIC bool graph_written_before(gl_frame_graph* graph, uint32_t resource, uint32_t pass);
+APIC unsigned char graph_depends(gl_frame_graph* graph, uint32_t pass, uint32_t other);
+APIC bool graph_order(gl_frame_graph* graph, unsigned char* edges);
+APIC void graph_cull(gl_frame_graph* graph, unsigned char* edges);
+APIC uint32_t graph_acquire_texture(gl_frame_graph* graph, gl_graph_resource* resource);
+APIC bool graph_build_framebuffer(gl_frame_graph* graph, gl_graph_pass* pass);
+
+APIC char* graph_copy_name(const char* name) {
+    if (!name)
+        name = "";
+    char* copy = (char*)malloc(strlen(name) + 1);
+    if (copy)
+        strcpy(copy, name);
+    return copy;
+}
+
+APIC size_t graph_texel_size(GLenum format) {
+    switch (format) {
+        case GL_R8:                 return 1;
+        case GL_RG8:
+        case GL_R16F:
+        case GL_DEPTH_COMPONENT16:  return 2;
+        case GL_RGB8:               return 3;
+        case GL_RGBA16F:
+        case GL_RGBA16:
+        case GL_RG32F:
+        case GL_DEPTH32F_STENCIL8:  return 8;
+        case GL_RGBA32F:            return 16;
+        default:                    return 4;
+    }
+}
+
+APIC GLsizei graph_extent(GLsizei size, float scale) {
+    GLsizei extent = (GLsizei)(size * scale + 0.5f);
+    return extent > 0 ? extent : 1;
+}
+
+APIC void graph_release_targets(gl_frame_graph* graph) {
+    for (size_t i = 0; i < graph->pass_count; i++) {
+        if (graph->passes[i].framebuffer) {
+            glDeleteFramebuffers(1, &graph->passes[i].framebuffer);
+            graph->passes[i].framebuffer = 0;
+        }
+    }
+    graph->compiled = false;
+}
+
+APIC void graph_release_pool(gl_frame_graph* graph) {
+    for (size_t i = 0; i < graph->pool_count; i++)
+        glDeleteTextures(1, &graph->pool[i].texture);
+    graph->pool_count = 0;
+}
+
+APIC bool graph_writes(const gl_graph_pass* pass, uint32_t resource) {
+    for (GLuint w = 0; w < pass->write_count; w++)
+        if (pass->writes[w] == resource)
+            return true;
+    return pass->depth == resource;
+}
+
+APIC bool graph_reads(const gl_graph_pass* pass, uint32_t resource) {
+    for (GLuint r = 0; r < pass->read_count; r++)
+        if (pass->reads[r] == resource)
+            return true;
+    return false;
+}
+
+APIC bool graph_written_before(gl_frame_graph* graph, uint32_t resource, uint32_t pass) {
+    for (uint32_t e = 0; e < pass; e++)
+        if (graph_writes(&graph->passes[e], resource))
+            return true;
+    return false;
+}
+
+APIC unsigned char graph_depends(gl_frame_graph* graph, uint32_t pass, uint32_t other) {
+    gl_graph_pass* reader = &graph->passes[pass];
+    gl_graph_pass* writer = &graph->passes[other];
+    for (GLuint r = 0; r < reader->read_count; r++) {
+        uint32_t resource = reader->reads[r];
+        if (!graph_writes(writer, resource))
+            continue;
+        if (other < pass || !graph_written_before(graph, resource, pass))
+            return FRAME_GRAPH_EDGE_DATA;
+    }
+    if (other > pass)
+        return 0;
+    for (GLuint w = 0; w < reader->write_count; w++)
+        if (graph_writes(writer, reader->writes[w]))
+            return FRAME_GRAPH_EDGE_DATA;
+    if (reader->depth != FRAME_GRAPH_INVALID && graph_writes(writer, reader->depth))
+        return FRAME_GRAPH_EDGE_DATA;
+    for (GLuint w = 0; w < reader->write_count; w++)
+        if (graph_reads(writer, reader->writes[w]) && graph_written_before(graph, reader->writes[w], other))
+            return FRAME_GRAPH_EDGE_ORDER;
+    if (reader->depth != FRAME_GRAPH_INVALID && graph_reads(writer, reader->depth) && graph_written_before(graph, reader->depth, other))
+        return FRAME_GRAPH_EDGE_ORDER;
+    return 0;
+}
+
+APIC bool graph_order(gl_frame_graph* graph, unsigned char* edges) {
+    size_t count = graph->pass_count;
+    for (size_t p = 0; p < count; p++)
+        for (size_t o = 0; o < count; o++)
+            edges[p * count + o] = p == o ? 0 : graph_depends(graph, (uint32_t)p, (uint32_t)o);
+
+    bool* placed = (bool*)calloc(count, sizeof(bool));
+    if (!placed) {
+        fprintf(stderr, "[%s] - Failure to allocate 'placed' to heap in graph_order\n", _FL);
+        return false;
+    }
+    graph->order_count = 0;
+    while (graph->order_count < count) {
+        size_t next = count;
+        for (size_t p = 0; p < count && next == count; p++) {
+            if (placed[p])
+                continue;
+            bool ready = true;
+            for (size_t o = 0; o < count && ready; o++)
+                if (edges[p * count + o] && !placed[o])
+                    ready = false;
+            if (ready)
+                next = p;
+        }
+        if (next == count) {
+            fprintf(stderr, "[%s] - Cyclic pass dependencies in graph_order\n", _FL);
+            free(placed);
+            return false;
+        }
+        placed[next] = true;
+        graph->order[graph->order_count++] = (uint32_t)next;
+    }
+    free(placed);
+    return true;
+}
+
+APIC void graph_cull(gl_frame_graph* graph, unsigned char* edges) {
+    size_t count = graph->pass_count;
+    for (size_t p = 0; p < count; p++) {
+        gl_graph_pass* pass = &graph->passes[p];
+        pass->culled = !(pass->flags & FRAME_GRAPH_PASS_PRESENT);
+        for (GLuint w = 0; w < pass->write_count && pass->culled; w++)
+            if (graph->resources[pass->writes[w]].exported)
+                pass->culled = false;
+        if (pass->depth != FRAME_GRAPH_INVALID && graph->resources[pass->depth].exported)
+            pass->culled = false;
+    }
+    for (size_t i = count; i-- > 0;) {
+        uint32_t p = graph->order[i];
+        if (graph->passes[p].culled)
+            continue;
+        for (size_t o = 0; o < count; o++)
+            if (edges[p * count + o] == FRAME_GRAPH_EDGE_DATA)
+                graph->passes[o].culled = false;
+    }
+}
+
+APIC uint32_t graph_acquire_texture(gl_frame_graph* graph, gl_graph_resource* resource) {
+    for (size_t i = 0; i < graph->pool_count; i++) {
+        gl_graph_texture* entry = &graph->pool[i];
+        if (entry->format != resource->format || entry->width != resource->width || entry->height != resource->height)
+            continue;
+        if (entry->used && entry->busy_until >= resource->first)
+            continue;
+        entry->used = true;
+        entry->busy_until = resource->last;
+        return (uint32_t)i;
+    }
+
+    if (!glapi_GrowArray((void**)&graph->pool, &graph->pool_capacity, graph->pool_count, sizeof(gl_graph_texture), FRAME_GRAPH_APPEND_AMOUNT)) {
+        fprintf(stderr, "[%s] - Failure to reallocate 'graph->pool' in graph_acquire_texture\n", _FL);
+        return FRAME_GRAPH_INVALID;
+    }
+    gl_texture texture = glapi_CreateRenderTexture(resource->format, resource->width, resource->height);
+    if (!texture)
+        return FRAME_GRAPH_INVALID;
+    gl_graph_texture* entry = &graph->pool[graph->pool_count];
+    entry->texture = texture;
+    entry->format = resource->format;
+    entry->width = resource->width;
+    entry->height = resource->height;
+    entry->used = true;
+    entry->busy_until = resource->last;
+    return (uint32_t)graph->pool_count++;
+}
+
+APIC bool graph_build_framebuffer(gl_frame_graph* graph, gl_graph_pass* pass) {
+    if (pass->flags & FRAME_GRAPH_PASS_PRESENT) {
+        pass->width = graph->width;
+        pass->height = graph->height;
+        return true;
+    }
+    if (!pass->write_count && pass->depth == FRAME_GRAPH_INVALID)
+        return true;
+
+    glGenFramebuffers(1, &pass->framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, pass->framebuffer);
+    GLenum buffers[RENDER_TARGET_MAX_COLOR];
+    for (GLuint w = 0; w < pass->write_count; w++) {
+        gl_graph_resource* resource = &graph->resources[pass->writes[w]];
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + w, GL_TEXTURE_2D, glapi_GraphResourceTexture(graph, pass->writes[w]), 0);
+        buffers[w] = GL_COLOR_ATTACHMENT0 + w;
+        pass->width = resource->width;
+        pass->height = resource->height;
+    }
+    if (pass->depth != FRAME_GRAPH_INVALID) {
+        gl_graph_resource* resource = &graph->resources[pass->depth];
+        glFramebufferTexture2D(GL_FRAMEBUFFER, glapi_RenderTargetAttachment(resource->format), GL_TEXTURE_2D, glapi_GraphResourceTexture(graph, pass->depth), 0);
+        pass->width = resource->width;
+        pass->height = resource->height;
+    }
+    if (pass->write_count) {
+        glDrawBuffers((GLsizei)pass->write_count, buffers);
+    } else {
+        glDrawBuffer(GL_NONE);
+        glReadBuffer(GL_NONE);
+    }
+
+    GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    glBindFramebuffer(GL_FRAMEBUFFER, glapi_DefaultFramebuffer());
+    if (status != GL_FRAMEBUFFER_COMPLETE) {
+        fprintf(stderr, "[%s] - Incomplete framebuffer [0x%04X] for pass '%s' in graph_build_framebuffer\n", _FL, status, pass->name);
+        return false;
+    }
+    return true;
+}
+
+gl_frame_graph* glapi_GenFrameGraph(gl_app* app, GLsizei width, GLsizei height) {
+    gl_frame_graph* graph = (gl_frame_graph*)calloc(1, sizeof(gl_frame_graph));
+    if (!graph) {
+        fprintf(stderr, "[%s] - Failure to allocate 'graph' to heap in glapi_GenFrameGraph\n", _FL);
+        return NULL;
+    }
+    graph->app = app;
+    graph->width = width > 0 ? width : 1;
+    graph->height = height > 0 ? height : 1;
+    glapi_AppendOpenGLObjects(app, T{(GLuint*)graph, FRAME_GRAPH});
+    return graph;
+}
+
+uint32_t glapi_GraphCreateResource(gl_frame_graph* graph, const char* name, GLenum format, float scale) {
+    if (!glapi_RenderTargetAttachment(format)) {
+        fprintf(stderr, "[%s] - Unsupported resource format [0x%04X] in glapi_GraphCreateResource\n", _FL, format);
+        return FRAME_GRAPH_INVALID;
+    }
+    if (!glapi_GrowArray((void**)&graph->resources, &graph->resource_capacity, graph->resource_count, sizeof(gl_graph_resource), FRAME_GRAPH_APPEND_AMOUNT)) {
+        fprintf(stderr, "[%s] - Failure to reallocate 'graph->resources' in glapi_GraphCreateResource\n", _FL);
+        return FRAME_GRAPH_INVALID;
+    }
+    gl_graph_resource* resource = &graph->resources[graph->resource_count];
+    memset(resource, 0, sizeof(gl_graph_resource));
+    resource->name = graph_copy_name(name);
+    resource->format = format;
+    resource->scale = scale > 0.0f ? scale : 1.0f;
+    resource->physical = FRAME_GRAPH_INVALID;
+    graph->compiled = false;
+    return (uint32_t)graph->resource_count++;
+}
+
+uint32_t glapi_GraphImportTexture(gl_frame_graph* graph, const char* name, gl_texture texture, GLsizei width, GLsizei height) {
+    if (!glapi_GrowArray((void**)&graph->resources, &graph->resource_capacity, graph->resource_count, sizeof(gl_graph_resource), FRAME_GRAPH_APPEND_AMOUNT)) {
+        fprintf(stderr, "[%s] - Failure to reallocate 'graph->resources' in glapi_GraphImportTexture\n", _FL);
+        return FRAME_GRAPH_INVALID;
+    }
+    gl_graph_resource* resource = &graph->resources[graph->resource_count];
+    memset(resource, 0, sizeof(gl_graph_resource));
+    resource->name = graph_copy_name(name);
+    resource->imported = texture;
+    resource->width = width;
+    resource->height = height;
+    resource->physical = FRAME_GRAPH_INVALID;
+    graph->compiled = false;
+    return (uint32_t)graph->resource_count++;
+}
+
+void glapi_GraphExportResource(gl_frame_graph* graph, uint32_t resource) {
+    if (resource >= graph->resource_count)
+        return;
+    graph->resources[resource].exported = true;
+    graph->compiled = false;
+}
+
+uint32_t glapi_GraphAddPass(gl_frame_graph* graph, const char* name, gl_graph_execute execute, void* user, unsigned int flags) {
+    if (!glapi_GrowArray((void**)&graph->passes, &graph->pass_capacity, graph->pass_count, sizeof(gl_graph_pass), FRAME_GRAPH_APPEND_AMOUNT)) {
+        fprintf(stderr, "[%s] - Failure to reallocate 'graph->passes' in glapi_GraphAddPass\n", _FL);
+        return FRAME_GRAPH_INVALID;
+    }
+    gl_graph_pass* pass = &graph->passes[graph->pass_count];
+    memset(pass, 0, sizeof(gl_graph_pass));
+    pass->name = glapi_InternCpuZoneName(name ? name : "");
+    pass->execute = execute;
+    pass->user = user;
+    pass->flags = flags;
+    pass->depth = FRAME_GRAPH_INVALID;
+    graph->compiled = false;
+    return (uint32_t)graph->pass_count++;
+}
+
+bool glapi_GraphPassRead(gl_frame_graph* graph, uint32_t pass, uint32_t resource) {
+    if (pass >= graph->pass_count || resource >= graph->resource_count) {
+        fprintf(stderr, "[%s] - Invalid pass [%u] or resource [%u] in glapi_GraphPassRead\n", _FL, pass, resource);
+        return false;
+    }
+    gl_graph_pass* target = &graph->passes[pass];
+    if (target->read_count >= FRAME_GRAPH_MAX_READS) {
+        fprintf(stderr, "[%s] - Too many reads for pass '%s' in glapi_GraphPassRead\n", _FL, target->name);
+        return false;
+    }
+    target->reads[target->read_count++] = resource;
+    graph->compiled = false;
+    return true;
+}
+
+bool glapi_GraphPassWrite(gl_frame_graph* graph, uint32_t pass, uint32_t resource) {
+    if (pass >= graph->pass_count || resource >= graph->resource_count) {
+        fprintf(stderr, "[%s] - Invalid pass [%u] or resource [%u] in glapi_GraphPassWrite\n", _FL, pass, resource);
+        return false;
+    }
+    gl_graph_pass* target = &graph->passes[pass];
+    gl_graph_resource* written = &graph->resources[resource];
+    if (written->imported) {
+        fprintf(stderr, "[%s] - Imported resource '%s' is read only in glapi_GraphPassWrite\n", _FL, written->name);
+        return false;
+    }
+    if (glapi_RenderTargetAttachment(written->format) != GL_COLOR_ATTACHMENT0) {
+        if (target->depth != FRAME_GRAPH_INVALID) {
+            fprintf(stderr, "[%s] - Pass '%s' already writes depth in glapi_GraphPassWrite\n", _FL, target->name);
+            return false;
+        }
+        target->depth = resource;
+    } else {
+        if (target->write_count >= RENDER_TARGET_MAX_COLOR) {
+            fprintf(stderr, "[%s] - Too many writes for pass '%s' in glapi_GraphPassWrite\n", _FL, target->name);
+            return false;
+        }
+        target->writes[target->write_count++] = resource;
+    }
+    graph->compiled = false;
+    return true;
+}
+
+bool glapi_CompileFrameGraph(gl_frame_graph* graph) {
+    graph_release_targets(graph);
+    memset(&graph->stats, 0, sizeof(gl_frame_graph_stats));
+    size_t count = graph->pass_count;
+    if (!count) {
+        graph->order_count = 0;
+        graph->compiled = true;
+        return true;
+    }
+
+    uint32_t* order = (uint32_t*)realloc(graph->order, count * sizeof(uint32_t));
+    unsigned char* edges = (unsigned char*)malloc(count * count);
+    if (!order || !edges) {
+        fprintf(stderr, "[%s] - Failure to allocate pass order in glapi_CompileFrameGraph\n", _FL);
+        if (order)
+            graph->order = order;
+        free(edges);
+        return false;
+    }
+    graph->order = order;
+    if (!graph_order(graph, edges)) {
+        free(edges);
+        return false;
+    }
+    graph_cull(graph, edges);
+    free(edges);
+
+    size_t alive = 0;
+    for (size_t i = 0; i < graph->order_count; i++)
+        if (!graph->passes[graph->order[i]].culled)
+            graph->order[alive++] = graph->order[i];
+    graph->stats.passes = alive;
+    graph->stats.culled = graph->order_count - alive;
+    graph->order_count = alive;
+
+    for (size_t r = 0; r < graph->resource_count; r++) {
+        gl_graph_resource* resource = &graph->resources[r];
+        resource->first = FRAME_GRAPH_INVALID;
+        resource->last = 0;
+        resource->physical = FRAME_GRAPH_INVALID;
+        if (!resource->imported) {
+            resource->width = graph_extent(graph->width, resource->scale);
+            resource->height = graph_extent(graph->height, resource->scale);
+        }
+    }
+    for (uint32_t i = 0; i < graph->order_count; i++) {
+        gl_graph_pass* pass = &graph->passes[graph->order[i]];
+        uint32_t used[FRAME_GRAPH_MAX_READS + RENDER_TARGET_MAX_COLOR + 1];
+        GLuint used_count = 0;
+        for (GLuint r = 0; r < pass->read_count; r++)
+            used[used_count++] = pass->reads[r];
+        for (GLuint w = 0; w < pass->write_count; w++)
+            used[used_count++] = pass->writes[w];
+        if (pass->depth != FRAME_GRAPH_INVALID)
+            used[used_count++] = pass->depth;
+        for (GLuint u = 0; u < used_count; u++) {
+            gl_graph_resource* resource = &graph->resources[used[u]];
+            if (resource->first == FRAME_GRAPH_INVALID)
+                resource->first = i;
+            resource->last = i;
+        }
+    }
+
+    for (size_t i = 0; i < graph->pool_count; i++)
+        graph->pool[i].used = false;
+    for (uint32_t i = 0; i < graph->order_count; i++) {
+        for (size_t r = 0; r < graph->resource_count; r++) {
+            gl_graph_resource* resource = &graph->resources[r];
+            if (resource->imported || resource->first != i)
+                continue;
+            if (resource->exported)
+                resource->last = FRAME_GRAPH_INVALID - 1;
+            resource->physical = graph_acquire_texture(graph, resource);
+            if (resource->physical == FRAME_GRAPH_INVALID)
+                return false;
+            graph->stats.resources++;
+            graph->stats.unaliased_bytes += (size_t)resource->width * resource->height * graph_texel_size(resource->format);
+        }
+    }
+
+    size_t kept = 0;
+    for (size_t i = 0; i < graph->pool_count; i++) {
+        if (!graph->pool[i].used) {
+            glDeleteTextures(1, &graph->pool[i].texture);
+            continue;
+        }
+        for (size_t r = 0; r < graph->resource_count; r++)
+            if (graph->resources[r].physical == i)
+                graph->resources[r].physical = (uint32_t)kept;
+        graph->pool[kept++] = graph->pool[i];
+    }
+    graph->pool_count = kept;
+    for (size_t i = 0; i < graph->pool_count; i++)
+        graph->stats.bytes += (size_t)graph->pool[i].width * graph->pool[i].height * graph_texel_size(graph->pool[i].format);
+    graph->stats.textures = graph->pool_count;
+
+    for (uint32_t i = 0; i < graph->order_count; i++) {
+        if (!graph_build_framebuffer(graph, &graph->passes[graph->order[i]])) {
+            graph_release_targets(graph);
+            return false;
+        }
+    }
+    check_gl_error("glapi_CompileFrameGraph");
+    graph->compiled = true;
+    return true;
+}
+
+bool glapi_ExecuteFrameGraph(gl_frame_graph* graph) {
+    if (!graph->compiled && !glapi_CompileFrameGraph(graph))
+        return false;
+
+
+    glapi_BeginCpuZone("glapi_ExecuteFrameGraph");
+    bool result = true;
+    for (size_t i = 0; i < graph->order_count && result; i++) {
+        uint32_t index = graph->order[i];
+        gl_graph_pass* pass = &graph->passes[index];
+        glBindFramebuffer(GL_FRAMEBUFFER, pass->framebuffer ? pass->framebuffer : glapi_DefaultFramebuffer());
+        if (pass->width && pass->height)
+            glViewport(0, 0, pass->width, pass->height);
+        glapi_BeginCpuZone(pass->name);
+        if (graph->profiler)
+            glapi_BeginGpuScope(graph->profiler, pass->name);
+        if (pass->execute)
+            result = pass->execute(graph, index, pass->user);
+        if (graph->profiler)
+            glapi_EndGpuScope(graph->profiler);
+        glapi_EndCpuZone();
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, glapi_DefaultFramebuffer());
+    glViewport(0, 0, graph->width, graph->height);
+    glapi_EndCpuZone();
+    return result;
+}
+
+gl_texture glapi_GraphResourceTexture(gl_frame_graph* graph, uint32_t resource) {
+    if (resource >= graph->resource_count)
+        return 0;
+    gl_graph_resource* entry = &graph->resources[resource];
+    if (entry->imported)
+        return entry->imported;
+    if (entry->physical == FRAME_GRAPH_INVALID || entry->physical >= graph->pool_count)
+        return 0;
+    return graph->pool[entry->physical].texture;
+}
+
+void glapi_ResizeFrameGraph(gl_frame_graph* graph, GLsizei width, GLsizei height) {
+    width = width > 0 ? width : 1;
+    height = height > 0 ? height : 1;
+    if (width == graph->width && height == graph->height)
+        return;
+    graph_release_targets(graph);
+    graph_release_pool(graph);
+    graph->width = width;
+    graph->height = height;
+}
+
+void glapi_ResetFrameGraph(gl_frame_graph* graph) {
+    graph_release_targets(graph);
+    for (size_t i = 0; i < graph->pass_count; i++) {
+        if (graph->release && graph->passes[i].user)
+            graph->release(graph->passes[i].user);
+    }
+    for (size_t i = 0; i < graph->resource_count; i++)
+        free(graph->resources[i].name);
+    graph->pass_count = 0;
+    graph->resource_count = 0;
+    graph->order_count = 0;
+}
+
+void glapi_DestroyFrameGraph(gl_frame_graph* graph) {
+    glapi_ResetFrameGraph(graph);
+    graph_release_pool(graph);
+    free(graph->resources);
+    free(graph->passes);
+    free(graph->order);
+    free(graph->pool);
+    free(graph);
+}
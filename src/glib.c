@@ -25,6 +25,15 @@ static PyObject* glib_bind_app(PyObject* self, PyObject* args);
 static PyObject* glib_unbind_app(PyObject* self, PyObject* args);
 static PyObject* glib_destroy_app(PyObject* self, PyObject* args);
 static PyObject* glib_should_app_close(PyObject* self, PyObject* args);
+static PyObject* glib_request_app_close(PyObject* self, PyObject* args);
+static PyObject* glib_set_swap_interval(PyObject* self, PyObject* args);
+static PyObject* glib_get_swap_interval(PyObject* self, PyObject* args);
+static PyObject* glib_set_frame_cap(PyObject* self, PyObject* args);
+static PyObject* glib_frame_stats(PyObject* self, PyObject* args);
+static PyObject* glib_reset_frame_stats(PyObject* self, PyObject* args);
+static PyObject* glib_set_max_frames_in_flight(PyObject* self, PyObject* args);
+static PyObject* glib_set_late_latch(PyObject* self, PyObject* args);
+static PyObject* glib_latch_frame(PyObject* self, PyObject* args);
 static PyObject* glib_bind_vertex_buffer_object(PyObject* self, PyObject* args);
 static PyObject* glib_unbind_vertex_buffer_object(PyObject* self, PyObject* args);
 static PyObject* glib_bind_shader(PyObject* self, PyObject* args);
@@ -34,9 +43,103 @@ static PyObject* glib_unbind_frame_buffer_object(PyObject* self, PyObject* args)
 static PyObject* glib_draw_vertex_buffer_object(PyObject* self, PyObject* args);
 static PyObject* glib_gen_shader_program_f(PyObject* self, PyObject* args);
 static PyObject* glib_gen_shader_program_s(PyObject* self, PyObject* args);
+static PyObject* glib_acquire_shader_program_f(PyObject* self, PyObject* args);
+static PyObject* glib_acquire_shader_program_s(PyObject* self, PyObject* args);
+static PyObject* glib_preprocess_shader(PyObject* self, PyObject* args);
+static PyObject* glib_release_shader_program(PyObject* self, PyObject* args);
+static PyObject* glib_release_texture(PyObject* self, PyObject* args);
+static PyObject* glib_asset_cache_stats(PyObject* self, PyObject* args);
+static PyObject* glib_build_shader_programs(PyObject* self, PyObject* args);
+static PyObject* glib_set_program_cache_dir(PyObject* self, PyObject* args);
+static PyObject* glib_program_cache_stats(PyObject* self, PyObject* args);
 static PyObject* glib_gen_vertex_buffer_object(PyObject* self, PyObject* args);
 static PyObject* glib_gen_frame_buffer_object(PyObject* self, PyObject* args);
+static PyObject* glib_gen_render_target(PyObject* self, PyObject* args);
+static PyObject* glib_bind_render_target(PyObject* self, PyObject* args);
+static PyObject* glib_unbind_render_target(PyObject* self, PyObject* args);
+static PyObject* glib_resolve_render_target(PyObject* self, PyObject* args);
+static PyObject* glib_blit_render_target(PyObject* self, PyObject* args);
+static PyObject* glib_render_target_textures(PyObject* self, PyObject* args);
+static PyObject* glib_gen_readback(PyObject* self, PyObject* args);
+static PyObject* glib_readback_framebuffer(PyObject* self, PyObject* args);
+static PyObject* glib_map_readback(PyObject* self, PyObject* args);
+static PyObject* glib_readback_stats(PyObject* self, PyObject* args);
+static PyObject* glib_gen_batch_renderer(PyObject* self, PyObject* args);
+static PyObject* glib_batch_renderer_uniform(PyObject* self, PyObject* args);
+static PyObject* glib_batch_renderer_outputs(PyObject* self, PyObject* args);
+static PyObject* glib_batch_render(PyObject* self, PyObject* args);
+static PyObject* glib_batch_renderer_stats(PyObject* self, PyObject* args);
+static PyObject* glib_gen_frame_graph(PyObject* self, PyObject* args);
+static PyObject* glib_frame_graph_resource(PyObject* self, PyObject* args);
+static PyObject* glib_frame_graph_import(PyObject* self, PyObject* args);
+static PyObject* glib_frame_graph_export(PyObject* self, PyObject* args);
+static PyObject* glib_frame_graph_pass(PyObject* self, PyObject* args);
+static PyObject* glib_compile_frame_graph(PyObject* self, PyObject* args);
+static PyObject* glib_execute_frame_graph(PyObject* self, PyObject* args);
+static PyObject* glib_frame_graph_texture(PyObject* self, PyObject* args);
+static PyObject* glib_resize_frame_graph(PyObject* self, PyObject* args);
+static PyObject* glib_reset_frame_graph(PyObject* self, PyObject* args);
+static PyObject* glib_set_frame_graph_profiler(PyObject* self, PyObject* args);
+static PyObject* glib_gen_gpu_profiler(PyObject* self, PyObject* args);
+static PyObject* glib_begin_gpu_frame(PyObject* self, PyObject* args);
+static PyObject* glib_end_gpu_frame(PyObject* self, PyObject* args);
+static PyObject* glib_begin_gpu_scope(PyObject* self, PyObject* args);
+static PyObject* glib_end_gpu_scope(PyObject* self, PyObject* args);
+static PyObject* glib_gpu_profiler_report(PyObject* self, PyObject* args);
+static PyObject* glib_profiler_enable(PyObject* self, PyObject* args);
+static PyObject* glib_profiler_begin(PyObject* self, PyObject* args);
+static PyObject* glib_profiler_end(PyObject* self, PyObject* args);
+static PyObject* glib_profiler_name_thread(PyObject* self, PyObject* args);
+static PyObject* glib_profiler_reset(PyObject* self, PyObject* args);
+static PyObject* glib_profiler_dump(PyObject* self, PyObject* args);
 static PyObject* glib_gen_texture_from_fpath(PyObject* self, PyObject* args);
+static PyObject* glib_gen_texture(PyObject* self, PyObject* args);
+static PyObject* glib_get_sampler(PyObject* self, PyObject* args);
+static PyObject* glib_gen_compressed_texture_from_fpath(PyObject* self, PyObject* args);
+static PyObject* glib_gen_texture_from_fpath_compressed(PyObject* self, PyObject* args);
+static PyObject* glib_gen_texture_array(PyObject* self, PyObject* args);
+static PyObject* glib_gen_texture_atlas(PyObject* self, PyObject* args);
+static PyObject* glib_texture_atlas_info(PyObject* self, PyObject* args);
+static PyObject* glib_push_texture_atlas_to_shader(PyObject* self, PyObject* args);
+static PyObject* glib_gen_texture_loader(PyObject* self, PyObject* args);
+static PyObject* glib_load_texture_async(PyObject* self, PyObject* args);
+static PyObject* glib_texture_loader_texture(PyObject* self, PyObject* args);
+static PyObject* glib_texture_loader_status(PyObject* self, PyObject* args);
+static PyObject* glib_pump_texture_loader(PyObject* self, PyObject* args);
+static PyObject* glib_finish_texture_loader(PyObject* self, PyObject* args);
+static PyObject* glib_gen_mesh_arena(PyObject* self, PyObject* args);
+static PyObject* glib_gen_arena_mesh(PyObject* self, PyObject* args);
+static PyObject* glib_free_arena_mesh(PyObject* self, PyObject* args);
+static PyObject* glib_defrag_mesh_arena(PyObject* self, PyObject* args);
+static PyObject* glib_bind_mesh_arena(PyObject* self, PyObject* args);
+static PyObject* glib_draw_arena_mesh(PyObject* self, PyObject* args);
+static PyObject* glib_gen_instance_buffer(PyObject* self, PyObject* args);
+static PyObject* glib_attach_instance_buffer(PyObject* self, PyObject* args);
+static PyObject* glib_update_instance_buffer(PyObject* self, PyObject* args);
+static PyObject* glib_update_instance_buffer_trs(PyObject* self, PyObject* args);
+static PyObject* glib_draw_vertex_buffer_object_instanced(PyObject* self, PyObject* args);
+static PyObject* glib_draw_arena_mesh_instanced(PyObject* self, PyObject* args);
+static PyObject* glib_gen_draw_batch(PyObject* self, PyObject* args);
+static PyObject* glib_append_draw_batch(PyObject* self, PyObject* args);
+static PyObject* glib_clear_draw_batch(PyObject* self, PyObject* args);
+static PyObject* glib_draw_batch(PyObject* self, PyObject* args);
+static PyObject* glib_push_draw_batch_to_shader(PyObject* self, PyObject* args);
+static PyObject* glib_gen_dynamic_mesh(PyObject* self, PyObject* args);
+static PyObject* glib_update_dynamic_mesh_vertices(PyObject* self, PyObject* args);
+static PyObject* glib_update_dynamic_mesh_indices(PyObject* self, PyObject* args);
+static PyObject* glib_set_dynamic_mesh_counts(PyObject* self, PyObject* args);
+static PyObject* glib_commit_dynamic_mesh(PyObject* self, PyObject* args);
+static PyObject* glib_draw_dynamic_mesh(PyObject* self, PyObject* args);
+static PyObject* glib_gen_mesh_buffer(PyObject* self, PyObject* args);
+static PyObject* glib_draw_mesh_buffer(PyObject* self, PyObject* args);
+static PyObject* glib_mesh_buffer_stats(PyObject* self, PyObject* args);
+static PyObject* glib_select_mesh_lod(PyObject* self, PyObject* args);
+static PyObject* glib_gen_render_queue(PyObject* self, PyObject* args);
+static PyObject* glib_append_render_queue(PyObject* self, PyObject* args);
+static PyObject* glib_push_render_queue_uniform(PyObject* self, PyObject* args);
+static PyObject* glib_clear_render_queue(PyObject* self, PyObject* args);
+static PyObject* glib_submit_render_queue(PyObject* self, PyObject* args);
+static PyObject* glib_render_queue_stats(PyObject* self, PyObject* args);
 static PyObject* glib_push_int_to_shader(PyObject* self, PyObject* args);
 static PyObject* glib_push_float_to_shader(PyObject* self, PyObject* args);
 static PyObject* glib_push_vec2_to_shader(PyObject* self, PyObject* args);
@@ -232,6 +335,136 @@ static PyObject* glib_projection_matrix4x4(PyObject* self, PyObject* args) {
     return float_array_to_list(result, 16);
 }
 
+static int buffer_to_rows(PyObject* obj, Py_buffer* view, char type, Py_ssize_t row_len, Py_ssize_t* rows) {
+    if (PyObject_GetBuffer(obj, view, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT) < 0) {
+        return 0;
+    }
+    const char* format = view->format ? view->format : "B";
+    if (*format == '<' || *format == '=') {
+        format++;
+    }
+    if (view->itemsize != 4 || format[0] != type || format[1]) {
+        PyBuffer_Release(view);
+        PyErr_SetString(PyExc_TypeError, type == 'f' ? "Expected a float32 buffer" : "Expected a uint32 buffer");
+        return 0;
+    }
+    if ((view->ndim == 2 && view->shape[1] != row_len) || (view->len / view->itemsize) % row_len != 0) {
+        PyBuffer_Release(view);
+        PyErr_Format(PyExc_ValueError, "Expected a buffer of shape (N, %zd)", row_len);
+        return 0;
+    }
+    *rows = (view->len / view->itemsize) / row_len;
+    return 1;
+}
+
+static int buffer_to_float_rows(PyObject* obj, Py_buffer* view, Py_ssize_t row_len, Py_ssize_t* rows) {
+    return buffer_to_rows(obj, view, 'f', row_len, rows);
+}
+
+static void free_mesh_arrays(gl_mesh* mesh) {
+    free(mesh->positions);
+    free(mesh->indices);
+    free(mesh->uvs);
+    free(mesh->normals);
+}
+
+static int sequences_to_mesh(PyObject* positions, PyObject* indices, PyObject* uvs, PyObject* normals, gl_mesh* mesh) {
+    if (!PySequence_Check(positions) || !PySequence_Check(indices) ||
+        (uvs && uvs != Py_None && !PySequence_Check(uvs)) ||
+        (normals && normals != Py_None && !PySequence_Check(normals))) {
+        PyErr_SetString(PyExc_TypeError, "Inputs must be sequences");
+        return 0;
+    }
+
+    Py_ssize_t pos_len = PySequence_Length(positions);
+    Py_ssize_t idx_len = PySequence_Length(indices);
+    Py_ssize_t uvs_len = (uvs && uvs != Py_None) ? PySequence_Length(uvs) : 0;
+    Py_ssize_t norm_len = (normals && normals != Py_None) ? PySequence_Length(normals) : 0;
+
+    if (pos_len % 3 != 0) {
+        PyErr_SetString(PyExc_ValueError, "Positions sequence size must be a multiple of 3");
+        return 0;
+    }
+    if (idx_len % 3 != 0) {
+        PyErr_SetString(PyExc_ValueError, "Indices sequence size must be a multiple of 3");
+        return 0;
+    }
+    if (uvs_len > 0 && uvs_len % 2 != 0) {
+        PyErr_SetString(PyExc_ValueError, "UVs sequence size must be a multiple of 2");
+        return 0;
+    }
+    if (norm_len > 0 && norm_len % 3 != 0) {
+        PyErr_SetString(PyExc_ValueError, "Normals sequence size must be a multiple of 3");
+        return 0;
+    }
+
+    memset(mesh, 0, sizeof(gl_mesh));
+    mesh->positions = (float*)malloc(pos_len * sizeof(float));
+    mesh->indices = (GLuint*)malloc(idx_len * sizeof(GLuint));
+    mesh->uvs = uvs_len > 0 ? (float*)malloc(uvs_len * sizeof(float)) : NULL;
+    mesh->normals = norm_len > 0 ? (float*)malloc(norm_len * sizeof(float)) : NULL;
+
+    if (!mesh->positions || !mesh->indices || (uvs_len > 0 && !mesh->uvs) || (norm_len > 0 && !mesh->normals)) {
+        free_mesh_arrays(mesh);
+        PyErr_SetString(PyExc_MemoryError, "Failed to allocate memory");
+        return 0;
+    }
+
+    for (Py_ssize_t i = 0; i < pos_len; i++) {
+        PyObject* item = PySequence_GetItem(positions, i);
+        if (!PyFloat_Check(item)) {
+            free_mesh_arrays(mesh);
+            PyErr_SetString(PyExc_TypeError, "Positions must contain floats");
+            Py_DECREF(item);
+            return 0;
+        }
+        mesh->positions[i] = (float)PyFloat_AsDouble(item);
+        Py_DECREF(item);
+    }
+
+    for (Py_ssize_t i = 0; i < idx_len; i++) {
+        PyObject* item = PySequence_GetItem(indices, i);
+        if (!PyLong_Check(item)) {
+            free_mesh_arrays(mesh);
+            PyErr_SetString(PyExc_TypeError, "Indices must contain integers");
+            Py_DECREF(item);
+            return 0;
+        }
+        mesh->indices[i] = (GLuint)PyLong_AsUnsignedLong(item);
+        Py_DECREF(item);
+    }
+
+    for (Py_ssize_t i = 0; i < uvs_len; i++) {
+        PyObject* item = PySequence_GetItem(uvs, i);
+        if (!PyFloat_Check(item)) {
+            free_mesh_arrays(mesh);
+            PyErr_SetString(PyExc_TypeError, "UVs must contain floats");
+            Py_DECREF(item);
+            return 0;
+        }
+        mesh->uvs[i] = (float)PyFloat_AsDouble(item);
+        Py_DECREF(item);
+    }
+
+    for (Py_ssize_t i = 0; i < norm_len; i++) {
+        PyObject* item = PySequence_GetItem(normals, i);
+        if (!PyFloat_Check(item)) {
+            free_mesh_arrays(mesh);
+            PyErr_SetString(PyExc_TypeError, "Normals must contain floats");
+            Py_DECREF(item);
+            return 0;
+        }
+        mesh->normals[i] = (float)PyFloat_AsDouble(item);
+        Py_DECREF(item);
+    }
+
+    mesh->positions_size = pos_len * sizeof(float);
+    mesh->indices_size = idx_len * sizeof(GLuint);
+    mesh->uvs_size = uvs_len * sizeof(float);
+    mesh->normals_size = norm_len * sizeof(float);
+    return 1;
+}
+
 static PyObject* glib_gen_vertex_buffer_object(PyObject* self, PyObject* args) {
     PyObject *app_capsule, *positions, *indices, *uvs = NULL, *normals = NULL;
 
@@ -246,145 +479,2817 @@ static PyObject* glib_gen_vertex_buffer_object(PyObject* self, PyObject* args) {
         return NULL;
     }
 
-    if (!PySequence_Check(positions) || !PySequence_Check(indices) ||
-        (uvs && uvs != Py_None && !PySequence_Check(uvs)) ||
-        (normals && normals != Py_None && !PySequence_Check(normals))) {
-        PyErr_SetString(PyExc_TypeError, "Inputs must be sequences");
+    gl_mesh mesh;
+    if (!sequences_to_mesh(positions, indices, uvs, normals, &mesh)) {
         return NULL;
     }
 
-    Py_ssize_t pos_len = PySequence_Length(positions);
-    Py_ssize_t idx_len = PySequence_Length(indices);
-    Py_ssize_t uvs_len = (uvs && uvs != Py_None) ? PySequence_Length(uvs) : 0;
-    Py_ssize_t norm_len = (normals && normals != Py_None) ? PySequence_Length(normals) : 0;
+    GLuint vao_address;
+    GLuint vao = glapi_GenVertexBufferObjectFromMesh(app, &mesh, &vao_address);
+    free_mesh_arrays(&mesh);
+
+    if (!vao) {
+        PyErr_SetString(PyExc_RuntimeError, "Failed to generate vertex buffer object");
+        return NULL;
+    }
+
+    return PyLong_FromUnsignedLong(vao);
+}
+
+static gl_mesh_arena* capsule_to_arena(PyObject* arena_capsule) {
+    gl_mesh_arena* arena = (gl_mesh_arena*)PyCapsule_GetPointer(arena_capsule, "gl_mesh_arena");
+    if (!arena) {
+        PyErr_SetString(PyExc_ValueError, "Invalid gl_mesh_arena pointer");
+        return NULL;
+    }
+    return arena;
+}
+
+static PyObject* glib_gen_mesh_arena(PyObject* self, PyObject* args) {
+    PyObject* app_capsule;
+    unsigned int layout, vertex_capacity, index_capacity;
+
+    if (!PyArg_ParseTuple(args, "OIII", &app_capsule, &layout, &vertex_capacity, &index_capacity)) {
+        PyErr_SetString(PyExc_TypeError, "Expected app, layout, vertex_capacity, index_capacity");
+        return NULL;
+    }
+
+    gl_app* app = (gl_app*)PyCapsule_GetPointer(app_capsule, "gl_app");
+    if (!app) {
+        PyErr_SetString(PyExc_ValueError, "Invalid gl_app pointer");
+        return NULL;
+    }
+
+    gl_mesh_arena* arena = glapi_GenMeshArena(app, layout, vertex_capacity, index_capacity);
+    if (!arena) {
+        PyErr_SetString(PyExc_RuntimeError, "Failed to generate mesh arena");
+        return NULL;
+    }
+
+    return PyCapsule_New(arena, "gl_mesh_arena", NULL);
+}
+
+static PyObject* glib_gen_arena_mesh(PyObject* self, PyObject* args) {
+    PyObject *arena_capsule, *positions, *indices, *uvs = NULL, *normals = NULL;
+
+    if (!PyArg_ParseTuple(args, "OOO|OO", &arena_capsule, &positions, &indices, &uvs, &normals)) {
+        PyErr_SetString(PyExc_TypeError, "Expected arena, positions, indices, [uvs, normals]");
+        return NULL;
+    }
+
+    gl_mesh_arena* arena = capsule_to_arena(arena_capsule);
+    if (!arena) {
+        return NULL;
+    }
+
+    gl_mesh mesh;
+    if (!sequences_to_mesh(positions, indices, uvs, normals, &mesh)) {
+        return NULL;
+    }
+
+    GLuint handle = glapi_GenVertexBufferObjectFromMeshInArena(arena, &mesh);
+    free_mesh_arrays(&mesh);
+
+    if (handle == ARENA_INVALID_MESH) {
+        PyErr_SetString(PyExc_RuntimeError, "Failed to allocate mesh in arena");
+        return NULL;
+    }
+
+    return PyLong_FromUnsignedLong(handle);
+}
+
+static PyObject* glib_free_arena_mesh(PyObject* self, PyObject* args) {
+    PyObject* arena_capsule;
+    GLuint handle;
+    if (!PyArg_ParseTuple(args, "OI", &arena_capsule, &handle)) {
+        return NULL;
+    }
+
+    gl_mesh_arena* arena = capsule_to_arena(arena_capsule);
+    if (!arena) {
+        return NULL;
+    }
+
+    return PyBool_FromLong(glapi_FreeArenaMesh(arena, handle));
+}
+
+static PyObject* glib_defrag_mesh_arena(PyObject* self, PyObject* args) {
+    PyObject* arena_capsule;
+    if (!PyArg_ParseTuple(args, "O", &arena_capsule)) {
+        return NULL;
+    }
+
+    gl_mesh_arena* arena = capsule_to_arena(arena_capsule);
+    if (!arena) {
+        return NULL;
+    }
+
+    if (!glapi_DefragMeshArena(arena)) {
+        PyErr_SetString(PyExc_RuntimeError, "Failed to defragment mesh arena");
+        return NULL;
+    }
+    Py_RETURN_NONE;
+}
+
+static PyObject* glib_bind_mesh_arena(PyObject* self, PyObject* args) {
+    PyObject* arena_capsule;
+    if (!PyArg_ParseTuple(args, "O", &arena_capsule)) {
+        return NULL;
+    }
+
+    gl_mesh_arena* arena = capsule_to_arena(arena_capsule);
+    if (!arena) {
+        return NULL;
+    }
+
+    glapi_BindMeshArena(arena);
+    Py_RETURN_NONE;
+}
+
+static PyObject* glib_draw_arena_mesh(PyObject* self, PyObject* args) {
+    PyObject* arena_capsule;
+    GLuint handle;
+    if (!PyArg_ParseTuple(args, "OI", &arena_capsule, &handle)) {
+        return NULL;
+    }
+
+    gl_mesh_arena* arena = capsule_to_arena(arena_capsule);
+    if (!arena) {
+        return NULL;
+    }
+
+    glapi_DrawArenaMesh(arena, handle);
+    Py_RETURN_NONE;
+}
+
+static PyObject* glib_gen_instance_buffer(PyObject* self, PyObject* args) {
+    PyObject* app_capsule;
+    unsigned int layout, capacity;
+
+    if (!PyArg_ParseTuple(args, "OII", &app_capsule, &layout, &capacity)) {
+        PyErr_SetString(PyExc_TypeError, "Expected app, layout, capacity");
+        return NULL;
+    }
+
+    gl_app* app = (gl_app*)PyCapsule_GetPointer(app_capsule, "gl_app");
+    if (!app) {
+        PyErr_SetString(PyExc_ValueError, "Invalid gl_app pointer");
+        return NULL;
+    }
+
+    gl_instance_buffer* instances = glapi_GenInstanceBuffer(app, layout, capacity);
+    if (!instances) {
+        PyErr_SetString(PyExc_RuntimeError, "Failed to generate instance buffer");
+        return NULL;
+    }
+
+    return PyCapsule_New(instances, "gl_instance_buffer", NULL);
+}
+
+static PyObject* glib_attach_instance_buffer(PyObject* self, PyObject* args) {
+    PyObject *instances_capsule, *vao_obj;
+    if (!PyArg_ParseTuple(args, "OO", &instances_capsule, &vao_obj)) {
+        return NULL;
+    }
+
+    gl_instance_buffer* instances = (gl_instance_buffer*)PyCapsule_GetPointer(instances_capsule, "gl_instance_buffer");
+    if (!instances) {
+        PyErr_SetString(PyExc_ValueError, "Invalid gl_instance_buffer pointer");
+        return NULL;
+    }
+
+    gl_vao vao;
+    if (PyCapsule_CheckExact(vao_obj)) {
+        gl_mesh_arena* arena = capsule_to_arena(vao_obj);
+        if (!arena) {
+            return NULL;
+        }
+        vao = arena->vao;
+    } else {
+        vao = (gl_vao)PyLong_AsUnsignedLong(vao_obj);
+        if (PyErr_Occurred()) {
+            return NULL;
+        }
+    }
+
+    if (!glapi_AttachInstanceBuffer(instances, vao)) {
+        PyErr_SetString(PyExc_MemoryError, "Failed to attach instance buffer");
+        return NULL;
+    }
+    Py_RETURN_NONE;
+}
+
+static PyObject* update_instance_buffer(PyObject* args, Py_ssize_t row_len) {
+    PyObject *instances_capsule, *rows_obj, *colors_obj = NULL;
+    if (!PyArg_ParseTuple(args, "OO|O", &instances_capsule, &rows_obj, &colors_obj)) {
+        return NULL;
+    }
+
+    gl_instance_buffer* instances = (gl_instance_buffer*)PyCapsule_GetPointer(instances_capsule, "gl_instance_buffer");
+    if (!instances) {
+        PyErr_SetString(PyExc_ValueError, "Invalid gl_instance_buffer pointer");
+        return NULL;
+    }
+
+    Py_buffer rows_view, colors_view;
+    Py_ssize_t rows, colors = 0;
+    if (!buffer_to_float_rows(rows_obj, &rows_view, row_len, &rows)) {
+        return NULL;
+    }
+    bool has_colors = colors_obj && colors_obj != Py_None;
+    if (has_colors) {
+        if (!buffer_to_float_rows(colors_obj, &colors_view, 4, &colors)) {
+            PyBuffer_Release(&rows_view);
+            return NULL;
+        }
+        if (colors != rows) {
+            PyBuffer_Release(&rows_view);
+            PyBuffer_Release(&colors_view);
+            PyErr_SetString(PyExc_ValueError, "Colors must have one row per instance");
+            return NULL;
+        }
+    }
+
+    const GLfloat* color_data = has_colors ? (const GLfloat*)colors_view.buf : NULL;
+    bool updated = false;
+    if ((size_t)rows > UINT32_MAX) {
+        PyErr_SetString(PyExc_ValueError, "Too many instances for one instance buffer");
+    } else if (row_len == 16) {
+        updated = glapi_UpdateInstanceBuffer(instances, (const GLfloat*)rows_view.buf, color_data, (GLuint)rows);
+    } else {
+        updated = glapi_UpdateInstanceBufferTRS(instances, (const GLfloat*)rows_view.buf, color_data, (GLuint)rows);
+    }
+
+    PyBuffer_Release(&rows_view);
+    if (has_colors) {
+        PyBuffer_Release(&colors_view);
+    }
+    if (!updated) {
+        if (!PyErr_Occurred()) {
+            PyErr_SetString(PyExc_RuntimeError, "Failed to update instance buffer");
+        }
+        return NULL;
+    }
+    Py_RETURN_NONE;
+}
+
+static PyObject* glib_update_instance_buffer(PyObject* self, PyObject* args) {
+    return update_instance_buffer(args, 16);
+}
+
+static PyObject* glib_update_instance_buffer_trs(PyObject* self, PyObject* args) {
+    return update_instance_buffer(args, 9);
+}
+
+static PyObject* glib_draw_vertex_buffer_object_instanced(PyObject* self, PyObject* args) {
+    Py_ssize_t index_count;
+    GLuint instance_count;
+    if (!PyArg_ParseTuple(args, "nI", &index_count, &instance_count)) {
+        return NULL;
+    }
+
+    glapi_DrawVertexBufferObjectInstanced((size_t)index_count, instance_count);
+    Py_RETURN_NONE;
+}
+
+static PyObject* glib_draw_arena_mesh_instanced(PyObject* self, PyObject* args) {
+    PyObject* arena_capsule;
+    GLuint handle, instance_count;
+    if (!PyArg_ParseTuple(args, "OII", &arena_capsule, &handle, &instance_count)) {
+        return NULL;
+    }
+
+    gl_mesh_arena* arena = capsule_to_arena(arena_capsule);
+    if (!arena) {
+        return NULL;
+    }
+
+    glapi_DrawArenaMeshInstanced(arena, handle, instance_count);
+    Py_RETURN_NONE;
+}
+
+static gl_draw_batch* capsule_to_draw_batch(PyObject* batch_capsule) {
+    gl_draw_batch* batch = (gl_draw_batch*)PyCapsule_GetPointer(batch_capsule, "gl_draw_batch");
+    if (!batch) {
+        PyErr_SetString(PyExc_ValueError, "Invalid gl_draw_batch pointer");
+        return NULL;
+    }
+    return batch;
+}
+
+static PyObject* glib_gen_draw_batch(PyObject* self, PyObject* args) {
+    PyObject *app_capsule, *arena_capsule;
+    unsigned int draw_data_vec4s = 0;
+
+    if (!PyArg_ParseTuple(args, "OO|I", &app_capsule, &arena_capsule, &draw_data_vec4s)) {
+        PyErr_SetString(PyExc_TypeError, "Expected app, arena, [draw_data_vec4s]");
+        return NULL;
+    }
+
+    gl_app* app = (gl_app*)PyCapsule_GetPointer(app_capsule, "gl_app");
+    if (!app) {
+        PyErr_SetString(PyExc_ValueError, "Invalid gl_app pointer");
+        return NULL;
+    }
+
+    gl_mesh_arena* arena = capsule_to_arena(arena_capsule);
+    if (!arena) {
+        return NULL;
+    }
+
+    gl_draw_batch* batch = glapi_GenDrawBatch(app, arena, draw_data_vec4s);
+    if (!batch) {
+        PyErr_SetString(PyExc_RuntimeError, "Failed to generate draw batch");
+        return NULL;
+    }
+
+    return PyCapsule_New(batch, "gl_draw_batch", NULL);
+}
+
+static PyObject* glib_append_draw_batch(PyObject* self, PyObject* args) {
+    PyObject *batch_capsule, *data_obj = NULL;
+    GLuint handle;
+
+    if (!PyArg_ParseTuple(args, "OI|O", &batch_capsule, &handle, &data_obj)) {
+        return NULL;
+    }
+
+    gl_draw_batch* batch = capsule_to_draw_batch(batch_capsule);
+    if (!batch) {
+        return NULL;
+    }
+
+    if (!data_obj || data_obj == Py_None || !batch->draw_data_vec4s) {
+        glapi_AppendDrawBatch(batch, handle, NULL);
+        Py_RETURN_NONE;
+    }
+
+    Py_ssize_t floats = (Py_ssize_t)batch->draw_data_vec4s * 4;
+    float* data = (float*)malloc(floats * sizeof(float));
+    if (!data) {
+        PyErr_SetString(PyExc_MemoryError, "Failed to allocate memory");
+        return NULL;
+    }
+    if (!sequence_to_float_array(data_obj, data, floats)) {
+        free(data);
+        return NULL;
+    }
+
+    glapi_AppendDrawBatch(batch, handle, data);
+    free(data);
+    Py_RETURN_NONE;
+}
+
+static PyObject* glib_clear_draw_batch(PyObject* self, PyObject* args) {
+    PyObject* batch_capsule;
+    if (!PyArg_ParseTuple(args, "O", &batch_capsule)) {
+        return NULL;
+    }
+
+    gl_draw_batch* batch = capsule_to_draw_batch(batch_capsule);
+    if (!batch) {
+        return NULL;
+    }
+
+    glapi_ClearDrawBatch(batch);
+    Py_RETURN_NONE;
+}
+
+static PyObject* glib_draw_batch(PyObject* self, PyObject* args) {
+    PyObject* batch_capsule;
+    if (!PyArg_ParseTuple(args, "O", &batch_capsule)) {
+        return NULL;
+    }
+
+    gl_draw_batch* batch = capsule_to_draw_batch(batch_capsule);
+    if (!batch) {
+        return NULL;
+    }
+
+    glapi_DrawBatch(batch);
+    Py_RETURN_NONE;
+}
+
+static PyObject* glib_push_draw_batch_to_shader(PyObject* self, PyObject* args) {
+    const char* varname;
+    PyObject* batch_capsule;
+    GLuint shader;
+    if (!PyArg_ParseTuple(args, "sOI", &varname, &batch_capsule, &shader)) {
+        return NULL;
+    }
+
+    gl_draw_batch* batch = capsule_to_draw_batch(batch_capsule);
+    if (!batch) {
+        return NULL;
+    }
+
+    glapi_PushDrawBatchToShader(varname, batch, shader);
+    Py_RETURN_NONE;
+}
+
+static gl_dynamic_mesh* capsule_to_dynamic_mesh(PyObject* mesh_capsule) {
+    gl_dynamic_mesh* mesh = (gl_dynamic_mesh*)PyCapsule_GetPointer(mesh_capsule, "gl_dynamic_mesh");
+    if (!mesh) {
+        PyErr_SetString(PyExc_ValueError, "Invalid gl_dynamic_mesh pointer");
+        return NULL;
+    }
+    return mesh;
+}
+
+static PyObject* glib_gen_dynamic_mesh(PyObject* self, PyObject* args) {
+    PyObject* app_capsule;
+    unsigned int layout, max_vertices, max_indices;
+
+    if (!PyArg_ParseTuple(args, "OIII", &app_capsule, &layout, &max_vertices, &max_indices)) {
+        PyErr_SetString(PyExc_TypeError, "Expected app, layout, max_vertices, max_indices");
+        return NULL;
+    }
+
+    gl_app* app = (gl_app*)PyCapsule_GetPointer(app_capsule, "gl_app");
+    if (!app) {
+        PyErr_SetString(PyExc_ValueError, "Invalid gl_app pointer");
+        return NULL;
+    }
+
+    gl_dynamic_mesh* mesh = glapi_GenDynamicMesh(app, layout, max_vertices, max_indices);
+    if (!mesh) {
+        PyErr_SetString(PyExc_RuntimeError, "Failed to generate dynamic mesh");
+        return NULL;
+    }
+
+    return PyCapsule_New(mesh, "gl_dynamic_mesh", NULL);
+}
+
+static PyObject* glib_update_dynamic_mesh_vertices(PyObject* self, PyObject* args) {
+    PyObject *mesh_capsule, *attribute_objs[3] = {Py_None, Py_None, Py_None};
+    GLuint first_vertex;
+    if (!PyArg_ParseTuple(args, "OIO|OO", &mesh_capsule, &first_vertex, &attribute_objs[0], &attribute_objs[1], &attribute_objs[2])) {
+        PyErr_SetString(PyExc_TypeError, "Expected mesh, first_vertex, positions, [uvs, normals]");
+        return NULL;
+    }
+
+    gl_dynamic_mesh* mesh = capsule_to_dynamic_mesh(mesh_capsule);
+    if (!mesh) {
+        return NULL;
+    }
+
+    const Py_ssize_t row_lens[3] = {3, 2, 3};
+    Py_buffer views[3];
+    const GLfloat* data[3] = {NULL, NULL, NULL};
+    Py_ssize_t count = -1;
+    int acquired = 0;
+    for (; acquired < 3; acquired++) {
+        if (attribute_objs[acquired] == Py_None) {
+            continue;
+        }
+        Py_ssize_t rows;
+        if (!buffer_to_float_rows(attribute_objs[acquired], &views[acquired], row_lens[acquired], &rows)) {
+            break;
+        }
+        data[acquired] = (const GLfloat*)views[acquired].buf;
+        if (count >= 0 && rows != count) {
+            PyErr_SetString(PyExc_ValueError, "Vertex attributes must have the same number of rows");
+            acquired++;
+            break;
+        }
+        count = rows;
+    }
+
+    if (acquired == 3 && !PyErr_Occurred() && count > 0) {
+        glapi_UpdateDynamicMeshVertices(mesh, first_vertex, (GLuint)count, data[0], data[1], data[2]);
+    }
+    for (int i = 0; i < acquired; i++) {
+        if (data[i]) {
+            PyBuffer_Release(&views[i]);
+        }
+    }
+    if (PyErr_Occurred()) {
+        return NULL;
+    }
+    Py_RETURN_NONE;
+}
+
+static PyObject* glib_update_dynamic_mesh_indices(PyObject* self, PyObject* args) {
+    PyObject *mesh_capsule, *indices_obj;
+    GLuint first_index;
+    if (!PyArg_ParseTuple(args, "OIO", &mesh_capsule, &first_index, &indices_obj)) {
+        return NULL;
+    }
+
+    gl_dynamic_mesh* mesh = capsule_to_dynamic_mesh(mesh_capsule);
+    if (!mesh) {
+        return NULL;
+    }
+
+    Py_buffer view;
+    Py_ssize_t count;
+    if (!buffer_to_rows(indices_obj, &view, 'I', 1, &count)) {
+        return NULL;
+    }
+
+    glapi_UpdateDynamicMeshIndices(mesh, first_index, (GLuint)count, (const GLuint*)view.buf);
+    PyBuffer_Release(&view);
+    Py_RETURN_NONE;
+}
+
+static PyObject* glib_set_dynamic_mesh_counts(PyObject* self, PyObject* args) {
+    PyObject* mesh_capsule;
+    GLuint vertex_count, index_count;
+    if (!PyArg_ParseTuple(args, "OII", &mesh_capsule, &vertex_count, &index_count)) {
+        return NULL;
+    }
+
+    gl_dynamic_mesh* mesh = capsule_to_dynamic_mesh(mesh_capsule);
+    if (!mesh) {
+        return NULL;
+    }
+
+    glapi_SetDynamicMeshCounts(mesh, vertex_count, index_count);
+    Py_RETURN_NONE;
+}
+
+static PyObject* glib_commit_dynamic_mesh(PyObject* self, PyObject* args) {
+    PyObject* mesh_capsule;
+    if (!PyArg_ParseTuple(args, "O", &mesh_capsule)) {
+        return NULL;
+    }
+
+    gl_dynamic_mesh* mesh = capsule_to_dynamic_mesh(mesh_capsule);
+    if (!mesh) {
+        return NULL;
+    }
+
+    return PyBool_FromLong(glapi_CommitDynamicMesh(mesh));
+}
+
+static PyObject* glib_draw_dynamic_mesh(PyObject* self, PyObject* args) {
+    PyObject* mesh_capsule;
+    if (!PyArg_ParseTuple(args, "O", &mesh_capsule)) {
+        return NULL;
+    }
+
+    gl_dynamic_mesh* mesh = capsule_to_dynamic_mesh(mesh_capsule);
+    if (!mesh) {
+        return NULL;
+    }
+
+    glapi_DrawDynamicMesh(mesh);
+    Py_RETURN_NONE;
+}
+
+static gl_mesh_buffer* capsule_to_mesh_buffer(PyObject* buffer_capsule) {
+    gl_mesh_buffer* buffer = (gl_mesh_buffer*)PyCapsule_GetPointer(buffer_capsule, "gl_mesh_buffer");
+    if (!buffer) {
+        PyErr_SetString(PyExc_ValueError, "Invalid gl_mesh_buffer pointer");
+        return NULL;
+    }
+    return buffer;
+}
+
+static PyObject* glib_gen_mesh_buffer(PyObject* self, PyObject* args) {
+    PyObject *app_capsule, *positions, *indices, *uvs = NULL, *normals = NULL;
+    int optimize = 1;
+    unsigned int max_lods = 1;
+
+    if (!PyArg_ParseTuple(args, "OOO|OOpI", &app_capsule, &positions, &indices, &uvs, &normals, &optimize, &max_lods)) {
+        PyErr_SetString(PyExc_TypeError, "Expected app, positions, indices, [uvs, normals, optimize, max_lods]");
+        return NULL;
+    }
+
+    gl_app* app = (gl_app*)PyCapsule_GetPointer(app_capsule, "gl_app");
+    if (!app) {
+        PyErr_SetString(PyExc_ValueError, "Invalid gl_app pointer");
+        return NULL;
+    }
+
+    gl_mesh mesh;
+    if (!sequences_to_mesh(positions, indices, uvs, normals, &mesh)) {
+        return NULL;
+    }
+
+    gl_mesh_buffer* buffer = glapi_GenMeshBuffer(app, &mesh, optimize, max_lods);
+    free_mesh_arrays(&mesh);
+
+    if (!buffer) {
+        PyErr_SetString(PyExc_RuntimeError, "Failed to generate mesh buffer");
+        return NULL;
+    }
+
+    return PyCapsule_New(buffer, "gl_mesh_buffer", NULL);
+}
+
+static PyObject* glib_draw_mesh_buffer(PyObject* self, PyObject* args) {
+    PyObject* buffer_capsule;
+    if (!PyArg_ParseTuple(args, "O", &buffer_capsule)) {
+        return NULL;
+    }
+
+    gl_mesh_buffer* buffer = capsule_to_mesh_buffer(buffer_capsule);
+    if (!buffer) {
+        return NULL;
+    }
+
+    glapi_DrawMeshBuffer(buffer);
+    Py_RETURN_NONE;
+}
+
+static PyObject* glib_mesh_buffer_stats(PyObject* self, PyObject* args) {
+    PyObject* buffer_capsule;
+    if (!PyArg_ParseTuple(args, "O", &buffer_capsule)) {
+        return NULL;
+    }
+
+    gl_mesh_buffer* buffer = capsule_to_mesh_buffer(buffer_capsule);
+    if (!buffer) {
+        return NULL;
+    }
+
+    PyObject* lods = PyList_New(buffer->lod_count);
+    if (!lods) {
+        return NULL;
+    }
+    for (GLuint i = 0; i < buffer->lod_count; i++) {
+        PyList_SET_ITEM(lods, i, Py_BuildValue("(If)", buffer->lods[i].index_count / 3, buffer->lods[i].error));
+    }
+
+    gl_mesh_stats* stats = &buffer->stats;
+    return Py_BuildValue("{s:I,s:I,s:I,s:f,s:f,s:O,s:O,s:f,s:N}",
+        "vertices_before", stats->vertices_before,
+        "vertices_after", stats->vertices_after,
+        "triangles", stats->triangles,
+        "acmr_before", stats->acmr_before,
+        "acmr_after", stats->acmr_after,
+        "overdraw_sorted", stats->overdraw_sorted ? Py_True : Py_False,
+        "short_indices", buffer->index_type == GL_UNSIGNED_SHORT ? Py_True : Py_False,
+        "radius", buffer->radius,
+        "lods", lods);
+}
+
+static PyObject* glib_select_mesh_lod(PyObject* self, PyObject* args) {
+    PyObject *buffer_capsule, *projection_obj;
+    float distance, viewport_height, pixel_error = 1.0f;
+    if (!PyArg_ParseTuple(args, "OOff|f", &buffer_capsule, &projection_obj, &distance, &viewport_height, &pixel_error)) {
+        PyErr_SetString(PyExc_TypeError, "Expected mesh_buffer, projection, distance, viewport_height, [pixel_error]");
+        return NULL;
+    }
+
+    gl_mesh_buffer* buffer = capsule_to_mesh_buffer(buffer_capsule);
+    if (!buffer) {
+        return NULL;
+    }
+
+    float projection[16];
+    if (!sequence_to_float_array(projection_obj, projection, 16)) {
+        return NULL;
+    }
+
+    return PyLong_FromUnsignedLong(glapi_SelectMeshLOD(buffer, projection, distance, viewport_height, pixel_error));
+}
+
+static gl_render_queue* capsule_to_render_queue(PyObject* queue_capsule) {
+    gl_render_queue* queue = (gl_render_queue*)PyCapsule_GetPointer(queue_capsule, "gl_render_queue");
+    if (!queue) {
+        PyErr_SetString(PyExc_ValueError, "Invalid gl_render_queue pointer");
+        return NULL;
+    }
+    return queue;
+}
+
+static PyObject* glib_gen_render_queue(PyObject* self, PyObject* args) {
+    PyObject* app_capsule;
+    if (!PyArg_ParseTuple(args, "O", &app_capsule)) {
+        return NULL;
+    }
+
+    gl_app* app = (gl_app*)PyCapsule_GetPointer(app_capsule, "gl_app");
+    if (!app) {
+        PyErr_SetString(PyExc_ValueError, "Invalid gl_app pointer");
+        return NULL;
+    }
+
+    gl_render_queue* queue = glapi_GenRenderQueue(app);
+    if (!queue) {
+        PyErr_SetString(PyExc_RuntimeError, "Failed to generate render queue");
+        return NULL;
+    }
+
+    return PyCapsule_New(queue, "gl_render_queue", NULL);
+}
+
+static PyObject* glib_append_render_queue(PyObject* self, PyObject* args) {
+    PyObject *queue_capsule, *mesh_obj, *textures_obj = NULL;
+    GLuint shader, instances = 1;
+    Py_ssize_t isize = 0;
+    float depth = 0.0f;
+    int transparent = 0;
+
+    if (!PyArg_ParseTuple(args, "OIO|nOfpI", &queue_capsule, &shader, &mesh_obj, &isize, &textures_obj, &depth, &transparent, &instances)) {
+        PyErr_SetString(PyExc_TypeError, "Expected queue, shader, vao or mesh_buffer, [isize, textures, depth, transparent, instances]");
+        return NULL;
+    }
+
+    gl_render_queue* queue = capsule_to_render_queue(queue_capsule);
+    if (!queue) {
+        return NULL;
+    }
+
+    gl_render_item item;
+    memset(&item, 0, sizeof(gl_render_item));
+    item.shader = shader;
+    item.depth = depth;
+    item.transparent = transparent;
+    item.instance_count = instances;
+
+    if (PyCapsule_CheckExact(mesh_obj)) {
+        gl_mesh_buffer* buffer = capsule_to_mesh_buffer(mesh_obj);
+        if (!buffer) {
+            return NULL;
+        }
+        item.vao = buffer->vao;
+        item.index_type = buffer->index_type;
+        item.index_count = buffer->lods[buffer->lod].index_count;
+        item.first_index = buffer->lods[buffer->lod].first_index;
+    } else {
+        item.vao = (GLuint)PyLong_AsUnsignedLong(mesh_obj);
+        if (PyErr_Occurred()) {
+            return NULL;
+        }
+        item.index_type = GL_UNSIGNED_INT;
+        item.index_count = (GLuint)(isize / sizeof(GLuint));
+    }
+
+    if (textures_obj && textures_obj != Py_None) {
+        if (!PySequence_Check(textures_obj) || PySequence_Length(textures_obj) > RENDER_QUEUE_MAX_TEXTURES) {
+            PyErr_Format(PyExc_ValueError, "Expected a sequence of at most %d textures", RENDER_QUEUE_MAX_TEXTURES);
+            return NULL;
+        }
+        item.texture_count = (GLuint)PySequence_Length(textures_obj);
+        for (GLuint i = 0; i < item.texture_count; i++) {
+            PyObject* texture = PySequence_GetItem(textures_obj, i);
+            item.textures[i] = texture ? (GLuint)PyLong_AsUnsignedLong(texture) : 0;
+            Py_XDECREF(texture);
+            if (PyErr_Occurred()) {
+                return NULL;
+            }
+        }
+    }
+
+    if (!glapi_AppendRenderQueue(queue, &item)) {
+        PyErr_SetString(PyExc_RuntimeError, "Failed to append render item");
+        return NULL;
+    }
+    Py_RETURN_NONE;
+}
+
+static PyObject* glib_push_render_queue_uniform(PyObject* self, PyObject* args) {
+    PyObject *queue_capsule, *value_obj;
+    const char* varname;
+    if (!PyArg_ParseTuple(args, "OsO", &queue_capsule, &varname, &value_obj)) {
+        return NULL;
+    }
+
+    gl_render_queue* queue = capsule_to_render_queue(queue_capsule);
+    if (!queue) {
+        return NULL;
+    }
+
+    bool pushed;
+    if (PyLong_Check(value_obj)) {
+        GLint value = (GLint)PyLong_AsLong(value_obj);
+        pushed = glapi_PushRenderQueueUniform(queue, varname, RENDER_UNIFORM_INT, &value);
+    } else if (PyFloat_Check(value_obj)) {
+        GLfloat value = (GLfloat)PyFloat_AsDouble(value_obj);
+        pushed = glapi_PushRenderQueueUniform(queue, varname, RENDER_UNIFORM_FLOAT, &value);
+    } else {
+        Py_ssize_t len = PySequence_Check(value_obj) ? PySequence_Length(value_obj) : -1;
+        unsigned int type;
+        switch (len) {
+            case 2: type = RENDER_UNIFORM_VEC2; break;
+            case 3: type = RENDER_UNIFORM_VEC3; break;
+            case 4: type = RENDER_UNIFORM_VEC4; break;
+            case 9: type = RENDER_UNIFORM_MAT3; break;
+            case 16: type = RENDER_UNIFORM_MAT4; break;
+            default:
+                PyErr_SetString(PyExc_ValueError, "Uniform must be an int, float or sequence of 2, 3, 4, 9 or 16 floats");
+                return NULL;
+        }
+        float value[16];
+        if (!sequence_to_float_array(value_obj, value, len)) {
+            return NULL;
+        }
+        pushed = glapi_PushRenderQueueUniform(queue, varname, type, value);
+    }
+
+    return PyBool_FromLong(pushed);
+}
+
+static PyObject* glib_clear_render_queue(PyObject* self, PyObject* args) {
+    PyObject* queue_capsule;
+    if (!PyArg_ParseTuple(args, "O", &queue_capsule)) {
+        return NULL;
+    }
+
+    gl_render_queue* queue = capsule_to_render_queue(queue_capsule);
+    if (!queue) {
+        return NULL;
+    }
+
+    glapi_ClearRenderQueue(queue);
+    Py_RETURN_NONE;
+}
+
+static PyObject* glib_submit_render_queue(PyObject* self, PyObject* args) {
+    PyObject* queue_capsule;
+    if (!PyArg_ParseTuple(args, "O", &queue_capsule)) {
+        return NULL;
+    }
+
+    gl_render_queue* queue = capsule_to_render_queue(queue_capsule);
+    if (!queue) {
+        return NULL;
+    }
+
+    glapi_SubmitRenderQueue(queue);
+    Py_RETURN_NONE;
+}
+
+static PyObject* glib_render_queue_stats(PyObject* self, PyObject* args) {
+    PyObject* queue_capsule;
+    if (!PyArg_ParseTuple(args, "O", &queue_capsule)) {
+        return NULL;
+    }
+
+    gl_render_queue* queue = capsule_to_render_queue(queue_capsule);
+    if (!queue) {
+        return NULL;
+    }
+
+    gl_render_stats* stats = &queue->stats;
+    return Py_BuildValue("{s:n,s:n,s:n,s:n}",
+        "draws", (Py_ssize_t)stats->draws,
+        "state_changes", (Py_ssize_t)stats->state_changes,
+        "state_changes_unsorted", (Py_ssize_t)stats->state_changes_unsorted,
+        "state_changes_saved", (Py_ssize_t)stats->state_changes_unsorted - (Py_ssize_t)stats->state_changes);
+}
+
+static gl_texture_atlas* capsule_to_texture_atlas(PyObject* atlas_capsule) {
+    gl_texture_atlas* atlas = (gl_texture_atlas*)PyCapsule_GetPointer(atlas_capsule, "gl_texture_atlas");
+    if (!atlas) {
+        PyErr_SetString(PyExc_ValueError, "Invalid gl_texture_atlas pointer");
+        return NULL;
+    }
+    return atlas;
+}
+
+static const char** sequence_to_strings(PyObject* seq, PyObject** fast, size_t* count) {
+    *fast = PySequence_Fast(seq, "Expected a sequence of strings");
+    if (!*fast) {
+        return NULL;
+    }
+    *count = (size_t)PySequence_Fast_GET_SIZE(*fast);
+    const char** fpaths = (const char**)malloc((*count ? *count : 1) * sizeof(const char*));
+    if (!fpaths) {
+        Py_DECREF(*fast);
+        PyErr_NoMemory();
+        return NULL;
+    }
+    for (size_t i = 0; i < *count; i++) {
+        fpaths[i] = PyUnicode_AsUTF8(PySequence_Fast_GET_ITEM(*fast, i));
+        if (!fpaths[i]) {
+            free(fpaths);
+            Py_DECREF(*fast);
+            return NULL;
+        }
+    }
+    return fpaths;
+}
+
+static PyObject* glib_gen_texture_array(PyObject* self, PyObject* args) {
+    PyObject *app_capsule, *fpaths_obj, *fast;
+    GLenum internal_format = GL_RGBA8;
+    unsigned int mips = TEXTURE_MIPS_GPU;
+    if (!PyArg_ParseTuple(args, "OO|II", &app_capsule, &fpaths_obj, &internal_format, &mips)) {
+        return NULL;
+    }
+
+    gl_app* app = (gl_app*)PyCapsule_GetPointer(app_capsule, "gl_app");
+    if (!app) {
+        PyErr_SetString(PyExc_ValueError, "Invalid gl_app pointer");
+        return NULL;
+    }
+
+    size_t count;
+    const char** fpaths = sequence_to_strings(fpaths_obj, &fast, &count);
+    if (!fpaths) {
+        return NULL;
+    }
+
+    gl_texture_atlas* atlas = glapi_GenTextureArray(app, fpaths, count, internal_format, mips);
+    free(fpaths);
+    Py_DECREF(fast);
+    if (!atlas) {
+        PyErr_SetString(PyExc_IOError, "Failed to build texture array");
+        return NULL;
+    }
+
+    return PyCapsule_New(atlas, "gl_texture_atlas", NULL);
+}
+
+static PyObject* glib_gen_texture_atlas(PyObject* self, PyObject* args) {
+    PyObject *app_capsule, *fpaths_obj, *fast;
+    GLsizei max_size = 2048;
+    GLuint padding = 4;
+    GLenum internal_format = GL_RGBA8;
+    unsigned int mips = TEXTURE_MIPS_GPU;
+    if (!PyArg_ParseTuple(args, "OO|iIII", &app_capsule, &fpaths_obj, &max_size, &padding, &internal_format, &mips)) {
+        return NULL;
+    }
+
+    gl_app* app = (gl_app*)PyCapsule_GetPointer(app_capsule, "gl_app");
+    if (!app) {
+        PyErr_SetString(PyExc_ValueError, "Invalid gl_app pointer");
+        return NULL;
+    }
+
+    size_t count;
+    const char** fpaths = sequence_to_strings(fpaths_obj, &fast, &count);
+    if (!fpaths) {
+        return NULL;
+    }
+
+    gl_texture_atlas* atlas = glapi_GenTextureAtlas(app, fpaths, count, max_size, padding, internal_format, mips);
+    free(fpaths);
+    Py_DECREF(fast);
+    if (!atlas) {
+        PyErr_SetString(PyExc_IOError, "Failed to build texture atlas");
+        return NULL;
+    }
+
+    return PyCapsule_New(atlas, "gl_texture_atlas", NULL);
+}
+
+static PyObject* glib_texture_atlas_info(PyObject* self, PyObject* args) {
+    PyObject* atlas_capsule;
+    if (!PyArg_ParseTuple(args, "O", &atlas_capsule)) {
+        return NULL;
+    }
+
+    gl_texture_atlas* atlas = capsule_to_texture_atlas(atlas_capsule);
+    if (!atlas) {
+        return NULL;
+    }
+
+    PyObject* rects = PyList_New((Py_ssize_t)atlas->rect_count);
+    if (!rects) {
+        return NULL;
+    }
+    for (size_t i = 0; i < atlas->rect_count; i++) {
+        gl_atlas_rect* rect = &atlas->rects[i];
+        PyObject* item = Py_BuildValue("(Iffff)", rect->layer, rect->u0, rect->v0, rect->u1, rect->v1);
+        if (!item) {
+            Py_DECREF(rects);
+            return NULL;
+        }
+        PyList_SET_ITEM(rects, (Py_ssize_t)i, item);
+    }
+
+    return Py_BuildValue("{s:I,s:i,s:i,s:i,s:i,s:I,s:N}",
+        "texture", atlas->texture,
+        "width", atlas->width,
+        "height", atlas->height,
+        "layers", atlas->layers,
+        "levels", atlas->levels,
+        "padding", atlas->padding,
+        "rects", rects);
+}
+
+static PyObject* glib_push_texture_atlas_to_shader(PyObject* self, PyObject* args) {
+    const char* varname;
+    PyObject* atlas_capsule;
+    GLuint shader, sampler = 0, unit = 0;
+    if (!PyArg_ParseTuple(args, "sOI|II", &varname, &atlas_capsule, &shader, &sampler, &unit)) {
+        return NULL;
+    }
+
+    gl_texture_atlas* atlas = capsule_to_texture_atlas(atlas_capsule);
+    if (!atlas) {
+        return NULL;
+    }
+
+    glapi_PushTextureAtlasToShader(varname, atlas, sampler, unit, shader);
+    Py_RETURN_NONE;
+}
+
+static gl_texture_loader* capsule_to_texture_loader(PyObject* loader_capsule) {
+    gl_texture_loader* loader = (gl_texture_loader*)PyCapsule_GetPointer(loader_capsule, "gl_texture_loader");
+    if (!loader) {
+        PyErr_SetString(PyExc_ValueError, "Invalid gl_texture_loader pointer");
+        return NULL;
+    }
+    return loader;
+}
+
+static PyObject* glib_gen_texture_loader(PyObject* self, PyObject* args) {
+    PyObject* app_capsule;
+    unsigned int threads = 0;
+    Py_ssize_t upload_budget = 0;
+    if (!PyArg_ParseTuple(args, "O|In", &app_capsule, &threads, &upload_budget)) {
+        return NULL;
+    }
+
+    gl_app* app = (gl_app*)PyCapsule_GetPointer(app_capsule, "gl_app");
+    if (!app) {
+        PyErr_SetString(PyExc_ValueError, "Invalid gl_app pointer");
+        return NULL;
+    }
+    if (upload_budget < 0) {
+        PyErr_SetString(PyExc_ValueError, "Upload budget must be non-negative");
+        return NULL;
+    }
+
+    gl_texture_loader* loader = glapi_GenTextureLoader(app, threads, (size_t)upload_budget);
+    if (!loader) {
+        PyErr_SetString(PyExc_RuntimeError, "Failed to generate texture loader");
+        return NULL;
+    }
+
+    return PyCapsule_New(loader, "gl_texture_loader", NULL);
+}
+
+static PyObject* glib_load_texture_async(PyObject* self, PyObject* args) {
+    PyObject* loader_capsule;
+    const char* fpath;
+    unsigned int internal_format = GL_RGBA8;
+    unsigned int mips = TEXTURE_MIPS_GPU;
+    if (!PyArg_ParseTuple(args, "Os|II", &loader_capsule, &fpath, &internal_format, &mips)) {
+        return NULL;
+    }
+
+    gl_texture_loader* loader = capsule_to_texture_loader(loader_capsule);
+    if (!loader) {
+        return NULL;
+    }
+
+    uint32_t handle = glapi_LoadTextureAsync(loader, fpath, (GLenum)internal_format, mips);
+    if (handle == TEXTURE_LOADER_INVALID_HANDLE) {
+        PyErr_SetString(PyExc_ValueError, "Failed to queue texture load");
+        return NULL;
+    }
+
+    return PyLong_FromUnsignedLong(handle);
+}
+
+static PyObject* glib_texture_loader_texture(PyObject* self, PyObject* args) {
+    PyObject* loader_capsule;
+    unsigned int handle;
+    if (!PyArg_ParseTuple(args, "OI", &loader_capsule, &handle)) {
+        return NULL;
+    }
+
+    gl_texture_loader* loader = capsule_to_texture_loader(loader_capsule);
+    if (!loader) {
+        return NULL;
+    }
+
+    return PyLong_FromUnsignedLong(glapi_TextureLoaderTexture(loader, handle));
+}
+
+static PyObject* glib_texture_loader_status(PyObject* self, PyObject* args) {
+    PyObject* loader_capsule;
+    unsigned int handle;
+    if (!PyArg_ParseTuple(args, "OI", &loader_capsule, &handle)) {
+        return NULL;
+    }
+
+    gl_texture_loader* loader = capsule_to_texture_loader(loader_capsule);
+    if (!loader) {
+        return NULL;
+    }
+
+    return PyLong_FromUnsignedLong(glapi_TextureLoaderStatus(loader, handle));
+}
+
+static PyObject* glib_pump_texture_loader(PyObject* self, PyObject* args) {
+    PyObject* loader_capsule;
+    if (!PyArg_ParseTuple(args, "O", &loader_capsule)) {
+        return NULL;
+    }
+
+    gl_texture_loader* loader = capsule_to_texture_loader(loader_capsule);
+    if (!loader) {
+        return NULL;
+    }
+
+    return PyLong_FromSize_t(glapi_PumpTextureLoader(loader));
+}
+
+static PyObject* glib_finish_texture_loader(PyObject* self, PyObject* args) {
+    PyObject* loader_capsule;
+    if (!PyArg_ParseTuple(args, "O", &loader_capsule)) {
+        return NULL;
+    }
+
+    gl_texture_loader* loader = capsule_to_texture_loader(loader_capsule);
+    if (!loader) {
+        return NULL;
+    }
+
+    glapi_FinishTextureLoader(loader);
+    Py_RETURN_NONE;
+}
+
+static PyObject* glib_gen_frame_buffer_object(PyObject* self, PyObject* args) {
+    PyObject* app_capsule;
+    int out_tex, width, height;
+
+    if (!PyArg_ParseTuple(args, "Oiii", &app_capsule, &out_tex, &width, &height)) {
+        PyErr_SetString(PyExc_ValueError, "Expected a tuple of type 'Oiii' (app_capsule, out_tex, width, height)");
+        return NULL;
+    }
+
+    gl_app* app = (gl_app*)PyCapsule_GetPointer(app_capsule, "gl_app");
+    if (!app) {
+        PyErr_SetString(PyExc_ValueError, "Invalid gl_app pointer");
+        return NULL;
+    }
+
+    GLuint framebuffer = glapi_GenFrameBuffer(app, out_tex, NULL, width, height);
+
+    if (!framebuffer) {
+        PyErr_SetString(PyExc_RuntimeError, "Failed to generate frame buffer object");
+        return NULL;
+    }
+
+    return PyLong_FromUnsignedLong(framebuffer);
+}
+
+static gl_render_target* capsule_to_render_target(PyObject* target_capsule) {
+    gl_render_target* target = (gl_render_target*)PyCapsule_GetPointer(target_capsule, "gl_render_target");
+    if (!target) {
+        PyErr_SetString(PyExc_ValueError, "Invalid gl_render_target pointer");
+        return NULL;
+    }
+    return target;
+}
+
+static PyObject* glib_gen_render_target(PyObject* self, PyObject* args) {
+    PyObject* app_capsule;
+    PyObject* colors_obj = NULL;
+    int width, height, samples = 1, depth_texture = 0;
+    unsigned int depth_format = GL_DEPTH_COMPONENT24;
+    if (!PyArg_ParseTuple(args, "Oii|OIip", &app_capsule, &width, &height, &colors_obj, &depth_format, &samples, &depth_texture)) {
+        PyErr_SetString(PyExc_ValueError, "Expected a tuple of type 'Oii|OIip' (app_capsule, width, height, [colors, depth_format, samples, depth_texture])");
+        return NULL;
+    }
+
+    gl_app* app = (gl_app*)PyCapsule_GetPointer(app_capsule, "gl_app");
+    if (!app) {
+        PyErr_SetString(PyExc_ValueError, "Invalid gl_app pointer");
+        return NULL;
+    }
+
+    gl_render_target_desc desc;
+    memset(&desc, 0, sizeof(gl_render_target_desc));
+    desc.width = width;
+    desc.height = height;
+    desc.samples = samples;
+    desc.depth_format = depth_format;
+    desc.depth_texture = depth_texture;
+    if (!colors_obj) {
+        desc.color_count = 1;
+        desc.color_formats[0] = GL_RGBA8;
+    } else {
+        PyObject* fast = PySequence_Fast(colors_obj, "Expected a sequence of color formats");
+        if (!fast) {
+            return NULL;
+        }
+        Py_ssize_t count = PySequence_Fast_GET_SIZE(fast);
+        if (count > RENDER_TARGET_MAX_COLOR) {
+            Py_DECREF(fast);
+            PyErr_Format(PyExc_ValueError, "At most %d color attachments are supported", RENDER_TARGET_MAX_COLOR);
+            return NULL;
+        }
+        for (Py_ssize_t i = 0; i < count; i++) {
+            unsigned long format = PyLong_AsUnsignedLong(PySequence_Fast_GET_ITEM(fast, i));
+            if (PyErr_Occurred()) {
+                Py_DECREF(fast);
+                return NULL;
+            }
+            desc.color_formats[i] = (GLenum)format;
+        }
+        desc.color_count = (GLuint)count;
+        Py_DECREF(fast);
+    }
+
+    gl_render_target* target = glapi_GenRenderTarget(app, &desc);
+    if (!target) {
+        PyErr_SetString(PyExc_RuntimeError, "Failed to generate render target");
+        return NULL;
+    }
+
+    return PyCapsule_New(target, "gl_render_target", NULL);
+}
+
+static PyObject* glib_bind_render_target(PyObject* self, PyObject* args) {
+    PyObject* target_capsule;
+    if (!PyArg_ParseTuple(args, "O", &target_capsule)) {
+        return NULL;
+    }
+
+    gl_render_target* target = capsule_to_render_target(target_capsule);
+    if (!target) {
+        return NULL;
+    }
+
+    glapi_BindRenderTarget(target);
+    Py_RETURN_NONE;
+}
+
+static PyObject* glib_unbind_render_target(PyObject* self, PyObject* args) {
+    PyObject* app_capsule;
+    if (!PyArg_ParseTuple(args, "O", &app_capsule)) {
+        return NULL;
+    }
+
+    gl_app* app = (gl_app*)PyCapsule_GetPointer(app_capsule, "gl_app");
+    if (!app) {
+        PyErr_SetString(PyExc_ValueError, "Invalid gl_app pointer");
+        return NULL;
+    }
+
+    glapi_UnbindRenderTarget(app);
+    Py_RETURN_NONE;
+}
+
+static PyObject* glib_resolve_render_target(PyObject* self, PyObject* args) {
+    PyObject* target_capsule;
+    if (!PyArg_ParseTuple(args, "O", &target_capsule)) {
+        return NULL;
+    }
+
+    gl_render_target* target = capsule_to_render_target(target_capsule);
+    if (!target) {
+        return NULL;
+    }
+
+    glapi_ResolveRenderTarget(target);
+    Py_RETURN_NONE;
+}
+
+static PyObject* glib_blit_render_target(PyObject* self, PyObject* args) {
+    PyObject* target_capsule;
+    unsigned int attachment;
+    int width, height;
+    unsigned int destination = 0;
+    if (!PyArg_ParseTuple(args, "OIii|I", &target_capsule, &attachment, &width, &height, &destination)) {
+        return NULL;
+    }
+
+    gl_render_target* target = capsule_to_render_target(target_capsule);
+    if (!target) {
+        return NULL;
+    }
+    if (attachment >= target->desc.color_count) {
+        PyErr_SetString(PyExc_IndexError, "Color attachment out of range");
+        return NULL;
+    }
+
+    glapi_BlitRenderTarget(target, attachment, destination, width, height);
+    Py_RETURN_NONE;
+}
+
+static PyObject* glib_render_target_textures(PyObject* self, PyObject* args) {
+    PyObject* target_capsule;
+    if (!PyArg_ParseTuple(args, "O", &target_capsule)) {
+        return NULL;
+    }
+
+    gl_render_target* target = capsule_to_render_target(target_capsule);
+    if (!target) {
+        return NULL;
+    }
+
+    PyObject* colors = PyTuple_New(target->desc.color_count);
+    if (!colors) {
+        return NULL;
+    }
+    for (GLuint i = 0; i < target->desc.color_count; i++) {
+        PyTuple_SET_ITEM(colors, i, PyLong_FromUnsignedLong(target->color_textures[i]));
+    }
+
+    return Py_BuildValue("(NI)", colors, target->depth_texture);
+}
+
+static gl_frame_graph* capsule_to_frame_graph(PyObject* graph_capsule) {
+    gl_frame_graph* graph = (gl_frame_graph*)PyCapsule_GetPointer(graph_capsule, "gl_frame_graph");
+    if (!graph) {
+        PyErr_SetString(PyExc_ValueError, "Invalid gl_frame_graph pointer");
+        return NULL;
+    }
+    return graph;
+}
+
+static bool frame_graph_execute_callable(gl_frame_graph* graph, uint32_t pass, void* user) {
+    PyObject* result = PyObject_CallFunction((PyObject*)user, "I", pass);
+    if (!result) {
+        return false;
+    }
+    Py_DECREF(result);
+    return true;
+}
+
+static void frame_graph_release_callable(void* user) {
+    Py_DECREF((PyObject*)user);
+}
+
+static bool frame_graph_resources(gl_frame_graph* graph, uint32_t pass, PyObject* seq, bool (*declare)(gl_frame_graph*, uint32_t, uint32_t)) {
+    if (!seq) {
+        return true;
+    }
+    PyObject* fast = PySequence_Fast(seq, "Expected a sequence of frame graph resources");
+    if (!fast) {
+        return false;
+    }
+    for (Py_ssize_t i = 0; i < PySequence_Fast_GET_SIZE(fast); i++) {
+        unsigned long resource = PyLong_AsUnsignedLong(PySequence_Fast_GET_ITEM(fast, i));
+        if (PyErr_Occurred()) {
+            Py_DECREF(fast);
+            return false;
+        }
+        if (!declare(graph, pass, (uint32_t)resource)) {
+            Py_DECREF(fast);
+            PyErr_SetString(PyExc_ValueError, "Invalid frame graph resource for pass");
+            return false;
+        }
+    }
+    Py_DECREF(fast);
+    return true;
+}
+
+static PyObject* glib_gen_frame_graph(PyObject* self, PyObject* args) {
+    PyObject* app_capsule;
+    int width, height;
+    if (!PyArg_ParseTuple(args, "Oii", &app_capsule, &width, &height)) {
+        return NULL;
+    }
+
+    gl_app* app = (gl_app*)PyCapsule_GetPointer(app_capsule, "gl_app");
+    if (!app) {
+        PyErr_SetString(PyExc_ValueError, "Invalid gl_app pointer");
+        return NULL;
+    }
+
+    gl_frame_graph* graph = glapi_GenFrameGraph(app, width, height);
+    if (!graph) {
+        PyErr_SetString(PyExc_RuntimeError, "Failed to generate frame graph");
+        return NULL;
+    }
+    graph->release = frame_graph_release_callable;
+
+    return PyCapsule_New(graph, "gl_frame_graph", NULL);
+}
+
+static PyObject* glib_frame_graph_resource(PyObject* self, PyObject* args) {
+    PyObject* graph_capsule;
+    const char* name;
+    unsigned int format;
+    float scale = 1.0f;
+    if (!PyArg_ParseTuple(args, "OsI|f", &graph_capsule, &name, &format, &scale)) {
+        return NULL;
+    }
+
+    gl_frame_graph* graph = capsule_to_frame_graph(graph_capsule);
+    if (!graph) {
+        return NULL;
+    }
+
+    uint32_t resource = glapi_GraphCreateResource(graph, name, (GLenum)format, scale);
+    if (resource == FRAME_GRAPH_INVALID) {
+        PyErr_SetString(PyExc_ValueError, "Failed to create frame graph resource");
+        return NULL;
+    }
+
+    return PyLong_FromUnsignedLong(resource);
+}
+
+static PyObject* glib_frame_graph_import(PyObject* self, PyObject* args) {
+    PyObject* graph_capsule;
+    const char* name;
+    unsigned int texture;
+    int width, height;
+    if (!PyArg_ParseTuple(args, "OsIii", &graph_capsule, &name, &texture, &width, &height)) {
+        return NULL;
+    }
+
+    gl_frame_graph* graph = capsule_to_frame_graph(graph_capsule);
+    if (!graph) {
+        return NULL;
+    }
+
+    uint32_t resource = glapi_GraphImportTexture(graph, name, texture, width, height);
+    if (resource == FRAME_GRAPH_INVALID) {
+        PyErr_SetString(PyExc_RuntimeError, "Failed to import frame graph texture");
+        return NULL;
+    }
+
+    return PyLong_FromUnsignedLong(resource);
+}
+
+static PyObject* glib_frame_graph_export(PyObject* self, PyObject* args) {
+    PyObject* graph_capsule;
+    unsigned int resource;
+    if (!PyArg_ParseTuple(args, "OI", &graph_capsule, &resource)) {
+        return NULL;
+    }
+
+    gl_frame_graph* graph = capsule_to_frame_graph(graph_capsule);
+    if (!graph) {
+        return NULL;
+    }
+    if (resource >= graph->resource_count) {
+        PyErr_SetString(PyExc_IndexError, "Frame graph resource out of range");
+        return NULL;
+    }
+
+    glapi_GraphExportResource(graph, resource);
+    Py_RETURN_NONE;
+}
+
+static PyObject* glib_frame_graph_pass(PyObject* self, PyObject* args) {
+    PyObject* graph_capsule;
+    const char* name;
+    PyObject* callable;
+    PyObject* reads = NULL;
+    PyObject* writes = NULL;
+    int present = 0;
+    if (!PyArg_ParseTuple(args, "OsO|OOp", &graph_capsule, &name, &callable, &reads, &writes, &present)) {
+        return NULL;
+    }
+
+    gl_frame_graph* graph = capsule_to_frame_graph(graph_capsule);
+    if (!graph) {
+        return NULL;
+    }
+    if (callable != Py_None && !PyCallable_Check(callable)) {
+        PyErr_SetString(PyExc_TypeError, "Frame graph pass expects a callable or None");
+        return NULL;
+    }
+
+    void* user = callable == Py_None ? NULL : callable;
+    uint32_t pass = glapi_GraphAddPass(graph, name, user ? frame_graph_execute_callable : NULL, user, present ? FRAME_GRAPH_PASS_PRESENT : 0);
+    if (pass == FRAME_GRAPH_INVALID) {
+        PyErr_SetString(PyExc_RuntimeError, "Failed to add frame graph pass");
+        return NULL;
+    }
+    Py_XINCREF((PyObject*)user);
+
+    if (!frame_graph_resources(graph, pass, reads, glapi_GraphPassRead) || !frame_graph_resources(graph, pass, writes, glapi_GraphPassWrite)) {
+        return NULL;
+    }
+
+    return PyLong_FromUnsignedLong(pass);
+}
+
+static PyObject* glib_compile_frame_graph(PyObject* self, PyObject* args) {
+    PyObject* graph_capsule;
+    if (!PyArg_ParseTuple(args, "O", &graph_capsule)) {
+        return NULL;
+    }
+
+    gl_frame_graph* graph = capsule_to_frame_graph(graph_capsule);
+    if (!graph) {
+        return NULL;
+    }
+    if (!glapi_CompileFrameGraph(graph)) {
+        PyErr_SetString(PyExc_RuntimeError, "Failed to compile frame graph");
+        return NULL;
+    }
+
+    PyObject* order = PyList_New((Py_ssize_t)graph->order_count);
+    if (!order) {
+        return NULL;
+    }
+    for (size_t i = 0; i < graph->order_count; i++) {
+        PyList_SET_ITEM(order, (Py_ssize_t)i, PyUnicode_FromString(graph->passes[graph->order[i]].name));
+    }
+
+    gl_frame_graph_stats* stats = &graph->stats;
+    return Py_BuildValue(
+        "{s:N,s:n,s:n,s:n,s:n,s:n,s:n}",
+        "order", order,
+        "passes", (Py_ssize_t)stats->passes,
+        "culled", (Py_ssize_t)stats->culled,
+        "resources", (Py_ssize_t)stats->resources,
+        "textures", (Py_ssize_t)stats->textures,
+        "bytes", (Py_ssize_t)stats->bytes,
+        "unaliased_bytes", (Py_ssize_t)stats->unaliased_bytes
+    );
+}
+
+static PyObject* glib_execute_frame_graph(PyObject* self, PyObject* args) {
+    PyObject* graph_capsule;
+    if (!PyArg_ParseTuple(args, "O", &graph_capsule)) {
+        return NULL;
+    }
+
+    gl_frame_graph* graph = capsule_to_frame_graph(graph_capsule);
+    if (!graph) {
+        return NULL;
+    }
+    if (!glapi_ExecuteFrameGraph(graph)) {
+        if (!PyErr_Occurred()) {
+            PyErr_SetString(PyExc_RuntimeError, "Failed to execute frame graph");
+        }
+        return NULL;
+    }
+
+    Py_RETURN_NONE;
+}
+
+static PyObject* glib_frame_graph_texture(PyObject* self, PyObject* args) {
+    PyObject* graph_capsule;
+    unsigned int resource;
+    if (!PyArg_ParseTuple(args, "OI", &graph_capsule, &resource)) {
+        return NULL;
+    }
+
+    gl_frame_graph* graph = capsule_to_frame_graph(graph_capsule);
+    if (!graph) {
+        return NULL;
+    }
+
+    return PyLong_FromUnsignedLong(glapi_GraphResourceTexture(graph, resource));
+}
+
+static PyObject* glib_resize_frame_graph(PyObject* self, PyObject* args) {
+    PyObject* graph_capsule;
+    int width, height;
+    if (!PyArg_ParseTuple(args, "Oii", &graph_capsule, &width, &height)) {
+        return NULL;
+    }
+
+    gl_frame_graph* graph = capsule_to_frame_graph(graph_capsule);
+    if (!graph) {
+        return NULL;
+    }
+
+    glapi_ResizeFrameGraph(graph, width, height);
+    Py_RETURN_NONE;
+}
+
+static PyObject* glib_reset_frame_graph(PyObject* self, PyObject* args) {
+    PyObject* graph_capsule;
+    if (!PyArg_ParseTuple(args, "O", &graph_capsule)) {
+        return NULL;
+    }
+
+    gl_frame_graph* graph = capsule_to_frame_graph(graph_capsule);
+    if (!graph) {
+        return NULL;
+    }
+
+    glapi_ResetFrameGraph(graph);
+    Py_RETURN_NONE;
+}
+
+static gl_gpu_profiler* capsule_to_gpu_profiler(PyObject* profiler_capsule) {
+    gl_gpu_profiler* profiler = (gl_gpu_profiler*)PyCapsule_GetPointer(profiler_capsule, "gl_gpu_profiler");
+    if (!profiler) {
+        PyErr_SetString(PyExc_ValueError, "Invalid gl_gpu_profiler pointer");
+        return NULL;
+    }
+    return profiler;
+}
+
+static PyObject* glib_set_frame_graph_profiler(PyObject* self, PyObject* args) {
+    PyObject* graph_capsule;
+    PyObject* profiler_capsule;
+    if (!PyArg_ParseTuple(args, "OO", &graph_capsule, &profiler_capsule)) {
+        return NULL;
+    }
+
+    gl_frame_graph* graph = capsule_to_frame_graph(graph_capsule);
+    if (!graph) {
+        return NULL;
+    }
+    gl_gpu_profiler* profiler = NULL;
+    if (profiler_capsule != Py_None) {
+        profiler = capsule_to_gpu_profiler(profiler_capsule);
+        if (!profiler) {
+            return NULL;
+        }
+    }
+
+    graph->profiler = profiler;
+    Py_RETURN_NONE;
+}
+
+static PyObject* glib_gen_gpu_profiler(PyObject* self, PyObject* args) {
+    PyObject* app_capsule;
+    unsigned int frames = 0;
+    if (!PyArg_ParseTuple(args, "O|I", &app_capsule, &frames)) {
+        return NULL;
+    }
+
+    gl_app* app = (gl_app*)PyCapsule_GetPointer(app_capsule, "gl_app");
+    if (!app) {
+        PyErr_SetString(PyExc_ValueError, "Invalid gl_app pointer");
+        return NULL;
+    }
+
+    gl_gpu_profiler* profiler = glapi_GenGpuProfiler(app, frames);
+    if (!profiler) {
+        PyErr_SetString(PyExc_RuntimeError, "Failed to generate GPU profiler");
+        return NULL;
+    }
+
+    return PyCapsule_New(profiler, "gl_gpu_profiler", NULL);
+}
+
+static PyObject* glib_begin_gpu_frame(PyObject* self, PyObject* args) {
+    PyObject* profiler_capsule;
+    if (!PyArg_ParseTuple(args, "O", &profiler_capsule)) {
+        return NULL;
+    }
+
+    gl_gpu_profiler* profiler = capsule_to_gpu_profiler(profiler_capsule);
+    if (!profiler) {
+        return NULL;
+    }
+
+    glapi_BeginGpuFrame(profiler);
+    Py_RETURN_NONE;
+}
+
+static PyObject* glib_end_gpu_frame(PyObject* self, PyObject* args) {
+    PyObject* profiler_capsule;
+    if (!PyArg_ParseTuple(args, "O", &profiler_capsule)) {
+        return NULL;
+    }
+
+    gl_gpu_profiler* profiler = capsule_to_gpu_profiler(profiler_capsule);
+    if (!profiler) {
+        return NULL;
+    }
+
+    glapi_EndGpuFrame(profiler);
+    Py_RETURN_NONE;
+}
+
+static PyObject* glib_begin_gpu_scope(PyObject* self, PyObject* args) {
+    PyObject* profiler_capsule;
+    const char* name;
+    if (!PyArg_ParseTuple(args, "Os", &profiler_capsule, &name)) {
+        return NULL;
+    }
+
+    gl_gpu_profiler* profiler = capsule_to_gpu_profiler(profiler_capsule);
+    if (!profiler) {
+        return NULL;
+    }
+
+    return PyBool_FromLong(glapi_BeginGpuScope(profiler, name));
+}
+
+static PyObject* glib_end_gpu_scope(PyObject* self, PyObject* args) {
+    PyObject* profiler_capsule;
+    if (!PyArg_ParseTuple(args, "O", &profiler_capsule)) {
+        return NULL;
+    }
+
+    gl_gpu_profiler* profiler = capsule_to_gpu_profiler(profiler_capsule);
+    if (!profiler) {
+        return NULL;
+    }
+
+    glapi_EndGpuScope(profiler);
+    Py_RETURN_NONE;
+}
+
+static PyObject* glib_gpu_profiler_report(PyObject* self, PyObject* args) {
+    PyObject* profiler_capsule;
+    if (!PyArg_ParseTuple(args, "O", &profiler_capsule)) {
+        return NULL;
+    }
+
+    gl_gpu_profiler* profiler = capsule_to_gpu_profiler(profiler_capsule);
+    if (!profiler) {
+        return NULL;
+    }
+    glapi_CollectGpuProfiler(profiler);
+
+    PyObject* scopes = PyList_New(profiler->timing_count);
+    if (!scopes) {
+        return NULL;
+    }
+    for (GLuint i = 0; i < profiler->timing_count; i++) {
+        gl_gpu_timing* timing = &profiler->timings[i];
+        PyList_SET_ITEM(scopes, i, Py_BuildValue("(sId)", timing->name, timing->depth, timing->ms));
+    }
+
+    return Py_BuildValue(
+        "{s:K,s:d,s:n,s:n,s:N}",
+        "frame", (unsigned long long)profiler->report_frame,
+        "frame_ms", profiler->frame_ms,
+        "dropped", (Py_ssize_t)profiler->dropped,
+        "overflow", (Py_ssize_t)profiler->overflow,
+        "scopes", scopes
+    );
+}
+
+static PyObject* glib_profiler_enable(PyObject* self, PyObject* args) {
+    int enabled = 1;
+    if (!PyArg_ParseTuple(args, "|p", &enabled)) {
+        return NULL;
+    }
+
+    glapi_EnableCpuProfiler(enabled);
+    Py_RETURN_NONE;
+}
+
+static PyObject* glib_profiler_begin(PyObject* self, PyObject* args) {
+    const char* name;
+    if (!PyArg_ParseTuple(args, "s", &name)) {
+        return NULL;
+    }
+
+    if (glapi_IsCpuProfilerEnabled()) {
+        glapi_BeginCpuZone(glapi_InternCpuZoneName(name));
+    }
+    Py_RETURN_NONE;
+}
+
+static PyObject* glib_profiler_end(PyObject* self, PyObject* args) {
+    glapi_EndCpuZone();
+    Py_RETURN_NONE;
+}
+
+static PyObject* glib_profiler_name_thread(PyObject* self, PyObject* args) {
+    const char* name;
+    if (!PyArg_ParseTuple(args, "s", &name)) {
+        return NULL;
+    }
+
+    glapi_NameCpuThread(name);
+    Py_RETURN_NONE;
+}
+
+static PyObject* glib_profiler_reset(PyObject* self, PyObject* args) {
+    glapi_ResetCpuProfiler();
+    Py_RETURN_NONE;
+}
+
+static PyObject* glib_profiler_dump(PyObject* self, PyObject* args) {
+    const char* fpath;
+    if (!PyArg_ParseTuple(args, "s", &fpath)) {
+        return NULL;
+    }
+
+    size_t events = 0;
+    if (!glapi_DumpCpuProfile(fpath, &events)) {
+        PyErr_SetString(PyExc_IOError, "Failed to write CPU profile");
+        return NULL;
+    }
+
+    return PyLong_FromSize_t(events);
+}
+
+typedef struct readback_frame {
+    PyObject_HEAD
+    gl_readback* readback;
+    GLuint slot;
+    GLsizei width;
+    GLsizei height;
+    GLuint channels;
+    uint64_t frame;
+    Py_ssize_t exports;
+    struct readback_frame* prev;
+    struct readback_frame* next;
+} readback_frame;
+
+static readback_frame* readback_frames = NULL;
+
+static void readback_frame_detach(readback_frame* frame) {
+    if (!frame->readback)
+        return;
+    if (frame->prev)
+        frame->prev->next = frame->next;
+    else
+        readback_frames = frame->next;
+    if (frame->next)
+        frame->next->prev = frame->prev;
+    frame->prev = frame->next = NULL;
+    frame->readback = NULL;
+}
+
+static void readback_frame_unmap(readback_frame* frame) {
+    if (!frame->readback)
+        return;
+    glapi_UnmapReadback(frame->readback, frame->slot);
+    readback_frame_detach(frame);
+}
+
+static bool readback_frames_exported(gl_app* app) {
+    for (readback_frame* frame = readback_frames; frame; frame = frame->next) {
+        if (frame->readback->app == app && frame->exports)
+            return true;
+    }
+    return false;
+}
+
+static void readback_frames_release_app(gl_app* app) {
+    readback_frame* frame = readback_frames;
+    while (frame) {
+        readback_frame* next = frame->next;
+        if (frame->readback->app == app)
+            readback_frame_detach(frame);
+        frame = next;
+    }
+}
+
+static int readback_frame_getbuffer(PyObject* self, Py_buffer* view, int flags) {
+    readback_frame* frame = (readback_frame*)self;
+    if (!frame->readback) {
+        PyErr_SetString(PyExc_BufferError, "Readback frame has been released");
+        view->obj = NULL;
+        return -1;
+    }
+    gl_readback_slot* slot = &frame->readback->slots[frame->slot];
+    if (PyBuffer_FillInfo(view, self, slot->data, (Py_ssize_t)slot->size, 1, flags) < 0)
+        return -1;
+    frame->exports++;
+    return 0;
+}
+
+static void readback_frame_releasebuffer(PyObject* self, Py_buffer* view) {
+    ((readback_frame*)self)->exports--;
+}
+
+static PyObject* readback_frame_release(PyObject* self, PyObject* args) {
+    readback_frame* frame = (readback_frame*)self;
+    if (frame->exports) {
+        PyErr_SetString(PyExc_BufferError, "Readback frame is still exported");
+        return NULL;
+    }
+    readback_frame_unmap(frame);
+    Py_RETURN_NONE;
+}
+
+static PyObject* readback_frame_enter(PyObject* self, PyObject* args) {
+    Py_INCREF(self);
+    return self;
+}
+
+static PyObject* readback_frame_exit(PyObject* self, PyObject* args) {
+    return readback_frame_release(self, NULL);
+}
+
+static void readback_frame_dealloc(PyObject* self) {
+    readback_frame_unmap((readback_frame*)self);
+    Py_TYPE(self)->tp_free(self);
+}
+
+static PyObject* readback_frame_get(PyObject* self, void* field) {
+    readback_frame* frame = (readback_frame*)self;
+    switch ((intptr_t)field) {
+        case 0:  return PyLong_FromLong(frame->width);
+        case 1:  return PyLong_FromLong(frame->height);
+        case 2:  return PyLong_FromUnsignedLong(frame->channels);
+        case 3:  return PyLong_FromUnsignedLongLong((unsigned long long)frame->frame);
+        default: return PyBool_FromLong(frame->readback != NULL);
+    }
+}
+
+static PyMethodDef readback_frame_methods[] = {
+    {"release", readback_frame_release, METH_NOARGS, "Unmap the pixel buffer backing this frame"},
+    {"__enter__", readback_frame_enter, METH_NOARGS, NULL},
+    {"__exit__", readback_frame_exit, METH_VARARGS, NULL},
+    {NULL, NULL, 0, NULL}
+};
+
+static PyGetSetDef readback_frame_getset[] = {
+    {"width", readback_frame_get, NULL, "Frame width in pixels", (void*)0},
+    {"height", readback_frame_get, NULL, "Frame height in pixels", (void*)1},
+    {"channels", readback_frame_get, NULL, "Components per pixel", (void*)2},
+    {"frame", readback_frame_get, NULL, "Sequence number of the readback", (void*)3},
+    {"mapped", readback_frame_get, NULL, "Whether the pixel buffer is still mapped", (void*)4},
+    {NULL, NULL, NULL, NULL, NULL}
+};
+
+static PyBufferProcs readback_frame_buffer = {
+    readback_frame_getbuffer,
+    readback_frame_releasebuffer
+};
+
+static PyTypeObject readback_frame_type = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    .tp_name = "glib.ReadbackFrame",
+    .tp_basicsize = sizeof(readback_frame),
+    .tp_flags = Py_TPFLAGS_DEFAULT,
+    .tp_doc = "Mapped pixel buffer holding one completed framebuffer readback, bottom row first",
+    .tp_dealloc = readback_frame_dealloc,
+    .tp_as_buffer = &readback_frame_buffer,
+    .tp_methods = readback_frame_methods,
+    .tp_getset = readback_frame_getset,
+};
+
+static gl_readback* capsule_to_readback(PyObject* readback_capsule) {
+    gl_readback* readback = (gl_readback*)PyCapsule_GetPointer(readback_capsule, "gl_readback");
+    if (!readback) {
+        PyErr_SetString(PyExc_ValueError, "Invalid gl_readback pointer");
+        return NULL;
+    }
+    return readback;
+}
+
+static PyObject* glib_gen_readback(PyObject* self, PyObject* args) {
+    PyObject* app_capsule;
+    unsigned int slots = 0, channels = 4;
+    if (!PyArg_ParseTuple(args, "O|II", &app_capsule, &slots, &channels)) {
+        return NULL;
+    }
+
+    gl_app* app = (gl_app*)PyCapsule_GetPointer(app_capsule, "gl_app");
+    if (!app) {
+        PyErr_SetString(PyExc_ValueError, "Invalid gl_app pointer");
+        return NULL;
+    }
+
+    gl_readback* readback = glapi_GenReadback(app, slots, channels);
+    if (!readback) {
+        PyErr_SetString(PyExc_RuntimeError, "Failed to create gl_readback");
+        return NULL;
+    }
+    return PyCapsule_New(readback, "gl_readback", NULL);
+}
+
+static PyObject* glib_readback_framebuffer(PyObject* self, PyObject* args) {
+    PyObject* readback_capsule;
+    int width, height;
+    unsigned int framebuffer = 0, attachment = 0;
+    int x = 0, y = 0;
+    if (!PyArg_ParseTuple(args, "Oii|IIii", &readback_capsule, &width, &height, &framebuffer, &attachment, &x, &y)) {
+        return NULL;
+    }
+
+    gl_readback* readback = capsule_to_readback(readback_capsule);
+    if (!readback) {
+        return NULL;
+    }
+    return PyBool_FromLong(glapi_ReadbackFramebuffer(readback, framebuffer, attachment, x, y, width, height));
+}
+
+static PyObject* glib_map_readback(PyObject* self, PyObject* args) {
+    PyObject* readback_capsule;
+    int wait = 0;
+    if (!PyArg_ParseTuple(args, "O|p", &readback_capsule, &wait)) {
+        return NULL;
+    }
+
+    gl_readback* readback = capsule_to_readback(readback_capsule);
+    if (!readback) {
+        return NULL;
+    }
+    GLuint index = glapi_MapReadback(readback, wait);
+    if (index == READBACK_INVALID) {
+        Py_RETURN_NONE;
+    }
+
+    readback_frame* frame = PyObject_New(readback_frame, &readback_frame_type);
+    if (!frame) {
+        glapi_UnmapReadback(readback, index);
+        return NULL;
+    }
+    gl_readback_slot* slot = &readback->slots[index];
+    frame->readback = readback;
+    frame->slot = index;
+    frame->width = slot->width;
+    frame->height = slot->height;
+    frame->channels = readback->channels;
+    frame->frame = slot->frame;
+    frame->exports = 0;
+    frame->prev = NULL;
+    frame->next = readback_frames;
+    if (readback_frames)
+        readback_frames->prev = frame;
+    readback_frames = frame;
+    return (PyObject*)frame;
+}
+
+static PyObject* glib_readback_stats(PyObject* self, PyObject* args) {
+    PyObject* readback_capsule;
+    if (!PyArg_ParseTuple(args, "O", &readback_capsule)) {
+        return NULL;
+    }
+
+    gl_readback* readback = capsule_to_readback(readback_capsule);
+    if (!readback) {
+        return NULL;
+    }
+    Py_ssize_t pending = 0;
+    for (GLuint i = 0; i < readback->slot_count; i++)
+        pending += readback->slots[i].pending && !readback->slots[i].data;
+
+    return Py_BuildValue(
+        "{s:n,s:n,s:n,s:n,s:n}",
+        "issued", (Py_ssize_t)readback->issued,
+        "completed", (Py_ssize_t)readback->completed,
+        "dropped", (Py_ssize_t)readback->dropped,
+        "skipped", (Py_ssize_t)readback->skipped,
+        "pending", pending
+    );
+}
+
+static gl_batch_renderer* capsule_to_batch_renderer(PyObject* batch_capsule) {
+    gl_batch_renderer* batch = (gl_batch_renderer*)PyCapsule_GetPointer(batch_capsule, "gl_batch_renderer");
+    if (!batch) {
+        PyErr_SetString(PyExc_ValueError, "Invalid gl_batch_renderer pointer");
+        return NULL;
+    }
+    return batch;
+}
+
+static PyObject* glib_gen_batch_renderer(PyObject* self, PyObject* args) {
+    PyObject* app_capsule;
+    PyObject* outputs;
+    int width, height;
+    unsigned int depth_format = GL_DEPTH_COMPONENT24, slots = 0, writers = 4;
+    if (!PyArg_ParseTuple(args, "OiiO|III", &app_capsule, &width, &height, &outputs, &depth_format, &slots, &writers)) {
+        return NULL;
+    }
+
+    gl_app* app = (gl_app*)PyCapsule_GetPointer(app_capsule, "gl_app");
+    if (!app) {
+        PyErr_SetString(PyExc_ValueError, "Invalid gl_app pointer");
+        return NULL;
+    }
+    PyObject* fast = PySequence_Fast(outputs, "Expected a sequence of (name, format) outputs");
+    if (!fast) {
+        return NULL;
+    }
+    Py_ssize_t count = PySequence_Fast_GET_SIZE(fast);
+    if (count < 1 || count > RENDER_TARGET_MAX_COLOR) {
+        Py_DECREF(fast);
+        PyErr_Format(PyExc_ValueError, "Batch renderer takes 1 to %d outputs", RENDER_TARGET_MAX_COLOR);
+        return NULL;
+    }
+
+    gl_render_target_desc desc;
+    memset(&desc, 0, sizeof(gl_render_target_desc));
+    desc.width = width;
+    desc.height = height;
+    desc.samples = 1;
+    desc.color_count = (GLuint)count;
+    desc.depth_format = depth_format;
+    const char* names[RENDER_TARGET_MAX_COLOR];
+    for (Py_ssize_t i = 0; i < count; i++) {
+        if (!PyArg_ParseTuple(PySequence_Fast_GET_ITEM(fast, i), "sI", &names[i], &desc.color_formats[i])) {
+            Py_DECREF(fast);
+            return NULL;
+        }
+    }
+
+    gl_batch_renderer* batch = glapi_GenBatchRenderer(app, &desc, names, slots, writers);
+    Py_DECREF(fast);
+    if (!batch) {
+        PyErr_SetString(PyExc_RuntimeError, "Failed to create gl_batch_renderer");
+        return NULL;
+    }
+    return PyCapsule_New(batch, "gl_batch_renderer", NULL);
+}
+
+static PyObject* glib_batch_renderer_uniform(PyObject* self, PyObject* args) {
+    PyObject* batch_capsule;
+    const char* name;
+    unsigned int floats;
+    if (!PyArg_ParseTuple(args, "OsI", &batch_capsule, &name, &floats)) {
+        return NULL;
+    }
+
+    gl_batch_renderer* batch = capsule_to_batch_renderer(batch_capsule);
+    if (!batch) {
+        return NULL;
+    }
+    unsigned int type;
+    switch (floats) {
+        case 1: type = RENDER_UNIFORM_FLOAT; break;
+        case 2: type = RENDER_UNIFORM_VEC2; break;
+        case 3: type = RENDER_UNIFORM_VEC3; break;
+        case 4: type = RENDER_UNIFORM_VEC4; break;
+        case 9: type = RENDER_UNIFORM_MAT3; break;
+        case 16: type = RENDER_UNIFORM_MAT4; break;
+        default:
+            PyErr_SetString(PyExc_ValueError, "Batch uniforms take 1, 2, 3, 4, 9 or 16 floats");
+            return NULL;
+    }
+    if (!glapi_BatchRendererUniform(batch, name, type)) {
+        PyErr_SetString(PyExc_RuntimeError, "Failed to add batch uniform");
+        return NULL;
+    }
+    return PyLong_FromUnsignedLong(batch->param_count);
+}
+
+static PyObject* glib_batch_renderer_outputs(PyObject* self, PyObject* args) {
+    PyObject* batch_capsule;
+    if (!PyArg_ParseTuple(args, "O", &batch_capsule)) {
+        return NULL;
+    }
+
+    gl_batch_renderer* batch = capsule_to_batch_renderer(batch_capsule);
+    if (!batch) {
+        return NULL;
+    }
+    PyObject* outputs = PyList_New(batch->output_count);
+    if (!outputs) {
+        return NULL;
+    }
+    for (GLuint i = 0; i < batch->output_count; i++) {
+        gl_readback* readback = batch->outputs[i].readback;
+        const char* dtype = readback->type == GL_UNSIGNED_BYTE ? "u1" : readback->type == GL_UNSIGNED_SHORT ? "u2" : readback->type == GL_FLOAT ? "f4" : "u4";
+        PyList_SET_ITEM(outputs, i, Py_BuildValue("(s(iiI)s)", batch->outputs[i].name, batch->target->desc.height, batch->target->desc.width, readback->channels, dtype));
+    }
+    return outputs;
+}
+
+static bool batch_scene_callable(gl_batch_renderer* batch, size_t index, const float* params, void* user) {
+    PyGILState_STATE state = PyGILState_Ensure();
+    PyObject* result = PyObject_CallFunction((PyObject*)user, "n", (Py_ssize_t)index);
+    bool proceed = result != NULL && result != Py_False;
+    Py_XDECREF(result);
+    PyGILState_Release(state);
+    return proceed;
+}
+
+static PyObject* glib_batch_render(PyObject* self, PyObject* args) {
+    PyObject* batch_capsule;
+    PyObject* queue_capsule;
+    PyObject* params_obj;
+    PyObject* outputs = Py_None;
+    const char* directory = NULL;
+    Py_ssize_t first = 0;
+    PyObject* scene = Py_None;
+    if (!PyArg_ParseTuple(args, "OOO|OznO", &batch_capsule, &queue_capsule, &params_obj, &outputs, &directory, &first, &scene)) {
+        return NULL;
+    }
+
+    gl_batch_renderer* batch = capsule_to_batch_renderer(batch_capsule);
+    if (!batch) {
+        return NULL;
+    }
+    gl_render_queue* queue = NULL;
+    if (queue_capsule != Py_None && !(queue = capsule_to_render_queue(queue_capsule))) {
+        return NULL;
+    }
+    if (scene != Py_None && !PyCallable_Check(scene)) {
+        PyErr_SetString(PyExc_TypeError, "Batch scene must be callable");
+        return NULL;
+    }
+
+    Py_buffer params = {0};
+    size_t count = 0;
+    if (PyLong_Check(params_obj)) {
+        Py_ssize_t requested = PyLong_AsSsize_t(params_obj);
+        if (requested < 0) {
+            PyErr_SetString(PyExc_ValueError, "Batch count must be non-negative");
+            return NULL;
+        }
+        if (batch->param_count) {
+            PyErr_SetString(PyExc_ValueError, "Batch has uniforms, pass a float32 parameter buffer");
+            return NULL;
+        }
+        count = (size_t)requested;
+    } else {
+        if (PyObject_GetBuffer(params_obj, &params, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT) < 0) {
+            return NULL;
+        }
+        if (params.itemsize != sizeof(float) || !params.format || strcmp(params.format, "f") || !batch->param_count || params.len % (batch->param_count * sizeof(float))) {
+            PyBuffer_Release(&params);
+            PyErr_Format(PyExc_ValueError, "Batch parameters must be float32 rows of %u values", batch->param_count);
+            return NULL;
+        }
+        count = (size_t)params.len / (batch->param_count * sizeof(float));
+    }
+
+    Py_buffer views[RENDER_TARGET_MAX_COLOR];
+    GLuint view_count = 0;
+    bool ok = true;
+    for (GLuint i = 0; i < batch->output_count; i++)
+        glapi_SetBatchOutputMemory(batch, i, NULL);
+    if (outputs != Py_None) {
+        for (GLuint i = 0; i < batch->output_count && ok; i++) {
+            PyObject* array = PyMapping_GetItemString(outputs, batch->outputs[i].name);
+            if (!array) {
+                PyErr_Clear();
+                continue;
+            }
+            ok = PyObject_GetBuffer(array, &views[view_count], PyBUF_C_CONTIGUOUS | PyBUF_WRITABLE) == 0;
+            Py_DECREF(array);
+            if (!ok) {
+                break;
+            }
+            if ((size_t)views[view_count].len < count * batch->outputs[i].frame_size) {
+                PyErr_Format(PyExc_ValueError, "Output '%s' holds fewer than %zu frames", batch->outputs[i].name, count);
+                view_count++;
+                ok = false;
+                break;
+            }
+            glapi_SetBatchOutputMemory(batch, i, views[view_count++].buf);
+        }
+    }
+    if (ok && !glapi_SetBatchOutputDirectory(batch, directory)) {
+        PyErr_Format(PyExc_OSError, "Batch output directory '%s' is not writable", directory);
+        ok = false;
+    }
+
+    size_t rendered = 0;
+    if (ok) {
+        const float* data = params.buf ? (const float*)params.buf : NULL;
+        Py_BEGIN_ALLOW_THREADS
+        rendered = glapi_BatchRender(batch, queue, data, count, (size_t)first, scene != Py_None ? batch_scene_callable : NULL, scene);
+        Py_END_ALLOW_THREADS
+    }
+
+    for (GLuint i = 0; i < batch->output_count; i++)
+        glapi_SetBatchOutputMemory(batch, i, NULL);
+    glapi_SetBatchOutputDirectory(batch, NULL);
+    for (GLuint i = 0; i < view_count; i++)
+        PyBuffer_Release(&views[i]);
+    if (params.buf) {
+        PyBuffer_Release(&params);
+    }
+    if (!ok || PyErr_Occurred()) {
+        return NULL;
+    }
+    return PyLong_FromSize_t(rendered);
+}
+
+static PyObject* glib_batch_renderer_stats(PyObject* self, PyObject* args) {
+    PyObject* batch_capsule;
+    if (!PyArg_ParseTuple(args, "O", &batch_capsule)) {
+        return NULL;
+    }
+
+    gl_batch_renderer* batch = capsule_to_batch_renderer(batch_capsule);
+    if (!batch) {
+        return NULL;
+    }
+    return Py_BuildValue(
+        "{s:n,s:n,s:n,s:I}",
+        "rendered", (Py_ssize_t)batch->rendered,
+        "written", (Py_ssize_t)batch->written,
+        "failed", (Py_ssize_t)batch->failed,
+        "writers", batch->writer_count
+    );
+}
+
+static PyObject* glib_bind_frame_buffer_object(PyObject* self, PyObject* args) {
+    gl_framebuffer framebuffer;
+    if (!PyArg_ParseTuple(args, "i", &framebuffer)) {
+        PyErr_SetString(PyExc_ValueError, "Expected a tuple of type 'i' in glib_bind_frame_buffer_object");
+        return NULL;
+    }
+    glapi_BindFrameBufferObject(framebuffer);
+    Py_RETURN_NONE;
+}
+
+static PyObject* glib_unbind_frame_buffer_object(PyObject* self, PyObject* args) {
+    glapi_UnbindFrameBufferObject();
+    Py_RETURN_NONE;
+}
+
+static PyObject* glib_depth_test(PyObject* self, PyObject* args) {
+    int test;
+    if (!PyArg_ParseTuple(args, "i", &test)) {
+        PyErr_SetString(PyExc_ValueError, "Expected a bool in glib_depth_test");
+        return NULL;
+    }
+
+    if (test) {
+        glapi_EnableDepthTest();
+    } else {
+        glapi_DisableDepthTest();
+    }
+
+    Py_RETURN_NONE;
+}
+
+static PyObject* glib_get_window_width(PyObject* self, PyObject* args) {
+    PyObject* app_capsule;
+    if (!PyArg_ParseTuple(args, "O", &app_capsule)) {
+        return NULL;
+    }
+
+    gl_app* app = (gl_app*)PyCapsule_GetPointer(app_capsule, "gl_app");
+    if (!app) {
+        PyErr_SetString(PyExc_ValueError, "Invalid gl_app pointer");
+        return NULL;
+    }
+
+    return PyFloat_FromDouble((double)app->window->window_width);
+}  
+
+static PyObject* glib_get_window_height(PyObject* self, PyObject* args) {
+    PyObject* app_capsule;
+    if (!PyArg_ParseTuple(args, "O", &app_capsule)) {
+        return NULL;
+    }
+
+    gl_app* app = (gl_app*)PyCapsule_GetPointer(app_capsule, "gl_app");
+    if (!app) {
+        PyErr_SetString(PyExc_ValueError, "Invalid gl_app pointer");
+        return NULL;
+    }
+
+    return PyFloat_FromDouble((double)app->window->window_height);
+}
+
+static PyObject* glib_degs_to_rads(PyObject* self, PyObject* args) {
+    float val;
+    if (!PyArg_ParseTuple(args, "f", &val)) {
+        PyErr_SetString(PyExc_TypeError, "Expected a float value to convert");
+        return NULL;
+    }
+
+    return PyFloat_FromDouble((double)degs_to_rads(val));
+}
+
+static PyObject* glib_rads_to_degs(PyObject* self, PyObject* args) {
+    float val;
+    if (!PyArg_ParseTuple(args, "f", &val)) {
+        PyErr_SetString(PyExc_TypeError, "Expected a float value to convert");
+        return NULL;
+    }
+
+    return PyFloat_FromDouble((double)rads_to_degs(val));
+}
+
+static PyObject* glib_create_app(PyObject* self, PyObject* args) {
+    uint16_t window_width, window_height;
+    const char* title;
+    int resizable_int;
+    float r, g, b;
+    int headless = 0;
+
+    if (!PyArg_ParseTuple(args, "HHspfff|p", &window_width, &window_height, &title, &resizable_int, &r, &g, &b, &headless)) {
+        PyErr_SetString(PyExc_TypeError, "Invalid arguments for create_app");
+        return NULL;
+    }
+
+    bool resizable = (bool)resizable_int;
+    gl_app* app = headless ? glapi_CreateHeadlessApp(window_width, window_height, r, g, b) : glapi_CreateApp(window_width, window_height, title, resizable, r, g, b);
+    if (!app) {
+        PyErr_SetString(PyExc_RuntimeError, "Failed to create gl_app");
+        return NULL;
+    }
+
+    return PyCapsule_New(app, "gl_app", NULL);
+}
+
+static PyObject* glib_bind_app(PyObject* self, PyObject* args) {
+    PyObject* app_capsule;
+    if (!PyArg_ParseTuple(args, "O", &app_capsule)) {
+        return NULL;
+    }
+
+    gl_app* app = (gl_app*)PyCapsule_GetPointer(app_capsule, "gl_app");
+    if (!app) {
+        PyErr_SetString(PyExc_ValueError, "Invalid gl_app pointer");
+        return NULL;
+    }
+
+    glapi_BindApp(app);
+    Py_RETURN_NONE;
+}
+
+static PyObject* glib_unbind_app(PyObject* self, PyObject* args) {
+    PyObject* app_capsule;
+    if (!PyArg_ParseTuple(args, "O", &app_capsule)) {
+        return NULL;
+    }
+
+    gl_app* app = (gl_app*)PyCapsule_GetPointer(app_capsule, "gl_app");
+    if (!app) {
+        PyErr_SetString(PyExc_ValueError, "Invalid gl_app pointer");
+        return NULL;
+    }
+
+    glapi_UnbindApp(app);
+    Py_RETURN_NONE;
+}
+
+static PyObject* glib_destroy_app(PyObject* self, PyObject* args) {
+    PyObject* app_capsule;
+    if (!PyArg_ParseTuple(args, "O", &app_capsule)) {
+        return NULL;
+    }
+
+    gl_app* app = (gl_app*)PyCapsule_GetPointer(app_capsule, "gl_app");
+    if (!app) {
+        PyErr_SetString(PyExc_ValueError, "Invalid gl_app pointer");
+        return NULL;
+    }
+
+    if (readback_frames_exported(app)) {
+        PyErr_SetString(PyExc_BufferError, "Readback frame is still exported");
+        return NULL;
+    }
+    readback_frames_release_app(app);
+    glapi_DestroyApp(app);
+    Py_RETURN_NONE;
+}
+
+static PyObject* glib_should_app_close(PyObject* self, PyObject* args) {
+    PyObject* app_capsule;
+    if (!PyArg_ParseTuple(args, "O", &app_capsule)) {
+        return NULL;
+    }
+
+    gl_app* app = (gl_app*)PyCapsule_GetPointer(app_capsule, "gl_app");
+    if (!app) {
+        PyErr_SetString(PyExc_ValueError, "Invalid gl_app pointer");
+        return NULL;
+    }
+
+    int should_close = glapi_ShouldAppClose(app);
+    return PyBool_FromLong(should_close);
+}
+
+static PyObject* glib_request_app_close(PyObject* self, PyObject* args) {
+    PyObject* app_capsule;
+    if (!PyArg_ParseTuple(args, "O", &app_capsule)) {
+        return NULL;
+    }
+
+    gl_app* app = (gl_app*)PyCapsule_GetPointer(app_capsule, "gl_app");
+    if (!app) {
+        PyErr_SetString(PyExc_ValueError, "Invalid gl_app pointer");
+        return NULL;
+    }
+
+    glapi_RequestAppClose(app);
+    Py_RETURN_NONE;
+}
+
+static PyObject* glib_set_swap_interval(PyObject* self, PyObject* args) {
+    PyObject* app_capsule;
+    int interval;
+    if (!PyArg_ParseTuple(args, "Oi", &app_capsule, &interval)) {
+        return NULL;
+    }
+
+    gl_app* app = (gl_app*)PyCapsule_GetPointer(app_capsule, "gl_app");
+    if (!app) {
+        PyErr_SetString(PyExc_ValueError, "Invalid gl_app pointer");
+        return NULL;
+    }
+    return PyBool_FromLong(glapi_SetSwapInterval(app, interval));
+}
+
+static PyObject* glib_get_swap_interval(PyObject* self, PyObject* args) {
+    PyObject* app_capsule;
+    if (!PyArg_ParseTuple(args, "O", &app_capsule)) {
+        return NULL;
+    }
+
+    gl_app* app = (gl_app*)PyCapsule_GetPointer(app_capsule, "gl_app");
+    if (!app) {
+        PyErr_SetString(PyExc_ValueError, "Invalid gl_app pointer");
+        return NULL;
+    }
+    return PyLong_FromLong(glapi_SwapInterval(app));
+}
+
+static PyObject* glib_set_frame_cap(PyObject* self, PyObject* args) {
+    PyObject* app_capsule;
+    double fps;
+    if (!PyArg_ParseTuple(args, "Od", &app_capsule, &fps)) {
+        return NULL;
+    }
+
+    gl_app* app = (gl_app*)PyCapsule_GetPointer(app_capsule, "gl_app");
+    if (!app) {
+        PyErr_SetString(PyExc_ValueError, "Invalid gl_app pointer");
+        return NULL;
+    }
+    glapi_SetFrameCap(app, fps);
+    Py_RETURN_NONE;
+}
+
+static PyObject* glib_frame_stats(PyObject* self, PyObject* args) {
+    PyObject* app_capsule;
+    if (!PyArg_ParseTuple(args, "O", &app_capsule)) {
+        return NULL;
+    }
+
+    gl_app* app = (gl_app*)PyCapsule_GetPointer(app_capsule, "gl_app");
+    if (!app) {
+        PyErr_SetString(PyExc_ValueError, "Invalid gl_app pointer");
+        return NULL;
+    }
+    gl_frame_stats stats;
+    if (!glapi_FrameStats(app, &stats)) {
+        Py_RETURN_NONE;
+    }
+
+    const double* edges = glapi_FrameHistogramEdges();
+    PyObject* histogram = PyList_New(FRAME_PACER_BUCKETS);
+    if (!histogram) {
+        return NULL;
+    }
+    for (GLuint i = 0; i < FRAME_PACER_BUCKETS; i++) {
+        double upper = i < FRAME_PACER_BUCKETS - 1 ? edges[i] : Py_HUGE_VAL;
+        PyList_SET_ITEM(histogram, i, Py_BuildValue("(dn)", upper, (Py_ssize_t)stats.histogram[i]));
+    }
+
+    return Py_BuildValue(
+        "{s:n,s:K,s:n,s:d,s:d,s:d,s:d,s:d,s:d,s:d,s:N,s:n,s:d,s:d,s:d,s:d,s:d,s:I}",
+        "count", (Py_ssize_t)stats.count,
+        "frames", (unsigned long long)stats.frames,
+        "missed", (Py_ssize_t)stats.missed,
+        "mean_ms", stats.mean_ms,
+        "min_ms", stats.min_ms,
+        "max_ms", stats.max_ms,
+        "p50_ms", stats.p50_ms,
+        "p95_ms", stats.p95_ms,
+        "p99_ms", stats.p99_ms,
+        "fps", stats.fps,
+        "histogram", histogram,
+        "latency_count", (Py_ssize_t)stats.latency_count,
+        "latency_mean_ms", stats.latency_mean_ms,
+        "latency_p50_ms", stats.latency_p50_ms,
+        "latency_p99_ms", stats.latency_p99_ms,
+        "latency_max_ms", stats.latency_max_ms,
+        "wait_mean_ms", stats.wait_mean_ms,
+        "in_flight", stats.in_flight
+    );
+}
+
+static PyObject* glib_reset_frame_stats(PyObject* self, PyObject* args) {
+    PyObject* app_capsule;
+    if (!PyArg_ParseTuple(args, "O", &app_capsule)) {
+        return NULL;
+    }
+
+    gl_app* app = (gl_app*)PyCapsule_GetPointer(app_capsule, "gl_app");
+    if (!app) {
+        PyErr_SetString(PyExc_ValueError, "Invalid gl_app pointer");
+        return NULL;
+    }
+    glapi_ResetFrameStats(app);
+    Py_RETURN_NONE;
+}
+
+static PyObject* glib_set_max_frames_in_flight(PyObject* self, PyObject* args) {
+    PyObject* app_capsule;
+    unsigned int frames;
+    if (!PyArg_ParseTuple(args, "OI", &app_capsule, &frames)) {
+        return NULL;
+    }
+
+    gl_app* app = (gl_app*)PyCapsule_GetPointer(app_capsule, "gl_app");
+    if (!app) {
+        PyErr_SetString(PyExc_ValueError, "Invalid gl_app pointer");
+        return NULL;
+    }
+    glapi_SetMaxFramesInFlight(app, frames);
+    return PyLong_FromUnsignedLong(glapi_MaxFramesInFlight(app));
+}
+
+static bool late_latch_callable(gl_app* app, void* data, size_t size, void* user) {
+    PyGILState_STATE state = PyGILState_Ensure();
+    bool updated = false;
+    PyObject* result = PyObject_CallNoArgs((PyObject*)user);
+    if (result && result != Py_None) {
+        Py_buffer view;
+        if (PyObject_CheckBuffer(result) && PyObject_GetBuffer(result, &view, PyBUF_C_CONTIGUOUS) == 0) {
+            memcpy(data, view.buf, (size_t)view.len < size ? (size_t)view.len : size);
+            PyBuffer_Release(&view);
+            updated = true;
+        } else if (!PyErr_Occurred()) {
+            PyObject* fast = PySequence_Fast(result, "Late latch callable must return a buffer or a sequence of floats");
+            if (fast) {
+                Py_ssize_t count = PySequence_Fast_GET_SIZE(fast);
+                if ((size_t)count * sizeof(float) > size)
+                    count = (Py_ssize_t)(size / sizeof(float));
+                for (Py_ssize_t i = 0; i < count; i++)
+                    ((float*)data)[i] = (float)PyFloat_AsDouble(PySequence_Fast_GET_ITEM(fast, i));
+                Py_DECREF(fast);
+                updated = !PyErr_Occurred();
+            }
+        }
+    }
+    Py_XDECREF(result);
+    if (PyErr_Occurred()) {
+        PyErr_WriteUnraisable((PyObject*)user);
+    }
+    PyGILState_Release(state);
+    return updated;
+}
+
+static void late_latch_release(void* user) {
+    Py_DECREF((PyObject*)user);
+}
+
+static PyObject* glib_set_late_latch(PyObject* self, PyObject* args) {
+    PyObject* app_capsule;
+    unsigned int binding;
+    Py_ssize_t size;
+    PyObject* update;
+    if (!PyArg_ParseTuple(args, "OInO", &app_capsule, &binding, &size, &update)) {
+        return NULL;
+    }
+
+    gl_app* app = (gl_app*)PyCapsule_GetPointer(app_capsule, "gl_app");
+    if (!app) {
+        PyErr_SetString(PyExc_ValueError, "Invalid gl_app pointer");
+        return NULL;
+    }
+    if (update != Py_None && !PyCallable_Check(update)) {
+        PyErr_SetString(PyExc_TypeError, "Late latch update must be callable or None");
+        return NULL;
+    }
+    if (update == Py_None) {
+        glapi_SetLateLatch(app, binding, 0, NULL, NULL, NULL);
+        Py_RETURN_NONE;
+    }
+    if (size <= 0 || !glapi_SetLateLatch(app, binding, (size_t)size, late_latch_callable, update, late_latch_release)) {
+        PyErr_SetString(PyExc_RuntimeError, "Failed to set late latch");
+        return NULL;
+    }
+    Py_INCREF(update);
+    Py_RETURN_NONE;
+}
+
+static PyObject* glib_latch_frame(PyObject* self, PyObject* args) {
+    PyObject* app_capsule;
+    if (!PyArg_ParseTuple(args, "O", &app_capsule)) {
+        return NULL;
+    }
+
+    gl_app* app = (gl_app*)PyCapsule_GetPointer(app_capsule, "gl_app");
+    if (!app) {
+        PyErr_SetString(PyExc_ValueError, "Invalid gl_app pointer");
+        return NULL;
+    }
+    return PyBool_FromLong(glapi_LatchFrame(app));
+}
+
+static PyObject* glib_bind_vertex_buffer_object(PyObject* self, PyObject* args) {
+    GLuint vao;
+    if (!PyArg_ParseTuple(args, "I", &vao)) {
+        return NULL;
+    }
+
+    glapi_BindVertexBufferObject(vao);
+    Py_RETURN_NONE;
+}
+
+static PyObject* glib_unbind_vertex_buffer_object(PyObject* self, PyObject* args) {
+    glapi_UnbindVertexBufferObject();
+    Py_RETURN_NONE;
+}
+
+static PyObject* glib_bind_shader(PyObject* self, PyObject* args) {
+    GLuint shader;
+    if (!PyArg_ParseTuple(args, "I", &shader)) {
+        return NULL;
+    }
+
+    glapi_BindShader(shader);
+    Py_RETURN_NONE;
+}
+
+static PyObject* glib_unbind_shader(PyObject* self, PyObject* args) {
+    glapi_UnbindShader();
+    Py_RETURN_NONE;
+}
+
+static PyObject* glib_draw_vertex_buffer_object(PyObject* self, PyObject* args) {
+    Py_ssize_t index_count;
+    if (!PyArg_ParseTuple(args, "n", &index_count)) {
+        return NULL;
+    }
+
+    glapi_DrawVertexBufferObject((size_t)index_count);
+    Py_RETURN_NONE;
+}
+
+static PyObject* glib_gen_shader_program_f(PyObject* self, PyObject* args) {
+    PyObject* app_capsule;
+    const char* v_fpath;
+    const char* f_fpath;
+    if (!PyArg_ParseTuple(args, "Oss", &app_capsule, &v_fpath, &f_fpath)) {
+        return NULL;
+    }
+
+    gl_app* app = (gl_app*)PyCapsule_GetPointer(app_capsule, "gl_app");
+    if (!app) {
+        PyErr_SetString(PyExc_ValueError, "Invalid gl_app pointer");
+        return NULL;
+    }
+
+    GLuint shader;
+    shader = glapi_GenShaderProgram_f(app, v_fpath, f_fpath, &shader);
+    if (!shader) {
+        PyErr_SetString(PyExc_RuntimeError, "Failed to create shader program");
+        return NULL;
+    }
+
+    return PyLong_FromUnsignedLong(shader);
+}
 
-    if (pos_len % 3 != 0) {
-        PyErr_SetString(PyExc_ValueError, "Positions sequence size must be a multiple of 3");
+static PyObject* glib_gen_shader_program_s(PyObject* self, PyObject* args) {
+    PyObject* app_capsule;
+    const char* v_source;
+    const char* f_source;
+    if (!PyArg_ParseTuple(args, "Oss", &app_capsule, &v_source, &f_source)) {
         return NULL;
     }
-    if (idx_len % 3 != 0) {
-        PyErr_SetString(PyExc_ValueError, "Indices sequence size must be a multiple of 3");
+
+    gl_app* app = (gl_app*)PyCapsule_GetPointer(app_capsule, "gl_app");
+    if (!app) {
+        PyErr_SetString(PyExc_ValueError, "Invalid gl_app pointer");
         return NULL;
     }
-    if (uvs_len > 0 && uvs_len % 2 != 0) {
-        PyErr_SetString(PyExc_ValueError, "UVs sequence size must be a multiple of 2");
+
+    GLuint shader;
+    shader = glapi_GenShaderProgram_s(app, v_source, f_source, &shader);
+    if (!shader) {
+        PyErr_SetString(PyExc_RuntimeError, "Failed to create shader program");
         return NULL;
     }
-    if (norm_len > 0 && norm_len % 3 != 0) {
-        PyErr_SetString(PyExc_ValueError, "Normals sequence size must be a multiple of 3");
+
+    return PyLong_FromUnsignedLong(shader);
+}
+
+static PyObject* glib_acquire_shader_program_f(PyObject* self, PyObject* args) {
+    PyObject *app_capsule, *defines_obj = NULL, *fast = NULL;
+    const char* v_fpath;
+    const char* f_fpath;
+    if (!PyArg_ParseTuple(args, "Oss|O", &app_capsule, &v_fpath, &f_fpath, &defines_obj)) {
         return NULL;
     }
 
-    float* pos_data = (float*)malloc(pos_len * sizeof(float));
-    GLuint* idx_data = (GLuint*)malloc(idx_len * sizeof(GLuint));
-    float* uvs_data = uvs_len > 0 ? (float*)malloc(uvs_len * sizeof(float)) : NULL;
-    float* norm_data = norm_len > 0 ? (float*)malloc(norm_len * sizeof(float)) : NULL;
-
-    if (!pos_data || !idx_data || (uvs_len > 0 && !uvs_data) || (norm_len > 0 && !norm_data)) {
-        free(pos_data);
-        free(idx_data);
-        free(uvs_data);
-        free(norm_data);
-        PyErr_SetString(PyExc_MemoryError, "Failed to allocate memory");
+    gl_app* app = (gl_app*)PyCapsule_GetPointer(app_capsule, "gl_app");
+    if (!app) {
+        PyErr_SetString(PyExc_ValueError, "Invalid gl_app pointer");
         return NULL;
     }
 
-    for (Py_ssize_t i = 0; i < pos_len; i++) {
-        PyObject* item = PySequence_GetItem(positions, i);
-        if (!PyFloat_Check(item)) {
-            free(pos_data);
-            free(idx_data);
-            free(uvs_data);
-            free(norm_data);
-            PyErr_SetString(PyExc_TypeError, "Positions must contain floats");
-            Py_DECREF(item);
+    size_t define_count = 0;
+    const char** defines = NULL;
+    if (defines_obj && defines_obj != Py_None) {
+        defines = sequence_to_strings(defines_obj, &fast, &define_count);
+        if (!defines) {
             return NULL;
         }
-        pos_data[i] = (float)PyFloat_AsDouble(item);
-        Py_DECREF(item);
     }
 
-    for (Py_ssize_t i = 0; i < idx_len; i++) {
-        PyObject* item = PySequence_GetItem(indices, i);
-        if (!PyLong_Check(item)) {
-            free(pos_data);
-            free(idx_data);
-            free(uvs_data);
-            free(norm_data);
-            PyErr_SetString(PyExc_TypeError, "Indices must contain integers");
-            Py_DECREF(item);
-            return NULL;
-        }
-        idx_data[i] = (GLuint)PyLong_AsUnsignedLong(item);
-        Py_DECREF(item);
+    GLuint shader = glapi_AcquireShaderProgram_f(app, v_fpath, f_fpath, defines, define_count);
+    free(defines);
+    Py_XDECREF(fast);
+    if (!shader) {
+        PyErr_SetString(PyExc_RuntimeError, "Failed to create shader program");
+        return NULL;
     }
 
-    if (uvs_len > 0) {
-        for (Py_ssize_t i = 0; i < uvs_len; i++) {
-            PyObject* item = PySequence_GetItem(uvs, i);
-            if (!PyFloat_Check(item)) {
-                free(pos_data);
-                free(idx_data);
-                free(uvs_data);
-                free(norm_data);
-                PyErr_SetString(PyExc_TypeError, "UVs must contain floats");
-                Py_DECREF(item);
-                return NULL;
-            }
-            uvs_data[i] = (float)PyFloat_AsDouble(item);
-            Py_DECREF(item);
-        }
+    return PyLong_FromUnsignedLong(shader);
+}
+
+static PyObject* glib_preprocess_shader(PyObject* self, PyObject* args) {
+    PyObject *defines_obj = NULL, *fast = NULL;
+    const char* fpath;
+    if (!PyArg_ParseTuple(args, "s|O", &fpath, &defines_obj)) {
+        return NULL;
     }
 
-    if (norm_len > 0) {
-        for (Py_ssize_t i = 0; i < norm_len; i++) {
-            PyObject* item = PySequence_GetItem(normals, i);
-            if (!PyFloat_Check(item)) {
-                free(pos_data);
-                free(idx_data);
-                free(uvs_data);
-                free(norm_data);
-                PyErr_SetString(PyExc_TypeError, "Normals must contain floats");
-                Py_DECREF(item);
-                return NULL;
-            }
-            norm_data[i] = (float)PyFloat_AsDouble(item);
-            Py_DECREF(item);
+    size_t define_count = 0;
+    const char** defines = NULL;
+    if (defines_obj && defines_obj != Py_None) {
+        defines = sequence_to_strings(defines_obj, &fast, &define_count);
+        if (!defines) {
+            return NULL;
         }
     }
 
-    gl_mesh mesh = {0};
-    mesh.positions = pos_data;
-    mesh.indices = idx_data;
-    mesh.positions_size = pos_len * sizeof(float);
-    mesh.indices_size = idx_len * sizeof(GLuint);
-    mesh.uvs = uvs_data;
-    mesh.uvs_size = uvs_len * sizeof(float);
-    mesh.normals = norm_data;
-    mesh.normals_size = norm_len * sizeof(float);
-
-    GLuint vao_address;
-    GLuint vao = glapi_GenVertexBufferObjectFromMesh(app, &mesh, &vao_address);
-
-    free(pos_data);
-    free(idx_data);
-    free(uvs_data);
-    free(norm_data);
-
-    if (!vao) {
-        PyErr_SetString(PyExc_RuntimeError, "Failed to generate vertex buffer object");
+    char* source = glapi_PreprocessShaderFile(fpath, defines, define_count);
+    free(defines);
+    Py_XDECREF(fast);
+    if (!source) {
+        PyErr_SetString(PyExc_IOError, "Failed to preprocess shader");
         return NULL;
     }
 
-    return PyLong_FromUnsignedLong(vao);
+    PyObject* result = PyUnicode_FromString(source);
+    free(source);
+    return result;
 }
 
-static PyObject* glib_gen_frame_buffer_object(PyObject* self, PyObject* args) {
+static PyObject* glib_acquire_shader_program_s(PyObject* self, PyObject* args) {
     PyObject* app_capsule;
-    int out_tex, width, height;
-
-    if (!PyArg_ParseTuple(args, "Oiii", &app_capsule, &out_tex, &width, &height)) {
-        PyErr_SetString(PyExc_ValueError, "Expected a tuple of type 'Oiii' (app_capsule, out_tex, width, height)");
+    const char* v_source;
+    const char* f_source;
+    if (!PyArg_ParseTuple(args, "Oss", &app_capsule, &v_source, &f_source)) {
         return NULL;
     }
 
@@ -394,51 +3299,35 @@ static PyObject* glib_gen_frame_buffer_object(PyObject* self, PyObject* args) {
         return NULL;
     }
 
-    GLuint fb_address;
-    GLuint framebuffer = glapi_GenFrameBuffer(app, out_tex, &fb_address, width, height);
-
-    if (!framebuffer) {
-        PyErr_SetString(PyExc_RuntimeError, "Failed to generate frame buffer object");
+    GLuint shader = glapi_AcquireShaderProgram_s(app, v_source, f_source);
+    if (!shader) {
+        PyErr_SetString(PyExc_RuntimeError, "Failed to create shader program");
         return NULL;
     }
 
-    return PyLong_FromUnsignedLong(framebuffer);
+    return PyLong_FromUnsignedLong(shader);
 }
 
-static PyObject* glib_bind_frame_buffer_object(PyObject* self, PyObject* args) {
-    gl_framebuffer framebuffer;
-    if (!PyArg_ParseTuple(args, "i", &framebuffer)) {
-        PyErr_SetString(PyExc_ValueError, "Expected a tuple of type 'i' in glib_bind_frame_buffer_object");
+static PyObject* glib_release_shader_program(PyObject* self, PyObject* args) {
+    PyObject* app_capsule;
+    GLuint object;
+    if (!PyArg_ParseTuple(args, "OI", &app_capsule, &object)) {
         return NULL;
     }
-    glapi_BindFrameBufferObject(framebuffer);
-    Py_RETURN_NONE;
-}
-
-static PyObject* glib_unbind_frame_buffer_object(PyObject* self, PyObject* args) {
-    glapi_UnbindFrameBufferObject();
-    Py_RETURN_NONE;
-}
 
-static PyObject* glib_depth_test(PyObject* self, PyObject* args) {
-    int test;
-    if (!PyArg_ParseTuple(args, "i", &test)) {
-        PyErr_SetString(PyExc_ValueError, "Expected a bool in glib_depth_test");
+    gl_app* app = (gl_app*)PyCapsule_GetPointer(app_capsule, "gl_app");
+    if (!app) {
+        PyErr_SetString(PyExc_ValueError, "Invalid gl_app pointer");
         return NULL;
     }
 
-    if (test) {
-        glapi_EnableDepthTest();
-    } else {
-        glapi_DisableDepthTest();
-    }
-
-    Py_RETURN_NONE;
+    return PyLong_FromSize_t(glapi_ReleaseShaderProgram(app, object));
 }
 
-static PyObject* glib_get_window_width(PyObject* self, PyObject* args) {
+static PyObject* glib_release_texture(PyObject* self, PyObject* args) {
     PyObject* app_capsule;
-    if (!PyArg_ParseTuple(args, "O", &app_capsule)) {
+    GLuint object;
+    if (!PyArg_ParseTuple(args, "OI", &app_capsule, &object)) {
         return NULL;
     }
 
@@ -448,10 +3337,10 @@ static PyObject* glib_get_window_width(PyObject* self, PyObject* args) {
         return NULL;
     }
 
-    return PyFloat_FromDouble((double)app->window->window_width);
-}  
+    return PyLong_FromSize_t(glapi_ReleaseTexture(app, object));
+}
 
-static PyObject* glib_get_window_height(PyObject* self, PyObject* args) {
+static PyObject* glib_asset_cache_stats(PyObject* self, PyObject* args) {
     PyObject* app_capsule;
     if (!PyArg_ParseTuple(args, "O", &app_capsule)) {
         return NULL;
@@ -463,53 +3352,101 @@ static PyObject* glib_get_window_height(PyObject* self, PyObject* args) {
         return NULL;
     }
 
-    return PyFloat_FromDouble((double)app->window->window_height);
-}
-
-static PyObject* glib_degs_to_rads(PyObject* self, PyObject* args) {
-    float val;
-    if (!PyArg_ParseTuple(args, "f", &val)) {
-        PyErr_SetString(PyExc_TypeError, "Expected a float value to convert");
-        return NULL;
+    size_t textures = 0, shaders = 0, references = 0, hits = 0, misses = 0;
+    if (app->assets) {
+        for (size_t i = 0; i < app->assets->count; i++) {
+            if (app->assets->assets[i].kind == ASSET_TEXTURE)
+                textures++;
+            else
+                shaders++;
+            references += app->assets->assets[i].refs;
+        }
+        hits = app->assets->hits;
+        misses = app->assets->misses;
     }
 
-    return PyFloat_FromDouble((double)degs_to_rads(val));
+    return Py_BuildValue("{s:n,s:n,s:n,s:n,s:n}",
+        "textures", (Py_ssize_t)textures,
+        "shaders", (Py_ssize_t)shaders,
+        "references", (Py_ssize_t)references,
+        "hits", (Py_ssize_t)hits,
+        "misses", (Py_ssize_t)misses);
 }
 
-static PyObject* glib_rads_to_degs(PyObject* self, PyObject* args) {
-    float val;
-    if (!PyArg_ParseTuple(args, "f", &val)) {
-        PyErr_SetString(PyExc_TypeError, "Expected a float value to convert");
+static PyObject* glib_build_shader_programs(PyObject* self, PyObject* args) {
+    PyObject *app_capsule, *sources_obj;
+    if (!PyArg_ParseTuple(args, "OO", &app_capsule, &sources_obj)) {
         return NULL;
     }
 
-    return PyFloat_FromDouble((double)rads_to_degs(val));
-}
-
-static PyObject* glib_create_app(PyObject* self, PyObject* args) {
-    uint16_t window_width, window_height;
-    const char* title;
-    int resizable_int;
-    float r, g, b;
-
-    if (!PyArg_ParseTuple(args, "HHspfff", &window_width, &window_height, &title, &resizable_int, &r, &g, &b)) {
-        PyErr_SetString(PyExc_TypeError, "Invalid arguments for create_app");
+    gl_app* app = (gl_app*)PyCapsule_GetPointer(app_capsule, "gl_app");
+    if (!app) {
+        PyErr_SetString(PyExc_ValueError, "Invalid gl_app pointer");
         return NULL;
     }
 
-    bool resizable = (bool)resizable_int;
-    gl_app* app = glapi_CreateApp(window_width, window_height, title, resizable, r, g, b);
-    if (!app) {
-        PyErr_SetString(PyExc_RuntimeError, "Failed to create gl_app");
+    PyObject* sources = PySequence_Fast(sources_obj, "Expected a sequence of (vertex, fragment) source pairs");
+    if (!sources) {
+        return NULL;
+    }
+    Py_ssize_t count = PySequence_Fast_GET_SIZE(sources);
+    if (!count) {
+        Py_DECREF(sources);
+        return PyList_New(0);
+    }
+    gl_program_build* builds = (gl_program_build*)calloc((size_t)count, sizeof(gl_program_build));
+    PyObject** pairs = (PyObject**)calloc((size_t)count, sizeof(PyObject*));
+    if (!builds || !pairs) {
+        free(builds);
+        free(pairs);
+        Py_DECREF(sources);
+        return PyErr_NoMemory();
+    }
+    bool parsed = true;
+    for (Py_ssize_t i = 0; parsed && i < count; i++) {
+        pairs[i] = PySequence_Fast(PySequence_Fast_GET_ITEM(sources, i), "Each program must be a (vertex, fragment) source pair");
+        parsed = pairs[i] && PySequence_Fast_GET_SIZE(pairs[i]) == 2;
+        if (pairs[i] && !parsed)
+            PyErr_SetString(PyExc_ValueError, "Each program must be a (vertex, fragment) source pair");
+        if (parsed) {
+            builds[i].v_source = PyUnicode_AsUTF8(PySequence_Fast_GET_ITEM(pairs[i], 0));
+            builds[i].f_source = builds[i].v_source ? PyUnicode_AsUTF8(PySequence_Fast_GET_ITEM(pairs[i], 1)) : NULL;
+            parsed = builds[i].f_source != NULL;
+        }
+    }
+    if (!parsed) {
+        for (Py_ssize_t i = 0; i < count; i++)
+            Py_XDECREF(pairs[i]);
+        free(pairs);
+        free(builds);
+        Py_DECREF(sources);
         return NULL;
     }
 
-    return PyCapsule_New(app, "gl_app", NULL);
+    glapi_GenShaderPrograms(app, builds, (size_t)count);
+
+    PyObject* result = PyList_New(count);
+    for (Py_ssize_t i = 0; result && i < count; i++) {
+        PyObject* item = Py_BuildValue("(Iz)", builds[i].program, builds[i].log);
+        if (!item) {
+            Py_CLEAR(result);
+            break;
+        }
+        PyList_SET_ITEM(result, i, item);
+    }
+    glapi_FreeProgramBuildLogs(builds, (size_t)count);
+    for (Py_ssize_t i = 0; i < count; i++)
+        Py_DECREF(pairs[i]);
+    free(pairs);
+    free(builds);
+    Py_DECREF(sources);
+    return result;
 }
 
-static PyObject* glib_bind_app(PyObject* self, PyObject* args) {
+static PyObject* glib_set_program_cache_dir(PyObject* self, PyObject* args) {
     PyObject* app_capsule;
-    if (!PyArg_ParseTuple(args, "O", &app_capsule)) {
+    const char* directory;
+    if (!PyArg_ParseTuple(args, "Os", &app_capsule, &directory)) {
         return NULL;
     }
 
@@ -519,11 +3456,10 @@ static PyObject* glib_bind_app(PyObject* self, PyObject* args) {
         return NULL;
     }
 
-    glapi_BindApp(app);
-    Py_RETURN_NONE;
+    return PyBool_FromLong(glapi_SetProgramCacheDirectory(app, directory));
 }
 
-static PyObject* glib_unbind_app(PyObject* self, PyObject* args) {
+static PyObject* glib_program_cache_stats(PyObject* self, PyObject* args) {
     PyObject* app_capsule;
     if (!PyArg_ParseTuple(args, "O", &app_capsule)) {
         return NULL;
@@ -535,13 +3471,20 @@ static PyObject* glib_unbind_app(PyObject* self, PyObject* args) {
         return NULL;
     }
 
-    glapi_UnbindApp(app);
-    Py_RETURN_NONE;
+    gl_program_cache* cache = app->programs;
+    return Py_BuildValue("{s:O,s:n,s:n,s:n}",
+        "enabled", cache && cache->directory ? Py_True : Py_False,
+        "hits", (Py_ssize_t)(cache ? cache->hits : 0),
+        "misses", (Py_ssize_t)(cache ? cache->misses : 0),
+        "rejected", (Py_ssize_t)(cache ? cache->rejected : 0));
 }
 
-static PyObject* glib_destroy_app(PyObject* self, PyObject* args) {
+static PyObject* glib_gen_texture_from_fpath(PyObject* self, PyObject* args) {
     PyObject* app_capsule;
-    if (!PyArg_ParseTuple(args, "O", &app_capsule)) {
+    const char* fpath;
+    GLenum internal_format = GL_RGBA8;
+    unsigned int mips = TEXTURE_MIPS_GPU;
+    if (!PyArg_ParseTuple(args, "Os|II", &app_capsule, &fpath, &internal_format, &mips)) {
         return NULL;
     }
 
@@ -551,13 +3494,27 @@ static PyObject* glib_destroy_app(PyObject* self, PyObject* args) {
         return NULL;
     }
 
-    glapi_DestroyApp(app);
-    Py_RETURN_NONE;
+    GLuint texture;
+    if (strcmp("", fpath))
+        texture = glapi_AcquireTextureFromFpath(app, fpath, internal_format, mips);
+    else
+        texture = glapi_GenTextureFromFpathFormat(app, fpath, internal_format, mips, NULL);
+    if (!texture) {
+        PyErr_SetString(PyExc_IOError, "Failed to load texture");
+        return NULL;
+    }
+
+    return PyLong_FromUnsignedLong(texture);
 }
 
-static PyObject* glib_should_app_close(PyObject* self, PyObject* args) {
-    PyObject* app_capsule;
-    if (!PyArg_ParseTuple(args, "O", &app_capsule)) {
+static PyObject* glib_gen_texture(PyObject* self, PyObject* args) {
+    PyObject *app_capsule, *data_obj = Py_None;
+    gl_texture_desc desc;
+    memset(&desc, 0, sizeof(gl_texture_desc));
+    desc.internal_format = GL_RGBA8;
+    desc.mips = TEXTURE_MIPS_GPU;
+    if (!PyArg_ParseTuple(args, "Oii|OIIi", &app_capsule, &desc.width, &desc.height, &data_obj, &desc.internal_format, &desc.mips, &desc.levels)) {
+        PyErr_SetString(PyExc_TypeError, "Expected app, width, height, [data, internal_format, mips, levels]");
         return NULL;
     }
 
@@ -567,55 +3524,46 @@ static PyObject* glib_should_app_close(PyObject* self, PyObject* args) {
         return NULL;
     }
 
-    int should_close = glapi_ShouldAppClose(app);
-    return PyBool_FromLong(should_close);
-}
-
-static PyObject* glib_bind_vertex_buffer_object(PyObject* self, PyObject* args) {
-    GLuint vao;
-    if (!PyArg_ParseTuple(args, "I", &vao)) {
+    GLsizei texel_size = glapi_TextureTexelSize(desc.internal_format);
+    if (!texel_size) {
+        PyErr_SetString(PyExc_ValueError, "Unsupported texture internal format");
         return NULL;
     }
-
-    glapi_BindVertexBufferObject(vao);
-    Py_RETURN_NONE;
-}
-
-static PyObject* glib_unbind_vertex_buffer_object(PyObject* self, PyObject* args) {
-    glapi_UnbindVertexBufferObject();
-    Py_RETURN_NONE;
-}
-
-static PyObject* glib_bind_shader(PyObject* self, PyObject* args) {
-    GLuint shader;
-    if (!PyArg_ParseTuple(args, "I", &shader)) {
+    if (desc.width <= 0 || desc.height <= 0) {
+        PyErr_SetString(PyExc_ValueError, "Texture width and height must be positive");
         return NULL;
     }
 
-    glapi_BindShader(shader);
-    Py_RETURN_NONE;
-}
-
-static PyObject* glib_unbind_shader(PyObject* self, PyObject* args) {
-    glapi_UnbindShader();
-    Py_RETURN_NONE;
-}
+    Py_buffer view;
+    const void* pixels = NULL;
+    if (data_obj != Py_None) {
+        if (PyObject_GetBuffer(data_obj, &view, PyBUF_C_CONTIGUOUS) < 0) {
+            return NULL;
+        }
+        if (view.len != (Py_ssize_t)desc.width * desc.height * texel_size) {
+            PyBuffer_Release(&view);
+            PyErr_Format(PyExc_ValueError, "Expected %zd bytes of pixel data", (Py_ssize_t)desc.width * desc.height * texel_size);
+            return NULL;
+        }
+        pixels = view.buf;
+    }
 
-static PyObject* glib_draw_vertex_buffer_object(PyObject* self, PyObject* args) {
-    Py_ssize_t index_count;
-    if (!PyArg_ParseTuple(args, "n", &index_count)) {
+    GLuint texture = glapi_GenTexture(app, &desc, pixels, NULL);
+    if (pixels) {
+        PyBuffer_Release(&view);
+    }
+    if (!texture) {
+        PyErr_SetString(PyExc_RuntimeError, "Failed to generate texture");
         return NULL;
     }
 
-    glapi_DrawVertexBufferObject((size_t)index_count);
-    Py_RETURN_NONE;
+    return PyLong_FromUnsignedLong(texture);
 }
 
-static PyObject* glib_gen_shader_program_f(PyObject* self, PyObject* args) {
+static PyObject* glib_gen_compressed_texture_from_fpath(PyObject* self, PyObject* args) {
     PyObject* app_capsule;
-    const char* v_fpath;
-    const char* f_fpath;
-    if (!PyArg_ParseTuple(args, "Oss", &app_capsule, &v_fpath, &f_fpath)) {
+    const char* fpath;
+    if (!PyArg_ParseTuple(args, "Os", &app_capsule, &fpath)) {
         return NULL;
     }
 
@@ -625,21 +3573,30 @@ static PyObject* glib_gen_shader_program_f(PyObject* self, PyObject* args) {
         return NULL;
     }
 
-    GLuint shader;
-    shader = glapi_GenShaderProgram_f(app, v_fpath, f_fpath, &shader);
-    if (!shader) {
-        PyErr_SetString(PyExc_RuntimeError, "Failed to create shader program");
+    gl_compressed_stats stats;
+    GLuint texture = glapi_GenCompressedTextureFromFpath(app, fpath, &stats, NULL);
+    if (!texture) {
+        PyErr_SetString(PyExc_IOError, "Failed to load compressed texture");
         return NULL;
     }
 
-    return PyLong_FromUnsignedLong(shader);
+    return Py_BuildValue("(I{s:I,s:I,s:i,s:i,s:i,s:n,s:O})", texture,
+        "internal_format", stats.internal_format,
+        "storage_format", stats.storage_format,
+        "width", stats.width,
+        "height", stats.height,
+        "levels", stats.levels,
+        "gpu_bytes", (Py_ssize_t)stats.gpu_bytes,
+        "transcoded", stats.transcoded ? Py_True : Py_False);
 }
 
-static PyObject* glib_gen_shader_program_s(PyObject* self, PyObject* args) {
+static PyObject* glib_gen_texture_from_fpath_compressed(PyObject* self, PyObject* args) {
     PyObject* app_capsule;
-    const char* v_source;
-    const char* f_source;
-    if (!PyArg_ParseTuple(args, "Oss", &app_capsule, &v_source, &f_source)) {
+    const char* fpath;
+    unsigned int format = GL_COMPRESSED_RGBA_BPTC_UNORM_ARB;
+    const char* cache_dir = ".texcache";
+    unsigned int threads = 0;
+    if (!PyArg_ParseTuple(args, "Os|IsI", &app_capsule, &fpath, &format, &cache_dir, &threads)) {
         return NULL;
     }
 
@@ -649,20 +3606,30 @@ static PyObject* glib_gen_shader_program_s(PyObject* self, PyObject* args) {
         return NULL;
     }
 
-    GLuint shader;
-    shader = glapi_GenShaderProgram_s(app, v_source, f_source, &shader);
-    if (!shader) {
-        PyErr_SetString(PyExc_RuntimeError, "Failed to create shader program");
+    gl_compressed_stats stats;
+    GLuint texture = glapi_GenTextureFromFpathCompressed(app, fpath, (GLenum)format, cache_dir, threads, &stats, NULL);
+    if (!texture) {
+        PyErr_SetString(PyExc_IOError, "Failed to compress texture");
         return NULL;
     }
 
-    return PyLong_FromUnsignedLong(shader);
+    return Py_BuildValue("(I{s:I,s:I,s:i,s:i,s:i,s:n,s:O,s:O})", texture,
+        "internal_format", stats.internal_format,
+        "storage_format", stats.storage_format,
+        "width", stats.width,
+        "height", stats.height,
+        "levels", stats.levels,
+        "gpu_bytes", (Py_ssize_t)stats.gpu_bytes,
+        "transcoded", stats.transcoded ? Py_True : Py_False,
+        "cache_hit", stats.cache_hit ? Py_True : Py_False);
 }
 
-static PyObject* glib_gen_texture_from_fpath(PyObject* self, PyObject* args) {
+static PyObject* glib_get_sampler(PyObject* self, PyObject* args) {
     PyObject* app_capsule;
-    const char* fpath;
-    if (!PyArg_ParseTuple(args, "Os", &app_capsule, &fpath)) {
+    unsigned int filter = SAMPLER_FILTER_TRILINEAR;
+    unsigned int wrap = SAMPLER_WRAP_REPEAT;
+    float anisotropy = 1.0f;
+    if (!PyArg_ParseTuple(args, "O|IIf", &app_capsule, &filter, &wrap, &anisotropy)) {
         return NULL;
     }
 
@@ -672,14 +3639,13 @@ static PyObject* glib_gen_texture_from_fpath(PyObject* self, PyObject* args) {
         return NULL;
     }
 
-    GLuint texture;
-    texture = glapi_GenTextureFromFpath(app, fpath, &texture);
-    if (!texture) {
-        PyErr_SetString(PyExc_IOError, "Failed to load texture");
+    GLuint sampler = glapi_GetSampler(app, filter, wrap, anisotropy);
+    if (!sampler) {
+        PyErr_SetString(PyExc_RuntimeError, "Failed to create sampler");
         return NULL;
     }
 
-    return PyLong_FromUnsignedLong(texture);
+    return PyLong_FromUnsignedLong(sampler);
 }
 
 static PyObject* glib_push_int_to_shader(PyObject* self, PyObject* args) {
@@ -800,11 +3766,16 @@ static PyObject* glib_push_texture2D_to_shader(PyObject* self, PyObject* args) {
     const char* varname;
     GLuint texture;
     GLuint shader;
-    if (!PyArg_ParseTuple(args, "sII", &varname, &texture, &shader)) {
+    GLuint sampler = 0, unit = 0;
+    if (!PyArg_ParseTuple(args, "sII|II", &varname, &texture, &shader, &sampler, &unit)) {
         return NULL;
     }
 
-    glapi_PushTexture2DToShader(varname, texture, shader);
+    if (PyTuple_GET_SIZE(args) > 3) {
+        glapi_PushSampledTexture2DToShader(varname, texture, sampler, unit, shader);
+    } else {
+        glapi_PushTexture2DToShader(varname, texture, shader);
+    }
     Py_RETURN_NONE;
 }
 
@@ -825,7 +3796,16 @@ static PyMethodDef GLIBMethods[] = {
     {"bind_app", glib_bind_app, METH_VARARGS, "Bind the application's context"},
     {"unbind_app", glib_unbind_app, METH_VARARGS, "Unbind the application's context"},
     {"destroy_app", glib_destroy_app, METH_VARARGS, "Destroy the OpenGL application"},
-    {"should_app_close", glib_should_app_close, METH_VARARGS, "Check if the application should close"},
+    {"should_app_close", glib_should_app_close, METH_VARARGS, "Check if the application should close; headless apps close after GLIB_HEADLESS_FRAMES frames or request_app_close"},
+    {"request_app_close", glib_request_app_close, METH_VARARGS, "Ask the application to close on the next should_app_close check"},
+    {"set_swap_interval", glib_set_swap_interval, METH_VARARGS, "Set the swap interval (0 uncapped, 1 vsync, -1 adaptive), returns False if it fell back"},
+    {"get_swap_interval", glib_get_swap_interval, METH_VARARGS, "Return the active swap interval"},
+    {"set_frame_cap", glib_set_frame_cap, METH_VARARGS, "Cap the frame rate with a sleep-plus-spin limiter (0 disables)"},
+    {"frame_stats", glib_frame_stats, METH_VARARGS, "Return rolling frame-time statistics (mean, percentiles, max, histogram) or None"},
+    {"reset_frame_stats", glib_reset_frame_stats, METH_VARARGS, "Clear the rolling frame-time history"},
+    {"set_max_frames_in_flight", glib_set_max_frames_in_flight, METH_VARARGS, "Block after swap until at most N frames are queued on the GPU (0 leaves it to the driver)"},
+    {"set_late_latch", glib_set_late_latch, METH_VARARGS, "Register a callable filling a uniform buffer at a binding just before the final draws"},
+    {"latch_frame", glib_latch_frame, METH_VARARGS, "Poll input and refresh the late-latched uniform buffer"},
     {"bind_vertex_buffer_object", glib_bind_vertex_buffer_object, METH_VARARGS, "Bind a vertex buffer object"},
     {"unbind_vertex_buffer_object", glib_unbind_vertex_buffer_object, METH_VARARGS, "Unbind a vertex buffer object"},
     {"bind_frame_buffer_object", glib_bind_frame_buffer_object, METH_VARARGS, "Bind a frame buffer object"},
@@ -835,9 +3815,103 @@ static PyMethodDef GLIBMethods[] = {
     {"draw_vertex_buffer_object", glib_draw_vertex_buffer_object, METH_VARARGS, "Draw a vertex buffer object"},
     {"gen_shader_program_f", glib_gen_shader_program_f, METH_VARARGS, "Generate shader program from file paths"},
     {"gen_shader_program_s", glib_gen_shader_program_s, METH_VARARGS, "Generate shader program from source"},
+    {"acquire_shader_program_f", glib_acquire_shader_program_f, METH_VARARGS, "Return a shared shader variant for file paths and an optional define set ['NAME' or 'NAME=VALUE'], compiled once per permutation"},
+    {"preprocess_shader", glib_preprocess_shader, METH_VARARGS, "Return shader file source with #include resolved, #version hoisted and [defines] injected"},
+    {"acquire_shader_program_s", glib_acquire_shader_program_s, METH_VARARGS, "Return a shared shader program for sources, keyed by source hash"},
+    {"release_shader_program", glib_release_shader_program, METH_VARARGS, "Drop a reference to a shared shader program, deleting it at zero; returns remaining references"},
+    {"release_texture", glib_release_texture, METH_VARARGS, "Drop a reference to a shared texture from gen_texture_from_fpath, deleting it at zero; returns remaining references"},
+    {"asset_cache_stats", glib_asset_cache_stats, METH_VARARGS, "Return shared texture/shader counts, references, hits and misses"},
+    {"build_shader_programs", glib_build_shader_programs, METH_VARARGS, "Compile and link (vertex, fragment) source pairs as one batch; returns [(program or 0, log or None)]"},
+    {"set_program_cache_dir", glib_set_program_cache_dir, METH_VARARGS, "Store linked program binaries in a directory and reuse them on later launches; empty path disables"},
+    {"program_cache_stats", glib_program_cache_stats, METH_VARARGS, "Return program binary cache hits, misses and driver-rejected binaries"},
     {"gen_vertex_buffer_object", glib_gen_vertex_buffer_object, METH_VARARGS, "Generate vertex buffer object from mesh"},
     {"gen_frame_buffer_object", glib_gen_frame_buffer_object, METH_VARARGS, "Generate frame buffer object"},
-    {"gen_texture_from_fpath", glib_gen_texture_from_fpath, METH_VARARGS, "Generate texture from file path"},
+    {"gen_render_target", glib_gen_render_target, METH_VARARGS, "Generate a render target with MRT color formats, depth format and MSAA samples, [colors, depth_format, samples, depth_texture]"},
+    {"bind_render_target", glib_bind_render_target, METH_VARARGS, "Bind a render target and set the viewport to its size"},
+    {"unbind_render_target", glib_unbind_render_target, METH_VARARGS, "Bind the default framebuffer and restore the window viewport"},
+    {"resolve_render_target", glib_resolve_render_target, METH_VARARGS, "Resolve a multisampled render target into its textures"},
+    {"blit_render_target", glib_blit_render_target, METH_VARARGS, "Blit a color attachment to a framebuffer, [destination]"},
+    {"render_target_textures", glib_render_target_textures, METH_VARARGS, "Return ((color textures), depth texture) of a render target"},
+    {"gen_readback", glib_gen_readback, METH_VARARGS, "Create a ring of pixel pack buffers for asynchronous framebuffer readback"},
+    {"readback_framebuffer", glib_readback_framebuffer, METH_VARARGS, "Queue a glReadPixels of a framebuffer into the next pixel pack buffer"},
+    {"map_readback", glib_map_readback, METH_VARARGS, "Map the oldest readback whose fence has signalled as a ReadbackFrame, or None"},
+    {"readback_stats", glib_readback_stats, METH_VARARGS, "Return issued/completed/dropped/skipped/pending readback counts"},
+    {"gen_batch_renderer", glib_gen_batch_renderer, METH_VARARGS, "Create an offscreen MRT batch renderer with a writer thread pool"},
+    {"batch_renderer_uniform", glib_batch_renderer_uniform, METH_VARARGS, "Declare a per-item uniform, returns the parameter row length"},
+    {"batch_renderer_outputs", glib_batch_renderer_outputs, METH_VARARGS, "Return [(name, (height, width, channels), dtype)] for each output"},
+    {"batch_render", glib_batch_render, METH_VARARGS, "Render every parameter row back-to-back into output arrays and/or .npy files"},
+    {"batch_renderer_stats", glib_batch_renderer_stats, METH_VARARGS, "Return rendered/written/failed counts of a batch renderer"},
+    {"gen_frame_graph", glib_gen_frame_graph, METH_VARARGS, "Generate a frame graph sized to the given output resolution"},
+    {"frame_graph_resource", glib_frame_graph_resource, METH_VARARGS, "Declare a transient frame graph texture, [scale]"},
+    {"frame_graph_import", glib_frame_graph_import, METH_VARARGS, "Import an existing texture as a read only frame graph resource"},
+    {"frame_graph_export", glib_frame_graph_export, METH_VARARGS, "Keep a frame graph resource alive after execution"},
+    {"frame_graph_pass", glib_frame_graph_pass, METH_VARARGS, "Add a pass callable(pass) with reads and writes, [reads, writes, present]"},
+    {"compile_frame_graph", glib_compile_frame_graph, METH_VARARGS, "Cull, order and alias a frame graph and return its stats"},
+    {"execute_frame_graph", glib_execute_frame_graph, METH_VARARGS, "Run the passes of a frame graph in order"},
+    {"frame_graph_texture", glib_frame_graph_texture, METH_VARARGS, "Return the texture backing a frame graph resource"},
+    {"resize_frame_graph", glib_resize_frame_graph, METH_VARARGS, "Resize a frame graph and rebuild its texture pool"},
+    {"reset_frame_graph", glib_reset_frame_graph, METH_VARARGS, "Clear the passes and resources of a frame graph, keeping its pool"},
+    {"set_frame_graph_profiler", glib_set_frame_graph_profiler, METH_VARARGS, "Time every frame graph pass with a GPU profiler, or None to stop"},
+    {"gen_gpu_profiler", glib_gen_gpu_profiler, METH_VARARGS, "Generate a GPU profiler with a ring of timestamp queries, [frames]"},
+    {"begin_gpu_frame", glib_begin_gpu_frame, METH_VARARGS, "Start recording GPU timings for a frame"},
+    {"end_gpu_frame", glib_end_gpu_frame, METH_VARARGS, "Finish recording GPU timings for a frame"},
+    {"begin_gpu_scope", glib_begin_gpu_scope, METH_VARARGS, "Open a named GPU timing scope"},
+    {"end_gpu_scope", glib_end_gpu_scope, METH_VARARGS, "Close the innermost GPU timing scope"},
+    {"gpu_profiler_report", glib_gpu_profiler_report, METH_VARARGS, "Return the latest resolved GPU frame timings without stalling"},
+    {"profiler_enable", glib_profiler_enable, METH_VARARGS, "Enable or disable CPU zone recording, [enabled]"},
+    {"profiler_begin", glib_profiler_begin, METH_VARARGS, "Open a named CPU zone on the calling thread"},
+    {"profiler_end", glib_profiler_end, METH_VARARGS, "Close the innermost CPU zone on the calling thread"},
+    {"profiler_name_thread", glib_profiler_name_thread, METH_VARARGS, "Name the calling thread's track in CPU traces"},
+    {"profiler_reset", glib_profiler_reset, METH_VARARGS, "Discard recorded CPU zones"},
+    {"profiler_dump", glib_profiler_dump, METH_VARARGS, "Write recorded CPU zones as Chrome trace JSON and return the event count"},
+    {"gen_texture_from_fpath", glib_gen_texture_from_fpath, METH_VARARGS, "Generate or share a cached mipmapped texture from file path, [internal_format, mips]"},
+    {"gen_texture", glib_gen_texture, METH_VARARGS, "Generate immutable texture storage from a pixel buffer with GPU or CPU mips"},
+    {"gen_compressed_texture_from_fpath", glib_gen_compressed_texture_from_fpath, METH_VARARGS, "Load a DDS or KTX2 texture, uploading block-compressed mips or decoding them when unsupported; rows stay in file order. Returns (texture, stats)"},
+    {"gen_texture_from_fpath_compressed", glib_gen_texture_from_fpath_compressed, METH_VARARGS, "Load an image, encoding BC1/BC3/BC5/BC7 mips across worker threads and caching the result by content hash in cache_dir. Returns (texture, stats)"},
+    {"get_sampler", glib_get_sampler, METH_VARARGS, "Return a shared sampler object for filter, wrap and anisotropy"},
+    {"gen_texture_array", glib_gen_texture_array, METH_VARARGS, "Load image files into one layer each of a 2D array texture"},
+    {"gen_texture_atlas", glib_gen_texture_atlas, METH_VARARGS, "Shelf-pack image files with extruded padding into 2D array texture layers"},
+    {"texture_atlas_info", glib_texture_atlas_info, METH_VARARGS, "Return atlas texture, size, layers, levels and per-image (layer, u0, v0, u1, v1) rects"},
+    {"push_texture_atlas_to_shader", glib_push_texture_atlas_to_shader, METH_VARARGS, "Push atlas array texture to a sampler2DArray uniform, [sampler, unit]"},
+    {"gen_texture_loader", glib_gen_texture_loader, METH_VARARGS, "Start a texture decode worker pool, [threads, upload_budget bytes per pump]"},
+    {"load_texture_async", glib_load_texture_async, METH_VARARGS, "Queue an image file for background decoding and return a handle, [internal_format, mips]"},
+    {"texture_loader_texture", glib_texture_loader_texture, METH_VARARGS, "Return the handle's texture, the placeholder until it is uploaded"},
+    {"texture_loader_status", glib_texture_loader_status, METH_VARARGS, "Return the handle's TEXTURE_LOAD_* status"},
+    {"pump_texture_loader", glib_pump_texture_loader, METH_VARARGS, "Upload decoded textures within the per-frame budget and return the count"},
+    {"finish_texture_loader", glib_finish_texture_loader, METH_VARARGS, "Wait for all queued decodes and upload them"},
+    {"gen_mesh_arena", glib_gen_mesh_arena, METH_VARARGS, "Generate a mesh arena sharing one VAO and large VBO/EBO"},
+    {"gen_arena_mesh", glib_gen_arena_mesh, METH_VARARGS, "Sub-allocate a mesh inside a mesh arena"},
+    {"free_arena_mesh", glib_free_arena_mesh, METH_VARARGS, "Release a mesh back to its mesh arena"},
+    {"defrag_mesh_arena", glib_defrag_mesh_arena, METH_VARARGS, "Compact live meshes of a mesh arena"},
+    {"bind_mesh_arena", glib_bind_mesh_arena, METH_VARARGS, "Bind a mesh arena's shared VAO"},
+    {"draw_arena_mesh", glib_draw_arena_mesh, METH_VARARGS, "Draw a mesh from the bound mesh arena"},
+    {"gen_instance_buffer", glib_gen_instance_buffer, METH_VARARGS, "Generate a per-instance attribute buffer"},
+    {"attach_instance_buffer", glib_attach_instance_buffer, METH_VARARGS, "Attach an instance buffer to a VAO or mesh arena"},
+    {"update_instance_buffer", glib_update_instance_buffer, METH_VARARGS, "Upload (N,16) float32 instance matrices and optional (N,4) colors"},
+    {"update_instance_buffer_trs", glib_update_instance_buffer_trs, METH_VARARGS, "Upload (N,9) float32 position/rotation/scale rows and optional (N,4) colors"},
+    {"draw_vertex_buffer_object_instanced", glib_draw_vertex_buffer_object_instanced, METH_VARARGS, "Draw a vertex buffer object once per instance"},
+    {"draw_arena_mesh_instanced", glib_draw_arena_mesh_instanced, METH_VARARGS, "Draw an arena mesh once per instance"},
+    {"gen_draw_batch", glib_gen_draw_batch, METH_VARARGS, "Generate a multi-draw batch over a mesh arena"},
+    {"append_draw_batch", glib_append_draw_batch, METH_VARARGS, "Append an arena mesh and its per-draw data to a draw batch"},
+    {"clear_draw_batch", glib_clear_draw_batch, METH_VARARGS, "Remove all draws from a draw batch"},
+    {"draw_batch", glib_draw_batch, METH_VARARGS, "Issue every draw of a draw batch in one multi-draw call"},
+    {"push_draw_batch_to_shader", glib_push_draw_batch_to_shader, METH_VARARGS, "Push a draw batch's per-draw data buffer to a shader sampler"},
+    {"gen_dynamic_mesh", glib_gen_dynamic_mesh, METH_VARARGS, "Generate a streaming mesh with triple-buffered persistent-mapped regions"},
+    {"update_dynamic_mesh_vertices", glib_update_dynamic_mesh_vertices, METH_VARARGS, "Write (N,3) positions, optional (N,2) uvs and (N,3) normals at a vertex offset"},
+    {"update_dynamic_mesh_indices", glib_update_dynamic_mesh_indices, METH_VARARGS, "Write uint32 indices at an index offset"},
+    {"set_dynamic_mesh_counts", glib_set_dynamic_mesh_counts, METH_VARARGS, "Set the live vertex and index counts of a dynamic mesh"},
+    {"commit_dynamic_mesh", glib_commit_dynamic_mesh, METH_VARARGS, "Publish pending dirty ranges; returns False if deferred because the GPU still reads the next region"},
+    {"draw_dynamic_mesh", glib_draw_dynamic_mesh, METH_VARARGS, "Draw the last committed region of a dynamic mesh"},
+    {"gen_mesh_buffer", glib_gen_mesh_buffer, METH_VARARGS, "Weld, cache/overdraw/fetch optimize and upload a mesh with 16-bit indices when possible"},
+    {"draw_mesh_buffer", glib_draw_mesh_buffer, METH_VARARGS, "Draw a mesh buffer"},
+    {"mesh_buffer_stats", glib_mesh_buffer_stats, METH_VARARGS, "Return vertex counts, ACMR before and after optimization and the LOD chain"},
+    {"select_mesh_lod", glib_select_mesh_lod, METH_VARARGS, "Pick the coarsest LOD whose error projects under pixel_error; draw_mesh_buffer submits it"},
+    {"gen_render_queue", glib_gen_render_queue, METH_VARARGS, "Generate a sort-keyed render queue"},
+    {"append_render_queue", glib_append_render_queue, METH_VARARGS, "Queue a draw of a VAO (with isize) or mesh buffer with textures, view depth and transparency"},
+    {"push_render_queue_uniform", glib_push_render_queue_uniform, METH_VARARGS, "Attach a uniform value to the last queued draw"},
+    {"clear_render_queue", glib_clear_render_queue, METH_VARARGS, "Remove all queued draws"},
+    {"submit_render_queue", glib_submit_render_queue, METH_VARARGS, "Radix sort queued draws and submit them with redundant state changes skipped"},
+    {"render_queue_stats", glib_render_queue_stats, METH_VARARGS, "Return draw count and state changes with and without sorting"},
     {"push_int_to_shader", glib_push_int_to_shader, METH_VARARGS, "Push integer to shader uniform"},
     {"push_float_to_shader", glib_push_float_to_shader, METH_VARARGS, "Push float to shader uniform"},
     {"push_vec2_to_shader", glib_push_vec2_to_shader, METH_VARARGS, "Push vec2 to shader uniform"},
@@ -845,7 +3919,7 @@ static PyMethodDef GLIBMethods[] = {
     {"push_vec4_to_shader", glib_push_vec4_to_shader, METH_VARARGS, "Push vec4 to shader uniform"},
     {"push_matrix3x3_to_shader", glib_push_matrix3x3_to_shader, METH_VARARGS, "Push 3x3 matrix to shader uniform"},
     {"push_matrix4x4_to_shader", glib_push_matrix4x4_to_shader, METH_VARARGS, "Push 4x4 matrix to shader uniform"},
-    {"push_texture2D_to_shader", glib_push_texture2D_to_shader, METH_VARARGS, "Push 2D texture to shader uniform"},
+    {"push_texture2D_to_shader", glib_push_texture2D_to_shader, METH_VARARGS, "Push 2D texture to shader uniform, [sampler, unit]"},
     {NULL, NULL, 0, NULL}
 };
 
@@ -858,5 +3932,67 @@ static struct PyModuleDef glibmodule = {
 };
 
 PyMODINIT_FUNC PyInit_glib(void) {
-    return PyModule_Create(&glibmodule);
+    if (PyType_Ready(&readback_frame_type) < 0) {
+        return NULL;
+    }
+    PyObject* module = PyModule_Create(&glibmodule);
+    if (!module) {
+        return NULL;
+    }
+    Py_INCREF(&readback_frame_type);
+    if (PyModule_AddObject(module, "ReadbackFrame", (PyObject*)&readback_frame_type) < 0) {
+        Py_DECREF(&readback_frame_type);
+        Py_DECREF(module);
+        return NULL;
+    }
+
+    PyModule_AddIntConstant(module, "ARENA_LAYOUT_UVS", ARENA_LAYOUT_UVS);
+    PyModule_AddIntConstant(module, "ARENA_LAYOUT_NORMALS", ARENA_LAYOUT_NORMALS);
+    PyModule_AddIntConstant(module, "INSTANCE_LAYOUT_MATRIX", INSTANCE_LAYOUT_MATRIX);
+    PyModule_AddIntConstant(module, "INSTANCE_LAYOUT_COLOR", INSTANCE_LAYOUT_COLOR);
+    PyModule_AddIntConstant(module, "TEXTURE_FORMAT_R8", GL_R8);
+    PyModule_AddIntConstant(module, "TEXTURE_FORMAT_RG8", GL_RG8);
+    PyModule_AddIntConstant(module, "TEXTURE_FORMAT_RGB8", GL_RGB8);
+    PyModule_AddIntConstant(module, "TEXTURE_FORMAT_RGBA8", GL_RGBA8);
+    PyModule_AddIntConstant(module, "TEXTURE_FORMAT_SRGB8", GL_SRGB8);
+    PyModule_AddIntConstant(module, "TEXTURE_FORMAT_SRGB8_ALPHA8", GL_SRGB8_ALPHA8);
+    PyModule_AddIntConstant(module, "TEXTURE_FORMAT_R16F", GL_R16F);
+    PyModule_AddIntConstant(module, "TEXTURE_FORMAT_RG16F", GL_RG16F);
+    PyModule_AddIntConstant(module, "TEXTURE_FORMAT_RGBA16F", GL_RGBA16F);
+    PyModule_AddIntConstant(module, "TEXTURE_FORMAT_R32F", GL_R32F);
+    PyModule_AddIntConstant(module, "TEXTURE_FORMAT_R8UI", GL_R8UI);
+    PyModule_AddIntConstant(module, "TEXTURE_FORMAT_R16UI", GL_R16UI);
+    PyModule_AddIntConstant(module, "TEXTURE_FORMAT_R32UI", GL_R32UI);
+    PyModule_AddIntConstant(module, "TEXTURE_FORMAT_RG32F", GL_RG32F);
+    PyModule_AddIntConstant(module, "TEXTURE_FORMAT_RGBA32F", GL_RGBA32F);
+    PyModule_AddIntConstant(module, "TEXTURE_FORMAT_RG16", GL_RG16);
+    PyModule_AddIntConstant(module, "TEXTURE_FORMAT_RGBA16", GL_RGBA16);
+    PyModule_AddIntConstant(module, "TEXTURE_FORMAT_RGB10_A2", GL_RGB10_A2);
+    PyModule_AddIntConstant(module, "TEXTURE_FORMAT_R11F_G11F_B10F", GL_R11F_G11F_B10F);
+    PyModule_AddIntConstant(module, "TEXTURE_FORMAT_DEPTH16", GL_DEPTH_COMPONENT16);
+    PyModule_AddIntConstant(module, "TEXTURE_FORMAT_DEPTH24", GL_DEPTH_COMPONENT24);
+    PyModule_AddIntConstant(module, "TEXTURE_FORMAT_DEPTH32F", GL_DEPTH_COMPONENT32F);
+    PyModule_AddIntConstant(module, "TEXTURE_FORMAT_DEPTH24_STENCIL8", GL_DEPTH24_STENCIL8);
+    PyModule_AddIntConstant(module, "TEXTURE_FORMAT_DEPTH32F_STENCIL8", GL_DEPTH32F_STENCIL8);
+    PyModule_AddIntConstant(module, "TEXTURE_FORMAT_BC1", GL_COMPRESSED_RGB_S3TC_DXT1_EXT);
+    PyModule_AddIntConstant(module, "TEXTURE_FORMAT_BC1_SRGB", GL_COMPRESSED_SRGB_S3TC_DXT1_EXT);
+    PyModule_AddIntConstant(module, "TEXTURE_FORMAT_BC3", GL_COMPRESSED_RGBA_S3TC_DXT5_EXT);
+    PyModule_AddIntConstant(module, "TEXTURE_FORMAT_BC3_SRGB", GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT);
+    PyModule_AddIntConstant(module, "TEXTURE_FORMAT_BC5", GL_COMPRESSED_RG_RGTC2);
+    PyModule_AddIntConstant(module, "TEXTURE_FORMAT_BC7", GL_COMPRESSED_RGBA_BPTC_UNORM_ARB);
+    PyModule_AddIntConstant(module, "TEXTURE_FORMAT_BC7_SRGB", GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM_ARB);
+    PyModule_AddIntConstant(module, "TEXTURE_MIPS_NONE", TEXTURE_MIPS_NONE);
+    PyModule_AddIntConstant(module, "TEXTURE_MIPS_GPU", TEXTURE_MIPS_GPU);
+    PyModule_AddIntConstant(module, "TEXTURE_MIPS_CPU", TEXTURE_MIPS_CPU);
+    PyModule_AddIntConstant(module, "SAMPLER_FILTER_NEAREST", SAMPLER_FILTER_NEAREST);
+    PyModule_AddIntConstant(module, "SAMPLER_FILTER_BILINEAR", SAMPLER_FILTER_BILINEAR);
+    PyModule_AddIntConstant(module, "SAMPLER_FILTER_TRILINEAR", SAMPLER_FILTER_TRILINEAR);
+    PyModule_AddIntConstant(module, "SAMPLER_WRAP_REPEAT", SAMPLER_WRAP_REPEAT);
+    PyModule_AddIntConstant(module, "SAMPLER_WRAP_CLAMP", SAMPLER_WRAP_CLAMP);
+    PyModule_AddIntConstant(module, "SAMPLER_WRAP_MIRROR", SAMPLER_WRAP_MIRROR);
+    PyModule_AddIntConstant(module, "TEXTURE_LOAD_PENDING", TEXTURE_LOAD_PENDING);
+    PyModule_AddIntConstant(module, "TEXTURE_LOAD_DECODED", TEXTURE_LOAD_DECODED);
+    PyModule_AddIntConstant(module, "TEXTURE_LOAD_READY", TEXTURE_LOAD_READY);
+    PyModule_AddIntConstant(module, "TEXTURE_LOAD_FAILED", TEXTURE_LOAD_FAILED);
+    return module;
 }
\ No newline at end of file
@@ -1,12 +1,37 @@
+#include <sys/stat.h>
+#include <time.h>
+#ifdef _WIN32
+#include <direct.h>
+#endif
+
 #include "graphics.h"
 
 #define _FL "graphics.c"
 
 #define APIC static
 #define GL_ADDRESS_ARR_APPEND_AMOUNT 25
-
-APIC char* load_raw_txt(const char* fpath);
-APIC GLuint compile_shader_code(const char* source, GLenum type);
+#define GL_ASSET_CACHE_APPEND_AMOUNT 16
+
+#if defined(_WIN32)
+#define FILE_STAMP_NSEC(info) 0
+#elif defined(__APPLE__)
+#define FILE_STAMP_NSEC(info) (info).st_mtimespec.tv_nsec
+#else
+#define FILE_STAMP_NSEC(info) (info).st_mtim.tv_nsec
+#endif
+
+APIC gl_asset_cache* asset_cache(gl_app* app);
+APIC gl_asset* asset_find(gl_app* app, unsigned int kind, uint64_t hash);
+APIC gl_asset* asset_find_key(gl_app* app, unsigned int kind, const char* key, uint64_t stamp);
+APIC gl_asset* asset_find_depends(gl_app* app, unsigned int kind, const char* key);
+APIC bool asset_depends_stamp(const char* depends, uint64_t* stamp);
+APIC bool asset_alias(gl_app* app, unsigned int kind, const char* key, uint64_t stamp, uint64_t hash, char* depends);
+APIC gl_asset* asset_lookup(gl_app* app, unsigned int kind, const char* key, uint64_t stamp, uint64_t hash, char* depends);
+APIC gl_asset* asset_insert(gl_app* app, unsigned int kind, const char* key, uint64_t stamp, uint64_t hash, char* depends, GLuint object);
+APIC uint64_t asset_shader_hash(const char* v_source, const char* f_source);
+APIC size_t asset_release(gl_app* app, unsigned int kind, GLuint object);
+APIC int asset_define_compare(const void* a, const void* b);
+APIC char* asset_variant_key(const char* v_fpath, const char* f_fpath, const char** defines, size_t define_count);
 
 void check_gl_error(const char* operation) {
     GLenum err;
@@ -21,6 +46,20 @@ typedef struct {
     size_t openglobjects_objcapacity;
 } app_resources;
 
+static gl_framebuffer default_framebuffer = 0;
+
+void* glapi_CreateAppResources(void) {
+    return calloc(1, sizeof(app_resources));
+}
+
+gl_framebuffer glapi_DefaultFramebuffer(void) {
+    return default_framebuffer;
+}
+
+void glapi_SetDefaultFramebuffer(gl_framebuffer framebuffer) {
+    default_framebuffer = framebuffer;
+}
+
 void resize_callback(GLFWwindow* window, int width, int height) {
     glViewport(0, 0, width, height);
     check_gl_error("resize_callback");
@@ -39,6 +78,14 @@ API void glapi_DisableDepthTest() {
 }
 
 gl_app* glapi_CreateApp(uint16_t window_width, uint16_t window_height, const char* title, bool resizable, float r, float g, float b) {
+    const char* headless = getenv("GLIB_HEADLESS");
+    if (headless && strcmp(headless, "0")) {
+        gl_app* app = glapi_CreateHeadlessApp(window_width, window_height, r, g, b);
+        if (app)
+            return app;
+        fprintf(stderr, "[%s] - Headless context unavailable, falling back to a window in glapi_CreateApp\n", _FL);
+    }
+
     gl_app* app = (gl_app*)calloc(1, sizeof(gl_app));
     if (!app) {
         fprintf(stderr, "[%s] - Failure to allocate 'app' to heap in glapi_CreateApp\n", _FL); 
@@ -52,7 +99,7 @@ gl_app* glapi_CreateApp(uint16_t window_width, uint16_t window_height, const cha
         exit(1);
     }
 
-    app->resources = (void*)calloc(1, sizeof(app_resources));
+    app->resources = glapi_CreateAppResources();
     if (!app->resources) {
         fprintf(stderr, "[%s] - Failure to allocate 'app->resources' to heap in glapi_CreateApp\n", _FL); 
         free(app->window);
@@ -138,15 +185,23 @@ gl_app* glapi_CreateApp(uint16_t window_width, uint16_t window_height, const cha
     printf("[%s] - Window shown\n", _FL);
 
     glEnable(GL_DEPTH_TEST);
-    glfwSwapInterval(1);
+    glapi_SetSwapInterval(app, 1);
     return app;
 }
 
 void glapi_BindApp(gl_app* app) {
-    int x, y;
-    glfwGetWindowSize(app->window->pointer, &x, &y);
-    app->window->window_width = x;
-    app->window->window_height = y;
+    app->frame_begin_ns = glapi_IsCpuProfilerEnabled() ? glapi_NowNanoseconds() : 0;
+    glapi_BeginCpuZone("glapi_BindApp");
+    glapi_StartFrame(app);
+    if (app->window->headless) {
+        glBindFramebuffer(GL_FRAMEBUFFER, default_framebuffer);
+        glViewport(0, 0, app->window->window_width, app->window->window_height);
+    } else {
+        int x, y;
+        glfwGetWindowSize(app->window->pointer, &x, &y);
+        app->window->window_width = x;
+        app->window->window_height = y;
+    }
 
     glClearColor(
         app->window->r, 
@@ -155,11 +210,25 @@ void glapi_BindApp(gl_app* app) {
         1.0f
     );
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    glapi_EndCpuZone();
 }
 
 void glapi_UnbindApp(gl_app* app) {
-    glfwSwapBuffers(app->window->pointer);
-    glfwPollEvents();
+    glapi_BeginCpuZone("glapi_UnbindApp");
+    glapi_PaceFrame(app);
+    if (app->window->headless) {
+        glFlush();
+        app->window->frames++;
+    } else {
+        glfwSwapBuffers(app->window->pointer);
+        glfwPollEvents();
+    }
+    glapi_ThrottleFrame(app);
+    glapi_RecordFrame(app);
+    glapi_EndCpuZone();
+    if (app->frame_begin_ns)
+        glapi_RecordCpuZone("frame", app->frame_begin_ns, glapi_NowNanoseconds());
+    app->frame_begin_ns = 0;
 }
 
 int glapi_DestroyApp(gl_app* app) {
@@ -186,6 +255,53 @@ int glapi_DestroyApp(gl_app* app) {
                 case FRAMEBUFFER:
                     glDeleteFramebuffers(1, (GLuint*)clist[i].globject);
                     break;
+                case MESH_ARENA:
+                    glapi_DestroyMeshArena((gl_mesh_arena*)clist[i].globject);
+                    break;
+                case INSTANCE_BUFFER:
+                    glapi_DestroyInstanceBuffer((gl_instance_buffer*)clist[i].globject);
+                    break;
+                case DRAW_BATCH:
+                    glapi_DestroyDrawBatch((gl_draw_batch*)clist[i].globject);
+                    break;
+                case DYNAMIC_MESH:
+                    glapi_DestroyDynamicMesh((gl_dynamic_mesh*)clist[i].globject);
+                    break;
+                case MESH_BUFFER:
+                    glapi_DestroyMeshBuffer((gl_mesh_buffer*)clist[i].globject);
+                    break;
+                case RENDER_QUEUE:
+                    glapi_DestroyRenderQueue((gl_render_queue*)clist[i].globject);
+                    break;
+                case TEXTURE_ATLAS:
+                    glapi_DestroyTextureAtlas((gl_texture_atlas*)clist[i].globject);
+                    break;
+                case TEXTURE_LOADER:
+                    glapi_DestroyTextureLoader((gl_texture_loader*)clist[i].globject);
+                    break;
+                case RENDER_TARGET:
+                    glapi_DestroyRenderTarget((gl_render_target*)clist[i].globject);
+                    break;
+                case FRAME_GRAPH:
+                    glapi_DestroyFrameGraph((gl_frame_graph*)clist[i].globject);
+                    break;
+                case GPU_PROFILER:
+                    glapi_DestroyGpuProfiler((gl_gpu_profiler*)clist[i].globject);
+                    break;
+                case READBACK:
+                    glapi_DestroyReadback((gl_readback*)clist[i].globject);
+                    break;
+                case BATCH_RENDERER:
+                    glapi_DestroyBatchRenderer((gl_batch_renderer*)clist[i].globject);
+                    break;
+                case SHADER_PROGRAM:
+                    glDeleteProgram(*(GLuint*)clist[i].globject);
+                    free(clist[i].globject);
+                    break;
+                case TEXTURE_HANDLE:
+                    glDeleteTextures(1, (GLuint*)clist[i].globject);
+                    free(clist[i].globject);
+                    break;
                 default:
                     fprintf(stderr, "[%s] - Invalid globject type [%i] in glapi_DestroyApp\n", _FL, clist[i].objtype);
                     break;
@@ -194,9 +310,17 @@ int glapi_DestroyApp(gl_app* app) {
         graphics_resources->openglobjects_objcount = 0;
         free(clist);
     }
+    glapi_DestroySamplerCache(app);
+    glapi_DestroyAssetCache(app);
+    glapi_DestroyProgramCache(app);
+    glapi_DestroyFramePacer(app);
     
-    glfwDestroyWindow(app->window->pointer);
-    glfwTerminate();
+    if (app->window->headless) {
+        glapi_DestroyHeadlessContext(app);
+    } else {
+        glfwDestroyWindow(app->window->pointer);
+        glfwTerminate();
+    }
     free(app->window);
     free(app->resources);
     free(app);
@@ -204,7 +328,17 @@ int glapi_DestroyApp(gl_app* app) {
 }
 
 int glapi_ShouldAppClose(gl_app* app) {
-    return glfwWindowShouldClose(app->window->pointer);
+    gl_window* window = app->window;
+    if (window->headless)
+        return window->close_requested || (window->frame_budget && window->frames >= window->frame_budget);
+    return glfwWindowShouldClose(window->pointer);
+}
+
+void glapi_RequestAppClose(gl_app* app) {
+    if (app->window->headless)
+        app->window->close_requested = true;
+    else
+        glfwSetWindowShouldClose(app->window->pointer, GLFW_TRUE);
 }
 
 void glapi_AppendOpenGLObjects(gl_app* app, globject_tcouple tcouple) {
@@ -238,132 +372,41 @@ void glapi_AppendOpenGLObjects(gl_app* app, globject_tcouple tcouple) {
     graphics_resources->openglobjects_objcount = clistlen + 1;
 }
 
-APIC char* load_raw_txt(const char* fpath) {
-    FILE* file = fopen(fpath, "r");
-    if (!file) {
-        fprintf(stderr, "[%s] - Failure to read file in 'load_raw_txt(const char* fpath)': %s\n", _FL, fpath);
-        return NULL;
-    }  
-    fseek(file, 0, SEEK_END);
-    long size = ftell(file);
-    rewind(file);
-    char* source = (char*)malloc(size + 1);
-    if (!source) {
-        fprintf(stderr, "[%s] - Memory allocation failed for file in 'load_raw_txt(const char* fpath)': %s\n", _FL, fpath);
-        fclose(file);
-        return NULL;
+void glapi_AppendTextureObject(gl_app* app, GLuint texture, GLuint* address) {
+    if (address) {
+        glapi_AppendOpenGLObjects(app, T{address, TEXTURE});
+        return;
     }
-    size_t read = fread(source, 1, size, file);
-    if (read != size) {
-        fprintf(stderr, "[%s] - Failure to read file in 'load_raw_txt(const char* fpath)': %s\n", _FL, fpath);
-        free(source);
-        fclose(file);
-        return NULL;
+    GLuint* handle = (GLuint*)malloc(sizeof(GLuint));
+    if (!handle) {
+        fprintf(stderr, "[%s] - Failure to allocate texture handle to heap in glapi_AppendTextureObject\n", _FL);
+        return;
     }
-    source[size] = '\0';
-    fclose(file);
-    return source;
-}
-
-APIC GLuint compile_shader_code(const char* source, GLenum type) {
-    GLuint shaderp = glCreateShader(type);
-    glShaderSource(shaderp, 1, &source, NULL);
-    glCompileShader(shaderp);
-    int errcode;
-    glGetShaderiv(shaderp, GL_COMPILE_STATUS, &errcode);
-    if (!errcode) {
-        char log[512];
-        glGetShaderInfoLog(shaderp, 512, NULL, log);
-        fprintf(stderr, "[%s] - Shader compilation error: %s\n", _FL, log);
-    }
-    return shaderp;
-}
-
-GLuint glapi_GenShaderProgram_f(gl_app* app, const char* v_source, const char* f_source, GLuint* address) {
-    GLuint vshader = compile_shader_code(v_source, GL_VERTEX_SHADER);
-    GLuint fshader = compile_shader_code(f_source, GL_FRAGMENT_SHADER);
-    GLuint sprogram = glCreateProgram();
-    glAttachShader(sprogram, vshader);
-    glAttachShader(sprogram, fshader);
-    glLinkProgram(sprogram);
-    int errcode;
-    glGetProgramiv(sprogram, GL_LINK_STATUS, &errcode);
-    if (!errcode) {
-        char log[512];
-        glGetProgramInfoLog(sprogram, 512, NULL, log);
-        fprintf(stderr, "[%s] - Shader linking error: %s\n", _FL, log);
-    }
-    glDeleteShader(vshader);
-    glDeleteShader(fshader);
-    glapi_AppendOpenGLObjects(app, T{address, SHADER});
-    return sprogram;
+    *handle = texture;
+    glapi_AppendOpenGLObjects(app, T{handle, TEXTURE_HANDLE});
 }
 
-GLuint glapi_GenShaderProgram_s(gl_app* app, const char* v_fpath, const char* f_fpath, GLuint* address) {
-    char* v_source = load_raw_txt(v_fpath);
-    char* f_source = load_raw_txt(f_fpath);
-    GLuint vshader = compile_shader_code(v_source, GL_VERTEX_SHADER);
-    GLuint fshader = compile_shader_code(f_source, GL_FRAGMENT_SHADER);
-    GLuint sprogram = glCreateProgram();
-    glAttachShader(sprogram, vshader);
-    glAttachShader(sprogram, fshader);
-    glLinkProgram(sprogram);
-    int errcode;
-    glGetProgramiv(sprogram, GL_LINK_STATUS, &errcode);
-    if (!errcode) {
-        char log[512];
-        glGetProgramInfoLog(sprogram, 512, NULL, log);
-        fprintf(stderr, "[%s] - Shader linking error: %s\n", _FL, log);
-    }
-    glDeleteShader(vshader);
-    glDeleteShader(fshader);
+GLuint glapi_GenShaderProgram_f(gl_app* app, const char* v_fpath, const char* f_fpath, GLuint* address) {
+    char* v_source = glapi_PreprocessShaderFile(v_fpath, NULL, 0);
+    char* f_source = glapi_PreprocessShaderFile(f_fpath, NULL, 0);
+    if (!v_source || !f_source) {
+        free(v_source);
+        free(f_source);
+        return 0;
+    }
+    GLuint sprogram = glapi_LinkShaderProgram(app, v_source, f_source);
     free(v_source);
     free(f_source);
-    glapi_AppendOpenGLObjects(app, T{address, SHADER});
+    if (sprogram)
+        glapi_AppendOpenGLObjects(app, T{address, SHADER});
     return sprogram;
 }
 
-GLuint glapi_GenFrameBuffer(gl_app* app, gl_texture output_tex, GLuint* address, uint16_t width, uint16_t height) {
-    GLuint fbuffer;
-    glGenFramebuffers(1, &fbuffer);
-    glBindFramebuffer(GL_FRAMEBUFFER, fbuffer);
-
-    glBindTexture(GL_TEXTURE_2D, output_tex);
-    glTexImage2D(
-        GL_TEXTURE_2D, 
-        0, 
-        GL_RGB, 
-        width, 
-        height,
-        0,
-        GL_RGB, 
-        GL_UNSIGNED_BYTE, 
-        0
-    );
-
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-
-    GLuint dbuffer;
-    glGenRenderbuffers(1, &dbuffer);
-    glBindRenderbuffer(GL_RENDERBUFFER, dbuffer);
-    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT, width, height);
-    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, dbuffer);
-
-    glFramebufferTexture(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, output_tex, 0);
-
-    GLenum drawbuffers[1] = {GL_COLOR_ATTACHMENT0};
-    glDrawBuffers(1, drawbuffers);
-
-    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
-        fprintf(stderr, "[%s] - Failure to generate framebuffer in 'glapi_GenFrameBuffer'\n", _FL);
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
-        return 0;
-    }
-
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
-    glapi_AppendOpenGLObjects(app, T{address, FRAMEBUFFER});
-    return fbuffer;
+GLuint glapi_GenShaderProgram_s(gl_app* app, const char* v_source, const char* f_source, GLuint* address) {
+    GLuint sprogram = glapi_LinkShaderProgram(app, v_source, f_source);
+    if (sprogram)
+        glapi_AppendOpenGLObjects(app, T{address, SHADER});
+    return sprogram;
 }
 
 GLuint glapi_GenVertexBufferObjectFromMesh(gl_app* app, gl_mesh* mesh, GLuint* address) {
@@ -410,31 +453,478 @@ GLuint glapi_GenVertexBufferObjectFromMesh(gl_app* app, gl_mesh* mesh, GLuint* a
 }
 
 GLuint glapi_GenTextureFromFpath(gl_app* app, const char* fpath, GLuint* address) {
-    GLuint texture;
-    glGenTextures(1, &texture);
-    glBindTexture(GL_TEXTURE_2D, texture);
-    int width, height, channels;
-    stbi_set_flip_vertically_on_load(1);
-    if (strcmp("", fpath)) {
-        unsigned char* data = stbi_load(fpath, &width, &height, &channels, STBI_rgb_alpha);
-        if (data) {
-            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-            stbi_image_free(data);
-        } else {
-            fprintf(stderr, "[%s] - Texture load failed: %s\n", _FL, stbi_failure_reason());
+    if (!strcmp("", fpath))
+        return glapi_GenTextureFromFpathFormat(app, fpath, GL_RGBA8, TEXTURE_MIPS_GPU, address);
+    return glapi_AcquireTextureFromFpath(app, fpath, GL_RGBA8, TEXTURE_MIPS_GPU);
+}
+
+unsigned char* glapi_ReadFile(const char* fpath, size_t* size) {
+    FILE* file = fopen(fpath, "rb");
+    if (!file) {
+        fprintf(stderr, "[%s] - Failure to open '%s' in glapi_ReadFile\n", _FL, fpath);
+        return NULL;
+    }
+    fseek(file, 0, SEEK_END);
+    long length = ftell(file);
+    rewind(file);
+    unsigned char* data = length >= 0 ? (unsigned char*)malloc((size_t)length + 1) : NULL;
+    if (!data || fread(data, 1, (size_t)length, file) != (size_t)length) {
+        fprintf(stderr, "[%s] - Failure to read '%s' in glapi_ReadFile\n", _FL, fpath);
+        free(data);
+        fclose(file);
+        return NULL;
+    }
+    fclose(file);
+    data[length] = '\0';
+    if (size)
+        *size = (size_t)length;
+    return data;
+}
+
+bool glapi_GrowArray(void** array, size_t* capacity, size_t count, size_t size, size_t append_amount) {
+    if (count < *capacity)
+        return true;
+    size_t new_capacity = *capacity ? *capacity * 2 : append_amount;
+    if (new_capacity <= *capacity || new_capacity > SIZE_MAX / size)
+        return false;
+    void* grown = realloc(*array, new_capacity * size);
+    if (!grown)
+        return false;
+    *array = grown;
+    *capacity = new_capacity;
+    return true;
+}
+
+bool glapi_FileStamp(const char* fpath, uint64_t* stamp) {
+    struct stat info;
+    if (stat(fpath, &info)) {
+        fprintf(stderr, "[%s] - Failure to stat file in 'glapi_FileStamp': %s\n", _FL, fpath);
+        return false;
+    }
+    static uint64_t racy_serial = 0;
+    uint64_t fields[5] = {(uint64_t)info.st_mtime, (uint64_t)FILE_STAMP_NSEC(info), (uint64_t)info.st_size, (uint64_t)info.st_ino, 0};
+    if ((int64_t)info.st_mtime >= (int64_t)time(NULL) - 1)
+        fields[4] = ++racy_serial;
+    *stamp = glapi_HashBytes(fields, sizeof(fields), *stamp);
+    return true;
+}
+
+bool glapi_EnsureDirectory(const char* path) {
+#ifdef _WIN32
+    int result = _mkdir(path);
+#else
+    int result = mkdir(path, 0755);
+#endif
+    FILE* probe;
+    char probe_path[1024];
+    snprintf(probe_path, sizeof(probe_path), "%s/.probe", path);
+    probe = fopen(probe_path, "wb");
+    if (!probe) {
+        fprintf(stderr, "[%s] - Cache directory '%s' is not writable (%d) in glapi_EnsureDirectory\n", _FL, path, result);
+        return false;
+    }
+    fclose(probe);
+    remove(probe_path);
+    return true;
+}
+
+uint64_t glapi_HashBytes(const void* data, size_t size, uint64_t seed) {
+    const unsigned char* bytes = (const unsigned char*)data;
+    uint64_t hash = seed ^ 0xCBF29CE484222325ull;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 0x100000001B3ull;
+    }
+    return hash;
+}
+
+APIC gl_asset_cache* asset_cache(gl_app* app) {
+    if (!app->assets) {
+        app->assets = (gl_asset_cache*)calloc(1, sizeof(gl_asset_cache));
+        if (!app->assets)
+            fprintf(stderr, "[%s] - Failure to allocate 'app->assets' to heap in asset_cache\n", _FL);
+    }
+    return app->assets;
+}
+
+APIC gl_asset* asset_find(gl_app* app, unsigned int kind, uint64_t hash) {
+    gl_asset_cache* cache = app->assets;
+    if (!cache)
+        return NULL;
+    for (size_t i = 0; i < cache->count; i++) {
+        gl_asset* asset = &cache->assets[i];
+        if (asset->kind == kind && asset->hash == hash)
+            return asset;
+    }
+    return NULL;
+}
+
+APIC gl_asset* asset_find_key(gl_app* app, unsigned int kind, const char* key, uint64_t stamp) {
+    gl_asset_cache* cache = app->assets;
+    if (!cache)
+        return NULL;
+    for (size_t i = 0; i < cache->alias_count; i++) {
+        gl_asset_alias* alias = &cache->aliases[i];
+        if (alias->kind == kind && alias->stamp == stamp && !strcmp(alias->key, key))
+            return asset_find(app, kind, alias->hash);
+    }
+    return NULL;
+}
+
+APIC gl_asset* asset_find_depends(gl_app* app, unsigned int kind, const char* key) {
+    gl_asset_cache* cache = app->assets;
+    if (!cache)
+        return NULL;
+    for (size_t i = 0; i < cache->alias_count; i++) {
+        gl_asset_alias* alias = &cache->aliases[i];
+        if (alias->kind != kind || !alias->depends || strcmp(alias->key, key))
+            continue;
+        uint64_t stamp = 0;
+        if (!asset_depends_stamp(alias->depends, &stamp) || stamp != alias->stamp)
+            return NULL;
+        return asset_find(app, kind, alias->hash);
+    }
+    return NULL;
+}
+
+APIC bool asset_depends_stamp(const char* depends, uint64_t* stamp) {
+    char fpath[1100];
+    while (*depends) {
+        const char* end = strchr(depends, '\n');
+        size_t length = end ? (size_t)(end - depends) : strlen(depends);
+        if (length >= sizeof(fpath))
+            return false;
+        memcpy(fpath, depends, length);
+        fpath[length] = '\0';
+        if (!glapi_FileStamp(fpath, stamp))
+            return false;
+        depends += end ? length + 1 : length;
+    }
+    return true;
+}
+
+APIC bool asset_alias(gl_app* app, unsigned int kind, const char* key, uint64_t stamp, uint64_t hash, char* depends) {
+    gl_asset_cache* cache = app->assets;
+    for (size_t i = 0; i < cache->alias_count; i++) {
+        gl_asset_alias* alias = &cache->aliases[i];
+        if (alias->kind == kind && !strcmp(alias->key, key)) {
+            free(alias->depends);
+            alias->depends = depends;
+            alias->stamp = stamp;
+            alias->hash = hash;
+            return true;
         }
-    } else {
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, 0);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
     }
-    glBindTexture(GL_TEXTURE_2D, 0);
-    glapi_AppendOpenGLObjects(app, T{address, TEXTURE});
+
+    if (cache->alias_count >= cache->alias_capacity) {
+        size_t capacity = cache->alias_capacity ? cache->alias_capacity * 2 : GL_ASSET_CACHE_APPEND_AMOUNT;
+        gl_asset_alias* aliases = (gl_asset_alias*)realloc(cache->aliases, capacity * sizeof(gl_asset_alias));
+        if (!aliases) {
+            fprintf(stderr, "[%s] - Failure to reallocate 'app->assets->aliases' in asset_alias\n", _FL);
+            free(depends);
+            return false;
+        }
+        cache->aliases = aliases;
+        cache->alias_capacity = capacity;
+    }
+
+    gl_asset_alias* alias = &cache->aliases[cache->alias_count];
+    alias->key = (char*)malloc(strlen(key) + 1);
+    if (!alias->key) {
+        fprintf(stderr, "[%s] - Failure to allocate alias key to heap in asset_alias\n", _FL);
+        free(depends);
+        return false;
+    }
+    strcpy(alias->key, key);
+    alias->depends = depends;
+    alias->kind = kind;
+    alias->stamp = stamp;
+    alias->hash = hash;
+    cache->alias_count++;
+    return true;
+}
+
+APIC gl_asset* asset_insert(gl_app* app, unsigned int kind, const char* key, uint64_t stamp, uint64_t hash, char* depends, GLuint object) {
+    gl_asset_cache* cache = app->assets;
+    if (cache->count >= cache->capacity) {
+        size_t capacity = cache->capacity ? cache->capacity * 2 : GL_ASSET_CACHE_APPEND_AMOUNT;
+        gl_asset* assets = (gl_asset*)realloc(cache->assets, capacity * sizeof(gl_asset));
+        if (!assets) {
+            fprintf(stderr, "[%s] - Failure to reallocate 'app->assets' in asset_insert\n", _FL);
+            free(depends);
+            return NULL;
+        }
+        cache->assets = assets;
+        cache->capacity = capacity;
+    }
+
+    gl_asset* asset = &cache->assets[cache->count];
+    asset->kind = kind;
+    asset->hash = hash;
+    asset->object = object;
+    asset->refs = 1;
+    cache->count++;
+    if (key)
+        asset_alias(app, kind, key, stamp, hash, depends);
+    else
+        free(depends);
+    return asset;
+}
+
+APIC gl_asset* asset_lookup(gl_app* app, unsigned int kind, const char* key, uint64_t stamp, uint64_t hash, char* depends) {
+    gl_asset* asset = asset_find(app, kind, hash);
+    if (asset && key)
+        asset_alias(app, kind, key, stamp, hash, depends);
+    else if (asset)
+        free(depends);
+    return asset;
+}
+
+GLuint glapi_AcquireTextureFromFpath(gl_app* app, const char* fpath, GLenum internal_format, unsigned int mips) {
+    if (!asset_cache(app))
+        return 0;
+
+    char key[1100];
+    snprintf(key, sizeof(key), "%s|%04X|%u", fpath, internal_format, mips);
+    uint64_t stamp = 0;
+    if (!glapi_FileStamp(fpath, &stamp))
+        return 0;
+
+    gl_asset* asset = asset_find_key(app, ASSET_TEXTURE, key, stamp);
+    if (asset) {
+        asset->refs++;
+        app->assets->hits++;
+        return asset->object;
+    }
+
+    size_t size;
+    unsigned char* source = glapi_ReadFile(fpath, &size);
+    if (!source)
+        return 0;
+    uint64_t salt = ((uint64_t)internal_format << 8) | mips;
+    uint64_t hash = glapi_HashBytes(source, size, salt);
+
+    asset = asset_lookup(app, ASSET_TEXTURE, key, stamp, hash, NULL);
+    if (asset) {
+        free(source);
+        asset->refs++;
+        app->assets->hits++;
+        return asset->object;
+    }
+
+    GLenum format, type;
+    GLuint channels;
+    if (!glapi_TextureUploadFormat(internal_format, &format, &type, &channels) || type != GL_UNSIGNED_BYTE) {
+        fprintf(stderr, "[%s] - Unsupported image internal format [0x%04X] in glapi_AcquireTextureFromFpath\n", _FL, internal_format);
+        free(source);
+        return 0;
+    }
+
+    glapi_BeginCpuZone("glapi_AcquireTextureFromFpath");
+    int width, height, file_channels;
+    stbi_set_flip_vertically_on_load_thread(1);
+    unsigned char* data = stbi_load_from_memory(source, (int)size, &width, &height, &file_channels, (int)channels);
+    free(source);
+    if (!data) {
+        fprintf(stderr, "[%s] - Texture load failed: %s\n", _FL, stbi_failure_reason());
+        glapi_EndCpuZone();
+        return 0;
+    }
+
+    gl_texture_desc desc;
+    memset(&desc, 0, sizeof(gl_texture_desc));
+    desc.width = width;
+    desc.height = height;
+    desc.internal_format = internal_format;
+    desc.mips = mips;
+    GLuint texture = glapi_CreateTexture(&desc, data);
+    stbi_image_free(data);
+    glapi_EndCpuZone();
+    if (!texture)
+        return 0;
+
+    if (!asset_insert(app, ASSET_TEXTURE, key, stamp, hash, NULL, texture)) {
+        glDeleteTextures(1, &texture);
+        return 0;
+    }
+    app->assets->misses++;
     return texture;
 }
 
+APIC uint64_t asset_shader_hash(const char* v_source, const char* f_source) {
+    size_t v_length = strlen(v_source);
+    uint64_t hash = glapi_HashBytes(v_source, v_length, ASSET_SHADER);
+    hash = glapi_HashBytes(&v_length, sizeof(v_length), hash);
+    return glapi_HashBytes(f_source, strlen(f_source), hash);
+}
+
+GLuint glapi_AcquireShaderProgram_s(gl_app* app, const char* v_source, const char* f_source) {
+    if (!asset_cache(app))
+        return 0;
+
+    uint64_t hash = asset_shader_hash(v_source, f_source);
+    gl_asset* asset = asset_find(app, ASSET_SHADER, hash);
+    if (asset) {
+        asset->refs++;
+        app->assets->hits++;
+        return asset->object;
+    }
+
+    GLuint sprogram = glapi_LinkShaderProgram(app, v_source, f_source);
+    if (!sprogram)
+        return 0;
+    if (!asset_insert(app, ASSET_SHADER, NULL, 0, hash, NULL, sprogram)) {
+        glDeleteProgram(sprogram);
+        return 0;
+    }
+    app->assets->misses++;
+    return sprogram;
+}
+
+APIC int asset_define_compare(const void* a, const void* b) {
+    return strcmp(*(const char* const*)a, *(const char* const*)b);
+}
+
+APIC char* asset_variant_key(const char* v_fpath, const char* f_fpath, const char** defines, size_t define_count) {
+    size_t length = strlen(v_fpath) + strlen(f_fpath) + 2;
+    for (size_t i = 0; i < define_count; i++)
+        length += strlen(defines[i]) + 1;
+    char* key = (char*)malloc(length);
+    if (!key) {
+        fprintf(stderr, "[%s] - Failure to allocate variant key to heap in asset_variant_key\n", _FL);
+        return NULL;
+    }
+    strcpy(key, v_fpath);
+    strcat(key, "|");
+    strcat(key, f_fpath);
+    for (size_t i = 0; i < define_count; i++) {
+        strcat(key, "|");
+        strcat(key, defines[i]);
+    }
+    return key;
+}
+
+GLuint glapi_AcquireShaderProgram_f(gl_app* app, const char* v_fpath, const char* f_fpath, const char** defines, size_t define_count) {
+    if (!asset_cache(app))
+        return 0;
+
+    const char** sorted = define_count ? (const char**)malloc(define_count * sizeof(const char*)) : NULL;
+    if (define_count && !sorted) {
+        fprintf(stderr, "[%s] - Failure to allocate define set to heap in glapi_AcquireShaderProgram_f\n", _FL);
+        return 0;
+    }
+    if (define_count) {
+        memcpy(sorted, defines, define_count * sizeof(const char*));
+        qsort(sorted, define_count, sizeof(const char*), asset_define_compare);
+    }
+    char* key = asset_variant_key(v_fpath, f_fpath, sorted, define_count);
+    GLuint sprogram = 0;
+    gl_asset* asset = key ? asset_find_depends(app, ASSET_SHADER, key) : NULL;
+    if (asset) {
+        asset->refs++;
+        app->assets->hits++;
+        sprogram = asset->object;
+    } else if (key) {
+        uint64_t stamp = 0;
+        char *v_depends = NULL, *f_depends = NULL, *depends = NULL;
+        char* v_source = glapi_PreprocessShaderFileDepends(v_fpath, sorted, define_count, &v_depends, &stamp);
+        char* f_source = v_source ? glapi_PreprocessShaderFileDepends(f_fpath, sorted, define_count, &f_depends, &stamp) : NULL;
+        if (v_source && f_source) {
+            size_t v_length = v_depends ? strlen(v_depends) : 0, f_length = f_depends ? strlen(f_depends) : 0;
+            depends = (char*)malloc(v_length + f_length + 1);
+            if (depends) {
+                memcpy(depends, v_depends, v_length);
+                memcpy(depends + v_length, f_depends, f_length);
+                depends[v_length + f_length] = '\0';
+            } else {
+                fprintf(stderr, "[%s] - Failure to allocate dependency list to heap in glapi_AcquireShaderProgram_f\n", _FL);
+            }
+        }
+        if (depends) {
+            uint64_t hash = asset_shader_hash(v_source, f_source);
+            asset = asset_lookup(app, ASSET_SHADER, key, stamp, hash, depends);
+            if (asset) {
+                asset->refs++;
+                app->assets->hits++;
+                sprogram = asset->object;
+            } else if ((sprogram = glapi_LinkShaderProgram(app, v_source, f_source))) {
+                if (asset_insert(app, ASSET_SHADER, key, stamp, hash, depends, sprogram)) {
+                    app->assets->misses++;
+                } else {
+                    glDeleteProgram(sprogram);
+                    sprogram = 0;
+                }
+            } else {
+                free(depends);
+            }
+        }
+        free(v_depends);
+        free(f_depends);
+        free(v_source);
+        free(f_source);
+    }
+
+    free(key);
+    free(sorted);
+    return sprogram;
+}
+
+APIC size_t asset_release(gl_app* app, unsigned int kind, GLuint object) {
+    gl_asset_cache* cache = app->assets;
+    for (size_t i = 0; cache && i < cache->count; i++) {
+        gl_asset* asset = &cache->assets[i];
+        if (asset->kind != kind || asset->object != object)
+            continue;
+        if (--asset->refs)
+            return asset->refs;
+
+        if (kind == ASSET_TEXTURE)
+            glDeleteTextures(1, &asset->object);
+        else
+            glDeleteProgram(asset->object);
+        for (size_t a = cache->alias_count; a > 0; a--) {
+            gl_asset_alias* alias = &cache->aliases[a - 1];
+            if (alias->kind != kind || alias->hash != asset->hash)
+                continue;
+            free(alias->key);
+            free(alias->depends);
+            *alias = cache->aliases[--cache->alias_count];
+        }
+        cache->assets[i] = cache->assets[--cache->count];
+        return 0;
+    }
+    fprintf(stderr, "[%s] - Object [%u] is not a cached asset in asset_release\n", _FL, object);
+    return 0;
+}
+
+size_t glapi_ReleaseTexture(gl_app* app, GLuint texture) {
+    return asset_release(app, ASSET_TEXTURE, texture);
+}
+
+size_t glapi_ReleaseShaderProgram(gl_app* app, GLuint program) {
+    return asset_release(app, ASSET_SHADER, program);
+}
+
+void glapi_DestroyAssetCache(gl_app* app) {
+    gl_asset_cache* cache = app->assets;
+    if (!cache)
+        return;
+    for (size_t i = 0; i < cache->count; i++) {
+        if (cache->assets[i].kind == ASSET_TEXTURE)
+            glDeleteTextures(1, &cache->assets[i].object);
+        else
+            glDeleteProgram(cache->assets[i].object);
+    }
+    for (size_t i = 0; i < cache->alias_count; i++) {
+        free(cache->aliases[i].key);
+        free(cache->aliases[i].depends);
+    }
+    free(cache->aliases);
+    free(cache->assets);
+    free(cache);
+    app->assets = NULL;
+}
+
 void glapi_BindVertexBufferObject(gl_vao vao) {
     glBindVertexArray(vao);
 }
@@ -456,13 +946,17 @@ void glapi_BindFrameBufferObject(gl_framebuffer framebuffer) {
 }
 
 void glapi_UnbindFrameBufferObject() {
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glBindFramebuffer(GL_FRAMEBUFFER, default_framebuffer);
 }
 
 void glapi_DrawVertexBufferObject(size_t isize) {
     glDrawElements(GL_TRIANGLES, isize/sizeof(GLuint), GL_UNSIGNED_INT, 0);
 }
 
+void glapi_DrawVertexBufferObjectInstanced(size_t isize, GLuint instance_count) {
+    glDrawElementsInstanced(GL_TRIANGLES, isize/sizeof(GLuint), GL_UNSIGNED_INT, 0, instance_count);
+}
+
 void glapi_PushIntToShader(const char* varname, int value, gl_shader shader) {
     glUseProgram(shader);
     glUniform1i(glGetUniformLocation(shader, varname), value);
@@ -501,5 +995,6 @@ void glapi_PushMatrix4x4ToShader(const char* varname, float* value, gl_shader sh
 void glapi_PushTexture2DToShader(const char* varname, gl_texture value, gl_shader shader) {
     glActiveTexture(GL_TEXTURE0);
     glBindTexture(GL_TEXTURE_2D, value);
+    glBindSampler(0, 0);
     glUniform1i(glGetUniformLocation(shader, varname), 0);
 }
\ No newline at end of file
@@ -4,6 +4,7 @@
 #include <stdlib.h>
 #include <stdbool.h>
 #include <string.h>
+#include <pthread.h>
 
 #define GL_SILENCE_DEPRECATION
 #include <glad/glad.h>
@@ -17,6 +18,87 @@
 #define SHADER 1
 #define TEXTURE 2
 #define FRAMEBUFFER 3
+#define MESH_ARENA 4
+#define INSTANCE_BUFFER 5
+#define DRAW_BATCH 6
+#define DYNAMIC_MESH 7
+#define MESH_BUFFER 8
+#define RENDER_QUEUE 9
+#define TEXTURE_ATLAS 10
+#define TEXTURE_LOADER 11
+#define RENDER_TARGET 12
+#define FRAME_GRAPH 13
+#define GPU_PROFILER 14
+#define READBACK 15
+#define BATCH_RENDERER 16
+#define SHADER_PROGRAM 17
+#define TEXTURE_HANDLE 18
+
+#define ARENA_LAYOUT_UVS 0x1
+#define ARENA_LAYOUT_NORMALS 0x2
+#define ARENA_INVALID_MESH 0xFFFFFFFFu
+
+#define INSTANCE_LAYOUT_MATRIX 0x1
+#define INSTANCE_LAYOUT_COLOR 0x2
+#define INSTANCE_ATTRIB_MATRIX 3
+#define INSTANCE_ATTRIB_COLOR 7
+
+#define DRAW_BATCH_ATTRIB_DRAW_ID 8
+#define DRAW_BATCH_TEXTURE_UNIT 1
+
+#define DYNAMIC_MESH_REGIONS 3
+
+#define MESH_MAX_LODS 8
+
+#define RENDER_QUEUE_MAX_TEXTURES 4
+#define RENDER_UNIFORM_INT 0
+#define RENDER_UNIFORM_FLOAT 1
+#define RENDER_UNIFORM_VEC2 2
+#define RENDER_UNIFORM_VEC3 3
+#define RENDER_UNIFORM_VEC4 4
+#define RENDER_UNIFORM_MAT3 5
+#define RENDER_UNIFORM_MAT4 6
+
+#define TEXTURE_MIPS_NONE 0
+#define TEXTURE_MIPS_GPU 1
+#define TEXTURE_MIPS_CPU 2
+
+#define TEXTURE_LOAD_PENDING 0
+#define TEXTURE_LOAD_DECODED 1
+#define TEXTURE_LOAD_READY 2
+#define TEXTURE_LOAD_FAILED 3
+#define TEXTURE_LOADER_INVALID_HANDLE 0xFFFFFFFFu
+
+#define RENDER_TARGET_MAX_COLOR 8
+
+#define FRAME_GRAPH_INVALID 0xFFFFFFFFu
+#define FRAME_GRAPH_MAX_READS 8
+#define FRAME_GRAPH_PASS_PRESENT 0x1
+
+#define GPU_PROFILER_FRAMES 4
+#define GPU_PROFILER_MAX_SCOPES 64
+#define GPU_PROFILER_MAX_DEPTH 16
+#define GPU_PROFILER_NAME_LENGTH 48
+
+#define READBACK_SLOTS 3
+#define READBACK_INVALID 0xFFFFFFFFu
+
+#define FRAME_PACER_HISTORY 512
+#define FRAME_PACER_BUCKETS 15
+#define FRAME_PACER_MAX_IN_FLIGHT 8
+
+#define BATCH_MAX_UNIFORMS 16
+#define BATCH_NAME_LENGTH 32
+
+#define ASSET_TEXTURE 0
+#define ASSET_SHADER 1
+
+#define SAMPLER_FILTER_NEAREST 0
+#define SAMPLER_FILTER_BILINEAR 1
+#define SAMPLER_FILTER_TRILINEAR 2
+#define SAMPLER_WRAP_REPEAT 0
+#define SAMPLER_WRAP_CLAMP 1
+#define SAMPLER_WRAP_MIRROR 2
 
 typedef GLuint gl_shader;
 typedef GLuint gl_texture;
@@ -43,35 +125,814 @@ typedef struct gl_mesh {
     size_t normals_size;
 } gl_mesh;
 
+typedef struct gl_arena_range {
+    GLuint offset;
+    GLuint count;
+} gl_arena_range;
+
+typedef struct gl_arena_freelist {
+    gl_arena_range* ranges;
+    size_t range_count;
+    size_t range_capacity;
+} gl_arena_freelist;
+
+typedef struct gl_arena_mesh {
+    GLint base_vertex;
+    GLuint vertex_count;
+    GLuint first_index;
+    GLuint index_count;
+    bool live;
+} gl_arena_mesh;
+
+typedef struct gl_mesh_arena {
+    gl_vao vao;
+    GLuint vbo;
+    GLuint ebo;
+    unsigned int layout;
+    GLsizei stride;
+    GLuint vertex_capacity;
+    GLuint index_capacity;
+    gl_arena_freelist vertex_free;
+    gl_arena_freelist index_free;
+    gl_arena_mesh* meshes;
+    size_t mesh_count;
+    size_t mesh_capacity;
+} gl_mesh_arena;
+
+typedef struct gl_instance_buffer {
+    GLuint vbo;
+    unsigned int layout;
+    GLuint capacity;
+    GLuint count;
+    gl_vao* attached_vaos;
+    size_t attached_vao_count;
+    size_t attached_vao_capacity;
+    GLfloat* scratch;
+    size_t scratch_capacity;
+} gl_instance_buffer;
+
+typedef struct gl_draw_elements_indirect_command {
+    GLuint count;
+    GLuint instance_count;
+    GLuint first_index;
+    GLint base_vertex;
+    GLuint base_instance;
+} gl_draw_elements_indirect_command;
+
+typedef struct gl_draw_batch {
+    gl_mesh_arena* arena;
+    GLuint indirect_buffer;
+    GLuint draw_id_buffer;
+    GLuint draw_data_buffer;
+    gl_texture draw_data_texture;
+    GLuint draw_data_vec4s;
+    gl_draw_elements_indirect_command* commands;
+    GLfloat* draw_data;
+    size_t draw_count;
+    size_t draw_capacity;
+    size_t uploaded_capacity;
+    bool multi_draw_indirect;
+} gl_draw_batch;
+
+typedef struct gl_dirty_range {
+    GLuint begin;
+    GLuint end;
+} gl_dirty_range;
+
+typedef struct gl_dynamic_mesh {
+    gl_vao vao;
+    GLuint vbo;
+    GLuint ebo;
+    unsigned int layout;
+    GLsizei stride;
+    GLuint max_vertices;
+    GLuint max_indices;
+    GLuint vertex_count;
+    GLuint index_count;
+    GLfloat* vertices;
+    GLuint* indices;
+    unsigned char* mapped_vertices;
+    unsigned char* mapped_indices;
+    GLsync fences[DYNAMIC_MESH_REGIONS];
+    gl_dirty_range vertex_dirty[DYNAMIC_MESH_REGIONS];
+    gl_dirty_range index_dirty[DYNAMIC_MESH_REGIONS];
+    GLuint draw_region;
+    GLuint draw_index_count;
+    bool persistent;
+    size_t deferred_commits;
+} gl_dynamic_mesh;
+
+typedef struct gl_mesh_stats {
+    GLuint vertices_before;
+    GLuint vertices_after;
+    GLuint triangles;
+    float acmr_before;
+    float acmr_after;
+    bool overdraw_sorted;
+} gl_mesh_stats;
+
+typedef struct gl_mesh_lod {
+    GLuint first_index;
+    GLuint index_count;
+    float error;
+} gl_mesh_lod;
+
+typedef struct gl_mesh_buffer {
+    gl_vao vao;
+    GLuint vbo;
+    GLuint ebo;
+    unsigned int layout;
+    GLsizei stride;
+    GLenum index_type;
+    GLuint index_count;
+    GLuint vertex_count;
+    gl_mesh_stats stats;
+    float center[3];
+    float radius;
+    gl_mesh_lod lods[MESH_MAX_LODS];
+    GLuint lod_count;
+    GLuint lod;
+} gl_mesh_buffer;
+
+typedef struct gl_render_uniform {
+    GLint location;
+    unsigned int type;
+    union {
+        GLint i;
+        GLfloat f[16];
+    } value;
+} gl_render_uniform;
+
+typedef struct gl_render_item {
+    gl_shader shader;
+    gl_vao vao;
+    gl_texture textures[RENDER_QUEUE_MAX_TEXTURES];
+    GLuint texture_count;
+    GLenum index_type;
+    GLuint index_count;
+    GLuint first_index;
+    GLint base_vertex;
+    GLuint instance_count;
+    float depth;
+    bool transparent;
+    GLuint uniform_first;
+    GLuint uniform_count;
+} gl_render_item;
+
+typedef struct gl_render_stats {
+    size_t draws;
+    size_t state_changes;
+    size_t state_changes_unsorted;
+} gl_render_stats;
+
+typedef struct gl_render_queue {
+    gl_render_item* items;
+    size_t item_count;
+    size_t item_capacity;
+    gl_render_uniform* uniforms;
+    size_t uniform_count;
+    size_t uniform_capacity;
+    uint64_t* keys;
+    uint32_t* order;
+    gl_render_stats stats;
+} gl_render_queue;
+
+typedef struct gl_texture_desc {
+    GLsizei width;
+    GLsizei height;
+    GLenum internal_format;
+    GLsizei levels;
+    unsigned int mips;
+} gl_texture_desc;
+
+typedef struct gl_atlas_rect {
+    GLuint layer;
+    GLfloat u0, v0, u1, v1;
+    GLuint width;
+    GLuint height;
+} gl_atlas_rect;
+
+typedef struct gl_texture_atlas {
+    gl_texture texture;
+    GLenum internal_format;
+    GLsizei width;
+    GLsizei height;
+    GLsizei layers;
+    GLsizei levels;
+    GLuint padding;
+    gl_atlas_rect* rects;
+    size_t rect_count;
+} gl_texture_atlas;
+
+typedef struct gl_compressed_stats {
+    GLenum internal_format;
+    GLenum storage_format;
+    GLsizei width;
+    GLsizei height;
+    GLsizei levels;
+    size_t gpu_bytes;
+    bool transcoded;
+    bool cache_hit;
+} gl_compressed_stats;
+
+typedef struct gl_sampler_cache {
+    uint32_t* keys;
+    GLuint* samplers;
+    size_t count;
+    size_t capacity;
+    float max_anisotropy;
+} gl_sampler_cache;
+
+typedef struct gl_asset {
+    unsigned int kind;
+    uint64_t hash;
+    GLuint object;
+    size_t refs;
+} gl_asset;
+
+typedef struct gl_asset_alias {
+    unsigned int kind;
+    char* key;
+    char* depends;
+    uint64_t stamp;
+    uint64_t hash;
+} gl_asset_alias;
+
+typedef struct gl_asset_cache {
+    gl_asset* assets;
+    size_t count;
+    size_t capacity;
+    gl_asset_alias* aliases;
+    size_t alias_count;
+    size_t alias_capacity;
+    size_t hits;
+    size_t misses;
+} gl_asset_cache;
+
+typedef struct gl_program_cache {
+    char* directory;
+    uint64_t context_hash;
+    size_t hits;
+    size_t misses;
+    size_t rejected;
+} gl_program_cache;
+
+typedef struct gl_program_build {
+    const char* v_source;
+    const char* f_source;
+    GLuint program;
+    char* log;
+    bool cached;
+} gl_program_build;
+
+typedef struct gl_render_target gl_render_target;
+
 typedef struct gl_window {
     gl_apiwindow* pointer;
     uint16_t window_width;
     uint16_t window_height;
     float r, g, b;
+    bool headless;
+    void* display;
+    void* context;
+    gl_render_target* offscreen;
+    uint64_t frames;
+    uint64_t frame_budget;
+    bool close_requested;
 } gl_window;
 
-typedef struct gl_app {
+typedef struct gl_app gl_app;
+typedef bool (*gl_latch_update)(gl_app* app, void* data, size_t size, void* user);
+typedef void (*gl_latch_release)(void* user);
+
+typedef struct gl_late_latch {
+    GLuint buffer;
+    GLuint binding;
+    size_t size;
+    void* staging;
+    gl_latch_update update;
+    gl_latch_release release;
+    void* user;
+} gl_late_latch;
+
+typedef struct gl_frame_pacer {
+    int swap_interval;
+    double target_fps;
+    uint64_t period_ns;
+    uint64_t deadline_ns;
+    uint64_t spin_margin_ns;
+    uint64_t last_frame_ns;
+    float history[FRAME_PACER_HISTORY];
+    size_t history_head;
+    size_t history_count;
+    uint64_t frames;
+    size_t missed;
+    GLuint max_in_flight;
+    GLsync fences[FRAME_PACER_MAX_IN_FLIGHT];
+    uint64_t fence_start_ns[FRAME_PACER_MAX_IN_FLIGHT];
+    GLuint fence_head;
+    GLuint fence_count;
+    uint64_t frame_start_ns;
+    float latency[FRAME_PACER_HISTORY];
+    size_t latency_head;
+    size_t latency_count;
+    uint64_t wait_total_ns;
+    uint64_t wait_frames;
+    gl_late_latch latch;
+} gl_frame_pacer;
+
+typedef struct gl_frame_stats {
+    size_t count;
+    uint64_t frames;
+    size_t missed;
+    double mean_ms;
+    double min_ms;
+    double max_ms;
+    double p50_ms;
+    double p95_ms;
+    double p99_ms;
+    double fps;
+    size_t histogram[FRAME_PACER_BUCKETS];
+    size_t latency_count;
+    double latency_mean_ms;
+    double latency_p50_ms;
+    double latency_p99_ms;
+    double latency_max_ms;
+    double wait_mean_ms;
+    GLuint in_flight;
+} gl_frame_stats;
+
+struct gl_app {
     gl_window* window;
     void* resources;
-} gl_app;
+    gl_sampler_cache* samplers;
+    gl_asset_cache* assets;
+    gl_program_cache* programs;
+    gl_frame_pacer* pacer;
+    uint64_t frame_begin_ns;
+};
+
+typedef struct gl_texture_request {
+    char* fpath;
+    GLenum internal_format;
+    unsigned int mips;
+    unsigned int status;
+    gl_texture texture;
+    GLsizei width;
+    GLsizei height;
+    unsigned char* pixels;
+} gl_texture_request;
+
+typedef struct gl_texture_loader {
+    gl_app* app;
+    pthread_t* workers;
+    GLuint worker_count;
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    pthread_cond_t decoded;
+    bool stopping;
+    gl_texture_request* requests;
+    size_t request_count;
+    size_t request_capacity;
+    size_t* pending;
+    size_t pending_head;
+    size_t pending_count;
+    size_t pending_capacity;
+    size_t* completed;
+    size_t completed_count;
+    size_t completed_capacity;
+    size_t in_flight;
+    size_t upload_budget;
+    size_t uploaded_bytes;
+    gl_texture placeholder;
+} gl_texture_loader;
+
+typedef struct gl_render_target_desc {
+    GLsizei width;
+    GLsizei height;
+    GLsizei samples;
+    GLuint color_count;
+    GLenum color_formats[RENDER_TARGET_MAX_COLOR];
+    GLenum depth_format;
+    bool depth_texture;
+} gl_render_target_desc;
+
+struct gl_render_target {
+    gl_render_target_desc desc;
+    gl_framebuffer framebuffer;
+    gl_framebuffer resolve_framebuffer;
+    GLuint color_buffers[RENDER_TARGET_MAX_COLOR];
+    GLuint depth_buffer;
+    gl_texture color_textures[RENDER_TARGET_MAX_COLOR];
+    gl_texture depth_texture;
+    bool borrowed_color;
+};
+
+typedef struct gl_readback_slot {
+    GLuint pbo;
+    GLsync fence;
+    size_t capacity;
+    size_t size;
+    GLsizei width;
+    GLsizei height;
+    uint64_t frame;
+    void* data;
+    bool pending;
+} gl_readback_slot;
+
+typedef struct gl_readback {
+    gl_app* app;
+    gl_readback_slot* slots;
+    GLuint slot_count;
+    GLuint head;
+    GLenum internal_format;
+    GLenum format;
+    GLenum type;
+    GLuint channels;
+    GLuint pixel_size;
+    uint64_t frame_number;
+    size_t issued;
+    size_t completed;
+    size_t dropped;
+    size_t skipped;
+} gl_readback;
+
+typedef struct gl_batch_uniform {
+    char name[48];
+    unsigned int type;
+    GLuint offset;
+} gl_batch_uniform;
+
+typedef struct gl_batch_program {
+    GLuint program;
+    GLint locations[BATCH_MAX_UNIFORMS];
+    GLuint uniform_count;
+    uint64_t stamp;
+} gl_batch_program;
+
+typedef struct gl_batch_output {
+    char name[BATCH_NAME_LENGTH];
+    gl_readback* readback;
+    void* memory;
+    size_t frame_size;
+} gl_batch_output;
+
+typedef struct gl_batch_job {
+    GLuint slot;
+    GLuint output;
+    size_t index;
+    size_t item;
+    const void* pixels;
+} gl_batch_job;
+
+typedef struct gl_batch_renderer gl_batch_renderer;
+typedef bool (*gl_batch_scene)(gl_batch_renderer* batch, size_t index, const float* params, void* user);
+
+struct gl_batch_renderer {
+    gl_app* app;
+    gl_render_target* target;
+    gl_batch_output outputs[RENDER_TARGET_MAX_COLOR];
+    GLuint output_count;
+    gl_batch_uniform uniforms[BATCH_MAX_UNIFORMS];
+    GLuint uniform_count;
+    GLuint param_count;
+    gl_batch_program* programs;
+    GLuint program_count;
+    GLuint program_capacity;
+    uint64_t stamp;
+    GLuint slot_count;
+    size_t* slot_items;
+    GLuint* slot_remaining;
+    size_t first_item;
+    char* directory;
+    pthread_t* writers;
+    GLuint writer_count;
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    pthread_cond_t finished;
+    bool stopping;
+    gl_batch_job* jobs;
+    size_t job_head;
+    size_t job_count;
+    size_t job_capacity;
+    size_t rendered;
+    size_t written;
+    size_t failed;
+};
+
+typedef struct gl_gpu_scope {
+    char name[GPU_PROFILER_NAME_LENGTH];
+    GLuint depth;
+    bool closed;
+} gl_gpu_scope;
+
+typedef struct gl_gpu_frame {
+    GLuint queries[2 * GPU_PROFILER_MAX_SCOPES + 2];
+    gl_gpu_scope scopes[GPU_PROFILER_MAX_SCOPES];
+    GLuint scope_count;
+    uint64_t frame;
+    bool pending;
+} gl_gpu_frame;
+
+typedef struct gl_gpu_timing {
+    char name[GPU_PROFILER_NAME_LENGTH];
+    GLuint depth;
+    double ms;
+} gl_gpu_timing;
+
+typedef struct gl_gpu_profiler {
+    gl_gpu_frame* frames;
+    GLuint frame_count;
+    GLuint current;
+    GLuint stack[GPU_PROFILER_MAX_DEPTH];
+    GLuint depth;
+    GLuint untracked;
+    bool recording;
+    uint64_t frame_number;
+    gl_gpu_timing timings[GPU_PROFILER_MAX_SCOPES];
+    GLuint timing_count;
+    double frame_ms;
+    uint64_t report_frame;
+    size_t dropped;
+    size_t overflow;
+} gl_gpu_profiler;
+
+typedef struct gl_frame_graph gl_frame_graph;
+typedef bool (*gl_graph_execute)(gl_frame_graph* graph, uint32_t pass, void* user);
+typedef void (*gl_graph_release)(void* user);
+
+typedef struct gl_graph_resource {
+    char* name;
+    GLenum format;
+    float scale;
+    GLsizei width;
+    GLsizei height;
+    gl_texture imported;
+    bool exported;
+    uint32_t first;
+    uint32_t last;
+    uint32_t physical;
+} gl_graph_resource;
+
+typedef struct gl_graph_pass {
+    const char* name;
+    gl_graph_execute execute;
+    void* user;
+    unsigned int flags;
+    uint32_t reads[FRAME_GRAPH_MAX_READS];
+    GLuint read_count;
+    uint32_t writes[RENDER_TARGET_MAX_COLOR];
+    GLuint write_count;
+    uint32_t depth;
+    gl_framebuffer framebuffer;
+    GLsizei width;
+    GLsizei height;
+    bool culled;
+} gl_graph_pass;
 
+typedef struct gl_graph_texture {
+    gl_texture texture;
+    GLenum format;
+    GLsizei width;
+    GLsizei height;
+    uint32_t busy_until;
+    bool used;
+} gl_graph_texture;
+
+typedef struct gl_frame_graph_stats {
+    size_t passes;
+    size_t culled;
+    size_t resources;
+    size_t textures;
+    size_t bytes;
+    size_t unaliased_bytes;
+} gl_frame_graph_stats;
+
+struct gl_frame_graph {
+    gl_app* app;
+    GLsizei width;
+    GLsizei height;
+    gl_graph_resource* resources;
+    size_t resource_count;
+    size_t resource_capacity;
+    gl_graph_pass* passes;
+    size_t pass_count;
+    size_t pass_capacity;
+    uint32_t* order;
+    size_t order_count;
+    gl_graph_texture* pool;
+    size_t pool_count;
+    size_t pool_capacity;
+    gl_graph_release release;
+    gl_gpu_profiler* profiler;
+    gl_frame_graph_stats stats;
+    bool compiled;
+};
+
+API void check_gl_error(const char* operation);
 API void glapi_AppendOpenGLObjects(gl_app* app, globject_tcouple tcouple);
+API void glapi_AppendTextureObject(gl_app* app, GLuint texture, GLuint* address);
 
 API void glapi_EnableDepthTest();
 API void glapi_DisableDepthTest();
 
+API gl_app* glapi_CreateHeadlessApp(uint16_t width, uint16_t height, float r, float g, float b);
+API void glapi_DestroyHeadlessContext(gl_app* app);
+API void* glapi_CreateAppResources(void);
+API gl_framebuffer glapi_DefaultFramebuffer(void);
+API void glapi_SetDefaultFramebuffer(gl_framebuffer framebuffer);
 API gl_app* glapi_CreateApp(uint16_t window_width, uint16_t window_height, const char* title, bool resizable, float r, float g, float b);
 API int glapi_DestroyApp(gl_app* app);
 API void glapi_BindApp(gl_app* app);
 API void glapi_UnbindApp(gl_app* app);
 API int glapi_ShouldAppClose(gl_app* app);
+API void glapi_RequestAppClose(gl_app* app);
 
 API GLuint glapi_GenShaderProgram_f(gl_app* app, const char* v_fpath, const char* f_fpath, GLuint* address);
 API GLuint glapi_GenFrameBuffer(gl_app* app, gl_texture output_tex, GLuint* address, uint16_t width, uint16_t height);
 API GLuint glapi_GenShaderProgram_s(gl_app* app, const char* v_source, const char* f_source, GLuint* address);
+API GLuint glapi_LinkShaderProgram(gl_app* app, const char* v_source, const char* f_source);
+API size_t glapi_BuildShaderPrograms(gl_app* app, gl_program_build* builds, size_t count);
+API size_t glapi_GenShaderPrograms(gl_app* app, gl_program_build* builds, size_t count);
+API void glapi_FreeProgramBuildLogs(gl_program_build* builds, size_t count);
+API char* glapi_PreprocessShaderFile(const char* fpath, const char** defines, size_t define_count);
+API char* glapi_PreprocessShaderFileDepends(const char* fpath, const char** defines, size_t define_count, char** depends, uint64_t* stamp);
+API bool glapi_SetProgramCacheDirectory(gl_app* app, const char* directory);
+API void glapi_DestroyProgramCache(gl_app* app);
 API GLuint glapi_GenVertexBufferObjectFromMesh(gl_app* app, gl_mesh* mesh, GLuint* address);
 API GLuint glapi_GenTextureFromFpath(gl_app* app, const char* fpath, GLuint* address);
 
+API uint64_t glapi_HashBytes(const void* data, size_t size, uint64_t seed);
+API bool glapi_EnsureDirectory(const char* path);
+API bool glapi_FileStamp(const char* fpath, uint64_t* stamp);
+API unsigned char* glapi_ReadFile(const char* fpath, size_t* size);
+API bool glapi_GrowArray(void** array, size_t* capacity, size_t count, size_t size, size_t append_amount);
+API GLuint glapi_AcquireTextureFromFpath(gl_app* app, const char* fpath, GLenum internal_format, unsigned int mips);
+API GLuint glapi_AcquireShaderProgram_s(gl_app* app, const char* v_source, const char* f_source);
+API GLuint glapi_AcquireShaderProgram_f(gl_app* app, const char* v_fpath, const char* f_fpath, const char** defines, size_t define_count);
+API size_t glapi_ReleaseTexture(gl_app* app, GLuint texture);
+API size_t glapi_ReleaseShaderProgram(gl_app* app, GLuint program);
+API void glapi_DestroyAssetCache(gl_app* app);
+
+API GLsizei glapi_TextureMipLevels(GLsizei width, GLsizei height);
+API GLsizei glapi_TextureTexelSize(GLenum internal_format);
+API void glapi_DownsampleImage(const void* src, GLsizei src_width, GLsizei src_height, void* dst, GLsizei dst_width, GLsizei dst_height, GLenum type, GLuint channels, bool srgb);
+API bool glapi_TextureUploadFormat(GLenum internal_format, GLenum* format, GLenum* type, GLuint* channels);
+API GLuint glapi_CreateTexture(const gl_texture_desc* desc, const void* pixels);
+API GLuint glapi_GenTexture(gl_app* app, const gl_texture_desc* desc, const void* pixels, GLuint* address);
+API GLuint glapi_GenTextureFromFpathFormat(gl_app* app, const char* fpath, GLenum internal_format, unsigned int mips, GLuint* address);
+API GLuint glapi_GetSampler(gl_app* app, unsigned int filter, unsigned int wrap, float anisotropy);
+API void glapi_DestroySamplerCache(gl_app* app);
+API void glapi_BindTextureUnit(GLuint unit, gl_texture texture, GLuint sampler);
+
+API const uint16_t bc7_partitions2[64];
+API const unsigned char bc7_anchor2[64];
+
+API bool glapi_IsCompressedFormatSupported(GLenum format);
+API bool glapi_CanDecodeCompressedFormat(GLenum format);
+API bool glapi_DecodeCompressedImage(GLenum format, const void* data, GLsizei width, GLsizei height, unsigned char* rgba);
+API GLuint glapi_GenCompressedTexture(gl_app* app, GLenum internal_format, GLsizei width, GLsizei height, GLsizei levels, unsigned char* const* level_data, const size_t* level_size, gl_compressed_stats* stats, GLuint* address);
+API GLuint glapi_GenCompressedTextureFromFpath(gl_app* app, const char* fpath, gl_compressed_stats* stats, GLuint* address);
+
+API size_t glapi_CompressedImageSize(GLenum format, GLsizei width, GLsizei height);
+API bool glapi_CompressImage(GLenum format, const unsigned char* rgba, GLsizei width, GLsizei height, unsigned char* out, GLuint threads);
+API GLuint glapi_GenTextureFromFpathCompressed(gl_app* app, const char* fpath, GLenum format, const char* cache_dir, GLuint threads, gl_compressed_stats* stats, GLuint* address);
+API GLuint glapi_HardwareThreadCount(void);
+
+API gl_texture_loader* glapi_GenTextureLoader(gl_app* app, GLuint threads, size_t upload_budget);
+API uint32_t glapi_LoadTextureAsync(gl_texture_loader* loader, const char* fpath, GLenum internal_format, unsigned int mips);
+API gl_texture glapi_TextureLoaderTexture(gl_texture_loader* loader, uint32_t handle);
+API unsigned int glapi_TextureLoaderStatus(gl_texture_loader* loader, uint32_t handle);
+API size_t glapi_PumpTextureLoader(gl_texture_loader* loader);
+API void glapi_FinishTextureLoader(gl_texture_loader* loader);
+API void glapi_DestroyTextureLoader(gl_texture_loader* loader);
+
+API GLenum glapi_RenderTargetAttachment(GLenum internal_format);
+API gl_texture glapi_CreateRenderTexture(GLenum internal_format, GLsizei width, GLsizei height);
+API gl_render_target* glapi_GenRenderTarget(gl_app* app, const gl_render_target_desc* desc);
+API gl_render_target* glapi_CreateRenderTarget(const gl_render_target_desc* desc);
+API void glapi_BindRenderTarget(gl_render_target* target);
+API void glapi_UnbindRenderTarget(gl_app* app);
+API void glapi_ResolveRenderTarget(gl_render_target* target);
+API void glapi_BlitRenderTarget(gl_render_target* target, GLuint attachment, gl_framebuffer destination, GLsizei width, GLsizei height);
+API void glapi_DestroyRenderTarget(gl_render_target* target);
+API gl_readback* glapi_GenReadback(gl_app* app, GLuint slots, GLuint channels);
+API gl_readback* glapi_GenReadbackFormat(gl_app* app, GLuint slots, GLenum internal_format);
+API gl_readback* glapi_CreateReadback(gl_app* app, GLuint slots, GLenum internal_format);
+API bool glapi_ReadbackFramebuffer(gl_readback* readback, gl_framebuffer framebuffer, GLuint attachment, GLint x, GLint y, GLsizei width, GLsizei height);
+API GLuint glapi_MapReadback(gl_readback* readback, bool wait);
+API void glapi_UnmapReadback(gl_readback* readback, GLuint index);
+API void glapi_DestroyReadback(gl_readback* readback);
+
+API gl_batch_renderer* glapi_GenBatchRenderer(gl_app* app, const gl_render_target_desc* desc, const char** names, GLuint slots, GLuint writers);
+API bool glapi_BatchRendererUniform(gl_batch_renderer* batch, const char* name, unsigned int type);
+API bool glapi_SetBatchOutputMemory(gl_batch_renderer* batch, GLuint output, void* memory);
+API bool glapi_SetBatchOutputDirectory(gl_batch_renderer* batch, const char* directory);
+API size_t glapi_BatchRender(gl_batch_renderer* batch, gl_render_queue* queue, const float* params, size_t count, size_t first_item, gl_batch_scene scene, void* user);
+API void glapi_DestroyBatchRenderer(gl_batch_renderer* batch);
+
+API bool glapi_SetSwapInterval(gl_app* app, int interval);
+API int glapi_SwapInterval(gl_app* app);
+API void glapi_SetFrameCap(gl_app* app, double fps);
+API void glapi_SetMaxFramesInFlight(gl_app* app, GLuint frames);
+API GLuint glapi_MaxFramesInFlight(gl_app* app);
+API bool glapi_SetLateLatch(gl_app* app, GLuint binding, size_t size, gl_latch_update update, void* user, gl_latch_release release);
+API bool glapi_LatchFrame(gl_app* app);
+API void glapi_StartFrame(gl_app* app);
+API void glapi_PaceFrame(gl_app* app);
+API void glapi_ThrottleFrame(gl_app* app);
+API void glapi_RecordFrame(gl_app* app);
+API bool glapi_FrameStats(gl_app* app, gl_frame_stats* stats);
+API const double* glapi_FrameHistogramEdges(void);
+API void glapi_ResetFrameStats(gl_app* app);
+API void glapi_DestroyFramePacer(gl_app* app);
+
+API gl_frame_graph* glapi_GenFrameGraph(gl_app* app, GLsizei width, GLsizei height);
+API uint32_t glapi_GraphCreateResource(gl_frame_graph* graph, const char* name, GLenum format, float scale);
+API uint32_t glapi_GraphImportTexture(gl_frame_graph* graph, const char* name, gl_texture texture, GLsizei width, GLsizei height);
+API void glapi_GraphExportResource(gl_frame_graph* graph, uint32_t resource);
+API uint32_t glapi_GraphAddPass(gl_frame_graph* graph, const char* name, gl_graph_execute execute, void* user, unsigned int flags);
+API bool glapi_GraphPassRead(gl_frame_graph* graph, uint32_t pass, uint32_t resource);
+API bool glapi_GraphPassWrite(gl_frame_graph* graph, uint32_t pass, uint32_t resource);
+API bool glapi_CompileFrameGraph(gl_frame_graph* graph);
+API bool glapi_ExecuteFrameGraph(gl_frame_graph* graph);
+API gl_texture glapi_GraphResourceTexture(gl_frame_graph* graph, uint32_t resource);
+API void glapi_ResizeFrameGraph(gl_frame_graph* graph, GLsizei width, GLsizei height);
+API void glapi_ResetFrameGraph(gl_frame_graph* graph);
+API void glapi_DestroyFrameGraph(gl_frame_graph* graph);
+
+API gl_gpu_profiler* glapi_GenGpuProfiler(gl_app* app, GLuint frames);
+API void glapi_BeginGpuFrame(gl_gpu_profiler* profiler);
+API void glapi_EndGpuFrame(gl_gpu_profiler* profiler);
+API bool glapi_BeginGpuScope(gl_gpu_profiler* profiler, const char* name);
+API void glapi_EndGpuScope(gl_gpu_profiler* profiler);
+API bool glapi_CollectGpuProfiler(gl_gpu_profiler* profiler);
+API void glapi_DestroyGpuProfiler(gl_gpu_profiler* profiler);
+
+API uint64_t glapi_NowNanoseconds(void);
+API void glapi_EnableCpuProfiler(bool enabled);
+API bool glapi_IsCpuProfilerEnabled(void);
+API void glapi_NameCpuThread(const char* name);
+API const char* glapi_InternCpuZoneName(const char* name);
+API void glapi_BeginCpuZone(const char* name);
+API void glapi_EndCpuZone(void);
+API void glapi_RecordCpuZone(const char* name, uint64_t begin, uint64_t end);
+API void glapi_ResetCpuProfiler(void);
+API bool glapi_DumpCpuProfile(const char* fpath, size_t* event_count);
+
+API gl_texture_atlas* glapi_GenTextureArray(gl_app* app, const char** fpaths, size_t count, GLenum internal_format, unsigned int mips);
+API gl_texture_atlas* glapi_GenTextureAtlas(gl_app* app, const char** fpaths, size_t count, GLsizei max_size, GLuint padding, GLenum internal_format, unsigned int mips);
+API void glapi_BindTextureAtlas(GLuint unit, gl_texture_atlas* atlas, GLuint sampler);
+API void glapi_DestroyTextureAtlas(gl_texture_atlas* atlas);
+
+API gl_mesh_arena* glapi_GenMeshArena(gl_app* app, unsigned int layout, GLuint vertex_capacity, GLuint index_capacity);
+API GLuint glapi_GenVertexBufferObjectFromMeshInArena(gl_mesh_arena* arena, gl_mesh* mesh);
+API bool glapi_FreeArenaMesh(gl_mesh_arena* arena, GLuint mesh);
+API bool glapi_DefragMeshArena(gl_mesh_arena* arena);
+API void glapi_DestroyMeshArena(gl_mesh_arena* arena);
+API void glapi_BindMeshArena(gl_mesh_arena* arena);
+API void glapi_DrawArenaMesh(gl_mesh_arena* arena, GLuint mesh);
+
+API gl_instance_buffer* glapi_GenInstanceBuffer(gl_app* app, unsigned int layout, GLuint capacity);
+API bool glapi_AttachInstanceBuffer(gl_instance_buffer* instances, gl_vao vao);
+API bool glapi_UpdateInstanceBuffer(gl_instance_buffer* instances, const GLfloat* matrices, const GLfloat* colors, GLuint count);
+API bool glapi_UpdateInstanceBufferTRS(gl_instance_buffer* instances, const GLfloat* trs, const GLfloat* colors, GLuint count);
+API void glapi_DestroyInstanceBuffer(gl_instance_buffer* instances);
+API void glapi_DrawVertexBufferObjectInstanced(size_t isize, GLuint instance_count);
+API void glapi_DrawArenaMeshInstanced(gl_mesh_arena* arena, GLuint mesh, GLuint instance_count);
+
+API gl_draw_batch* glapi_GenDrawBatch(gl_app* app, gl_mesh_arena* arena, GLuint draw_data_vec4s);
+API void glapi_AppendDrawBatch(gl_draw_batch* batch, GLuint mesh, const GLfloat* draw_data);
+API void glapi_ClearDrawBatch(gl_draw_batch* batch);
+API void glapi_DrawBatch(gl_draw_batch* batch);
+API void glapi_DestroyDrawBatch(gl_draw_batch* batch);
+API void glapi_PushDrawBatchToShader(const char* varname, gl_draw_batch* batch, gl_shader shader);
+
+API gl_dynamic_mesh* glapi_GenDynamicMesh(gl_app* app, unsigned int layout, GLuint max_vertices, GLuint max_indices);
+API void glapi_UpdateDynamicMeshVertices(gl_dynamic_mesh* mesh, GLuint first_vertex, GLuint count, const GLfloat* positions, const GLfloat* uvs, const GLfloat* normals);
+API void glapi_UpdateDynamicMeshIndices(gl_dynamic_mesh* mesh, GLuint first_index, GLuint count, const GLuint* indices);
+API void glapi_SetDynamicMeshCounts(gl_dynamic_mesh* mesh, GLuint vertex_count, GLuint index_count);
+API bool glapi_CommitDynamicMesh(gl_dynamic_mesh* mesh);
+API void glapi_DrawDynamicMesh(gl_dynamic_mesh* mesh);
+API void glapi_DestroyDynamicMesh(gl_dynamic_mesh* mesh);
+
+API float glapi_MeshACMR(const GLuint* indices, GLuint index_count, GLuint vertex_count);
+API bool glapi_OptimizeMesh(gl_mesh* mesh, gl_mesh_stats* stats);
+API void glapi_OptimizeVertexCache(GLuint* dst, const GLuint* indices, GLuint index_count, GLuint vertex_count);
+API GLuint glapi_SimplifyMesh(GLuint* dst, const GLuint* indices, GLuint index_count, const GLfloat* positions, GLuint vertex_count, GLuint target_index_count, float target_error, float* result_error);
+API gl_mesh_buffer* glapi_GenMeshBuffer(gl_app* app, gl_mesh* mesh, bool optimize, GLuint max_lods);
+API GLuint glapi_SelectMeshLOD(gl_mesh_buffer* buffer, const float* projection, float distance, float viewport_height, float pixel_error);
+API void glapi_DrawMeshBuffer(gl_mesh_buffer* buffer);
+API void glapi_DestroyMeshBuffer(gl_mesh_buffer* buffer);
+
+API gl_render_queue* glapi_GenRenderQueue(gl_app* app);
+API bool glapi_AppendRenderQueue(gl_render_queue* queue, const gl_render_item* item);
+API bool glapi_PushRenderQueueUniform(gl_render_queue* queue, const char* varname, unsigned int type, const void* value);
+API void glapi_ClearRenderQueue(gl_render_queue* queue);
+API void glapi_SortRenderQueue(gl_render_queue* queue);
+API void glapi_SubmitRenderQueue(gl_render_queue* queue);
+API void glapi_DestroyRenderQueue(gl_render_queue* queue);
+
 API void glapi_BindVertexBufferObject(gl_vao vao);
 API void glapi_UnbindVertexBufferObject();
 API void glapi_BindShader(gl_shader shader);
@@ -87,4 +948,6 @@ API void glapi_PushVec3ToShader(const char* varname, float* value, gl_shader sha
 API void glapi_PushVec4ToShader(const char* varname, float* value, gl_shader shader);
 API void glapi_PushMatrix3x3ToShader(const char* varname, float* value, gl_shader shader);
 API void glapi_PushMatrix4x4ToShader(const char* varname, float* value, gl_shader shader);
-API void glapi_PushTexture2DToShader(const char* varname, gl_texture value, gl_shader shader);  
\ No newline at end of file
+API void glapi_PushTexture2DToShader(const char* varname, gl_texture value, gl_shader shader);
+API void glapi_PushSampledTexture2DToShader(const char* varname, gl_texture value, GLuint sampler, GLuint unit, gl_shader shader);
+API void glapi_PushTextureAtlasToShader(const char* varname, gl_texture_atlas* atlas, GLuint sampler, GLuint unit, gl_shader shader);  
\ No newline at end of file
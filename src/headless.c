@@ -0,0 +1,163 @@
+#include "graphics.h"
+
+#ifdef GLIB_HEADLESS
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
+
+#define _FL "headless.c"
+
+#define APIC static
+
+#ifdef GLIB_HEADLESS
+APIC bool headless_has_extension(const char* extensions, const char* name);
+APIC EGLDisplay headless_display(void);
+APIC EGLContext headless_context(EGLDisplay display);
+
+APIC bool headless_has_extension(const char* extensions, const char* name) {
+    size_t length = strlen(name);
+    for (const char* found = extensions; found && (found = strstr(found, name)); found += length)
+        if ((found == extensions || found[-1] == ' ') && (found[length] == ' ' || found[length] == '\0'))
+            return true;
+    return false;
+}
+
+APIC EGLDisplay headless_display(void) {
+    const char* client = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+    PFNEGLGETPLATFORMDISPLAYEXTPROC get_platform_display = (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+    if (get_platform_display && headless_has_extension(client, "EGL_MESA_platform_surfaceless")) {
+        EGLDisplay display = get_platform_display(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL);
+        if (display != EGL_NO_DISPLAY)
+            return display;
+    }
+    return eglGetDisplay(EGL_DEFAULT_DISPLAY);
+}
+
+APIC EGLContext headless_context(EGLDisplay display) {
+    const char* extensions = eglQueryString(display, EGL_EXTENSIONS);
+    if (!headless_has_extension(extensions, "EGL_KHR_surfaceless_context")) {
+        fprintf(stderr, "[%s] - EGL_KHR_surfaceless_context unsupported in headless_context\n", _FL);
+        return EGL_NO_CONTEXT;
+    }
+
+    EGLConfig config = EGL_NO_CONFIG_KHR;
+    if (!headless_has_extension(extensions, "EGL_KHR_no_config_context")) {
+        EGLint config_attribs[] = {
+            EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+            EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+            EGL_NONE
+        };
+        EGLint config_count = 0;
+        if (!eglChooseConfig(display, config_attribs, &config, 1, &config_count) || !config_count) {
+            fprintf(stderr, "[%s] - No OpenGL capable EGL config in headless_context\n", _FL);
+            return EGL_NO_CONTEXT;
+        }
+    }
+
+    EGLint context_attribs[] = {
+        EGL_CONTEXT_MAJOR_VERSION, 3,
+        EGL_CONTEXT_MINOR_VERSION, 3,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+        EGL_NONE
+    };
+    return eglCreateContext(display, config, EGL_NO_CONTEXT, context_attribs);
+}
+#endif
+
+gl_app* glapi_CreateHeadlessApp(uint16_t width, uint16_t height, float r, float g, float b) {
+#ifdef GLIB_HEADLESS
+    printf("[%s] - Starting headless program\n", _FL);
+    EGLDisplay display = headless_display();
+    EGLint major, minor;
+    if (display == EGL_NO_DISPLAY || !eglInitialize(display, &major, &minor)) {
+        fprintf(stderr, "[%s] - Failed to initialize EGL in glapi_CreateHeadlessApp\n", _FL);
+        return NULL;
+    }
+    printf("[%s] - EGL version: %d.%d\n", _FL, major, minor);
+
+    if (!eglBindAPI(EGL_OPENGL_API)) {
+        fprintf(stderr, "[%s] - Failed to bind the OpenGL API in glapi_CreateHeadlessApp\n", _FL);
+        eglTerminate(display);
+        return NULL;
+    }
+    EGLContext context = headless_context(display);
+    if (context == EGL_NO_CONTEXT || !eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context)) {
+        fprintf(stderr, "[%s] - Failed to create a surfaceless context in glapi_CreateHeadlessApp\n", _FL);
+        if (context != EGL_NO_CONTEXT)
+            eglDestroyContext(display, context);
+        eglTerminate(display);
+        return NULL;
+    }
+
+    if (!gladLoadGLLoader((GLADloadproc)eglGetProcAddress)) {
+        fprintf(stderr, "[%s] - Failed to initialize GLAD in glapi_CreateHeadlessApp\n", _FL);
+        eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        eglDestroyContext(display, context);
+        eglTerminate(display);
+        return NULL;
+    }
+    printf("[%s] - OpenGL version: %s\n", _FL, glGetString(GL_VERSION));
+
+    gl_app* app = (gl_app*)calloc(1, sizeof(gl_app));
+    gl_window* window = (gl_window*)calloc(1, sizeof(gl_window));
+    void* resources = glapi_CreateAppResources();
+    if (!app || !window || !resources) {
+        fprintf(stderr, "[%s] - Failure to allocate 'app' to heap in glapi_CreateHeadlessApp\n", _FL);
+        free(app);
+        free(window);
+        free(resources);
+        eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        eglDestroyContext(display, context);
+        eglTerminate(display);
+        return NULL;
+    }
+    app->window = window;
+    app->resources = resources;
+    window->headless = true;
+    window->display = display;
+    window->context = context;
+    window->window_width = width;
+    window->window_height = height;
+    window->r = r;
+    window->g = g;
+    window->b = b;
+    const char* budget = getenv("GLIB_HEADLESS_FRAMES");
+    if (budget)
+        window->frame_budget = strtoull(budget, NULL, 10);
+
+    gl_render_target_desc desc;
+    memset(&desc, 0, sizeof(gl_render_target_desc));
+    desc.width = width;
+    desc.height = height;
+    desc.samples = 1;
+    desc.color_count = 1;
+    desc.color_formats[0] = GL_RGBA8;
+    desc.depth_format = GL_DEPTH_COMPONENT24;
+    window->offscreen = glapi_GenRenderTarget(app, &desc);
+    if (!window->offscreen) {
+        fprintf(stderr, "[%s] - Failed to create the offscreen framebuffer in glapi_CreateHeadlessApp\n", _FL);
+        glapi_DestroyApp(app);
+        return NULL;
+    }
+    glapi_SetDefaultFramebuffer(window->offscreen->framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, window->offscreen->framebuffer);
+    glViewport(0, 0, width, height);
+
+    glEnable(GL_DEPTH_TEST);
+    glapi_SetSwapInterval(app, 0);
+    return app;
+#else
+    fprintf(stderr, "[%s] - Built without GLIB_HEADLESS in glapi_CreateHeadlessApp\n", _FL);
+    return NULL;
+#endif
+}
+
+void glapi_DestroyHeadlessContext(gl_app* app) {
+#ifdef GLIB_HEADLESS
+    EGLDisplay display = (EGLDisplay)app->window->display;
+    glapi_SetDefaultFramebuffer(0);
+    eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    eglDestroyContext(display, (EGLContext)app->window->context);
+    eglTerminate(display);
+#endif
+}
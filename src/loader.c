@@ -0,0 +1,249 @@
+#include "graphics.h"
+
+#define _FL "loader.c"
+
+#define APIC static
+#define TEXTURE_LOADER_APPEND_AMOUNT 16
+
+APIC void* loader_worker(void* arg);
+APIC size_t loader_upload(gl_texture_loader* loader, gl_texture_request* request);
+
+APIC void* loader_worker(void* arg) {
+    gl_texture_loader* loader = (gl_texture_loader*)arg;
+    stbi_set_flip_vertically_on_load_thread(1);
+    glapi_NameCpuThread("texture loader");
+
+    pthread_mutex_lock(&loader->lock);
+    for (;;) {
+        while (!loader->stopping && loader->pending_head == loader->pending_count)
+            pthread_cond_wait(&loader->wake, &loader->lock);
+        if (loader->stopping)
+            break;
+
+        size_t index = loader->pending[loader->pending_head++];
+        if (loader->pending_head == loader->pending_count)
+            loader->pending_head = loader->pending_count = 0;
+        const char* fpath = loader->requests[index].fpath;
+        GLenum format, type;
+        GLuint channels;
+        glapi_TextureUploadFormat(loader->requests[index].internal_format, &format, &type, &channels);
+        pthread_mutex_unlock(&loader->lock);
+
+        glapi_BeginCpuZone("loader_decode");
+        int width = 0, height = 0, file_channels;
+        unsigned char* pixels = NULL;
+        size_t size = 0;
+        unsigned char* source = glapi_ReadFile(fpath, &size);
+        if (source) {
+            pixels = stbi_load_from_memory(source, (int)size, &width, &height, &file_channels, (int)channels);
+            if (!pixels)
+                fprintf(stderr, "[%s] - Texture load failed for '%s': %s in loader_worker\n", _FL, fpath, stbi_failure_reason());
+            free(source);
+        }
+        glapi_EndCpuZone();
+
+        pthread_mutex_lock(&loader->lock);
+        gl_texture_request* request = &loader->requests[index];
+        request->pixels = pixels;
+        request->width = width;
+        request->height = height;
+        request->status = pixels ? TEXTURE_LOAD_DECODED : TEXTURE_LOAD_FAILED;
+        if (pixels) {
+            if (glapi_GrowArray((void**)&loader->completed, &loader->completed_capacity, loader->completed_count, sizeof(size_t), TEXTURE_LOADER_APPEND_AMOUNT)) {
+                loader->completed[loader->completed_count++] = index;
+            } else {
+                fprintf(stderr, "[%s] - Failure to reallocate 'loader->completed' in loader_worker\n", _FL);
+                stbi_image_free(pixels);
+                request->pixels = NULL;
+                request->status = TEXTURE_LOAD_FAILED;
+            }
+        }
+        loader->in_flight--;
+        pthread_cond_broadcast(&loader->decoded);
+    }
+    pthread_mutex_unlock(&loader->lock);
+    return NULL;
+}
+
+gl_texture_loader* glapi_GenTextureLoader(gl_app* app, GLuint threads, size_t upload_budget) {
+    gl_texture_loader* loader = (gl_texture_loader*)calloc(1, sizeof(gl_texture_loader));
+    if (!loader) {
+        fprintf(stderr, "[%s] - Failure to allocate 'loader' to heap in glapi_GenTextureLoader\n", _FL);
+        return NULL;
+    }
+    loader->app = app;
+    loader->upload_budget = upload_budget;
+
+    gl_texture_desc desc;
+    memset(&desc, 0, sizeof(gl_texture_desc));
+    desc.width = 1;
+    desc.height = 1;
+    desc.internal_format = GL_RGBA8;
+    desc.mips = TEXTURE_MIPS_NONE;
+    unsigned char texel[4] = {128, 128, 128, 255};
+    loader->placeholder = glapi_CreateTexture(&desc, texel);
+
+    if (!threads)
+        threads = glapi_HardwareThreadCount();
+    loader->workers = (pthread_t*)calloc(threads, sizeof(pthread_t));
+    if (!loader->workers) {
+        fprintf(stderr, "[%s] - Failure to allocate 'loader->workers' to heap in glapi_GenTextureLoader\n", _FL);
+        glDeleteTextures(1, &loader->placeholder);
+        free(loader);
+        return NULL;
+    }
+    pthread_mutex_init(&loader->lock, NULL);
+    pthread_cond_init(&loader->wake, NULL);
+    pthread_cond_init(&loader->decoded, NULL);
+    for (GLuint i = 0; i < threads; i++) {
+        if (pthread_create(&loader->workers[loader->worker_count], NULL, loader_worker, loader)) {
+            fprintf(stderr, "[%s] - Failure to start worker [%u] in glapi_GenTextureLoader\n", _FL, i);
+            break;
+        }
+        loader->worker_count++;
+    }
+    if (!loader->worker_count) {
+        glapi_DestroyTextureLoader(loader);
+        return NULL;
+    }
+
+    glapi_AppendOpenGLObjects(app, T{(GLuint*)loader, TEXTURE_LOADER});
+    return loader;
+}
+
+uint32_t glapi_LoadTextureAsync(gl_texture_loader* loader, const char* fpath, GLenum internal_format, unsigned int mips) {
+    GLenum format, type;
+    GLuint channels;
+    if (!glapi_TextureUploadFormat(internal_format, &format, &type, &channels) || type != GL_UNSIGNED_BYTE) {
+        fprintf(stderr, "[%s] - Unsupported image internal format [0x%04X] in glapi_LoadTextureAsync\n", _FL, internal_format);
+        return TEXTURE_LOADER_INVALID_HANDLE;
+    }
+    char* path = (char*)malloc(strlen(fpath) + 1);
+    if (!path) {
+        fprintf(stderr, "[%s] - Failure to allocate path to heap in glapi_LoadTextureAsync\n", _FL);
+        return TEXTURE_LOADER_INVALID_HANDLE;
+    }
+    strcpy(path, fpath);
+
+    pthread_mutex_lock(&loader->lock);
+    if (!glapi_GrowArray((void**)&loader->requests, &loader->request_capacity, loader->request_count, sizeof(gl_texture_request), TEXTURE_LOADER_APPEND_AMOUNT) ||
+        !glapi_GrowArray((void**)&loader->pending, &loader->pending_capacity, loader->pending_count, sizeof(size_t), TEXTURE_LOADER_APPEND_AMOUNT)) {
+        pthread_mutex_unlock(&loader->lock);
+        fprintf(stderr, "[%s] - Failure to reallocate loader queues in glapi_LoadTextureAsync\n", _FL);
+        free(path);
+        return TEXTURE_LOADER_INVALID_HANDLE;
+    }
+    size_t index = loader->request_count++;
+    gl_texture_request* request = &loader->requests[index];
+    memset(request, 0, sizeof(gl_texture_request));
+    request->fpath = path;
+    request->internal_format = internal_format;
+    request->mips = mips;
+    request->status = TEXTURE_LOAD_PENDING;
+    request->texture = loader->placeholder;
+    loader->pending[loader->pending_count++] = index;
+    loader->in_flight++;
+    pthread_cond_signal(&loader->wake);
+    pthread_mutex_unlock(&loader->lock);
+    return (uint32_t)index;
+}
+
+gl_texture glapi_TextureLoaderTexture(gl_texture_loader* loader, uint32_t handle) {
+    if (handle >= loader->request_count)
+        return loader->placeholder;
+    return loader->requests[handle].texture;
+}
+
+unsigned int glapi_TextureLoaderStatus(gl_texture_loader* loader, uint32_t handle) {
+    if (handle >= loader->request_count)
+        return TEXTURE_LOAD_FAILED;
+    pthread_mutex_lock(&loader->lock);
+    unsigned int status = loader->requests[handle].status;
+    pthread_mutex_unlock(&loader->lock);
+    return status;
+}
+
+APIC size_t loader_upload(gl_texture_loader* loader, gl_texture_request* request) {
+    gl_texture_desc desc;
+    memset(&desc, 0, sizeof(gl_texture_desc));
+    desc.width = request->width;
+    desc.height = request->height;
+    desc.internal_format = request->internal_format;
+    desc.mips = request->mips;
+
+    glapi_BeginCpuZone("loader_upload");
+    GLuint texture = glapi_CreateTexture(&desc, request->pixels);
+    glapi_EndCpuZone();
+    size_t bytes = (size_t)request->width * request->height * glapi_TextureTexelSize(request->internal_format);
+    stbi_image_free(request->pixels);
+    request->pixels = NULL;
+
+    pthread_mutex_lock(&loader->lock);
+    request->status = texture ? TEXTURE_LOAD_READY : TEXTURE_LOAD_FAILED;
+    pthread_mutex_unlock(&loader->lock);
+    if (texture)
+        request->texture = texture;
+    return bytes;
+}
+
+size_t glapi_PumpTextureLoader(gl_texture_loader* loader) {
+    size_t uploaded = 0;
+    loader->uploaded_bytes = 0;
+    for (;;) {
+        pthread_mutex_lock(&loader->lock);
+        if (!loader->completed_count || (uploaded && loader->upload_budget && loader->uploaded_bytes >= loader->upload_budget)) {
+            pthread_mutex_unlock(&loader->lock);
+            break;
+        }
+        size_t index = loader->completed[0];
+        memmove(loader->completed, loader->completed + 1, (loader->completed_count - 1) * sizeof(size_t));
+        loader->completed_count--;
+        gl_texture_request* request = &loader->requests[index];
+        pthread_mutex_unlock(&loader->lock);
+
+        loader->uploaded_bytes += loader_upload(loader, request);
+        uploaded++;
+    }
+    return uploaded;
+}
+
+void glapi_FinishTextureLoader(gl_texture_loader* loader) {
+    pthread_mutex_lock(&loader->lock);
+    while (loader->in_flight)
+        pthread_cond_wait(&loader->decoded, &loader->lock);
+    pthread_mutex_unlock(&loader->lock);
+
+    size_t budget = loader->upload_budget;
+    loader->upload_budget = 0;
+    glapi_PumpTextureLoader(loader);
+    loader->upload_budget = budget;
+}
+
+void glapi_DestroyTextureLoader(gl_texture_loader* loader) {
+    pthread_mutex_lock(&loader->lock);
+    loader->stopping = true;
+    pthread_cond_broadcast(&loader->wake);
+    pthread_mutex_unlock(&loader->lock);
+    for (GLuint i = 0; i < loader->worker_count; i++)
+        pthread_join(loader->workers[i], NULL);
+
+    for (size_t i = 0; i < loader->request_count; i++) {
+        gl_texture_request* request = &loader->requests[i];
+        if (request->pixels)
+            stbi_image_free(request->pixels);
+        if (request->texture && request->texture != loader->placeholder)
+            glDeleteTextures(1, &request->texture);
+        free(request->fpath);
+    }
+    if (loader->placeholder)
+        glDeleteTextures(1, &loader->placeholder);
+
+    pthread_cond_destroy(&loader->decoded);
+    pthread_cond_destroy(&loader->wake);
+    pthread_mutex_destroy(&loader->lock);
+    free(loader->workers);
+    free(loader->requests);
+    free(loader->pending);
+    free(loader->completed);
+    free(loader);
+}
@@ -0,0 +1,1241 @@
+#include <float.h>
+
+#include "graphics.h"
+#include "maths.h"
+
+#define _FL "meshes.c"
+
+#define APIC static
+#define GL_ARENA_FREELIST_APPEND_AMOUNT 16
+#define GL_ARENA_MESHES_APPEND_AMOUNT 64
+#define GL_ARENA_BUFFER_APPEND_AMOUNT 1024
+#define GL_DRAW_BATCH_APPEND_AMOUNT 64
+#define GL_INSTANCE_VAOS_APPEND_AMOUNT 8
+
+APIC bool freelist_reserve(gl_arena_freelist* list, size_t count);
+APIC bool freelist_insert(gl_arena_freelist* list, GLuint offset, GLuint count);
+APIC bool freelist_alloc(gl_arena_freelist* list, GLuint count, GLuint* offset);
+APIC bool freelist_reset(gl_arena_freelist* list, GLuint offset, GLuint count);
+APIC void interleaved_attributes(unsigned int layout, GLsizei stride);
+APIC GLsizei layout_stride(unsigned int layout);
+APIC GLfloat* interleave_mesh(gl_mesh* mesh, unsigned int layout, GLsizei stride, GLuint vertex_count);
+APIC void arena_bind_attributes(gl_mesh_arena* arena);
+APIC void mesh_bounding_sphere(gl_mesh_buffer* buffer, const GLfloat* positions, GLuint vertex_count);
+APIC GLuint* mesh_build_lods(gl_mesh_buffer* buffer, gl_mesh* mesh, GLuint vertex_count, GLuint max_lods);
+APIC bool arena_grow_buffer(GLuint* buffer, size_t old_size, size_t new_size);
+APIC bool arena_grow_capacity(GLuint capacity, GLuint count, GLuint* grown);
+APIC bool arena_alloc_vertices(gl_mesh_arena* arena, GLuint count, GLuint* offset);
+APIC bool arena_alloc_indices(gl_mesh_arena* arena, GLuint count, GLuint* offset);
+APIC gl_arena_mesh* arena_get_mesh(gl_mesh_arena* arena, GLuint mesh, const char* caller);
+APIC size_t instance_color_offset(gl_instance_buffer* instances);
+APIC void instance_bind_attributes(gl_instance_buffer* instances, gl_vao vao);
+APIC bool instance_fill_white(gl_instance_buffer* instances, size_t offset, GLuint count);
+APIC bool batch_reserve(gl_draw_batch* batch, size_t count);
+APIC void batch_upload(gl_draw_batch* batch);
+APIC void dynamic_mark_dirty(gl_dirty_range* ranges, GLuint begin, GLuint end);
+APIC void dynamic_flush_region(gl_dynamic_mesh* mesh, GLuint region);
+
+APIC bool freelist_reserve(gl_arena_freelist* list, size_t count) {
+    if (count <= list->range_capacity)
+        return true;
+
+    size_t capacity = list->range_capacity ? list->range_capacity * 2 : GL_ARENA_FREELIST_APPEND_AMOUNT;
+    while (capacity < count)
+        capacity *= 2;
+
+    gl_arena_range* ranges = (gl_arena_range*)realloc(list->ranges, capacity * sizeof(gl_arena_range));
+    if (!ranges) {
+        fprintf(stderr, "[%s] - Failure to reallocate arena free list in 'freelist_reserve'\n", _FL);
+        return false;
+    }
+    list->ranges = ranges;
+    list->range_capacity = capacity;
+    return true;
+}
+
+APIC bool freelist_insert(gl_arena_freelist* list, GLuint offset, GLuint count) {
+    if (!count)
+        return true;
+
+    size_t i = 0;
+    while (i < list->range_count && list->ranges[i].offset < offset)
+        i++;
+
+    bool merge_prev = i > 0 && list->ranges[i - 1].offset + list->ranges[i - 1].count == offset;
+    bool merge_next = i < list->range_count && offset + count == list->ranges[i].offset;
+
+    if (merge_prev && merge_next) {
+        list->ranges[i - 1].count += count + list->ranges[i].count;
+        memmove(&list->ranges[i], &list->ranges[i + 1], (list->range_count - i - 1) * sizeof(gl_arena_range));
+        list->range_count--;
+    } else if (merge_prev) {
+        list->ranges[i - 1].count += count;
+    } else if (merge_next) {
+        list->ranges[i].offset = offset;
+        list->ranges[i].count += count;
+    } else {
+        if (!freelist_reserve(list, list->range_count + 1))
+            return false;
+        memmove(&list->ranges[i + 1], &list->ranges[i], (list->range_count - i) * sizeof(gl_arena_range));
+        list->ranges[i].offset = offset;
+        list->ranges[i].count = count;
+        list->range_count++;
+    }
+    return true;
+}
+
+APIC bool freelist_alloc(gl_arena_freelist* list, GLuint count, GLuint* offset) {
+    size_t best = list->range_count;
+    for (size_t i = 0; i < list->range_count; i++) {
+        if (list->ranges[i].count < count)
+            continue;
+        if (best == list->range_count || list->ranges[i].count < list->ranges[best].count)
+            best = i;
+        if (list->ranges[i].count == count)
+            break;
+    }
+    if (best == list->range_count)
+        return false;
+
+    *offset = list->ranges[best].offset;
+    list->ranges[best].offset += count;
+    list->ranges[best].count -= count;
+    if (!list->ranges[best].count) {
+        memmove(&list->ranges[best], &list->ranges[best + 1], (list->range_count - best - 1) * sizeof(gl_arena_range));
+        list->range_count--;
+    }
+    return true;
+}
+
+APIC bool freelist_reset(gl_arena_freelist* list, GLuint offset, GLuint count) {
+    list->range_count = 0;
+    return freelist_insert(list, offset, count);
+}
+
+APIC void interleaved_attributes(unsigned int layout, GLsizei stride) {
+    size_t offset = 0;
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (void*)offset);
+    glEnableVertexAttribArray(0);
+    offset += 3 * sizeof(GLfloat);
+
+    if (layout & ARENA_LAYOUT_UVS) {
+        glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, stride, (void*)offset);
+        glEnableVertexAttribArray(1);
+        offset += 2 * sizeof(GLfloat);
+    }
+
+    if (layout & ARENA_LAYOUT_NORMALS) {
+        glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, stride, (void*)offset);
+        glEnableVertexAttribArray(2);
+    }
+}
+
+APIC GLsizei layout_stride(unsigned int layout) {
+    GLsizei stride = 3 * sizeof(GLfloat);
+    if (layout & ARENA_LAYOUT_UVS)
+        stride += 2 * sizeof(GLfloat);
+    if (layout & ARENA_LAYOUT_NORMALS)
+        stride += 3 * sizeof(GLfloat);
+    return stride;
+}
+
+APIC GLfloat* interleave_mesh(gl_mesh* mesh, unsigned int layout, GLsizei stride, GLuint vertex_count) {
+    GLfloat* vertices = (GLfloat*)calloc(vertex_count, stride);
+    if (!vertices)
+        return NULL;
+
+    size_t floats = stride / sizeof(GLfloat);
+    size_t uv_count = mesh->uvs ? mesh->uvs_size / (2 * sizeof(GLfloat)) : 0;
+    size_t normal_count = mesh->normals ? mesh->normals_size / (3 * sizeof(GLfloat)) : 0;
+    for (GLuint v = 0; v < vertex_count; v++) {
+        GLfloat* dst = vertices + v * floats;
+        memcpy(dst, &mesh->positions[v * 3], 3 * sizeof(GLfloat));
+        dst += 3;
+        if (layout & ARENA_LAYOUT_UVS) {
+            if (v < uv_count)
+                memcpy(dst, &mesh->uvs[v * 2], 2 * sizeof(GLfloat));
+            dst += 2;
+        }
+        if ((layout & ARENA_LAYOUT_NORMALS) && v < normal_count)
+            memcpy(dst, &mesh->normals[v * 3], 3 * sizeof(GLfloat));
+    }
+    return vertices;
+}
+
+APIC void arena_bind_attributes(gl_mesh_arena* arena) {
+    glBindVertexArray(arena->vao);
+    glBindBuffer(GL_ARRAY_BUFFER, arena->vbo);
+    interleaved_attributes(arena->layout, arena->stride);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, arena->ebo);
+    glBindVertexArray(0);
+}
+
+APIC bool arena_grow_buffer(GLuint* buffer, size_t old_size, size_t new_size) {
+    check_gl_error("arena_grow_buffer");
+    GLuint grown;
+    glGenBuffers(1, &grown);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, grown);
+    glBufferData(GL_COPY_WRITE_BUFFER, new_size, NULL, GL_STATIC_DRAW);
+    GLenum error = glGetError();
+    if (error != GL_NO_ERROR) {
+        fprintf(stderr, "[%s] - OpenGL error [%d] growing arena buffer to %zu bytes in 'arena_grow_buffer'\n", _FL, error, new_size);
+        glDeleteBuffers(1, &grown);
+        return false;
+    }
+
+    if (old_size) {
+        glBindBuffer(GL_COPY_READ_BUFFER, *buffer);
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, old_size);
+    }
+    glDeleteBuffers(1, buffer);
+    *buffer = grown;
+    return true;
+}
+
+APIC bool arena_grow_capacity(GLuint capacity, GLuint count, GLuint* grown) {
+    if (count > UINT32_MAX - capacity) {
+        fprintf(stderr, "[%s] - Arena capacity [%u] cannot grow by [%u] elements in 'arena_grow_capacity'\n", _FL, capacity, count);
+        return false;
+    }
+    size_t size = capacity ? (size_t)capacity * 2 : count;
+    while (size - capacity < count)
+        size *= 2;
+    *grown = size < UINT32_MAX ? (GLuint)size : UINT32_MAX;
+    return true;
+}
+
+APIC bool arena_alloc_vertices(gl_mesh_arena* arena, GLuint count, GLuint* offset) {
+    if (freelist_alloc(&arena->vertex_free, count, offset))
+        return true;
+
+    GLuint capacity = arena->vertex_capacity, grown;
+    if (!arena_grow_capacity(capacity, count, &grown) || !freelist_reserve(&arena->vertex_free, arena->vertex_free.range_count + 1))
+        return false;
+    if (!arena_grow_buffer(&arena->vbo, (size_t)capacity * arena->stride, (size_t)grown * arena->stride))
+        return false;
+    arena->vertex_capacity = grown;
+    freelist_insert(&arena->vertex_free, capacity, grown - capacity);
+    arena_bind_attributes(arena);
+    return freelist_alloc(&arena->vertex_free, count, offset);
+}
+
+APIC bool arena_alloc_indices(gl_mesh_arena* arena, GLuint count, GLuint* offset) {
+    if (freelist_alloc(&arena->index_free, count, offset))
+        return true;
+
+    GLuint capacity = arena->index_capacity, grown;
+    if (!arena_grow_capacity(capacity, count, &grown) || !freelist_reserve(&arena->index_free, arena->index_free.range_count + 1))
+        return false;
+    if (!arena_grow_buffer(&arena->ebo, (size_t)capacity * sizeof(GLuint), (size_t)grown * sizeof(GLuint)))
+        return false;
+    arena->index_capacity = grown;
+    freelist_insert(&arena->index_free, capacity, grown - capacity);
+    arena_bind_attributes(arena);
+    return freelist_alloc(&arena->index_free, count, offset);
+}
+
+APIC gl_arena_mesh* arena_get_mesh(gl_mesh_arena* arena, GLuint mesh, const char* caller) {
+    if (!arena || mesh >= arena->mesh_count || !arena->meshes[mesh].live) {
+        fprintf(stderr, "[%s] - Invalid arena mesh [%u] in '%s'\n", _FL, mesh, caller);
+        return NULL;
+    }
+    return &arena->meshes[mesh];
+}
+
+gl_mesh_arena* glapi_GenMeshArena(gl_app* app, unsigned int layout, GLuint vertex_capacity, GLuint index_capacity) {
+    gl_mesh_arena* arena = (gl_mesh_arena*)calloc(1, sizeof(gl_mesh_arena));
+    if (!arena) {
+        fprintf(stderr, "[%s] - Failure to allocate 'arena' to heap in glapi_GenMeshArena\n", _FL);
+        return NULL;
+    }
+
+    arena->layout = layout;
+    arena->stride = layout_stride(layout);
+
+    glGenVertexArrays(1, &arena->vao);
+    glGenBuffers(1, &arena->vbo);
+    glGenBuffers(1, &arena->ebo);
+
+    glBindBuffer(GL_ARRAY_BUFFER, arena->vbo);
+    glBufferData(GL_ARRAY_BUFFER, (size_t)vertex_capacity * arena->stride, NULL, GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, arena->ebo);
+    glBufferData(GL_COPY_WRITE_BUFFER, (size_t)index_capacity * sizeof(GLuint), NULL, GL_STATIC_DRAW);
+
+    arena->vertex_capacity = vertex_capacity;
+    arena->index_capacity = index_capacity;
+    if (!freelist_reset(&arena->vertex_free, 0, vertex_capacity) || !freelist_reset(&arena->index_free, 0, index_capacity)) {
+        fprintf(stderr, "[%s] - Failure to initialise arena free lists in glapi_GenMeshArena\n", _FL);
+        glapi_DestroyMeshArena(arena);
+        return NULL;
+    }
+    arena_bind_attributes(arena);
+    check_gl_error("glapi_GenMeshArena");
+
+    glapi_AppendOpenGLObjects(app, T{(GLuint*)arena, MESH_ARENA});
+    return arena;
+}
+
+GLuint glapi_GenVertexBufferObjectFromMeshInArena(gl_mesh_arena* arena, gl_mesh* mesh) {
+    GLuint vertex_count = (GLuint)(mesh->positions_size / (3 * sizeof(GLfloat)));
+    GLuint index_count = (GLuint)(mesh->indices_size / sizeof(GLuint));
+    if (!vertex_count || !index_count) {
+        fprintf(stderr, "[%s] - Empty mesh in 'glapi_GenVertexBufferObjectFromMeshInArena'\n", _FL);
+        return ARENA_INVALID_MESH;
+    }
+
+    size_t handle = arena->mesh_count;
+    for (size_t i = 0; i < arena->mesh_count; i++) {
+        if (!arena->meshes[i].live) {
+            handle = i;
+            break;
+        }
+    }
+    if (handle == arena->mesh_capacity) {
+        size_t capacity = arena->mesh_capacity ? arena->mesh_capacity * 2 : GL_ARENA_MESHES_APPEND_AMOUNT;
+        gl_arena_mesh* meshes = (gl_arena_mesh*)realloc(arena->meshes, capacity * sizeof(gl_arena_mesh));
+        if (!meshes) {
+            fprintf(stderr, "[%s] - Failure to reallocate 'arena->meshes' in glapi_GenVertexBufferObjectFromMeshInArena\n", _FL);
+            return ARENA_INVALID_MESH;
+        }
+        arena->meshes = meshes;
+        arena->mesh_capacity = capacity;
+    }
+
+    GLfloat* vertices = interleave_mesh(mesh, arena->layout, arena->stride, vertex_count);
+    if (!vertices) {
+        fprintf(stderr, "[%s] - Failure to allocate interleaved vertices in glapi_GenVertexBufferObjectFromMeshInArena\n", _FL);
+        return ARENA_INVALID_MESH;
+    }
+
+    GLuint vertex_offset, index_offset;
+    if (!arena_alloc_vertices(arena, vertex_count, &vertex_offset)) {
+        free(vertices);
+        return ARENA_INVALID_MESH;
+    }
+    if (!arena_alloc_indices(arena, index_count, &index_offset)) {
+        freelist_insert(&arena->vertex_free, vertex_offset, vertex_count);
+        free(vertices);
+        return ARENA_INVALID_MESH;
+    }
+
+    glBindBuffer(GL_COPY_WRITE_BUFFER, arena->vbo);
+    glBufferSubData(GL_COPY_WRITE_BUFFER, (size_t)vertex_offset * arena->stride, (size_t)vertex_count * arena->stride, vertices);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, arena->ebo);
+    glBufferSubData(GL_COPY_WRITE_BUFFER, (size_t)index_offset * sizeof(GLuint), (size_t)index_count * sizeof(GLuint), mesh->indices);
+    free(vertices);
+    check_gl_error("glapi_GenVertexBufferObjectFromMeshInArena");
+
+    gl_arena_mesh* record = &arena->meshes[handle];
+    record->base_vertex = (GLint)vertex_offset;
+    record->vertex_count = vertex_count;
+    record->first_index = index_offset;
+    record->index_count = index_count;
+    record->live = true;
+    if (handle == arena->mesh_count)
+        arena->mesh_count++;
+    return (GLuint)handle;
+}
+
+bool glapi_FreeArenaMesh(gl_mesh_arena* arena, GLuint mesh) {
+    gl_arena_mesh* record = arena_get_mesh(arena, mesh, "glapi_FreeArenaMesh");
+    if (!record)
+        return false;
+
+    if (!freelist_reserve(&arena->vertex_free, arena->vertex_free.range_count + 1) || !freelist_reserve(&arena->index_free, arena->index_free.range_count + 1)) {
+        fprintf(stderr, "[%s] - Failure to return mesh [%u] to the arena free lists in glapi_FreeArenaMesh\n", _FL, mesh);
+        return false;
+    }
+    freelist_insert(&arena->vertex_free, (GLuint)record->base_vertex, record->vertex_count);
+    freelist_insert(&arena->index_free, record->first_index, record->index_count);
+    record->live = false;
+    return true;
+}
+
+bool glapi_DefragMeshArena(gl_mesh_arena* arena) {
+    size_t live_vertices = 0, live_indices = 0;
+    for (size_t i = 0; i < arena->mesh_count; i++) {
+        if (!arena->meshes[i].live)
+            continue;
+        live_vertices += arena->meshes[i].vertex_count;
+        live_indices += arena->meshes[i].index_count;
+    }
+    size_t vertex_size = live_vertices + GL_ARENA_BUFFER_APPEND_AMOUNT;
+    size_t index_size = live_indices + GL_ARENA_BUFFER_APPEND_AMOUNT;
+    GLuint vertex_capacity = vertex_size < arena->vertex_capacity ? (GLuint)vertex_size : arena->vertex_capacity;
+    GLuint index_capacity = index_size < arena->index_capacity ? (GLuint)index_size : arena->index_capacity;
+    if (!freelist_reserve(&arena->vertex_free, 1) || !freelist_reserve(&arena->index_free, 1))
+        return false;
+
+    check_gl_error("glapi_DefragMeshArena");
+    GLuint vbo, ebo;
+    glGenBuffers(1, &vbo);
+    glGenBuffers(1, &ebo);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, vbo);
+    glBufferData(GL_COPY_WRITE_BUFFER, (size_t)vertex_capacity * arena->stride, NULL, GL_STATIC_DRAW);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, ebo);
+    glBufferData(GL_COPY_WRITE_BUFFER, (size_t)index_capacity * sizeof(GLuint), NULL, GL_STATIC_DRAW);
+    GLenum error = glGetError();
+    if (error != GL_NO_ERROR) {
+        fprintf(stderr, "[%s] - OpenGL error [%d] allocating defragmented arena buffers in 'glapi_DefragMeshArena'\n", _FL, error);
+        glDeleteBuffers(1, &vbo);
+        glDeleteBuffers(1, &ebo);
+        return false;
+    }
+
+    GLuint vertex_top = 0, index_top = 0;
+    for (size_t i = 0; i < arena->mesh_count; i++) {
+        gl_arena_mesh* record = &arena->meshes[i];
+        if (!record->live)
+            continue;
+
+        glBindBuffer(GL_COPY_READ_BUFFER, arena->vbo);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, vbo);
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER,
+            (size_t)record->base_vertex * arena->stride, (size_t)vertex_top * arena->stride, (size_t)record->vertex_count * arena->stride);
+
+        glBindBuffer(GL_COPY_READ_BUFFER, arena->ebo);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, ebo);
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER,
+            (size_t)record->first_index * sizeof(GLuint), (size_t)index_top * sizeof(GLuint), (size_t)record->index_count * sizeof(GLuint));
+
+        vertex_top += record->vertex_count;
+        index_top += record->index_count;
+    }
+    error = glGetError();
+    if (error != GL_NO_ERROR) {
+        fprintf(stderr, "[%s] - OpenGL error [%d] copying arena meshes in 'glapi_DefragMeshArena'\n", _FL, error);
+        glDeleteBuffers(1, &vbo);
+        glDeleteBuffers(1, &ebo);
+        return false;
+    }
+
+    vertex_top = index_top = 0;
+    for (size_t i = 0; i < arena->mesh_count; i++) {
+        gl_arena_mesh* record = &arena->meshes[i];
+        if (!record->live)
+            continue;
+        record->base_vertex = (GLint)vertex_top;
+        record->first_index = index_top;
+        vertex_top += record->vertex_count;
+        index_top += record->index_count;
+    }
+
+    glDeleteBuffers(1, &arena->vbo);
+    glDeleteBuffers(1, &arena->ebo);
+    arena->vbo = vbo;
+    arena->ebo = ebo;
+    arena->vertex_capacity = vertex_capacity;
+    arena->index_capacity = index_capacity;
+    freelist_reset(&arena->vertex_free, vertex_top, vertex_capacity - vertex_top);
+    freelist_reset(&arena->index_free, index_top, index_capacity - index_top);
+    arena_bind_attributes(arena);
+    check_gl_error("glapi_DefragMeshArena");
+    return true;
+}
+
+void glapi_DestroyMeshArena(gl_mesh_arena* arena) {
+    glDeleteVertexArrays(1, &arena->vao);
+    glDeleteBuffers(1, &arena->vbo);
+    glDeleteBuffers(1, &arena->ebo);
+    free(arena->vertex_free.ranges);
+    free(arena->index_free.ranges);
+    free(arena->meshes);
+    free(arena);
+}
+
+void glapi_BindMeshArena(gl_mesh_arena* arena) {
+    glBindVertexArray(arena->vao);
+}
+
+void glapi_DrawArenaMesh(gl_mesh_arena* arena, GLuint mesh) {
+    gl_arena_mesh* record = arena_get_mesh(arena, mesh, "glapi_DrawArenaMesh");
+    if (!record)
+        return;
+
+    glDrawElementsBaseVertex(GL_TRIANGLES, record->index_count, GL_UNSIGNED_INT,
+        (void*)((size_t)record->first_index * sizeof(GLuint)), record->base_vertex);
+}
+
+APIC size_t instance_color_offset(gl_instance_buffer* instances) {
+    return (instances->layout & INSTANCE_LAYOUT_MATRIX) ? (size_t)instances->capacity * 16 * sizeof(GLfloat) : 0;
+}
+
+APIC void instance_bind_attributes(gl_instance_buffer* instances, gl_vao vao) {
+    glBindVertexArray(vao);
+    glBindBuffer(GL_ARRAY_BUFFER, instances->vbo);
+
+    if (instances->layout & INSTANCE_LAYOUT_MATRIX) {
+        for (GLuint column = 0; column < 4; column++) {
+            GLuint location = INSTANCE_ATTRIB_MATRIX + column;
+            glVertexAttribPointer(location, 4, GL_FLOAT, GL_FALSE, 16 * sizeof(GLfloat), (void*)(column * 4 * sizeof(GLfloat)));
+            glEnableVertexAttribArray(location);
+            glVertexAttribDivisor(location, 1);
+        }
+    }
+
+    if (instances->layout & INSTANCE_LAYOUT_COLOR) {
+        glVertexAttribPointer(INSTANCE_ATTRIB_COLOR, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(GLfloat), (void*)instance_color_offset(instances));
+        glEnableVertexAttribArray(INSTANCE_ATTRIB_COLOR);
+        glVertexAttribDivisor(INSTANCE_ATTRIB_COLOR, 1);
+    }
+
+    glBindVertexArray(0);
+}
+
+gl_instance_buffer* glapi_GenInstanceBuffer(gl_app* app, unsigned int layout, GLuint capacity) {
+    gl_instance_buffer* instances = (gl_instance_buffer*)calloc(1, sizeof(gl_instance_buffer));
+    if (!instances) {
+        fprintf(stderr, "[%s] - Failure to allocate 'instances' to heap in glapi_GenInstanceBuffer\n", _FL);
+        return NULL;
+    }
+
+    instances->layout = layout;
+    instances->capacity = capacity ? capacity : 1;
+
+    size_t size = 0;
+    if (layout & INSTANCE_LAYOUT_MATRIX)
+        size += (size_t)instances->capacity * 16 * sizeof(GLfloat);
+    if (layout & INSTANCE_LAYOUT_COLOR)
+        size += (size_t)instances->capacity * 4 * sizeof(GLfloat);
+
+    glGenBuffers(1, &instances->vbo);
+    glBindBuffer(GL_ARRAY_BUFFER, instances->vbo);
+    glBufferData(GL_ARRAY_BUFFER, size, NULL, GL_STREAM_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    check_gl_error("glapi_GenInstanceBuffer");
+
+    glapi_AppendOpenGLObjects(app, T{(GLuint*)instances, INSTANCE_BUFFER});
+    return instances;
+}
+
+APIC bool instance_fill_white(gl_instance_buffer* instances, size_t offset, GLuint count) {
+    size_t size = (size_t)count * 4 * sizeof(GLfloat);
+    GLfloat* white = (GLfloat*)glMapBufferRange(GL_ARRAY_BUFFER, offset, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT);
+    if (!white) {
+        fprintf(stderr, "[%s] - Failure to map instance colors in 'instance_fill_white'\n", _FL);
+        return false;
+    }
+    for (size_t i = 0; i < (size_t)count * 4; i++)
+        white[i] = 1.0f;
+    return glUnmapBuffer(GL_ARRAY_BUFFER) == GL_TRUE;
+}
+
+bool glapi_AttachInstanceBuffer(gl_instance_buffer* instances, gl_vao vao) {
+    bool attached = false;
+    for (size_t i = 0; i < instances->attached_vao_count; i++)
+        attached |= instances->attached_vaos[i] == vao;
+
+    if (!attached) {
+        if (instances->attached_vao_count == instances->attached_vao_capacity) {
+            size_t capacity = instances->attached_vao_capacity ? instances->attached_vao_capacity * 2 : GL_INSTANCE_VAOS_APPEND_AMOUNT;
+            gl_vao* vaos = (gl_vao*)realloc(instances->attached_vaos, capacity * sizeof(gl_vao));
+            if (!vaos) {
+                fprintf(stderr, "[%s] - Failure to reallocate 'instances->attached_vaos' in 'glapi_AttachInstanceBuffer'\n", _FL);
+                return false;
+            }
+            instances->attached_vaos = vaos;
+            instances->attached_vao_capacity = capacity;
+        }
+        instances->attached_vaos[instances->attached_vao_count++] = vao;
+    }
+    instance_bind_attributes(instances, vao);
+    return true;
+}
+
+bool glapi_UpdateInstanceBuffer(gl_instance_buffer* instances, const GLfloat* matrices, const GLfloat* colors, GLuint count) {
+    if ((size_t)count > SIZE_MAX / (20 * sizeof(GLfloat))) {
+        fprintf(stderr, "[%s] - Instance count [%u] exceeds the addressable limit in 'glapi_UpdateInstanceBuffer'\n", _FL, count);
+        return false;
+    }
+    bool grown = count > instances->capacity;
+    if (grown) {
+        size_t capacity = instances->capacity;
+        while (capacity < count)
+            capacity *= 2;
+        instances->capacity = capacity < UINT32_MAX ? (GLuint)capacity : UINT32_MAX;
+    }
+
+    size_t matrix_size = (instances->layout & INSTANCE_LAYOUT_MATRIX) ? (size_t)instances->capacity * 16 * sizeof(GLfloat) : 0;
+    size_t color_size = (instances->layout & INSTANCE_LAYOUT_COLOR) ? (size_t)instances->capacity * 4 * sizeof(GLfloat) : 0;
+
+    check_gl_error("glapi_UpdateInstanceBuffer");
+    glBindBuffer(GL_ARRAY_BUFFER, instances->vbo);
+    glBufferData(GL_ARRAY_BUFFER, matrix_size + color_size, NULL, GL_STREAM_DRAW);
+    GLenum error = glGetError();
+    if (error != GL_NO_ERROR) {
+        fprintf(stderr, "[%s] - OpenGL error [%d] sizing instance buffer for [%u] instances in 'glapi_UpdateInstanceBuffer'\n", _FL, error, count);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        instances->count = 0;
+        return false;
+    }
+
+    if ((instances->layout & INSTANCE_LAYOUT_MATRIX) && matrices)
+        glBufferSubData(GL_ARRAY_BUFFER, 0, (size_t)count * 16 * sizeof(GLfloat), matrices);
+
+    bool updated = true;
+    if ((instances->layout & INSTANCE_LAYOUT_COLOR) && count) {
+        if (colors)
+            glBufferSubData(GL_ARRAY_BUFFER, matrix_size, (size_t)count * 4 * sizeof(GLfloat), colors);
+        else
+            updated = instance_fill_white(instances, matrix_size, count);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    if (grown) {
+        for (size_t i = 0; i < instances->attached_vao_count; i++)
+            instance_bind_attributes(instances, instances->attached_vaos[i]);
+    }
+    instances->count = count;
+    check_gl_error("glapi_UpdateInstanceBuffer");
+    return updated;
+}
+
+bool glapi_UpdateInstanceBufferTRS(gl_instance_buffer* instances, const GLfloat* trs, const GLfloat* colors, GLuint count) {
+    size_t floats = (size_t)count * 16;
+    if (floats > instances->scratch_capacity) {
+        GLfloat* scratch = (GLfloat*)realloc(instances->scratch, floats * sizeof(GLfloat));
+        if (!scratch) {
+            fprintf(stderr, "[%s] - Failure to allocate instance matrices in glapi_UpdateInstanceBufferTRS\n", _FL);
+            return false;
+        }
+        instances->scratch = scratch;
+        instances->scratch_capacity = floats;
+    }
+
+    GLfloat* matrices = instances->scratch;
+    for (GLuint i = 0; i < count; i++) {
+        float* position = (float*)&trs[(size_t)i * 9];
+        mapi_TransformMatrix4x4(&matrices[(size_t)i * 16], position, position + 3, position + 6);
+    }
+    return glapi_UpdateInstanceBuffer(instances, matrices, colors, count);
+}
+
+void glapi_DestroyInstanceBuffer(gl_instance_buffer* instances) {
+    glDeleteBuffers(1, &instances->vbo);
+    free(instances->attached_vaos);
+    free(instances->scratch);
+    free(instances);
+}
+
+void glapi_DrawArenaMeshInstanced(gl_mesh_arena* arena, GLuint mesh, GLuint instance_count) {
+    gl_arena_mesh* record = arena_get_mesh(arena, mesh, "glapi_DrawArenaMeshInstanced");
+    if (!record)
+        return;
+
+    glDrawElementsInstancedBaseVertex(GL_TRIANGLES, record->index_count, GL_UNSIGNED_INT,
+        (void*)((size_t)record->first_index * sizeof(GLuint)), instance_count, record->base_vertex);
+}
+
+APIC bool batch_reserve(gl_draw_batch* batch, size_t count) {
+    if (count <= batch->draw_capacity)
+        return true;
+
+    size_t capacity = batch->draw_capacity ? batch->draw_capacity * 2 : GL_DRAW_BATCH_APPEND_AMOUNT;
+    while (capacity < count)
+        capacity *= 2;
+
+    gl_draw_elements_indirect_command* commands = (gl_draw_elements_indirect_command*)realloc(batch->commands, capacity * sizeof(gl_draw_elements_indirect_command));
+    if (!commands) {
+        fprintf(stderr, "[%s] - Failure to reallocate 'batch->commands' in batch_reserve\n", _FL);
+        return false;
+    }
+    batch->commands = commands;
+
+    if (batch->draw_data_vec4s) {
+        GLfloat* draw_data = (GLfloat*)realloc(batch->draw_data, capacity * batch->draw_data_vec4s * 4 * sizeof(GLfloat));
+        if (!draw_data) {
+            fprintf(stderr, "[%s] - Failure to reallocate 'batch->draw_data' in batch_reserve\n", _FL);
+            return false;
+        }
+        batch->draw_data = draw_data;
+    }
+    batch->draw_capacity = capacity;
+    return true;
+}
+
+APIC void batch_upload(gl_draw_batch* batch) {
+    size_t data_stride = (size_t)batch->draw_data_vec4s * 4 * sizeof(GLfloat);
+
+    if (batch->uploaded_capacity < batch->draw_capacity) {
+        GLuint* draw_ids = (GLuint*)malloc(batch->draw_capacity * sizeof(GLuint));
+        if (!draw_ids) {
+            fprintf(stderr, "[%s] - Failure to allocate draw ids in batch_upload\n", _FL);
+            return;
+        }
+        for (size_t i = 0; i < batch->draw_capacity; i++)
+            draw_ids[i] = (GLuint)i;
+        glBindBuffer(GL_ARRAY_BUFFER, batch->draw_id_buffer);
+        glBufferData(GL_ARRAY_BUFFER, batch->draw_capacity * sizeof(GLuint), draw_ids, GL_STATIC_DRAW);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        free(draw_ids);
+
+        if (batch->draw_data_vec4s) {
+            glBindBuffer(GL_TEXTURE_BUFFER, batch->draw_data_buffer);
+            glBufferData(GL_TEXTURE_BUFFER, batch->draw_capacity * data_stride, NULL, GL_STREAM_DRAW);
+            glBindTexture(GL_TEXTURE_BUFFER, batch->draw_data_texture);
+            glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, batch->draw_data_buffer);
+            glBindTexture(GL_TEXTURE_BUFFER, 0);
+        }
+
+        if (batch->multi_draw_indirect) {
+            glBindBuffer(GL_DRAW_INDIRECT_BUFFER, batch->indirect_buffer);
+            glBufferData(GL_DRAW_INDIRECT_BUFFER, batch->draw_capacity * sizeof(gl_draw_elements_indirect_command), NULL, GL_STREAM_DRAW);
+        }
+        batch->uploaded_capacity = batch->draw_capacity;
+    }
+
+    if (batch->draw_data_vec4s) {
+        glBindBuffer(GL_TEXTURE_BUFFER, batch->draw_data_buffer);
+        glBufferData(GL_TEXTURE_BUFFER, batch->uploaded_capacity * data_stride, NULL, GL_STREAM_DRAW);
+        glBufferSubData(GL_TEXTURE_BUFFER, 0, batch->draw_count * data_stride, batch->draw_data);
+        glBindBuffer(GL_TEXTURE_BUFFER, 0);
+    }
+
+    if (batch->multi_draw_indirect) {
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, batch->indirect_buffer);
+        glBufferData(GL_DRAW_INDIRECT_BUFFER, batch->uploaded_capacity * sizeof(gl_draw_elements_indirect_command), NULL, GL_STREAM_DRAW);
+        glBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, batch->draw_count * sizeof(gl_draw_elements_indirect_command), batch->commands);
+    }
+}
+
+gl_draw_batch* glapi_GenDrawBatch(gl_app* app, gl_mesh_arena* arena, GLuint draw_data_vec4s) {
+    gl_draw_batch* batch = (gl_draw_batch*)calloc(1, sizeof(gl_draw_batch));
+    if (!batch) {
+        fprintf(stderr, "[%s] - Failure to allocate 'batch' to heap in glapi_GenDrawBatch\n", _FL);
+        return NULL;
+    }
+
+    batch->arena = arena;
+    batch->draw_data_vec4s = draw_data_vec4s;
+    batch->multi_draw_indirect = GLAD_GL_ARB_draw_indirect && GLAD_GL_ARB_multi_draw_indirect && GLAD_GL_ARB_base_instance;
+
+    glGenBuffers(1, &batch->indirect_buffer);
+    glGenBuffers(1, &batch->draw_id_buffer);
+    glGenBuffers(1, &batch->draw_data_buffer);
+    glGenTextures(1, &batch->draw_data_texture);
+
+    if (!batch_reserve(batch, GL_DRAW_BATCH_APPEND_AMOUNT)) {
+        glapi_DestroyDrawBatch(batch);
+        return NULL;
+    }
+    check_gl_error("glapi_GenDrawBatch");
+
+    glapi_AppendOpenGLObjects(app, T{(GLuint*)batch, DRAW_BATCH});
+    return batch;
+}
+
+void glapi_AppendDrawBatch(gl_draw_batch* batch, GLuint mesh, const GLfloat* draw_data) {
+    gl_arena_mesh* record = arena_get_mesh(batch->arena, mesh, "glapi_AppendDrawBatch");
+    if (!record || !batch_reserve(batch, batch->draw_count + 1))
+        return;
+
+    gl_draw_elements_indirect_command* command = &batch->commands[batch->draw_count];
+    command->count = record->index_count;
+    command->instance_count = 1;
+    command->first_index = record->first_index;
+    command->base_vertex = record->base_vertex;
+    command->base_instance = (GLuint)batch->draw_count;
+
+    if (batch->draw_data_vec4s) {
+        size_t floats = (size_t)batch->draw_data_vec4s * 4;
+        GLfloat* dst = &batch->draw_data[batch->draw_count * floats];
+        if (draw_data)
+            memcpy(dst, draw_data, floats * sizeof(GLfloat));
+        else
+            memset(dst, 0, floats * sizeof(GLfloat));
+    }
+    batch->draw_count++;
+}
+
+void glapi_ClearDrawBatch(gl_draw_batch* batch) {
+    batch->draw_count = 0;
+}
+
+void glapi_DrawBatch(gl_draw_batch* batch) {
+    if (!batch->draw_count)
+        return;
+
+    batch_upload(batch);
+    glBindVertexArray(batch->arena->vao);
+
+    if (batch->multi_draw_indirect) {
+        glBindBuffer(GL_ARRAY_BUFFER, batch->draw_id_buffer);
+        glVertexAttribIPointer(DRAW_BATCH_ATTRIB_DRAW_ID, 1, GL_UNSIGNED_INT, sizeof(GLuint), (void*)0);
+        glEnableVertexAttribArray(DRAW_BATCH_ATTRIB_DRAW_ID);
+        glVertexAttribDivisor(DRAW_BATCH_ATTRIB_DRAW_ID, 1);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, batch->indirect_buffer);
+        glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, (void*)0, (GLsizei)batch->draw_count, 0);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+
+        glDisableVertexAttribArray(DRAW_BATCH_ATTRIB_DRAW_ID);
+        glVertexAttribDivisor(DRAW_BATCH_ATTRIB_DRAW_ID, 0);
+    } else if (batch->draw_data_vec4s) {
+        glDisableVertexAttribArray(DRAW_BATCH_ATTRIB_DRAW_ID);
+        for (size_t i = 0; i < batch->draw_count; i++) {
+            gl_draw_elements_indirect_command* command = &batch->commands[i];
+            glVertexAttribI1ui(DRAW_BATCH_ATTRIB_DRAW_ID, (GLuint)i);
+            glDrawElementsBaseVertex(GL_TRIANGLES, command->count, GL_UNSIGNED_INT,
+                (void*)((size_t)command->first_index * sizeof(GLuint)), command->base_vertex);
+        }
+    } else {
+        GLsizei* counts = (GLsizei*)malloc(batch->draw_count * sizeof(GLsizei));
+        void** offsets = (void**)malloc(batch->draw_count * sizeof(void*));
+        GLint* base_vertices = (GLint*)malloc(batch->draw_count * sizeof(GLint));
+        if (counts && offsets && base_vertices) {
+            for (size_t i = 0; i < batch->draw_count; i++) {
+                counts[i] = (GLsizei)batch->commands[i].count;
+                offsets[i] = (void*)((size_t)batch->commands[i].first_index * sizeof(GLuint));
+                base_vertices[i] = batch->commands[i].base_vertex;
+            }
+            glDisableVertexAttribArray(DRAW_BATCH_ATTRIB_DRAW_ID);
+            glMultiDrawElementsBaseVertex(GL_TRIANGLES, counts, GL_UNSIGNED_INT, (const void* const*)offsets, (GLsizei)batch->draw_count, base_vertices);
+        } else {
+            fprintf(stderr, "[%s] - Failure to allocate multi-draw arrays in glapi_DrawBatch\n", _FL);
+        }
+        free(counts);
+        free(offsets);
+        free(base_vertices);
+    }
+    check_gl_error("glapi_DrawBatch");
+}
+
+void glapi_DestroyDrawBatch(gl_draw_batch* batch) {
+    glDeleteBuffers(1, &batch->indirect_buffer);
+    glDeleteBuffers(1, &batch->draw_id_buffer);
+    glDeleteBuffers(1, &batch->draw_data_buffer);
+    glDeleteTextures(1, &batch->draw_data_texture);
+    free(batch->commands);
+    free(batch->draw_data);
+    free(batch);
+}
+
+void glapi_PushDrawBatchToShader(const char* varname, gl_draw_batch* batch, gl_shader shader) {
+    glUseProgram(shader);
+    glActiveTexture(GL_TEXTURE0 + DRAW_BATCH_TEXTURE_UNIT);
+    glBindTexture(GL_TEXTURE_BUFFER, batch->draw_data_texture);
+    glUniform1i(glGetUniformLocation(shader, varname), DRAW_BATCH_TEXTURE_UNIT);
+    glActiveTexture(GL_TEXTURE0);
+}
+
+APIC void dynamic_mark_dirty(gl_dirty_range* ranges, GLuint begin, GLuint end) {
+    for (GLuint r = 0; r < DYNAMIC_MESH_REGIONS; r++) {
+        if (ranges[r].begin == ranges[r].end) {
+            ranges[r].begin = begin;
+            ranges[r].end = end;
+            continue;
+        }
+        if (begin < ranges[r].begin)
+            ranges[r].begin = begin;
+        if (end > ranges[r].end)
+            ranges[r].end = end;
+    }
+}
+
+APIC void dynamic_flush_region(gl_dynamic_mesh* mesh, GLuint region) {
+    gl_dirty_range* vertices = &mesh->vertex_dirty[region];
+    gl_dirty_range* indices = &mesh->index_dirty[region];
+
+    if (mesh->persistent) {
+        size_t vertex_base = (size_t)region * mesh->max_vertices * mesh->stride;
+        size_t index_base = (size_t)region * mesh->max_indices * sizeof(GLuint);
+        if (vertices->end > vertices->begin)
+            memcpy(mesh->mapped_vertices + vertex_base + (size_t)vertices->begin * mesh->stride,
+                (unsigned char*)mesh->vertices + (size_t)vertices->begin * mesh->stride,
+                (size_t)(vertices->end - vertices->begin) * mesh->stride);
+        if (indices->end > indices->begin)
+            memcpy(mesh->mapped_indices + index_base + (size_t)indices->begin * sizeof(GLuint),
+                &mesh->indices[indices->begin], (size_t)(indices->end - indices->begin) * sizeof(GLuint));
+    } else {
+        if (vertices->end > vertices->begin) {
+            glBindBuffer(GL_ARRAY_BUFFER, mesh->vbo);
+            if (vertices->begin == 0 && vertices->end >= mesh->vertex_count) {
+                glBufferData(GL_ARRAY_BUFFER, (size_t)mesh->max_vertices * mesh->stride, NULL, GL_STREAM_DRAW);
+                glBufferSubData(GL_ARRAY_BUFFER, 0, (size_t)vertices->end * mesh->stride, mesh->vertices);
+            } else {
+                glBufferSubData(GL_ARRAY_BUFFER, (size_t)vertices->begin * mesh->stride,
+                    (size_t)(vertices->end - vertices->begin) * mesh->stride, (unsigned char*)mesh->vertices + (size_t)vertices->begin * mesh->stride);
+            }
+            glBindBuffer(GL_ARRAY_BUFFER, 0);
+        }
+        if (indices->end > indices->begin) {
+            glBindBuffer(GL_COPY_WRITE_BUFFER, mesh->ebo);
+            if (indices->begin == 0 && indices->end >= mesh->index_count) {
+                glBufferData(GL_COPY_WRITE_BUFFER, (size_t)mesh->max_indices * sizeof(GLuint), NULL, GL_STREAM_DRAW);
+                glBufferSubData(GL_COPY_WRITE_BUFFER, 0, (size_t)indices->end * sizeof(GLuint), mesh->indices);
+            } else {
+                glBufferSubData(GL_COPY_WRITE_BUFFER, (size_t)indices->begin * sizeof(GLuint),
+                    (size_t)(indices->end - indices->begin) * sizeof(GLuint), &mesh->indices[indices->begin]);
+            }
+            glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+        }
+    }
+
+    vertices->begin = vertices->end = 0;
+    indices->begin = indices->end = 0;
+}
+
+gl_dynamic_mesh* glapi_GenDynamicMesh(gl_app* app, unsigned int layout, GLuint max_vertices, GLuint max_indices) {
+    if (!max_vertices || !max_indices) {
+        fprintf(stderr, "[%s] - Dynamic mesh needs non-zero capacities in 'glapi_GenDynamicMesh'\n", _FL);
+        return NULL;
+    }
+
+    gl_dynamic_mesh* mesh = (gl_dynamic_mesh*)calloc(1, sizeof(gl_dynamic_mesh));
+    if (!mesh) {
+        fprintf(stderr, "[%s] - Failure to allocate 'mesh' to heap in glapi_GenDynamicMesh\n", _FL);
+        return NULL;
+    }
+
+    mesh->layout = layout;
+    mesh->stride = layout_stride(layout);
+    mesh->max_vertices = max_vertices;
+    mesh->max_indices = max_indices;
+    mesh->persistent = GLAD_GL_ARB_buffer_storage;
+
+    mesh->vertices = (GLfloat*)calloc(max_vertices, mesh->stride);
+    mesh->indices = (GLuint*)calloc(max_indices, sizeof(GLuint));
+    if (!mesh->vertices || !mesh->indices) {
+        fprintf(stderr, "[%s] - Failure to allocate shadow copy in glapi_GenDynamicMesh\n", _FL);
+        free(mesh->vertices);
+        free(mesh->indices);
+        free(mesh);
+        return NULL;
+    }
+
+    glGenVertexArrays(1, &mesh->vao);
+    glGenBuffers(1, &mesh->vbo);
+    glGenBuffers(1, &mesh->ebo);
+    glBindVertexArray(mesh->vao);
+    glBindBuffer(GL_ARRAY_BUFFER, mesh->vbo);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh->ebo);
+
+    size_t vertex_size = (size_t)max_vertices * mesh->stride;
+    size_t index_size = (size_t)max_indices * sizeof(GLuint);
+    if (mesh->persistent) {
+        GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        glBufferStorage(GL_ARRAY_BUFFER, vertex_size * DYNAMIC_MESH_REGIONS, NULL, flags);
+        glBufferStorage(GL_ELEMENT_ARRAY_BUFFER, index_size * DYNAMIC_MESH_REGIONS, NULL, flags);
+        mesh->mapped_vertices = (unsigned char*)glMapBufferRange(GL_ARRAY_BUFFER, 0, vertex_size * DYNAMIC_MESH_REGIONS, flags);
+        mesh->mapped_indices = (unsigned char*)glMapBufferRange(GL_ELEMENT_ARRAY_BUFFER, 0, index_size * DYNAMIC_MESH_REGIONS, flags);
+        if (!mesh->mapped_vertices || !mesh->mapped_indices) {
+            fprintf(stderr, "[%s] - Failure to persistently map buffers in glapi_GenDynamicMesh\n", _FL);
+            glBindVertexArray(0);
+            glapi_DestroyDynamicMesh(mesh);
+            return NULL;
+        }
+    } else {
+        glBufferData(GL_ARRAY_BUFFER, vertex_size, NULL, GL_STREAM_DRAW);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, index_size, NULL, GL_STREAM_DRAW);
+    }
+
+    interleaved_attributes(layout, mesh->stride);
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    check_gl_error("glapi_GenDynamicMesh");
+
+    glapi_AppendOpenGLObjects(app, T{(GLuint*)mesh, DYNAMIC_MESH});
+    return mesh;
+}
+
+void glapi_UpdateDynamicMeshVertices(gl_dynamic_mesh* mesh, GLuint first_vertex, GLuint count, const GLfloat* positions, const GLfloat* uvs, const GLfloat* normals) {
+    if (!count)
+        return;
+    if (first_vertex > mesh->max_vertices || count > mesh->max_vertices - first_vertex) {
+        fprintf(stderr, "[%s] - Vertex range [%u, %u) exceeds capacity %u in 'glapi_UpdateDynamicMeshVertices'\n", _FL, first_vertex, first_vertex + count, mesh->max_vertices);
+        return;
+    }
+
+    size_t floats = mesh->stride / sizeof(GLfloat);
+    size_t normal_offset = (mesh->layout & ARENA_LAYOUT_UVS) ? 5 : 3;
+    for (GLuint v = 0; v < count; v++) {
+        GLfloat* dst = mesh->vertices + (size_t)(first_vertex + v) * floats;
+        if (positions)
+            memcpy(dst, &positions[v * 3], 3 * sizeof(GLfloat));
+        if (uvs && (mesh->layout & ARENA_LAYOUT_UVS))
+            memcpy(dst + 3, &uvs[v * 2], 2 * sizeof(GLfloat));
+        if (normals && (mesh->layout & ARENA_LAYOUT_NORMALS))
+            memcpy(dst + normal_offset, &normals[v * 3], 3 * sizeof(GLfloat));
+    }
+
+    if (first_vertex + count > mesh->vertex_count)
+        mesh->vertex_count = first_vertex + count;
+    dynamic_mark_dirty(mesh->vertex_dirty, first_vertex, first_vertex + count);
+}
+
+void glapi_UpdateDynamicMeshIndices(gl_dynamic_mesh* mesh, GLuint first_index, GLuint count, const GLuint* indices) {
+    if (!count)
+        return;
+    if (first_index > mesh->max_indices || count > mesh->max_indices - first_index) {
+        fprintf(stderr, "[%s] - Index range [%u, %u) exceeds capacity %u in 'glapi_UpdateDynamicMeshIndices'\n", _FL, first_index, first_index + count, mesh->max_indices);
+        return;
+    }
+
+    memcpy(&mesh->indices[first_index], indices, (size_t)count * sizeof(GLuint));
+    if (first_index + count > mesh->index_count)
+        mesh->index_count = first_index + count;
+    dynamic_mark_dirty(mesh->index_dirty, first_index, first_index + count);
+}
+
+void glapi_SetDynamicMeshCounts(gl_dynamic_mesh* mesh, GLuint vertex_count, GLuint index_count) {
+    mesh->vertex_count = vertex_count < mesh->max_vertices ? vertex_count : mesh->max_vertices;
+    mesh->index_count = index_count < mesh->max_indices ? index_count : mesh->max_indices;
+}
+
+bool glapi_CommitDynamicMesh(gl_dynamic_mesh* mesh) {
+    if (!mesh->persistent) {
+        dynamic_flush_region(mesh, 0);
+        mesh->draw_index_count = mesh->index_count;
+        check_gl_error("glapi_CommitDynamicMesh");
+        return true;
+    }
+
+    GLuint current = mesh->draw_region;
+    if (mesh->vertex_dirty[current].begin == mesh->vertex_dirty[current].end &&
+        mesh->index_dirty[current].begin == mesh->index_dirty[current].end) {
+        mesh->draw_index_count = mesh->index_count;
+        return true;
+    }
+
+    GLuint region = (current + 1) % DYNAMIC_MESH_REGIONS;
+    if (mesh->fences[region]) {
+        if (glClientWaitSync(mesh->fences[region], 0, 0) == GL_TIMEOUT_EXPIRED) {
+            mesh->deferred_commits++;
+            return false;
+        }
+        glDeleteSync(mesh->fences[region]);
+        mesh->fences[region] = NULL;
+    }
+
+    dynamic_flush_region(mesh, region);
+    mesh->draw_region = region;
+    mesh->draw_index_count = mesh->index_count;
+    return true;
+}
+
+void glapi_DrawDynamicMesh(gl_dynamic_mesh* mesh) {
+    if (!mesh->draw_index_count)
+        return;
+
+    GLuint region = mesh->draw_region;
+    glBindVertexArray(mesh->vao);
+    glDrawElementsBaseVertex(GL_TRIANGLES, mesh->draw_index_count, GL_UNSIGNED_INT,
+        (void*)((size_t)region * mesh->max_indices * sizeof(GLuint)), (GLint)(region * mesh->max_vertices));
+
+    if (mesh->persistent) {
+        if (mesh->fences[region])
+            glDeleteSync(mesh->fences[region]);
+        mesh->fences[region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
+    check_gl_error("glapi_DrawDynamicMesh");
+}
+
+void glapi_DestroyDynamicMesh(gl_dynamic_mesh* mesh) {
+    for (GLuint r = 0; r < DYNAMIC_MESH_REGIONS; r++) {
+        if (mesh->fences[r])
+            glDeleteSync(mesh->fences[r]);
+    }
+    if (mesh->mapped_vertices) {
+        glBindBuffer(GL_COPY_WRITE_BUFFER, mesh->vbo);
+        glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+    }
+    if (mesh->mapped_indices) {
+        glBindBuffer(GL_COPY_WRITE_BUFFER, mesh->ebo);
+        glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+    }
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    glDeleteBuffers(1, &mesh->vbo);
+    glDeleteBuffers(1, &mesh->ebo);
+    glDeleteVertexArrays(1, &mesh->vao);
+    free(mesh->vertices);
+    free(mesh->indices);
+    free(mesh);
+}
+
+APIC void mesh_bounding_sphere(gl_mesh_buffer* buffer, const GLfloat* positions, GLuint vertex_count) {
+    float min[3] = {FLT_MAX, FLT_MAX, FLT_MAX}, max[3] = {-FLT_MAX, -FLT_MAX, -FLT_MAX};
+    for (GLuint v = 0; v < vertex_count; v++)
+        for (int i = 0; i < 3; i++) {
+            if (positions[v * 3 + i] < min[i])
+                min[i] = positions[v * 3 + i];
+            if (positions[v * 3 + i] > max[i])
+                max[i] = positions[v * 3 + i];
+        }
+
+    for (int i = 0; i < 3; i++)
+        buffer->center[i] = (min[i] + max[i]) * 0.5f;
+
+    float radius = 0.0f;
+    for (GLuint v = 0; v < vertex_count; v++) {
+        float dx = positions[v * 3] - buffer->center[0];
+        float dy = positions[v * 3 + 1] - buffer->center[1];
+        float dz = positions[v * 3 + 2] - buffer->center[2];
+        float distance = dx * dx + dy * dy + dz * dz;
+        if (distance > radius)
+            radius = distance;
+    }
+    buffer->radius = sqrtf(radius);
+}
+
+APIC GLuint* mesh_build_lods(gl_mesh_buffer* buffer, gl_mesh* mesh, GLuint vertex_count, GLuint max_lods) {
+    GLuint index_count = (GLuint)(mesh->indices_size / sizeof(GLuint));
+    GLuint capacity = index_count * 2;
+    GLuint* indices = (GLuint*)malloc((size_t)capacity * sizeof(GLuint));
+    GLuint* simplified = (GLuint*)malloc((size_t)index_count * sizeof(GLuint));
+    if (!indices || !simplified) {
+        fprintf(stderr, "[%s] - Failure to allocate LOD indices in 'mesh_build_lods'\n", _FL);
+        free(indices);
+        free(simplified);
+        return NULL;
+    }
+
+    memcpy(indices, mesh->indices, (size_t)index_count * sizeof(GLuint));
+    buffer->lods[0].first_index = 0;
+    buffer->lods[0].index_count = index_count;
+    buffer->lods[0].error = 0.0f;
+    buffer->lod_count = 1;
+
+    if (max_lods > MESH_MAX_LODS)
+        max_lods = MESH_MAX_LODS;
+    GLuint total = index_count;
+    while (buffer->lod_count < max_lods) {
+        gl_mesh_lod* previous = &buffer->lods[buffer->lod_count - 1];
+        GLuint target = previous->index_count / 6 * 3;
+        if (target < 3)
+            break;
+
+        float error;
+        GLuint count = glapi_SimplifyMesh(simplified, &indices[previous->first_index], previous->index_count,
+            mesh->positions, vertex_count, target, FLT_MAX, &error);
+        if (!count || count > previous->index_count / 10 * 9 || total + count > capacity)
+            break;
+
+        gl_mesh_lod* lod = &buffer->lods[buffer->lod_count++];
+        lod->first_index = total;
+        lod->index_count = count;
+        lod->error = previous->error + error;
+        glapi_OptimizeVertexCache(&indices[total], simplified, count, vertex_count);
+        total += count;
+    }
+
+    free(simplified);
+    buffer->index_count = total;
+    return indices;
+}
+
+gl_mesh_buffer* glapi_GenMeshBuffer(gl_app* app, gl_mesh* mesh, bool optimize, GLuint max_lods) {
+    GLuint vertex_count = (GLuint)(mesh->positions_size / (3 * sizeof(GLfloat)));
+    GLuint index_count = (GLuint)(mesh->indices_size / sizeof(GLuint));
+    if (!vertex_count || !index_count) {
+        fprintf(stderr, "[%s] - Empty mesh in 'glapi_GenMeshBuffer'\n", _FL);
+        return NULL;
+    }
+    if (index_count % 3) {
+        fprintf(stderr, "[%s] - Index count %u is not a whole number of triangles in 'glapi_GenMeshBuffer'\n", _FL, index_count);
+        return NULL;
+    }
+    for (GLuint i = 0; i < index_count; i++) {
+        if (mesh->indices[i] >= vertex_count) {
+            fprintf(stderr, "[%s] - Index %u out of range of %u vertices in 'glapi_GenMeshBuffer'\n", _FL, mesh->indices[i], vertex_count);
+            return NULL;
+        }
+    }
+
+    gl_mesh_buffer* buffer = (gl_mesh_buffer*)calloc(1, sizeof(gl_mesh_buffer));
+    if (!buffer) {
+        fprintf(stderr, "[%s] - Failure to allocate 'buffer' to heap in glapi_GenMeshBuffer\n", _FL);
+        return NULL;
+    }
+
+    buffer->stats.vertices_before = buffer->stats.vertices_after = vertex_count;
+    buffer->stats.triangles = index_count / 3;
+    if (optimize && glapi_OptimizeMesh(mesh, &buffer->stats)) {
+        vertex_count = buffer->stats.vertices_after;
+    } else {
+        buffer->stats.acmr_before = buffer->stats.acmr_after = glapi_MeshACMR(mesh->indices, index_count, vertex_count);
+    }
+
+    buffer->layout = 0;
+    if (mesh->uvs && mesh->uvs_size)
+        buffer->layout |= ARENA_LAYOUT_UVS;
+    if (mesh->normals && mesh->normals_size)
+        buffer->layout |= ARENA_LAYOUT_NORMALS;
+    buffer->stride = layout_stride(buffer->layout);
+    buffer->vertex_count = vertex_count;
+    buffer->index_type = vertex_count < 65536 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+    mesh_bounding_sphere(buffer, mesh->positions, vertex_count);
+
+    GLuint* lod_indices = mesh_build_lods(buffer, mesh, vertex_count, max_lods ? max_lods : 1);
+    GLfloat* vertices = interleave_mesh(mesh, buffer->layout, buffer->stride, vertex_count);
+    if (!lod_indices || !vertices) {
+        fprintf(stderr, "[%s] - Failure to allocate vertex data in glapi_GenMeshBuffer\n", _FL);
+        free(lod_indices);
+        free(vertices);
+        free(buffer);
+        return NULL;
+    }
+    index_count = buffer->index_count;
+
+    glGenVertexArrays(1, &buffer->vao);
+    glGenBuffers(1, &buffer->vbo);
+    glGenBuffers(1, &buffer->ebo);
+    glBindVertexArray(buffer->vao);
+    glBindBuffer(GL_ARRAY_BUFFER, buffer->vbo);
+    glBufferData(GL_ARRAY_BUFFER, (size_t)vertex_count * buffer->stride, vertices, GL_STATIC_DRAW);
+    interleaved_attributes(buffer->layout, buffer->stride);
+    free(vertices);
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffer->ebo);
+    if (buffer->index_type == GL_UNSIGNED_SHORT) {
+        GLushort* indices = (GLushort*)malloc((size_t)index_count * sizeof(GLushort));
+        if (!indices) {
+            fprintf(stderr, "[%s] - Failure to allocate 16-bit indices in glapi_GenMeshBuffer\n", _FL);
+            free(lod_indices);
+            glBindVertexArray(0);
+            glapi_DestroyMeshBuffer(buffer);
+            return NULL;
+        }
+        for (GLuint i = 0; i < index_count; i++)
+            indices[i] = (GLushort)lod_indices[i];
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, (size_t)index_count * sizeof(GLushort), indices, GL_STATIC_DRAW);
+        free(indices);
+    } else {
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, (size_t)index_count * sizeof(GLuint), lod_indices, GL_STATIC_DRAW);
+    }
+    free(lod_indices);
+
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    check_gl_error("glapi_GenMeshBuffer");
+
+    glapi_AppendOpenGLObjects(app, T{(GLuint*)buffer, MESH_BUFFER});
+    return buffer;
+}
+
+GLuint glapi_SelectMeshLOD(gl_mesh_buffer* buffer, const float* projection, float distance, float viewport_height, float pixel_error) {
+    float depth = distance - buffer->radius;
+    GLuint lod = 0;
+    if (depth > 0.0f) {
+        float pixels_per_unit = projection[5] * 0.5f * viewport_height / depth;
+        while (lod + 1 < buffer->lod_count && buffer->lods[lod + 1].error * pixels_per_unit <= pixel_error)
+            lod++;
+    }
+    buffer->lod = lod;
+    return lod;
+}
+
+void glapi_DrawMeshBuffer(gl_mesh_buffer* buffer) {
+    gl_mesh_lod* lod = &buffer->lods[buffer->lod];
+    size_t index_size = buffer->index_type == GL_UNSIGNED_SHORT ? sizeof(GLushort) : sizeof(GLuint);
+    glBindVertexArray(buffer->vao);
+    glDrawElements(GL_TRIANGLES, lod->index_count, buffer->index_type, (void*)((size_t)lod->first_index * index_size));
+}
+
+void glapi_DestroyMeshBuffer(gl_mesh_buffer* buffer) {
+    glDeleteBuffers(1, &buffer->vbo);
+    glDeleteBuffers(1, &buffer->ebo);
+    glDeleteVertexArrays(1, &buffer->vao);
+    free(buffer);
+}
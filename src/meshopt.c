@@ -0,0 +1,772 @@
+#include <float.h>
+#include <math.h>
+
+#include "graphics.h"
+
+#define _FL "meshopt.c"
+
+#define APIC static
+#define MESH_OPT_FORSYTH_CACHE_SIZE 32
+#define MESH_OPT_ANALYZE_CACHE_SIZE 16
+#define MESH_OPT_OVERDRAW_THRESHOLD 1.05f
+#define MESH_OPT_OVERDRAW_GRID 64
+#define MESH_OPT_EMPTY_SLOT 0xFFFFFFFFu
+#define MESH_OPT_QUADRIC_SIZE 11
+
+typedef struct mesh_cluster {
+    GLuint first_triangle;
+    GLuint triangle_count;
+    float sort_key;
+} mesh_cluster;
+
+typedef struct mesh_collapse {
+    GLuint source;
+    GLuint target;
+    double cost;
+} mesh_collapse;
+
+APIC GLuint mesh_vertex_floats(gl_mesh* mesh);
+APIC GLfloat* mesh_pack_vertices(gl_mesh* mesh, GLuint vertex_count, GLuint floats);
+APIC bool mesh_unpack_vertices(gl_mesh* mesh, const GLfloat* packed, GLuint vertex_count);
+APIC uint32_t mesh_hash_vertex(const GLfloat* vertex, GLuint floats);
+APIC GLuint mesh_weld(GLfloat* packed, GLuint vertex_count, GLuint floats, GLuint* remap);
+APIC float forsyth_vertex_score(int cache_position, GLuint remaining);
+APIC bool mesh_optimize_vertex_cache(GLuint* dst, const GLuint* indices, GLuint index_count, GLuint vertex_count);
+APIC int mesh_cluster_compare(const void* a, const void* b);
+APIC float mesh_overdraw(float* depth, const GLuint* indices, const GLfloat* packed, GLuint vertex_count, GLuint floats, const mesh_cluster* clusters, GLuint cluster_count);
+APIC bool mesh_optimize_overdraw(GLuint* indices, GLuint index_count, const GLfloat* packed, GLuint vertex_count, GLuint floats);
+APIC GLuint mesh_optimize_fetch(GLfloat** packed, GLuint* indices, GLuint index_count, GLuint vertex_count, GLuint floats);
+APIC void quadric_add_plane(double* q, const GLfloat* p0, const GLfloat* p1, const GLfloat* p2);
+APIC double quadric_error(const double* a, const double* b, const GLfloat* p);
+APIC int mesh_edge_compare(const void* a, const void* b);
+APIC int mesh_collapse_compare(const void* a, const void* b);
+APIC bool mesh_lock_boundaries(const GLuint* indices, GLuint index_count, bool* locked);
+APIC bool mesh_collapse_flips(const GLuint* indices, const GLuint* adjacency_offsets, const GLuint* adjacency, const GLfloat* positions, GLuint source, GLuint target);
+
+APIC GLuint mesh_vertex_floats(gl_mesh* mesh) {
+    GLuint floats = 3;
+    if (mesh->uvs && mesh->uvs_size)
+        floats += 2;
+    if (mesh->normals && mesh->normals_size)
+        floats += 3;
+    return floats;
+}
+
+APIC GLfloat* mesh_pack_vertices(gl_mesh* mesh, GLuint vertex_count, GLuint floats) {
+    GLfloat* packed = (GLfloat*)calloc((size_t)vertex_count * floats, sizeof(GLfloat));
+    if (!packed)
+        return NULL;
+
+    bool has_uvs = mesh->uvs && mesh->uvs_size;
+    bool has_normals = mesh->normals && mesh->normals_size;
+    size_t uv_count = has_uvs ? mesh->uvs_size / (2 * sizeof(GLfloat)) : 0;
+    size_t normal_count = has_normals ? mesh->normals_size / (3 * sizeof(GLfloat)) : 0;
+    for (GLuint v = 0; v < vertex_count; v++) {
+        GLfloat* dst = packed + (size_t)v * floats;
+        for (int i = 0; i < 3; i++)
+            dst[i] = mesh->positions[v * 3 + i] + 0.0f;
+        dst += 3;
+        if (has_uvs) {
+            if (v < uv_count)
+                for (int i = 0; i < 2; i++)
+                    dst[i] = mesh->uvs[v * 2 + i] + 0.0f;
+            dst += 2;
+        }
+        if (has_normals && v < normal_count)
+            for (int i = 0; i < 3; i++)
+                dst[i] = mesh->normals[v * 3 + i] + 0.0f;
+    }
+    return packed;
+}
+
+APIC bool mesh_unpack_vertices(gl_mesh* mesh, const GLfloat* packed, GLuint vertex_count) {
+    bool has_uvs = mesh->uvs && mesh->uvs_size;
+    bool has_normals = mesh->normals && mesh->normals_size;
+    GLuint floats = mesh_vertex_floats(mesh);
+
+    GLfloat* positions = (GLfloat*)malloc((size_t)vertex_count * 3 * sizeof(GLfloat));
+    GLfloat* uvs = has_uvs ? (GLfloat*)malloc((size_t)vertex_count * 2 * sizeof(GLfloat)) : NULL;
+    GLfloat* normals = has_normals ? (GLfloat*)malloc((size_t)vertex_count * 3 * sizeof(GLfloat)) : NULL;
+    if (!positions || (has_uvs && !uvs) || (has_normals && !normals)) {
+        free(positions);
+        free(uvs);
+        free(normals);
+        return false;
+    }
+
+    for (GLuint v = 0; v < vertex_count; v++) {
+        const GLfloat* src = packed + (size_t)v * floats;
+        memcpy(&positions[v * 3], src, 3 * sizeof(GLfloat));
+        src += 3;
+        if (has_uvs) {
+            memcpy(&uvs[v * 2], src, 2 * sizeof(GLfloat));
+            src += 2;
+        }
+        if (has_normals)
+            memcpy(&normals[v * 3], src, 3 * sizeof(GLfloat));
+    }
+
+    free(mesh->positions);
+    free(mesh->uvs);
+    free(mesh->normals);
+    mesh->positions = positions;
+    mesh->uvs = uvs;
+    mesh->normals = normals;
+    mesh->positions_size = (size_t)vertex_count * 3 * sizeof(GLfloat);
+    mesh->uvs_size = has_uvs ? (size_t)vertex_count * 2 * sizeof(GLfloat) : 0;
+    mesh->normals_size = has_normals ? (size_t)vertex_count * 3 * sizeof(GLfloat) : 0;
+    return true;
+}
+
+APIC uint32_t mesh_hash_vertex(const GLfloat* vertex, GLuint floats) {
+    const unsigned char* bytes = (const unsigned char*)vertex;
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < floats * sizeof(GLfloat); i++) {
+        hash ^= bytes[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+APIC GLuint mesh_weld(GLfloat* packed, GLuint vertex_count, GLuint floats, GLuint* remap) {
+    size_t table_size = 1;
+    while (table_size < (size_t)vertex_count * 2)
+        table_size *= 2;
+
+    GLuint* table = (GLuint*)malloc(table_size * sizeof(GLuint));
+    if (!table)
+        return 0;
+    memset(table, 0xFF, table_size * sizeof(GLuint));
+
+    size_t vertex_size = floats * sizeof(GLfloat);
+    GLuint unique = 0;
+    for (GLuint v = 0; v < vertex_count; v++) {
+        const GLfloat* vertex = packed + (size_t)v * floats;
+        size_t slot = mesh_hash_vertex(vertex, floats) & (table_size - 1);
+        while (table[slot] != MESH_OPT_EMPTY_SLOT && memcmp(packed + (size_t)table[slot] * floats, vertex, vertex_size))
+            slot = (slot + 1) & (table_size - 1);
+
+        if (table[slot] == MESH_OPT_EMPTY_SLOT) {
+            if (unique != v)
+                memcpy(packed + (size_t)unique * floats, vertex, vertex_size);
+            table[slot] = unique++;
+        }
+        remap[v] = table[slot];
+    }
+
+    free(table);
+    return unique;
+}
+
+APIC float forsyth_vertex_score(int cache_position, GLuint remaining) {
+    if (!remaining)
+        return 0.0f;
+
+    float score = 0.0f;
+    if (cache_position >= 0) {
+        if (cache_position < 3) {
+            score = 0.75f;
+        } else {
+            float scaled = 1.0f - (float)(cache_position - 3) / (MESH_OPT_FORSYTH_CACHE_SIZE - 3);
+            score = powf(scaled, 1.5f);
+        }
+    }
+    return score + 2.0f / sqrtf((float)remaining);
+}
+
+APIC bool mesh_optimize_vertex_cache(GLuint* dst, const GLuint* indices, GLuint index_count, GLuint vertex_count) {
+    GLuint triangle_count = index_count / 3;
+    GLuint* valence = (GLuint*)calloc(vertex_count, sizeof(GLuint));
+    GLuint* adjacency_offsets = (GLuint*)malloc(((size_t)vertex_count + 1) * sizeof(GLuint));
+    GLuint* adjacency = (GLuint*)malloc((size_t)index_count * sizeof(GLuint));
+    int* cache_position = (int*)malloc((size_t)vertex_count * sizeof(int));
+    float* vertex_score = (float*)malloc((size_t)vertex_count * sizeof(float));
+    float* triangle_score = (float*)malloc((size_t)triangle_count * sizeof(float));
+    bool* emitted = (bool*)calloc(triangle_count, sizeof(bool));
+    bool ok = valence && adjacency_offsets && adjacency && cache_position && vertex_score && triangle_score && emitted;
+
+    if (ok) {
+        for (GLuint i = 0; i < index_count; i++)
+            valence[indices[i]]++;
+
+        adjacency_offsets[0] = 0;
+        for (GLuint v = 0; v < vertex_count; v++)
+            adjacency_offsets[v + 1] = adjacency_offsets[v] + valence[v];
+        memset(valence, 0, vertex_count * sizeof(GLuint));
+        for (GLuint t = 0; t < triangle_count; t++)
+            for (int k = 0; k < 3; k++) {
+                GLuint v = indices[t * 3 + k];
+                adjacency[adjacency_offsets[v] + valence[v]++] = t;
+            }
+
+        for (GLuint v = 0; v < vertex_count; v++) {
+            cache_position[v] = -1;
+            vertex_score[v] = forsyth_vertex_score(-1, valence[v]);
+        }
+
+        GLuint best = 0;
+        for (GLuint t = 0; t < triangle_count; t++) {
+            triangle_score[t] = vertex_score[indices[t * 3]] + vertex_score[indices[t * 3 + 1]] + vertex_score[indices[t * 3 + 2]];
+            if (triangle_score[t] > triangle_score[best])
+                best = t;
+        }
+
+        GLuint cache[MESH_OPT_FORSYTH_CACHE_SIZE + 3];
+        GLuint next_cache[MESH_OPT_FORSYTH_CACHE_SIZE + 3];
+        GLuint cache_count = 0;
+        GLuint input_cursor = 0;
+
+        for (GLuint out = 0; out < triangle_count; out++) {
+            if (best == MESH_OPT_EMPTY_SLOT) {
+                while (emitted[input_cursor])
+                    input_cursor++;
+                best = input_cursor;
+            }
+
+            const GLuint* triangle = &indices[best * 3];
+            memcpy(&dst[out * 3], triangle, 3 * sizeof(GLuint));
+            emitted[best] = true;
+
+            GLuint next_count = 0;
+            for (int k = 0; k < 3; k++) {
+                GLuint v = triangle[k];
+                GLuint* list = &adjacency[adjacency_offsets[v]];
+                for (GLuint i = 0; i < valence[v]; i++) {
+                    if (list[i] == best) {
+                        list[i] = list[valence[v] - 1];
+                        break;
+                    }
+                }
+                valence[v]--;
+                next_cache[next_count++] = v;
+            }
+            for (GLuint i = 0; i < cache_count; i++) {
+                GLuint v = cache[i];
+                if (v != triangle[0] && v != triangle[1] && v != triangle[2])
+                    next_cache[next_count++] = v;
+            }
+
+            best = MESH_OPT_EMPTY_SLOT;
+            float best_score = 0.0f;
+            for (GLuint i = 0; i < next_count; i++) {
+                GLuint v = next_cache[i];
+                cache_position[v] = i < MESH_OPT_FORSYTH_CACHE_SIZE ? (int)i : -1;
+                float score = forsyth_vertex_score(cache_position[v], valence[v]);
+                float delta = score - vertex_score[v];
+                vertex_score[v] = score;
+
+                const GLuint* list = &adjacency[adjacency_offsets[v]];
+                for (GLuint j = 0; j < valence[v]; j++) {
+                    GLuint t = list[j];
+                    triangle_score[t] += delta;
+                    if (i < MESH_OPT_FORSYTH_CACHE_SIZE && triangle_score[t] > best_score) {
+                        best_score = triangle_score[t];
+                        best = t;
+                    }
+                }
+            }
+
+            cache_count = next_count < MESH_OPT_FORSYTH_CACHE_SIZE ? next_count : MESH_OPT_FORSYTH_CACHE_SIZE;
+            memcpy(cache, next_cache, cache_count * sizeof(GLuint));
+        }
+    } else {
+        fprintf(stderr, "[%s] - Failure to allocate vertex cache state in 'mesh_optimize_vertex_cache'\n", _FL);
+    }
+
+    free(valence);
+    free(adjacency_offsets);
+    free(adjacency);
+    free(cache_position);
+    free(vertex_score);
+    free(triangle_score);
+    free(emitted);
+    return ok;
+}
+
+APIC int mesh_cluster_compare(const void* a, const void* b) {
+    float ka = ((const mesh_cluster*)a)->sort_key;
+    float kb = ((const mesh_cluster*)b)->sort_key;
+    return (ka < kb) - (ka > kb);
+}
+
+APIC float mesh_overdraw(float* depth, const GLuint* indices, const GLfloat* packed, GLuint vertex_count, GLuint floats, const mesh_cluster* clusters, GLuint cluster_count) {
+    float low[3] = {FLT_MAX, FLT_MAX, FLT_MAX};
+    float high[3] = {-FLT_MAX, -FLT_MAX, -FLT_MAX};
+    for (GLuint v = 0; v < vertex_count; v++) {
+        for (int i = 0; i < 3; i++) {
+            low[i] = fminf(low[i], packed[(size_t)v * floats + i]);
+            high[i] = fmaxf(high[i], packed[(size_t)v * floats + i]);
+        }
+    }
+    float scale[3];
+    for (int i = 0; i < 3; i++)
+        scale[i] = high[i] > low[i] ? (MESH_OPT_OVERDRAW_GRID - 1) / (high[i] - low[i]) : 0.0f;
+
+    size_t shaded = 0, covered = 0;
+    for (int view = 0; view < 6; view++) {
+        int axis = view >> 1, u_axis = (axis + 1) % 3, v_axis = (axis + 2) % 3;
+        float facing = view & 1 ? -1.0f : 1.0f;
+        for (int i = 0; i < MESH_OPT_OVERDRAW_GRID * MESH_OPT_OVERDRAW_GRID; i++)
+            depth[i] = FLT_MAX;
+
+        for (GLuint c = 0; c < cluster_count; c++) {
+            for (GLuint t = clusters[c].first_triangle; t < clusters[c].first_triangle + clusters[c].triangle_count; t++) {
+                float x[3], y[3], z[3];
+                for (int k = 0; k < 3; k++) {
+                    const GLfloat* p = packed + (size_t)indices[t * 3 + k] * floats;
+                    x[k] = (p[u_axis] - low[u_axis]) * scale[u_axis];
+                    y[k] = (p[v_axis] - low[v_axis]) * scale[v_axis];
+                    z[k] = -facing * p[axis];
+                }
+                float area = (x[1] - x[0]) * (y[2] - y[0]) - (x[2] - x[0]) * (y[1] - y[0]);
+                if (area * facing <= 0.0f)
+                    continue;
+
+                int min_x = (int)fmaxf(floorf(fminf(x[0], fminf(x[1], x[2]))), 0.0f);
+                int max_x = (int)fminf(ceilf(fmaxf(x[0], fmaxf(x[1], x[2]))), MESH_OPT_OVERDRAW_GRID - 1);
+                int min_y = (int)fmaxf(floorf(fminf(y[0], fminf(y[1], y[2]))), 0.0f);
+                int max_y = (int)fminf(ceilf(fmaxf(y[0], fmaxf(y[1], y[2]))), MESH_OPT_OVERDRAW_GRID - 1);
+                for (int py = min_y; py <= max_y; py++) {
+                    for (int px = min_x; px <= max_x; px++) {
+                        float w0 = ((x[2] - x[1]) * (py - y[1]) - (y[2] - y[1]) * (px - x[1])) / area;
+                        float w1 = ((x[0] - x[2]) * (py - y[2]) - (y[0] - y[2]) * (px - x[2])) / area;
+                        float w2 = 1.0f - w0 - w1;
+                        if (w0 < 0.0f || w1 < 0.0f || w2 < 0.0f)
+                            continue;
+                        float d = w0 * z[0] + w1 * z[1] + w2 * z[2];
+                        float* cell = &depth[py * MESH_OPT_OVERDRAW_GRID + px];
+                        if (d < *cell) {
+                            covered += *cell == FLT_MAX;
+                            *cell = d;
+                            shaded++;
+                        }
+                    }
+                }
+            }
+        }
+    }
+    return covered ? (float)shaded / (float)covered : 1.0f;
+}
+
+APIC bool mesh_optimize_overdraw(GLuint* indices, GLuint index_count, const GLfloat* packed, GLuint vertex_count, GLuint floats) {
+    GLuint triangle_count = index_count / 3;
+    GLuint* timestamps = (GLuint*)calloc(vertex_count, sizeof(GLuint));
+    mesh_cluster* clusters = (mesh_cluster*)malloc((size_t)triangle_count * sizeof(mesh_cluster));
+    GLuint* sorted = (GLuint*)malloc((size_t)index_count * sizeof(GLuint));
+    float* depth = (float*)malloc(MESH_OPT_OVERDRAW_GRID * MESH_OPT_OVERDRAW_GRID * sizeof(float));
+    if (!timestamps || !clusters || !sorted || !depth) {
+        fprintf(stderr, "[%s] - Failure to allocate cluster state in 'mesh_optimize_overdraw'\n", _FL);
+        free(timestamps);
+        free(clusters);
+        free(sorted);
+        free(depth);
+        return false;
+    }
+
+    GLuint cluster_count = 0;
+    GLuint time = MESH_OPT_ANALYZE_CACHE_SIZE + 1;
+    for (GLuint t = 0; t < triangle_count; t++) {
+        GLuint misses = 0;
+        for (int k = 0; k < 3; k++) {
+            GLuint v = indices[t * 3 + k];
+            if (time - timestamps[v] > MESH_OPT_ANALYZE_CACHE_SIZE) {
+                timestamps[v] = time++;
+                misses++;
+            }
+        }
+        if (!cluster_count || misses == 3) {
+            clusters[cluster_count].first_triangle = t;
+            clusters[cluster_count].triangle_count = 0;
+            cluster_count++;
+        }
+        clusters[cluster_count - 1].triangle_count++;
+    }
+
+    float overdraw_cache = mesh_overdraw(depth, indices, packed, vertex_count, floats, clusters, cluster_count);
+
+    float mesh_center[3] = {0.0f, 0.0f, 0.0f};
+    for (GLuint v = 0; v < vertex_count; v++)
+        for (int i = 0; i < 3; i++)
+            mesh_center[i] += packed[(size_t)v * floats + i];
+    for (int i = 0; i < 3; i++)
+        mesh_center[i] /= vertex_count ? (float)vertex_count : 1.0f;
+
+    for (GLuint c = 0; c < cluster_count; c++) {
+        float center[3] = {0.0f, 0.0f, 0.0f};
+        float normal[3] = {0.0f, 0.0f, 0.0f};
+        float area = 0.0f;
+        for (GLuint t = clusters[c].first_triangle; t < clusters[c].first_triangle + clusters[c].triangle_count; t++) {
+            const GLfloat* p0 = packed + (size_t)indices[t * 3] * floats;
+            const GLfloat* p1 = packed + (size_t)indices[t * 3 + 1] * floats;
+            const GLfloat* p2 = packed + (size_t)indices[t * 3 + 2] * floats;
+            float e1[3] = {p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2]};
+            float e2[3] = {p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2]};
+            float n[3] = {e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0]};
+            float weight = sqrtf(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+            for (int i = 0; i < 3; i++) {
+                center[i] += (p0[i] + p1[i] + p2[i]) / 3.0f * weight;
+                normal[i] += n[i];
+            }
+            area += weight;
+        }
+
+        float length = sqrtf(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+        float key = 0.0f;
+        if (area > 0.0f && length > 0.0f)
+            for (int i = 0; i < 3; i++)
+                key += (center[i] / area - mesh_center[i]) * (normal[i] / length);
+        clusters[c].sort_key = key;
+    }
+
+    qsort(clusters, cluster_count, sizeof(mesh_cluster), mesh_cluster_compare);
+    float overdraw_sorted = mesh_overdraw(depth, indices, packed, vertex_count, floats, clusters, cluster_count);
+
+    GLuint out = 0;
+    for (GLuint c = 0; c < cluster_count; c++) {
+        size_t count = (size_t)clusters[c].triangle_count * 3;
+        memcpy(&sorted[out], &indices[clusters[c].first_triangle * 3], count * sizeof(GLuint));
+        out += (GLuint)count;
+    }
+
+    float acmr_cache = glapi_MeshACMR(indices, index_count, vertex_count);
+    float acmr_sorted = glapi_MeshACMR(sorted, index_count, vertex_count);
+    bool accepted = overdraw_sorted < overdraw_cache && acmr_sorted <= acmr_cache * MESH_OPT_OVERDRAW_THRESHOLD;
+    if (accepted)
+        memcpy(indices, sorted, (size_t)index_count * sizeof(GLuint));
+
+    free(timestamps);
+    free(clusters);
+    free(sorted);
+    free(depth);
+    return accepted;
+}
+
+APIC GLuint mesh_optimize_fetch(GLfloat** packed, GLuint* indices, GLuint index_count, GLuint vertex_count, GLuint floats) {
+    GLuint* remap = (GLuint*)malloc((size_t)vertex_count * sizeof(GLuint));
+    GLfloat* fetched = (GLfloat*)malloc((size_t)vertex_count * floats * sizeof(GLfloat));
+    if (!remap || !fetched) {
+        fprintf(stderr, "[%s] - Failure to allocate fetch remap in 'mesh_optimize_fetch'\n", _FL);
+        free(remap);
+        free(fetched);
+        return 0;
+    }
+    memset(remap, 0xFF, (size_t)vertex_count * sizeof(GLuint));
+
+    GLuint next = 0;
+    for (GLuint i = 0; i < index_count; i++) {
+        GLuint v = indices[i];
+        if (remap[v] == MESH_OPT_EMPTY_SLOT) {
+            memcpy(fetched + (size_t)next * floats, *packed + (size_t)v * floats, floats * sizeof(GLfloat));
+            remap[v] = next++;
+        }
+        indices[i] = remap[v];
+    }
+
+    free(remap);
+    free(*packed);
+    *packed = fetched;
+    return next;
+}
+
+float glapi_MeshACMR(const GLuint* indices, GLuint index_count, GLuint vertex_count) {
+    if (index_count < 3)
+        return 0.0f;
+
+    GLuint* timestamps = (GLuint*)calloc(vertex_count, sizeof(GLuint));
+    if (!timestamps) {
+        fprintf(stderr, "[%s] - Failure to allocate cache timestamps in 'glapi_MeshACMR'\n", _FL);
+        return 0.0f;
+    }
+
+    GLuint time = MESH_OPT_ANALYZE_CACHE_SIZE + 1;
+    GLuint misses = 0;
+    for (GLuint i = 0; i < index_count; i++) {
+        GLuint v = indices[i];
+        if (time - timestamps[v] > MESH_OPT_ANALYZE_CACHE_SIZE) {
+            timestamps[v] = time++;
+            misses++;
+        }
+    }
+
+    free(timestamps);
+    return (float)misses / (float)(index_count / 3);
+}
+
+bool glapi_OptimizeMesh(gl_mesh* mesh, gl_mesh_stats* stats) {
+    GLuint vertex_count = (GLuint)(mesh->positions_size / (3 * sizeof(GLfloat)));
+    GLuint index_count = (GLuint)(mesh->indices_size / sizeof(GLuint));
+    if (!vertex_count || index_count < 3 || index_count % 3) {
+        fprintf(stderr, "[%s] - Mesh has no triangles in 'glapi_OptimizeMesh'\n", _FL);
+        return false;
+    }
+
+    gl_mesh_stats result;
+    result.vertices_before = vertex_count;
+    result.triangles = index_count / 3;
+    result.acmr_before = glapi_MeshACMR(mesh->indices, index_count, vertex_count);
+    result.overdraw_sorted = false;
+
+    GLuint floats = mesh_vertex_floats(mesh);
+    GLfloat* packed = mesh_pack_vertices(mesh, vertex_count, floats);
+    GLuint* remap = (GLuint*)malloc((size_t)vertex_count * sizeof(GLuint));
+    GLuint* welded = (GLuint*)malloc((size_t)index_count * sizeof(GLuint));
+    GLuint* reordered = (GLuint*)malloc((size_t)index_count * sizeof(GLuint));
+    if (!packed || !remap || !welded || !reordered) {
+        fprintf(stderr, "[%s] - Failure to allocate working buffers in 'glapi_OptimizeMesh'\n", _FL);
+        free(packed);
+        free(remap);
+        free(welded);
+        free(reordered);
+        return false;
+    }
+
+    bool ok = false;
+    GLuint unique = mesh_weld(packed, vertex_count, floats, remap);
+    if (unique) {
+        for (GLuint i = 0; i < index_count; i++)
+            welded[i] = remap[mesh->indices[i]];
+
+        if (mesh_optimize_vertex_cache(reordered, welded, index_count, unique)) {
+            result.overdraw_sorted = mesh_optimize_overdraw(reordered, index_count, packed, unique, floats);
+            GLuint fetched = mesh_optimize_fetch(&packed, reordered, index_count, unique, floats);
+            if (fetched && mesh_unpack_vertices(mesh, packed, fetched)) {
+                memcpy(mesh->indices, reordered, (size_t)index_count * sizeof(GLuint));
+                result.vertices_after = fetched;
+                result.acmr_after = glapi_MeshACMR(mesh->indices, index_count, fetched);
+                ok = true;
+            }
+        }
+    }
+
+    free(packed);
+    free(remap);
+    free(welded);
+    free(reordered);
+    if (!ok) {
+        fprintf(stderr, "[%s] - Mesh optimization failed in 'glapi_OptimizeMesh'\n", _FL);
+        return false;
+    }
+
+    if (stats)
+        *stats = result;
+    return true;
+}
+
+APIC void quadric_add_plane(double* q, const GLfloat* p0, const GLfloat* p1, const GLfloat* p2) {
+    double e1[3] = {p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2]};
+    double e2[3] = {p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2]};
+    double n[3] = {e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0]};
+    double length = sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+    if (length <= 0.0)
+        return;
+    for (int i = 0; i < 3; i++)
+        n[i] /= length;
+    double d = -(n[0] * p0[0] + n[1] * p0[1] + n[2] * p0[2]);
+    double w = length * 0.5;
+
+    q[0] += w * n[0] * n[0]; q[1] += w * n[0] * n[1]; q[2] += w * n[0] * n[2]; q[3] += w * n[0] * d;
+    q[4] += w * n[1] * n[1]; q[5] += w * n[1] * n[2]; q[6] += w * n[1] * d;
+    q[7] += w * n[2] * n[2]; q[8] += w * n[2] * d;
+    q[9] += w * d * d;
+    q[10] += w;
+}
+
+APIC double quadric_error(const double* a, const double* b, const GLfloat* p) {
+    double q[MESH_OPT_QUADRIC_SIZE];
+    for (int i = 0; i < MESH_OPT_QUADRIC_SIZE; i++)
+        q[i] = a[i] + b[i];
+    double x = p[0], y = p[1], z = p[2];
+    double error = q[0] * x * x + q[4] * y * y + q[7] * z * z
+        + 2.0 * (q[1] * x * y + q[2] * x * z + q[5] * y * z)
+        + 2.0 * (q[3] * x + q[6] * y + q[8] * z) + q[9];
+    return error > 0.0 && q[10] > 0.0 ? error / q[10] : 0.0;
+}
+
+APIC int mesh_edge_compare(const void* a, const void* b) {
+    uint64_t ea = *(const uint64_t*)a, eb = *(const uint64_t*)b;
+    return (ea > eb) - (ea < eb);
+}
+
+APIC int mesh_collapse_compare(const void* a, const void* b) {
+    double ca = ((const mesh_collapse*)a)->cost, cb = ((const mesh_collapse*)b)->cost;
+    return (ca > cb) - (ca < cb);
+}
+
+APIC bool mesh_lock_boundaries(const GLuint* indices, GLuint index_count, bool* locked) {
+    uint64_t* edges = (uint64_t*)malloc((size_t)index_count * sizeof(uint64_t));
+    if (!edges)
+        return false;
+
+    for (GLuint t = 0; t < index_count / 3; t++)
+        for (int k = 0; k < 3; k++) {
+            uint64_t a = indices[t * 3 + k], b = indices[t * 3 + (k + 1) % 3];
+            edges[t * 3 + k] = a < b ? (a << 32) | b : (b << 32) | a;
+        }
+    qsort(edges, index_count, sizeof(uint64_t), mesh_edge_compare);
+
+    for (GLuint i = 0; i < index_count;) {
+        GLuint run = 1;
+        while (i + run < index_count && edges[i + run] == edges[i])
+            run++;
+        if (run != 2) {
+            locked[edges[i] >> 32] = true;
+            locked[edges[i] & 0xFFFFFFFFu] = true;
+        }
+        i += run;
+    }
+
+    free(edges);
+    return true;
+}
+
+APIC bool mesh_collapse_flips(const GLuint* indices, const GLuint* adjacency_offsets, const GLuint* adjacency, const GLfloat* positions, GLuint source, GLuint target) {
+    const GLfloat* moved = &positions[target * 3];
+    for (GLuint i = adjacency_offsets[source]; i < adjacency_offsets[source + 1]; i++) {
+        const GLuint* triangle = &indices[adjacency[i] * 3];
+        if (triangle[0] == target || triangle[1] == target || triangle[2] == target)
+            continue;
+
+        const GLfloat* before[3];
+        const GLfloat* after[3];
+        for (int k = 0; k < 3; k++) {
+            before[k] = &positions[triangle[k] * 3];
+            after[k] = triangle[k] == source ? moved : before[k];
+        }
+
+        float n0[3], n1[3];
+        const GLfloat** corners[2] = {before, after};
+        float* normals[2] = {n0, n1};
+        for (int s = 0; s < 2; s++) {
+            const GLfloat** p = corners[s];
+            float e1[3] = {p[1][0] - p[0][0], p[1][1] - p[0][1], p[1][2] - p[0][2]};
+            float e2[3] = {p[2][0] - p[0][0], p[2][1] - p[0][1], p[2][2] - p[0][2]};
+            normals[s][0] = e1[1] * e2[2] - e1[2] * e2[1];
+            normals[s][1] = e1[2] * e2[0] - e1[0] * e2[2];
+            normals[s][2] = e1[0] * e2[1] - e1[1] * e2[0];
+        }
+
+        float dot = n0[0] * n1[0] + n0[1] * n1[1] + n0[2] * n1[2];
+        float l0 = sqrtf(n0[0] * n0[0] + n0[1] * n0[1] + n0[2] * n0[2]);
+        float l1 = sqrtf(n1[0] * n1[0] + n1[1] * n1[1] + n1[2] * n1[2]);
+        if (dot <= 0.25f * l0 * l1)
+            return true;
+    }
+    return false;
+}
+
+void glapi_OptimizeVertexCache(GLuint* dst, const GLuint* indices, GLuint index_count, GLuint vertex_count) {
+    if (!mesh_optimize_vertex_cache(dst, indices, index_count, vertex_count) && dst != indices)
+        memcpy(dst, indices, (size_t)index_count * sizeof(GLuint));
+}
+
+GLuint glapi_SimplifyMesh(GLuint* dst, const GLuint* indices, GLuint index_count, const GLfloat* positions, GLuint vertex_count, GLuint target_index_count, float target_error, float* result_error) {
+    double* quadrics = (double*)calloc((size_t)vertex_count * MESH_OPT_QUADRIC_SIZE, sizeof(double));
+    bool* locked = (bool*)calloc(vertex_count, sizeof(bool));
+    bool* touched = (bool*)malloc(vertex_count * sizeof(bool));
+    GLuint* remap = (GLuint*)malloc((size_t)vertex_count * sizeof(GLuint));
+    GLuint* adjacency_offsets = (GLuint*)malloc(((size_t)vertex_count + 1) * sizeof(GLuint));
+    GLuint* adjacency = (GLuint*)malloc((size_t)index_count * sizeof(GLuint));
+    mesh_collapse* collapses = (mesh_collapse*)malloc((size_t)index_count * sizeof(mesh_collapse));
+    if (!quadrics || !locked || !touched || !remap || !adjacency_offsets || !adjacency || !collapses ||
+        !mesh_lock_boundaries(indices, index_count, locked)) {
+        fprintf(stderr, "[%s] - Failure to allocate simplifier state in 'glapi_SimplifyMesh'\n", _FL);
+        free(quadrics);
+        free(locked);
+        free(touched);
+        free(remap);
+        free(adjacency_offsets);
+        free(adjacency);
+        free(collapses);
+        return 0;
+    }
+
+    memcpy(dst, indices, (size_t)index_count * sizeof(GLuint));
+    for (GLuint t = 0; t < index_count / 3; t++) {
+        const GLuint* triangle = &dst[t * 3];
+        for (int k = 0; k < 3; k++)
+            quadric_add_plane(&quadrics[triangle[k] * MESH_OPT_QUADRIC_SIZE], &positions[triangle[0] * 3], &positions[triangle[1] * 3], &positions[triangle[2] * 3]);
+    }
+
+    double error_limit = (double)target_error * target_error;
+    double max_error = 0.0;
+    GLuint count = index_count;
+    while (count > target_index_count) {
+        memset(adjacency_offsets, 0, ((size_t)vertex_count + 1) * sizeof(GLuint));
+        for (GLuint i = 0; i < count; i++)
+            adjacency_offsets[dst[i] + 1]++;
+        for (GLuint v = 0; v < vertex_count; v++)
+            adjacency_offsets[v + 1] += adjacency_offsets[v];
+        for (GLuint i = 0; i < count; i++)
+            adjacency[adjacency_offsets[dst[i]]++] = i / 3;
+        for (GLuint v = vertex_count; v > 0; v--)
+            adjacency_offsets[v] = adjacency_offsets[v - 1];
+        adjacency_offsets[0] = 0;
+
+        GLuint collapse_count = 0;
+        for (GLuint i = 0; i < count; i++) {
+            GLuint a = dst[i], b = dst[i - i % 3 + (i % 3 + 1) % 3];
+            double cost_ab = locked[a] ? DBL_MAX : quadric_error(&quadrics[a * MESH_OPT_QUADRIC_SIZE], &quadrics[b * MESH_OPT_QUADRIC_SIZE], &positions[b * 3]);
+            double cost_ba = locked[b] ? DBL_MAX : quadric_error(&quadrics[a * MESH_OPT_QUADRIC_SIZE], &quadrics[b * MESH_OPT_QUADRIC_SIZE], &positions[a * 3]);
+            if (cost_ab == DBL_MAX && cost_ba == DBL_MAX)
+                continue;
+            mesh_collapse* collapse = &collapses[collapse_count++];
+            collapse->source = cost_ab <= cost_ba ? a : b;
+            collapse->target = cost_ab <= cost_ba ? b : a;
+            collapse->cost = cost_ab <= cost_ba ? cost_ab : cost_ba;
+        }
+        if (!collapse_count)
+            break;
+        qsort(collapses, collapse_count, sizeof(mesh_collapse), mesh_collapse_compare);
+
+        for (GLuint v = 0; v < vertex_count; v++)
+            remap[v] = v;
+        memset(touched, 0, vertex_count * sizeof(bool));
+
+        GLuint allowed = (count - target_index_count) / 6 + 1;
+        GLuint collapsed = 0;
+        for (GLuint c = 0; c < collapse_count && collapsed < allowed; c++) {
+            mesh_collapse* collapse = &collapses[c];
+            if (collapse->cost > error_limit)
+                break;
+            if (touched[collapse->source] || touched[collapse->target])
+                continue;
+            if (mesh_collapse_flips(dst, adjacency_offsets, adjacency, positions, collapse->source, collapse->target))
+                continue;
+
+            remap[collapse->source] = collapse->target;
+            for (int i = 0; i < MESH_OPT_QUADRIC_SIZE; i++)
+                quadrics[collapse->target * MESH_OPT_QUADRIC_SIZE + i] += quadrics[collapse->source * MESH_OPT_QUADRIC_SIZE + i];
+            for (GLuint i = adjacency_offsets[collapse->source]; i < adjacency_offsets[collapse->source + 1]; i++)
+                for (int k = 0; k < 3; k++)
+                    touched[dst[adjacency[i] * 3 + k]] = true;
+            if (collapse->cost > max_error)
+                max_error = collapse->cost;
+            collapsed++;
+        }
+        if (!collapsed)
+            break;
+
+        GLuint kept = 0;
+        for (GLuint t = 0; t < count / 3; t++) {
+            GLuint a = remap[dst[t * 3]], b = remap[dst[t * 3 + 1]], c = remap[dst[t * 3 + 2]];
+            if (a == b || b == c || a == c)
+                continue;
+            dst[kept++] = a;
+            dst[kept++] = b;
+            dst[kept++] = c;
+        }
+        count = kept;
+    }
+
+    free(quadrics);
+    free(locked);
+    free(touched);
+    free(remap);
+    free(adjacency_offsets);
+    free(adjacency);
+    free(collapses);
+
+    if (result_error)
+        *result_error = (float)sqrt(max_error);
+    return count;
+}
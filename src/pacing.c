@@ -0,0 +1,347 @@
+#include <time.h>
+
+#include "graphics.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+#define _FL "pacing.c"
+
+#define APIC static
+#define PACER_MARGIN_MIN_NS 200000ull
+#define PACER_MARGIN_MAX_NS 4000000ull
+#define PACER_FENCE_TIMEOUT_NS 1000000000ull
+
+static const double pacer_bucket_edges[FRAME_PACER_BUCKETS - 1] = {2.0, 4.0, 6.0, 8.0, 10.0, 12.0, 14.0, 16.7, 20.0, 25.0, 33.4, 50.0, 66.7, 100.0};
+
+APIC gl_frame_pacer* frame_pacer(gl_app* app);
+APIC void pacer_sleep(uint64_t ns);
+APIC int pacer_compare(const void* a, const void* b);
+APIC double pacer_percentile(const float* sorted, size_t count, double percentile);
+APIC bool pacer_retire(gl_frame_pacer* pacer, bool wait);
+
+APIC gl_frame_pacer* frame_pacer(gl_app* app) {
+    if (!app->pacer) {
+        app->pacer = (gl_frame_pacer*)calloc(1, sizeof(gl_frame_pacer));
+        if (!app->pacer) {
+            fprintf(stderr, "[%s] - Failure to allocate 'app->pacer' to heap in frame_pacer\n", _FL);
+            return NULL;
+        }
+        app->pacer->swap_interval = 1;
+        app->pacer->spin_margin_ns = 1000000ull;
+    }
+    return app->pacer;
+}
+
+APIC void pacer_sleep(uint64_t ns) {
+#ifdef _WIN32
+    Sleep((DWORD)(ns / 1000000ull));
+#else
+    struct timespec duration;
+    duration.tv_sec = (time_t)(ns / 1000000000ull);
+    duration.tv_nsec = (long)(ns % 1000000000ull);
+    nanosleep(&duration, NULL);
+#endif
+}
+
+APIC int pacer_compare(const void* a, const void* b) {
+    float x = *(const float*)a, y = *(const float*)b;
+    return (x > y) - (x < y);
+}
+
+APIC double pacer_percentile(const float* sorted, size_t count, double percentile) {
+    size_t rank = (size_t)(percentile * (double)(count - 1) + 0.5);
+    return sorted[rank < count ? rank : count - 1];
+}
+
+APIC bool pacer_retire(gl_frame_pacer* pacer, bool wait) {
+    GLuint oldest = (pacer->fence_head + FRAME_PACER_MAX_IN_FLIGHT - pacer->fence_count) % FRAME_PACER_MAX_IN_FLIGHT;
+    GLenum status = glClientWaitSync(pacer->fences[oldest], GL_SYNC_FLUSH_COMMANDS_BIT, wait ? PACER_FENCE_TIMEOUT_NS : 0);
+    if (status == GL_TIMEOUT_EXPIRED && !wait)
+        return false;
+
+    uint64_t now = glapi_NowNanoseconds();
+    if (status != GL_WAIT_FAILED && status != GL_TIMEOUT_EXPIRED) {
+        pacer->latency[pacer->latency_head] = (float)((double)(now - pacer->fence_start_ns[oldest]) / 1e6);
+        pacer->latency_head = (pacer->latency_head + 1) % FRAME_PACER_HISTORY;
+        if (pacer->latency_count < FRAME_PACER_HISTORY)
+            pacer->latency_count++;
+    }
+    glDeleteSync(pacer->fences[oldest]);
+    pacer->fences[oldest] = NULL;
+    pacer->fence_count--;
+    return true;
+}
+
+bool glapi_SetSwapInterval(gl_app* app, int interval) {
+    gl_frame_pacer* pacer = frame_pacer(app);
+    if (!pacer)
+        return false;
+    if (app->window->headless) {
+        pacer->swap_interval = interval;
+        return true;
+    }
+
+    bool applied = true;
+    if (interval < 0 && !glfwExtensionSupported("WGL_EXT_swap_control_tear") && !glfwExtensionSupported("GLX_EXT_swap_control_tear")) {
+        fprintf(stderr, "[%s] - Adaptive vsync unsupported, using interval [%d] in glapi_SetSwapInterval\n", _FL, -interval);
+        interval = -interval;
+        applied = false;
+    }
+    glfwSwapInterval(interval);
+    pacer->swap_interval = interval;
+    return applied;
+}
+
+int glapi_SwapInterval(gl_app* app) {
+    return app->pacer ? app->pacer->swap_interval : 1;
+}
+
+void glapi_SetFrameCap(gl_app* app, double fps) {
+    gl_frame_pacer* pacer = frame_pacer(app);
+    if (!pacer)
+        return;
+    pacer->target_fps = fps > 0.0 ? fps : 0.0;
+    pacer->period_ns = fps > 0.0 ? (uint64_t)(1e9 / fps) : 0;
+    pacer->deadline_ns = 0;
+}
+
+void glapi_SetMaxFramesInFlight(gl_app* app, GLuint frames) {
+    gl_frame_pacer* pacer = frame_pacer(app);
+    if (!pacer)
+        return;
+    pacer->max_in_flight = frames < FRAME_PACER_MAX_IN_FLIGHT ? frames : FRAME_PACER_MAX_IN_FLIGHT;
+}
+
+GLuint glapi_MaxFramesInFlight(gl_app* app) {
+    return app->pacer ? app->pacer->max_in_flight : 0;
+}
+
+bool glapi_SetLateLatch(gl_app* app, GLuint binding, size_t size, gl_latch_update update, void* user, gl_latch_release release) {
+    gl_frame_pacer* pacer = frame_pacer(app);
+    if (!pacer)
+        return false;
+    gl_late_latch* latch = &pacer->latch;
+    if (latch->release && latch->user)
+        latch->release(latch->user);
+    latch->update = NULL;
+    latch->release = NULL;
+    latch->user = NULL;
+    if (!update)
+        return true;
+
+    if (!size) {
+        fprintf(stderr, "[%s] - Late latch needs a non-empty buffer in glapi_SetLateLatch\n", _FL);
+        return false;
+    }
+    if (size > latch->size) {
+        void* staging = realloc(latch->staging, size);
+        if (!staging) {
+            fprintf(stderr, "[%s] - Failure to reallocate 'latch->staging' in glapi_SetLateLatch\n", _FL);
+            return false;
+        }
+        latch->staging = staging;
+    }
+    memset(latch->staging, 0, size);
+    if (!latch->buffer)
+        glGenBuffers(1, &latch->buffer);
+    glBindBuffer(GL_UNIFORM_BUFFER, latch->buffer);
+    glBufferData(GL_UNIFORM_BUFFER, (GLsizeiptr)size, NULL, GL_STREAM_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    check_gl_error("glapi_SetLateLatch");
+
+    latch->size = size;
+    latch->binding = binding;
+    latch->update = update;
+    latch->release = release;
+    latch->user = user;
+    return true;
+}
+
+bool glapi_LatchFrame(gl_app* app) {
+    gl_frame_pacer* pacer = app->pacer;
+    if (!pacer || !pacer->latch.update)
+        return false;
+
+    glapi_BeginCpuZone("glapi_LatchFrame");
+    gl_late_latch* latch = &pacer->latch;
+    if (!app->window->headless)
+        glfwPollEvents();
+    uint64_t sampled = glapi_NowNanoseconds();
+    bool updated = latch->update(app, latch->staging, latch->size, latch->user);
+    if (updated) {
+        glBindBuffer(GL_UNIFORM_BUFFER, latch->buffer);
+        glBufferData(GL_UNIFORM_BUFFER, (GLsizeiptr)latch->size, NULL, GL_STREAM_DRAW);
+        glBufferSubData(GL_UNIFORM_BUFFER, 0, (GLsizeiptr)latch->size, latch->staging);
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+        glBindBufferBase(GL_UNIFORM_BUFFER, latch->binding, latch->buffer);
+        pacer->frame_start_ns = sampled;
+    }
+    glapi_EndCpuZone();
+    return updated;
+}
+
+void glapi_StartFrame(gl_app* app) {
+    gl_frame_pacer* pacer = frame_pacer(app);
+    if (!pacer)
+        return;
+    pacer->frame_start_ns = glapi_NowNanoseconds();
+    if (pacer->latch.buffer)
+        glBindBufferBase(GL_UNIFORM_BUFFER, pacer->latch.binding, pacer->latch.buffer);
+}
+
+void glapi_PaceFrame(gl_app* app) {
+    gl_frame_pacer* pacer = app->pacer;
+    if (!pacer || !pacer->period_ns)
+        return;
+
+    uint64_t now = glapi_NowNanoseconds();
+    uint64_t target = pacer->deadline_ns + pacer->period_ns;
+    if (!pacer->deadline_ns || now >= target) {
+        if (pacer->deadline_ns)
+            pacer->missed++;
+        pacer->deadline_ns = now;
+        return;
+    }
+
+    glapi_BeginCpuZone("glapi_PaceFrame");
+    if (target - now > pacer->spin_margin_ns) {
+        uint64_t request = target - now - pacer->spin_margin_ns;
+        pacer_sleep(request);
+        uint64_t woke = glapi_NowNanoseconds();
+        uint64_t overshoot = woke > now + request ? woke - now - request : 0;
+        if (overshoot > pacer->spin_margin_ns)
+            pacer->spin_margin_ns = overshoot < PACER_MARGIN_MAX_NS ? overshoot : PACER_MARGIN_MAX_NS;
+        else
+            pacer->spin_margin_ns -= (pacer->spin_margin_ns - overshoot) / 16;
+        if (pacer->spin_margin_ns < PACER_MARGIN_MIN_NS)
+            pacer->spin_margin_ns = PACER_MARGIN_MIN_NS;
+    }
+    while (glapi_NowNanoseconds() < target)
+        ;
+    pacer->deadline_ns = target;
+    glapi_EndCpuZone();
+}
+
+void glapi_ThrottleFrame(gl_app* app) {
+    gl_frame_pacer* pacer = frame_pacer(app);
+    if (!pacer)
+        return;
+
+    if (pacer->fence_count == FRAME_PACER_MAX_IN_FLIGHT)
+        pacer_retire(pacer, true);
+    pacer->fences[pacer->fence_head] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    pacer->fence_start_ns[pacer->fence_head] = pacer->frame_start_ns ? pacer->frame_start_ns : glapi_NowNanoseconds();
+    pacer->fence_head = (pacer->fence_head + 1) % FRAME_PACER_MAX_IN_FLIGHT;
+    pacer->fence_count++;
+
+    if (pacer->max_in_flight && pacer->fence_count >= pacer->max_in_flight) {
+        glapi_BeginCpuZone("glapi_ThrottleFrame");
+        uint64_t begin = glapi_NowNanoseconds();
+        while (pacer->fence_count >= pacer->max_in_flight)
+            pacer_retire(pacer, true);
+        pacer->wait_total_ns += glapi_NowNanoseconds() - begin;
+        glapi_EndCpuZone();
+    }
+    pacer->wait_frames++;
+    while (pacer->fence_count && pacer_retire(pacer, false))
+        ;
+}
+
+void glapi_RecordFrame(gl_app* app) {
+    gl_frame_pacer* pacer = frame_pacer(app);
+    if (!pacer)
+        return;
+    uint64_t now = glapi_NowNanoseconds();
+    if (pacer->last_frame_ns) {
+        pacer->history[pacer->history_head] = (float)((double)(now - pacer->last_frame_ns) / 1e6);
+        pacer->history_head = (pacer->history_head + 1) % FRAME_PACER_HISTORY;
+        if (pacer->history_count < FRAME_PACER_HISTORY)
+            pacer->history_count++;
+    }
+    pacer->last_frame_ns = now;
+    pacer->frames++;
+}
+
+bool glapi_FrameStats(gl_app* app, gl_frame_stats* stats) {
+    memset(stats, 0, sizeof(gl_frame_stats));
+    gl_frame_pacer* pacer = app->pacer;
+    if (!pacer || !pacer->history_count)
+        return false;
+
+    float sorted[FRAME_PACER_HISTORY];
+    size_t count = pacer->history_count;
+    memcpy(sorted, pacer->history, count * sizeof(float));
+    qsort(sorted, count, sizeof(float), pacer_compare);
+
+    double total = 0.0;
+    for (size_t i = 0; i < count; i++) {
+        GLuint bucket = 0;
+        while (bucket < FRAME_PACER_BUCKETS - 1 && sorted[i] > pacer_bucket_edges[bucket])
+            bucket++;
+        stats->histogram[bucket]++;
+        total += sorted[i];
+    }
+    stats->count = count;
+    stats->frames = pacer->frames;
+    stats->missed = pacer->missed;
+    stats->mean_ms = total / (double)count;
+    stats->min_ms = sorted[0];
+    stats->max_ms = sorted[count - 1];
+    stats->p50_ms = pacer_percentile(sorted, count, 0.50);
+    stats->p95_ms = pacer_percentile(sorted, count, 0.95);
+    stats->p99_ms = pacer_percentile(sorted, count, 0.99);
+    stats->fps = stats->mean_ms > 0.0 ? 1000.0 / stats->mean_ms : 0.0;
+    stats->wait_mean_ms = pacer->wait_frames ? (double)pacer->wait_total_ns / 1e6 / (double)pacer->wait_frames : 0.0;
+    stats->in_flight = pacer->fence_count;
+
+    if (pacer->latency_count) {
+        count = pacer->latency_count;
+        memcpy(sorted, pacer->latency, count * sizeof(float));
+        qsort(sorted, count, sizeof(float), pacer_compare);
+        total = 0.0;
+        for (size_t i = 0; i < count; i++)
+            total += sorted[i];
+        stats->latency_count = count;
+        stats->latency_mean_ms = total / (double)count;
+        stats->latency_p50_ms = pacer_percentile(sorted, count, 0.50);
+        stats->latency_p99_ms = pacer_percentile(sorted, count, 0.99);
+        stats->latency_max_ms = sorted[count - 1];
+    }
+    return true;
+}
+
+const double* glapi_FrameHistogramEdges(void) {
+    return pacer_bucket_edges;
+}
+
+void glapi_ResetFrameStats(gl_app* app) {
+    gl_frame_pacer* pacer = app->pacer;
+    if (!pacer)
+        return;
+    pacer->history_count = 0;
+    pacer->history_head = 0;
+    pacer->last_frame_ns = 0;
+    pacer->missed = 0;
+    pacer->latency_count = 0;
+    pacer->latency_head = 0;
+    pacer->wait_total_ns = 0;
+    pacer->wait_frames = 0;
+}
+
+void glapi_DestroyFramePacer(gl_app* app) {
+    gl_frame_pacer* pacer = app->pacer;
+    if (!pacer)
+        return;
+    for (GLuint i = 0; i < FRAME_PACER_MAX_IN_FLIGHT; i++)
+        if (pacer->fences[i])
+            glDeleteSync(pacer->fences[i]);
+    if (pacer->latch.release && pacer->latch.user)
+        pacer->latch.release(pacer->latch.user);
+    if (pacer->latch.buffer)
+        glDeleteBuffers(1, &pacer->latch.buffer);
+    free(pacer->latch.staging);
+    free(pacer);
+    app->pacer = NULL;
+}
@@ -0,0 +1,458 @@
+#include <stdatomic.h>
+#include <time.h>
+
+#include "graphics.h"
+
+#define _FL "profiler.c"
+
+#define APIC static
+#define GPU_PROFILER_UNTRACKED 0xFFFFFFFFu
+#define CPU_PROFILER_EVENTS 16384
+#define CPU_PROFILER_MAX_DEPTH 32
+#define CPU_PROFILER_NAME_LENGTH 32
+
+typedef struct cpu_event {
+    const char* name;
+    uint64_t begin;
+    uint64_t end;
+} cpu_event;
+
+typedef struct cpu_track {
+    uint32_t tid;
+    char name[CPU_PROFILER_NAME_LENGTH];
+    cpu_event* events;
+    _Atomic uint64_t written;
+    const char* stack_names[CPU_PROFILER_MAX_DEPTH];
+    uint64_t stack_begin[CPU_PROFILER_MAX_DEPTH];
+    GLuint depth;
+    GLuint overflow;
+    uint32_t epoch;
+    uint32_t generation;
+    bool alive;
+    struct cpu_track* next;
+} cpu_track;
+
+static _Atomic bool cpu_profiler_enabled = false;
+static _Atomic uint32_t cpu_profiler_epoch = 0;
+static _Atomic uint32_t cpu_profiler_generation = 0;
+static pthread_mutex_t cpu_profiler_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t cpu_profiler_once = PTHREAD_ONCE_INIT;
+static pthread_key_t cpu_profiler_key;
+static cpu_track* cpu_tracks = NULL;
+static uint32_t cpu_track_count = 0;
+static uint64_t cpu_profiler_origin = 0;
+static char** cpu_zone_names = NULL;
+static size_t cpu_zone_name_count = 0;
+static size_t cpu_zone_name_capacity = 0;
+static _Thread_local cpu_track* cpu_thread_track = NULL;
+
+APIC gl_gpu_frame* profiler_oldest_pending(gl_gpu_profiler* profiler);
+APIC bool profiler_available(gl_gpu_frame* frame);
+APIC void profiler_resolve(gl_gpu_profiler* profiler, gl_gpu_frame* frame);
+APIC uint64_t profiler_now(void);
+APIC void profiler_thread_exit(void* track);
+APIC void profiler_create_key(void);
+APIC cpu_track* profiler_track(void);
+APIC void profiler_write_string(FILE* file, const char* text);
+APIC void profiler_sync_generation(cpu_track* track);
+APIC void profiler_push_event(cpu_track* track, const char* name, uint64_t begin, uint64_t end);
+
+APIC gl_gpu_frame* profiler_oldest_pending(gl_gpu_profiler* profiler) {
+    gl_gpu_frame* oldest = NULL;
+    for (GLuint i = 0; i < profiler->frame_count; i++) {
+        gl_gpu_frame* frame = &profiler->frames[i];
+        if (frame->pending && (!oldest || frame->frame < oldest->frame))
+            oldest = frame;
+    }
+    return oldest;
+}
+
+APIC bool profiler_available(gl_gpu_frame* frame) {
+    GLint available = 0;
+    glGetQueryObjectiv(frame->queries[1], GL_QUERY_RESULT_AVAILABLE, &available);
+    return available != 0;
+}
+
+APIC void profiler_resolve(gl_gpu_profiler* profiler, gl_gpu_frame* frame) {
+    GLuint64 begin = 0, end = 0;
+    glGetQueryObjectui64v(frame->queries[0], GL_QUERY_RESULT, &begin);
+    glGetQueryObjectui64v(frame->queries[1], GL_QUERY_RESULT, &end);
+    profiler->frame_ms = end > begin ? (double)(end - begin) / 1000000.0 : 0.0;
+
+    profiler->timing_count = 0;
+    for (GLuint i = 0; i < frame->scope_count; i++) {
+        gl_gpu_scope* scope = &frame->scopes[i];
+        if (!scope->closed)
+            continue;
+        GLuint64 scope_begin = 0, scope_end = 0;
+        glGetQueryObjectui64v(frame->queries[2 + 2 * i], GL_QUERY_RESULT, &scope_begin);
+        glGetQueryObjectui64v(frame->queries[3 + 2 * i], GL_QUERY_RESULT, &scope_end);
+        gl_gpu_timing* timing = &profiler->timings[profiler->timing_count++];
+        memcpy(timing->name, scope->name, GPU_PROFILER_NAME_LENGTH);
+        timing->depth = scope->depth;
+        timing->ms = scope_end > scope_begin ? (double)(scope_end - scope_begin) / 1000000.0 : 0.0;
+    }
+    profiler->report_frame = frame->frame;
+    frame->pending = false;
+}
+
+gl_gpu_profiler* glapi_GenGpuProfiler(gl_app* app, GLuint frames) {
+    gl_gpu_profiler* profiler = (gl_gpu_profiler*)calloc(1, sizeof(gl_gpu_profiler));
+    if (!profiler) {
+        fprintf(stderr, "[%s] - Failure to allocate 'profiler' to heap in glapi_GenGpuProfiler\n", _FL);
+        return NULL;
+    }
+    profiler->frame_count = frames ? frames : GPU_PROFILER_FRAMES;
+    profiler->frames = (gl_gpu_frame*)calloc(profiler->frame_count, sizeof(gl_gpu_frame));
+    if (!profiler->frames) {
+        fprintf(stderr, "[%s] - Failure to allocate 'profiler->frames' to heap in glapi_GenGpuProfiler\n", _FL);
+        free(profiler);
+        return NULL;
+    }
+    for (GLuint i = 0; i < profiler->frame_count; i++)
+        glGenQueries(2 * GPU_PROFILER_MAX_SCOPES + 2, profiler->frames[i].queries);
+    check_gl_error("glapi_GenGpuProfiler");
+
+    glapi_AppendOpenGLObjects(app, T{(GLuint*)profiler, GPU_PROFILER});
+    return profiler;
+}
+
+void glapi_BeginGpuFrame(gl_gpu_profiler* profiler) {
+    if (profiler->recording)
+        glapi_EndGpuFrame(profiler);
+
+    profiler->current = (GLuint)(profiler->frame_number % profiler->frame_count);
+    gl_gpu_frame* frame = &profiler->frames[profiler->current];
+    if (frame->pending) {
+        glapi_CollectGpuProfiler(profiler);
+        if (frame->pending) {
+            frame->pending = false;
+            profiler->dropped++;
+        }
+    }
+
+    frame->scope_count = 0;
+    frame->frame = profiler->frame_number;
+    profiler->depth = 0;
+    profiler->untracked = 0;
+    profiler->recording = true;
+    glQueryCounter(frame->queries[0], GL_TIMESTAMP);
+}
+
+void glapi_EndGpuFrame(gl_gpu_profiler* profiler) {
+    if (!profiler->recording)
+        return;
+    profiler->untracked = 0;
+    while (profiler->depth)
+        glapi_EndGpuScope(profiler);
+
+    gl_gpu_frame* frame = &profiler->frames[profiler->current];
+    glQueryCounter(frame->queries[1], GL_TIMESTAMP);
+    frame->pending = true;
+    profiler->recording = false;
+    profiler->frame_number++;
+    glapi_CollectGpuProfiler(profiler);
+}
+
+bool glapi_BeginGpuScope(gl_gpu_profiler* profiler, const char* name) {
+    if (!profiler->recording)
+        return false;
+    if (profiler->depth >= GPU_PROFILER_MAX_DEPTH) {
+        profiler->overflow++;
+        profiler->untracked++;
+        return false;
+    }
+
+    gl_gpu_frame* frame = &profiler->frames[profiler->current];
+    if (frame->scope_count >= GPU_PROFILER_MAX_SCOPES) {
+        profiler->overflow++;
+        profiler->stack[profiler->depth++] = GPU_PROFILER_UNTRACKED;
+        return false;
+    }
+
+    GLuint index = frame->scope_count++;
+    gl_gpu_scope* scope = &frame->scopes[index];
+    snprintf(scope->name, GPU_PROFILER_NAME_LENGTH, "%s", name ? name : "");
+    scope->depth = profiler->depth;
+    scope->closed = false;
+    profiler->stack[profiler->depth++] = index;
+    glQueryCounter(frame->queries[2 + 2 * index], GL_TIMESTAMP);
+    return true;
+}
+
+void glapi_EndGpuScope(gl_gpu_profiler* profiler) {
+    if (!profiler->recording)
+        return;
+    if (profiler->untracked) {
+        profiler->untracked--;
+        return;
+    }
+    if (!profiler->depth)
+        return;
+    GLuint index = profiler->stack[--profiler->depth];
+    if (index == GPU_PROFILER_UNTRACKED)
+        return;
+
+    gl_gpu_frame* frame = &profiler->frames[profiler->current];
+    glQueryCounter(frame->queries[3 + 2 * index], GL_TIMESTAMP);
+    frame->scopes[index].closed = true;
+}
+
+bool glapi_CollectGpuProfiler(gl_gpu_profiler* profiler) {
+    bool collected = false;
+    gl_gpu_frame* frame;
+    while ((frame = profiler_oldest_pending(profiler)) && profiler_available(frame)) {
+        profiler_resolve(profiler, frame);
+        collected = true;
+    }
+    return collected;
+}
+
+void glapi_DestroyGpuProfiler(gl_gpu_profiler* profiler) {
+    for (GLuint i = 0; i < profiler->frame_count; i++)
+        glDeleteQueries(2 * GPU_PROFILER_MAX_SCOPES + 2, profiler->frames[i].queries);
+    free(profiler->frames);
+    free(profiler);
+}
+
+APIC uint64_t profiler_now(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000ull + (uint64_t)now.tv_nsec;
+}
+
+APIC void profiler_thread_exit(void* track) {
+    pthread_mutex_lock(&cpu_profiler_lock);
+    ((cpu_track*)track)->alive = false;
+    ((cpu_track*)track)->depth = 0;
+    ((cpu_track*)track)->overflow = 0;
+    pthread_mutex_unlock(&cpu_profiler_lock);
+}
+
+APIC void profiler_create_key(void) {
+    pthread_key_create(&cpu_profiler_key, profiler_thread_exit);
+}
+
+APIC cpu_track* profiler_track(void) {
+    if (cpu_thread_track)
+        return cpu_thread_track;
+    pthread_once(&cpu_profiler_once, profiler_create_key);
+
+    pthread_mutex_lock(&cpu_profiler_lock);
+    cpu_track* track = cpu_tracks;
+    while (track && track->alive)
+        track = track->next;
+    if (!track) {
+        track = (cpu_track*)calloc(1, sizeof(cpu_track));
+        cpu_event* events = track ? (cpu_event*)malloc(CPU_PROFILER_EVENTS * sizeof(cpu_event)) : NULL;
+        if (!events) {
+            pthread_mutex_unlock(&cpu_profiler_lock);
+            fprintf(stderr, "[%s] - Failure to allocate profiler track to heap in profiler_track\n", _FL);
+            free(track);
+            return NULL;
+        }
+        track->events = events;
+        track->tid = ++cpu_track_count;
+        snprintf(track->name, CPU_PROFILER_NAME_LENGTH, "thread %u", track->tid);
+        track->next = cpu_tracks;
+        cpu_tracks = track;
+    } else {
+        snprintf(track->name, CPU_PROFILER_NAME_LENGTH, "thread %u", track->tid);
+        atomic_store_explicit(&track->written, 0, memory_order_release);
+    }
+    track->epoch = atomic_load(&cpu_profiler_epoch);
+    track->generation = atomic_load(&cpu_profiler_generation);
+    track->alive = true;
+    pthread_mutex_unlock(&cpu_profiler_lock);
+
+    pthread_setspecific(cpu_profiler_key, track);
+    cpu_thread_track = track;
+    return track;
+}
+
+APIC void profiler_write_string(FILE* file, const char* text) {
+    fputc('"', file);
+    for (const unsigned char* c = (const unsigned char*)text; *c; c++) {
+        if (*c == '"' || *c == '\\')
+            fprintf(file, "\\%c", *c);
+        else if (*c < 0x20)
+            fprintf(file, "\\u%04x", *c);
+        else
+            fputc(*c, file);
+    }
+    fputc('"', file);
+}
+
+APIC void profiler_sync_generation(cpu_track* track) {
+    uint32_t generation = atomic_load_explicit(&cpu_profiler_generation, memory_order_acquire);
+    if (track->generation != generation) {
+        track->generation = generation;
+        atomic_store_explicit(&track->written, 0, memory_order_release);
+    }
+}
+
+APIC void profiler_push_event(cpu_track* track, const char* name, uint64_t begin, uint64_t end) {
+    uint64_t written = atomic_load_explicit(&track->written, memory_order_relaxed);
+    cpu_event* event = &track->events[written % CPU_PROFILER_EVENTS];
+    event->name = name;
+    event->begin = begin;
+    event->end = end;
+    atomic_store_explicit(&track->written, written + 1, memory_order_release);
+}
+
+uint64_t glapi_NowNanoseconds(void) {
+    return profiler_now();
+}
+
+void glapi_EnableCpuProfiler(bool enabled) {
+    if (enabled && !cpu_profiler_origin)
+        cpu_profiler_origin = profiler_now();
+    if (atomic_exchange(&cpu_profiler_enabled, enabled) != enabled)
+        atomic_fetch_add(&cpu_profiler_epoch, 1);
+}
+
+bool glapi_IsCpuProfilerEnabled(void) {
+    return cpu_profiler_enabled;
+}
+
+void glapi_NameCpuThread(const char* name) {
+    cpu_track* track = profiler_track();
+    if (!track)
+        return;
+    pthread_mutex_lock(&cpu_profiler_lock);
+    snprintf(track->name, CPU_PROFILER_NAME_LENGTH, "%s", name);
+    pthread_mutex_unlock(&cpu_profiler_lock);
+}
+
+const char* glapi_InternCpuZoneName(const char* name) {
+    pthread_mutex_lock(&cpu_profiler_lock);
+    for (size_t i = 0; i < cpu_zone_name_count; i++) {
+        if (!strcmp(cpu_zone_names[i], name)) {
+            pthread_mutex_unlock(&cpu_profiler_lock);
+            return cpu_zone_names[i];
+        }
+    }
+    if (cpu_zone_name_count == cpu_zone_name_capacity) {
+        size_t capacity = cpu_zone_name_capacity ? cpu_zone_name_capacity * 2 : 64;
+        char** names = (char**)realloc(cpu_zone_names, capacity * sizeof(char*));
+        if (!names) {
+            pthread_mutex_unlock(&cpu_profiler_lock);
+            fprintf(stderr, "[%s] - Failure to reallocate zone names in glapi_InternCpuZoneName\n", _FL);
+            return NULL;
+        }
+        cpu_zone_names = names;
+        cpu_zone_name_capacity = capacity;
+    }
+    char* copy = (char*)malloc(strlen(name) + 1);
+    if (copy) {
+        strcpy(copy, name);
+        cpu_zone_names[cpu_zone_name_count++] = copy;
+    }
+    pthread_mutex_unlock(&cpu_profiler_lock);
+    return copy;
+}
+
+void glapi_BeginCpuZone(const char* name) {
+    if (!cpu_profiler_enabled)
+        return;
+    cpu_track* track = cpu_thread_track;
+    if (!track && !(track = profiler_track()))
+        return;
+    uint32_t epoch = atomic_load_explicit(&cpu_profiler_epoch, memory_order_acquire);
+    if (track->epoch != epoch) {
+        track->epoch = epoch;
+        track->depth = 0;
+        track->overflow = 0;
+        profiler_sync_generation(track);
+    }
+    if (track->depth >= CPU_PROFILER_MAX_DEPTH) {
+        track->overflow++;
+        return;
+    }
+    track->stack_names[track->depth] = name;
+    track->stack_begin[track->depth] = profiler_now();
+    track->depth++;
+}
+
+void glapi_EndCpuZone(void) {
+    if (!cpu_profiler_enabled)
+        return;
+    cpu_track* track = cpu_thread_track;
+    if (!track || track->epoch != atomic_load_explicit(&cpu_profiler_epoch, memory_order_acquire))
+        return;
+    if (track->overflow) {
+        track->overflow--;
+        return;
+    }
+    if (!track->depth)
+        return;
+    track->depth--;
+    const char* name = track->stack_names[track->depth];
+    if (!name)
+        return;
+
+    profiler_push_event(track, name, track->stack_begin[track->depth], profiler_now());
+}
+
+void glapi_RecordCpuZone(const char* name, uint64_t begin, uint64_t end) {
+    if (!cpu_profiler_enabled || !name)
+        return;
+    cpu_track* track = cpu_thread_track;
+    if (!track && !(track = profiler_track()))
+        return;
+    profiler_sync_generation(track);
+    profiler_push_event(track, name, begin, end);
+}
+
+void glapi_ResetCpuProfiler(void) {
+    pthread_mutex_lock(&cpu_profiler_lock);
+    cpu_profiler_origin = profiler_now();
+    atomic_fetch_add_explicit(&cpu_profiler_generation, 1, memory_order_release);
+    atomic_fetch_add_explicit(&cpu_profiler_epoch, 1, memory_order_release);
+    pthread_mutex_unlock(&cpu_profiler_lock);
+}
+
+bool glapi_DumpCpuProfile(const char* fpath, size_t* event_count) {
+    FILE* file = fopen(fpath, "w");
+    if (!file) {
+        fprintf(stderr, "[%s] - Failure to open '%s' in glapi_DumpCpuProfile\n", _FL, fpath);
+        return false;
+    }
+
+    size_t events = 0;
+    bool first = true;
+    fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    pthread_mutex_lock(&cpu_profiler_lock);
+    for (cpu_track* track = cpu_tracks; track; track = track->next) {
+        fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":", first ? "" : ",\n", track->tid);
+        profiler_write_string(file, track->name);
+        fprintf(file, "}}");
+        first = false;
+
+        uint64_t written = atomic_load_explicit(&track->written, memory_order_acquire);
+        uint64_t count = written < CPU_PROFILER_EVENTS ? written : CPU_PROFILER_EVENTS;
+        for (uint64_t i = written - count; i < written; i++) {
+            cpu_event event = track->events[i % CPU_PROFILER_EVENTS];
+            atomic_thread_fence(memory_order_acquire);
+            uint64_t current = atomic_load_explicit(&track->written, memory_order_relaxed);
+            if (current < i + 1 || current - i >= CPU_PROFILER_EVENTS || event.begin < cpu_profiler_origin)
+                continue;
+            fprintf(file, ",\n{\"name\":");
+            profiler_write_string(file, event.name);
+            fprintf(file, ",\"cat\":\"glib\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                track->tid, (double)(event.begin - cpu_profiler_origin) / 1000.0, (double)(event.end - event.begin) / 1000.0);
+            events++;
+        }
+    }
+    pthread_mutex_unlock(&cpu_profiler_lock);
+    fprintf(file, "\n]}\n");
+
+    bool written = !ferror(file);
+    if (fclose(file) != 0)
+        written = false;
+    if (!written)
+        fprintf(stderr, "[%s] - Failure to write '%s' in glapi_DumpCpuProfile\n", _FL, fpath);
+    if (event_count)
+        *event_count = events;
+    return written;
+}
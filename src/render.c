@@ -0,0 +1,332 @@
+#include <float.h>
+
+#include "graphics.h"
+
+#define _FL "render.c"
+
+#define APIC static
+#define GL_RENDER_QUEUE_APPEND_AMOUNT 256
+#define GL_RENDER_UNIFORMS_APPEND_AMOUNT 256
+
+#define RENDER_KEY_TRANSPARENT_BIT 63
+#define RENDER_KEY_DEPTH_BITS 24
+#define RENDER_KEY_PROGRAM_BITS 12
+#define RENDER_KEY_MATERIAL_BITS 16
+#define RENDER_KEY_VAO_BITS 11
+
+APIC bool queue_reserve_items(gl_render_queue* queue, size_t count);
+APIC bool queue_reserve_uniforms(gl_render_queue* queue, size_t count);
+APIC uint32_t render_material_hash(const gl_render_item* item);
+APIC uint64_t render_item_key(const gl_render_item* item, float depth_min, float depth_scale);
+APIC void render_radix_sort(gl_render_queue* queue);
+APIC size_t render_count_state_changes(gl_render_queue* queue, const uint32_t* order);
+APIC void render_apply_uniform(const gl_render_uniform* uniform);
+
+APIC bool queue_reserve_items(gl_render_queue* queue, size_t count) {
+    if (count <= queue->item_capacity)
+        return true;
+
+    size_t capacity = queue->item_capacity ? queue->item_capacity * 2 : GL_RENDER_QUEUE_APPEND_AMOUNT;
+    while (capacity < count)
+        capacity *= 2;
+
+    gl_render_item* items = (gl_render_item*)realloc(queue->items, capacity * sizeof(gl_render_item));
+    if (!items) {
+        fprintf(stderr, "[%s] - Failure to reallocate 'queue->items' in queue_reserve_items\n", _FL);
+        return false;
+    }
+    queue->items = items;
+
+    uint64_t* keys = (uint64_t*)realloc(queue->keys, capacity * 2 * sizeof(uint64_t));
+    uint32_t* order = (uint32_t*)realloc(queue->order, capacity * 2 * sizeof(uint32_t));
+    if (keys)
+        queue->keys = keys;
+    if (order)
+        queue->order = order;
+    if (!keys || !order) {
+        fprintf(stderr, "[%s] - Failure to reallocate sort buffers in queue_reserve_items\n", _FL);
+        return false;
+    }
+
+    queue->item_capacity = capacity;
+    return true;
+}
+
+APIC bool queue_reserve_uniforms(gl_render_queue* queue, size_t count) {
+    if (count <= queue->uniform_capacity)
+        return true;
+
+    size_t capacity = queue->uniform_capacity ? queue->uniform_capacity * 2 : GL_RENDER_UNIFORMS_APPEND_AMOUNT;
+    while (capacity < count)
+        capacity *= 2;
+
+    gl_render_uniform* uniforms = (gl_render_uniform*)realloc(queue->uniforms, capacity * sizeof(gl_render_uniform));
+    if (!uniforms) {
+        fprintf(stderr, "[%s] - Failure to reallocate 'queue->uniforms' in queue_reserve_uniforms\n", _FL);
+        return false;
+    }
+    queue->uniforms = uniforms;
+    queue->uniform_capacity = capacity;
+    return true;
+}
+
+APIC uint32_t render_material_hash(const gl_render_item* item) {
+    uint32_t hash = 2166136261u;
+    for (GLuint i = 0; i < item->texture_count; i++) {
+        hash ^= item->textures[i];
+        hash *= 16777619u;
+    }
+    return hash ^ (hash >> RENDER_KEY_MATERIAL_BITS);
+}
+
+APIC uint64_t render_item_key(const gl_render_item* item, float depth_min, float depth_scale) {
+    const uint64_t depth_max = (1ull << RENDER_KEY_DEPTH_BITS) - 1;
+    uint64_t depth = (uint64_t)((item->depth - depth_min) * depth_scale);
+    if (depth > depth_max)
+        depth = depth_max;
+
+    uint64_t program = item->shader & ((1u << RENDER_KEY_PROGRAM_BITS) - 1);
+    uint64_t material = render_material_hash(item) & ((1u << RENDER_KEY_MATERIAL_BITS) - 1);
+    uint64_t vao = item->vao & ((1u << RENDER_KEY_VAO_BITS) - 1);
+    uint64_t state = (program << (RENDER_KEY_MATERIAL_BITS + RENDER_KEY_VAO_BITS)) | (material << RENDER_KEY_VAO_BITS) | vao;
+
+    if (item->transparent)
+        return (1ull << RENDER_KEY_TRANSPARENT_BIT) | ((depth_max - depth) << (RENDER_KEY_TRANSPARENT_BIT - RENDER_KEY_DEPTH_BITS)) | state;
+    return (state << RENDER_KEY_DEPTH_BITS) | depth;
+}
+
+APIC void render_radix_sort(gl_render_queue* queue) {
+    size_t count = queue->item_count;
+    uint64_t* keys = queue->keys;
+    uint64_t* keys_out = queue->keys + queue->item_capacity;
+    uint32_t* order = queue->order;
+    uint32_t* order_out = queue->order + queue->item_capacity;
+
+    for (int shift = 0; shift < 64; shift += 8) {
+        size_t histogram[256] = {0};
+        for (size_t i = 0; i < count; i++)
+            histogram[(keys[i] >> shift) & 0xFF]++;
+        if (histogram[(keys[0] >> shift) & 0xFF] == count)
+            continue;
+
+        size_t offset = 0;
+        for (int b = 0; b < 256; b++) {
+            size_t bucket = histogram[b];
+            histogram[b] = offset;
+            offset += bucket;
+        }
+        for (size_t i = 0; i < count; i++) {
+            size_t slot = histogram[(keys[i] >> shift) & 0xFF]++;
+            keys_out[slot] = keys[i];
+            order_out[slot] = order[i];
+        }
+
+        uint64_t* swap_keys = keys;
+        keys = keys_out;
+        keys_out = swap_keys;
+        uint32_t* swap_order = order;
+        order = order_out;
+        order_out = swap_order;
+    }
+
+    if (order != queue->order)
+        memcpy(queue->order, order, count * sizeof(uint32_t));
+}
+
+APIC size_t render_count_state_changes(gl_render_queue* queue, const uint32_t* order) {
+    gl_shader program = 0;
+    gl_vao vao = 0;
+    gl_texture textures[RENDER_QUEUE_MAX_TEXTURES] = {0};
+    size_t changes = 0;
+
+    for (size_t i = 0; i < queue->item_count; i++) {
+        const gl_render_item* item = &queue->items[order ? order[i] : i];
+        if (item->shader != program) {
+            program = item->shader;
+            changes++;
+        }
+        if (item->vao != vao) {
+            vao = item->vao;
+            changes++;
+        }
+        for (GLuint unit = 0; unit < item->texture_count; unit++) {
+            if (item->textures[unit] != textures[unit]) {
+                textures[unit] = item->textures[unit];
+                changes++;
+            }
+        }
+    }
+    return changes;
+}
+
+APIC void render_apply_uniform(const gl_render_uniform* uniform) {
+    switch (uniform->type) {
+        case RENDER_UNIFORM_INT:
+            glUniform1i(uniform->location, uniform->value.i);
+            break;
+        case RENDER_UNIFORM_FLOAT:
+            glUniform1f(uniform->location, uniform->value.f[0]);
+            break;
+        case RENDER_UNIFORM_VEC2:
+            glUniform2fv(uniform->location, 1, uniform->value.f);
+            break;
+        case RENDER_UNIFORM_VEC3:
+            glUniform3fv(uniform->location, 1, uniform->value.f);
+            break;
+        case RENDER_UNIFORM_VEC4:
+            glUniform4fv(uniform->location, 1, uniform->value.f);
+            break;
+        case RENDER_UNIFORM_MAT3:
+            glUniformMatrix3fv(uniform->location, 1, GL_FALSE, uniform->value.f);
+            break;
+        case RENDER_UNIFORM_MAT4:
+            glUniformMatrix4fv(uniform->location, 1, GL_FALSE, uniform->value.f);
+            break;
+    }
+}
+
+gl_render_queue* glapi_GenRenderQueue(gl_app* app) {
+    gl_render_queue* queue = (gl_render_queue*)calloc(1, sizeof(gl_render_queue));
+    if (!queue) {
+        fprintf(stderr, "[%s] - Failure to allocate 'queue' to heap in glapi_GenRenderQueue\n", _FL);
+        return NULL;
+    }
+
+    if (!queue_reserve_items(queue, GL_RENDER_QUEUE_APPEND_AMOUNT) || !queue_reserve_uniforms(queue, GL_RENDER_UNIFORMS_APPEND_AMOUNT)) {
+        glapi_DestroyRenderQueue(queue);
+        return NULL;
+    }
+
+    glapi_AppendOpenGLObjects(app, T{(GLuint*)queue, RENDER_QUEUE});
+    return queue;
+}
+
+bool glapi_AppendRenderQueue(gl_render_queue* queue, const gl_render_item* item) {
+    if (item->texture_count > RENDER_QUEUE_MAX_TEXTURES) {
+        fprintf(stderr, "[%s] - Render item binds %u textures, limit is %d in 'glapi_AppendRenderQueue'\n", _FL, item->texture_count, RENDER_QUEUE_MAX_TEXTURES);
+        return false;
+    }
+    if (!queue_reserve_items(queue, queue->item_count + 1))
+        return false;
+
+    gl_render_item* dst = &queue->items[queue->item_count++];
+    *dst = *item;
+    dst->uniform_first = (GLuint)queue->uniform_count;
+    dst->uniform_count = 0;
+    return true;
+}
+
+bool glapi_PushRenderQueueUniform(gl_render_queue* queue, const char* varname, unsigned int type, const void* value) {
+    if (type > RENDER_UNIFORM_MAT4) {
+        fprintf(stderr, "[%s] - Unknown uniform type %u for '%s' in 'glapi_PushRenderQueueUniform'\n", _FL, type, varname);
+        return false;
+    }
+    if (!queue->item_count) {
+        fprintf(stderr, "[%s] - No render item to attach uniform '%s' to in 'glapi_PushRenderQueueUniform'\n", _FL, varname);
+        return false;
+    }
+
+    gl_render_item* item = &queue->items[queue->item_count - 1];
+    GLint location = glGetUniformLocation(item->shader, varname);
+    if (location < 0)
+        return false;
+    if (!queue_reserve_uniforms(queue, queue->uniform_count + 1))
+        return false;
+
+    static const size_t floats[] = {0, 1, 2, 3, 4, 9, 16};
+    gl_render_uniform* uniform = &queue->uniforms[queue->uniform_count++];
+    uniform->location = location;
+    uniform->type = type;
+    if (type == RENDER_UNIFORM_INT)
+        uniform->value.i = *(const GLint*)value;
+    else
+        memcpy(uniform->value.f, value, floats[type] * sizeof(GLfloat));
+    item->uniform_count++;
+    return true;
+}
+
+void glapi_ClearRenderQueue(gl_render_queue* queue) {
+    queue->item_count = 0;
+    queue->uniform_count = 0;
+}
+
+void glapi_SortRenderQueue(gl_render_queue* queue) {
+    if (!queue->item_count)
+        return;
+
+    float depth_min = FLT_MAX, depth_max = -FLT_MAX;
+    for (size_t i = 0; i < queue->item_count; i++) {
+        if (queue->items[i].depth < depth_min)
+            depth_min = queue->items[i].depth;
+        if (queue->items[i].depth > depth_max)
+            depth_max = queue->items[i].depth;
+    }
+    float depth_scale = depth_max > depth_min ? (float)((1u << RENDER_KEY_DEPTH_BITS) - 1) / (depth_max - depth_min) : 0.0f;
+
+    for (size_t i = 0; i < queue->item_count; i++) {
+        queue->keys[i] = render_item_key(&queue->items[i], depth_min, depth_scale);
+        queue->order[i] = (uint32_t)i;
+    }
+    render_radix_sort(queue);
+}
+
+void glapi_SubmitRenderQueue(gl_render_queue* queue) {
+    queue->stats.draws = queue->item_count;
+    queue->stats.state_changes = 0;
+    queue->stats.state_changes_unsorted = 0;
+    if (!queue->item_count)
+        return;
+
+    glapi_BeginCpuZone("glapi_SubmitRenderQueue");
+    glapi_SortRenderQueue(queue);
+    queue->stats.state_changes_unsorted = render_count_state_changes(queue, NULL);
+
+    gl_shader program = 0;
+    gl_vao vao = 0;
+    gl_texture textures[RENDER_QUEUE_MAX_TEXTURES] = {0};
+    size_t changes = 0;
+
+    for (size_t i = 0; i < queue->item_count; i++) {
+        const gl_render_item* item = &queue->items[queue->order[i]];
+        if (item->shader != program) {
+            glUseProgram(item->shader);
+            program = item->shader;
+            changes++;
+        }
+        if (item->vao != vao) {
+            glBindVertexArray(item->vao);
+            vao = item->vao;
+            changes++;
+        }
+        for (GLuint unit = 0; unit < item->texture_count; unit++) {
+            if (item->textures[unit] != textures[unit]) {
+                glActiveTexture(GL_TEXTURE0 + unit);
+                glBindTexture(GL_TEXTURE_2D, item->textures[unit]);
+                textures[unit] = item->textures[unit];
+                changes++;
+            }
+        }
+        for (GLuint u = 0; u < item->uniform_count; u++)
+            render_apply_uniform(&queue->uniforms[item->uniform_first + u]);
+
+        size_t index_size = item->index_type == GL_UNSIGNED_SHORT ? sizeof(GLushort) : item->index_type == GL_UNSIGNED_BYTE ? sizeof(GLubyte) : sizeof(GLuint);
+        void* offset = (void*)((size_t)item->first_index * index_size);
+        if (item->instance_count > 1)
+            glDrawElementsInstancedBaseVertex(GL_TRIANGLES, item->index_count, item->index_type, offset, item->instance_count, item->base_vertex);
+        else
+            glDrawElementsBaseVertex(GL_TRIANGLES, item->index_count, item->index_type, offset, item->base_vertex);
+    }
+    glActiveTexture(GL_TEXTURE0);
+
+    queue->stats.state_changes = changes;
+    check_gl_error("glapi_SubmitRenderQueue");
+    glapi_EndCpuZone();
+}
+
+void glapi_DestroyRenderQueue(gl_render_queue* queue) {
+    free(queue->items);
+    free(queue->uniforms);
+    free(queue->keys);
+    free(queue->order);
+    free(queue);
+}
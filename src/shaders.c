@@ -0,0 +1,659 @@
+#include "graphics.h"
+
+#define _FL "shaders.c"
+
+#define APIC static
+#define PROGRAM_BINARY_MAGIC 0x42504C47u
+#define PROGRAM_BINARY_VERSION 1
+#define SHADER_MAX_INCLUDE_DEPTH 32
+#define SHADER_TEXT_APPEND_AMOUNT 4096
+
+typedef struct program_binary_header {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t key;
+    uint32_t format;
+    uint32_t length;
+} program_binary_header;
+
+typedef struct shader_text {
+    char* data;
+    size_t length;
+    size_t capacity;
+} shader_text;
+
+typedef struct shader_preprocessor {
+    shader_text body;
+    char version[128];
+    char** once;
+    size_t once_count;
+    size_t once_capacity;
+    int file_count;
+    shader_text files;
+    uint64_t* stamp;
+} shader_preprocessor;
+
+APIC char* shader_info_log(GLuint object, bool program);
+APIC bool shader_parallel_supported(void);
+APIC void shader_submit(gl_program_build* build, GLuint* shaders, bool retrievable);
+APIC bool shader_collect(gl_program_build* build, GLuint* shaders);
+APIC uint64_t program_context_hash(void);
+APIC uint64_t program_key(gl_program_cache* cache, const char* v_source, const char* f_source);
+APIC GLuint program_load_binary(gl_program_cache* cache, const char* fpath, uint64_t key);
+APIC void program_store_binary(gl_program_cache* cache, const char* fpath, uint64_t key, GLuint program);
+APIC void program_cache_path(gl_program_cache* cache, uint64_t key, char* fpath, size_t size);
+APIC bool text_append(shader_text* text, const char* data, size_t length);
+APIC void shader_resolve_path(const char* base, const char* name, char* out, size_t size);
+APIC const char* shader_directive(const char* line, const char* end, const char* keyword);
+APIC char* shader_canonical_path(const char* fpath);
+APIC bool shader_scan_comment(const char* line, const char* end, bool comment);
+APIC bool shader_process_file(shader_preprocessor* pp, const char* fpath, int depth);
+
+APIC char* shader_info_log(GLuint object, bool program) {
+    GLint length = 0;
+    if (program)
+        glGetProgramiv(object, GL_INFO_LOG_LENGTH, &length);
+    else
+        glGetShaderiv(object, GL_INFO_LOG_LENGTH, &length);
+    if (length <= 1)
+        return NULL;
+
+    char* log = (char*)malloc((size_t)length);
+    if (!log) {
+        fprintf(stderr, "[%s] - Failure to allocate info log to heap in shader_info_log\n", _FL);
+        return NULL;
+    }
+    if (program)
+        glGetProgramInfoLog(object, length, NULL, log);
+    else
+        glGetShaderInfoLog(object, length, NULL, log);
+    return log;
+}
+
+APIC bool shader_parallel_supported(void) {
+    return GLAD_GL_KHR_parallel_shader_compile || GLAD_GL_ARB_parallel_shader_compile;
+}
+
+APIC void shader_submit(gl_program_build* build, GLuint* shaders, bool retrievable) {
+    const char* sources[2] = {build->v_source, build->f_source};
+    const GLenum types[2] = {GL_VERTEX_SHADER, GL_FRAGMENT_SHADER};
+    build->program = glCreateProgram();
+    for (int i = 0; i < 2; i++) {
+        shaders[i] = glCreateShader(types[i]);
+        glShaderSource(shaders[i], 1, &sources[i], NULL);
+        glCompileShader(shaders[i]);
+        glAttachShader(build->program, shaders[i]);
+    }
+    if (retrievable)
+        glProgramParameteri(build->program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    glLinkProgram(build->program);
+}
+
+APIC bool shader_collect(gl_program_build* build, GLuint* shaders) {
+    static const char* stages[2] = {"vertex", "fragment"};
+    int errcode;
+    glGetProgramiv(build->program, GL_LINK_STATUS, &errcode);
+    bool linked = errcode != 0;
+
+    if (!linked) {
+        size_t total = 0;
+        char* logs[3] = {NULL, NULL, NULL};
+        for (int i = 0; i < 2; i++) {
+            glGetShaderiv(shaders[i], GL_COMPILE_STATUS, &errcode);
+            if (!errcode) {
+                logs[i] = shader_info_log(shaders[i], false);
+                fprintf(stderr, "[%s] - Shader compilation error (%s): %s\n", _FL, stages[i], logs[i] ? logs[i] : "");
+                total += logs[i] ? strlen(logs[i]) + 1 : 0;
+            }
+        }
+        logs[2] = shader_info_log(build->program, true);
+        fprintf(stderr, "[%s] - Shader linking error: %s\n", _FL, logs[2] ? logs[2] : "");
+        total += logs[2] ? strlen(logs[2]) + 1 : 0;
+
+        free(build->log);
+        build->log = total ? (char*)malloc(total) : NULL;
+        if (build->log) {
+            build->log[0] = '\0';
+            for (int i = 0; i < 3; i++) {
+                if (!logs[i])
+                    continue;
+                if (build->log[0])
+                    strcat(build->log, "\n");
+                strcat(build->log, logs[i]);
+            }
+        }
+        for (int i = 0; i < 3; i++)
+            free(logs[i]);
+        glDeleteProgram(build->program);
+        build->program = 0;
+    }
+
+    for (int i = 0; i < 2; i++)
+        glDeleteShader(shaders[i]);
+    return linked;
+}
+
+APIC uint64_t program_context_hash(void) {
+    const char* strings[3] = {
+        (const char*)glGetString(GL_VENDOR),
+        (const char*)glGetString(GL_RENDERER),
+        (const char*)glGetString(GL_VERSION)
+    };
+    uint64_t hash = glapi_HashBytes(NULL, 0, PROGRAM_BINARY_VERSION);
+    for (int i = 0; i < 3; i++) {
+        const char* value = strings[i] ? strings[i] : "";
+        hash = glapi_HashBytes(value, strlen(value) + 1, hash);
+    }
+
+    GLint count = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &count);
+    if (count > 0) {
+        GLint* formats = (GLint*)malloc((size_t)count * sizeof(GLint));
+        if (formats) {
+            glGetIntegerv(GL_PROGRAM_BINARY_FORMATS, formats);
+            hash = glapi_HashBytes(formats, (size_t)count * sizeof(GLint), hash);
+            free(formats);
+        }
+    }
+    return hash;
+}
+
+APIC uint64_t program_key(gl_program_cache* cache, const char* v_source, const char* f_source) {
+    size_t v_length = strlen(v_source);
+    uint64_t hash = glapi_HashBytes(v_source, v_length, cache->context_hash);
+    hash = glapi_HashBytes(&v_length, sizeof(v_length), hash);
+    return glapi_HashBytes(f_source, strlen(f_source), hash);
+}
+
+APIC GLuint program_load_binary(gl_program_cache* cache, const char* fpath, uint64_t key) {
+    FILE* file = fopen(fpath, "rb");
+    if (!file)
+        return 0;
+
+    program_binary_header header;
+    void* binary = NULL;
+    bool valid = fread(&header, sizeof(header), 1, file) == 1 &&
+                 header.magic == PROGRAM_BINARY_MAGIC && header.version == PROGRAM_BINARY_VERSION &&
+                 header.key == key && header.length > 0;
+    if (valid) {
+        binary = malloc(header.length);
+        valid = binary && fread(binary, 1, header.length, file) == header.length;
+    }
+    fclose(file);
+
+    GLuint sprogram = 0;
+    if (valid) {
+        sprogram = glCreateProgram();
+        glProgramBinary(sprogram, (GLenum)header.format, binary, (GLsizei)header.length);
+        int errcode;
+        glGetProgramiv(sprogram, GL_LINK_STATUS, &errcode);
+        if (!errcode) {
+            glDeleteProgram(sprogram);
+            sprogram = 0;
+        }
+    }
+    free(binary);
+
+    if (!sprogram) {
+        fprintf(stderr, "[%s] - Discarding rejected program binary '%s' in program_load_binary\n", _FL, fpath);
+        cache->rejected++;
+        remove(fpath);
+        while (glGetError() != GL_NO_ERROR);
+    }
+    return sprogram;
+}
+
+APIC void program_store_binary(gl_program_cache* cache, const char* fpath, uint64_t key, GLuint program) {
+    char temp_path[1100];
+    if (snprintf(temp_path, sizeof(temp_path), "%s.tmp", fpath) >= (int)sizeof(temp_path)) {
+        fprintf(stderr, "[%s] - Path too long for '%s' in program_store_binary\n", _FL, fpath);
+        return;
+    }
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0)
+        return;
+
+    void* binary = malloc((size_t)length);
+    if (!binary) {
+        fprintf(stderr, "[%s] - Failure to allocate program binary to heap in program_store_binary\n", _FL);
+        return;
+    }
+    program_binary_header header;
+    GLenum format = 0;
+    GLsizei written = 0;
+    glGetProgramBinary(program, length, &written, &format, binary);
+    header.magic = PROGRAM_BINARY_MAGIC;
+    header.version = PROGRAM_BINARY_VERSION;
+    header.key = key;
+    header.format = (uint32_t)format;
+    header.length = (uint32_t)written;
+
+    FILE* file = fopen(temp_path, "wb");
+    bool stored = file && written > 0 &&
+                  fwrite(&header, sizeof(header), 1, file) == 1 &&
+                  fwrite(binary, 1, (size_t)written, file) == (size_t)written;
+    if (file)
+        stored = fclose(file) == 0 && stored;
+    free(binary);
+
+    if (stored) {
+        remove(fpath);
+        stored = rename(temp_path, fpath) == 0;
+    }
+    if (!stored) {
+        fprintf(stderr, "[%s] - Failure to write program binary '%s' in program_store_binary\n", _FL, fpath);
+        remove(temp_path);
+    }
+}
+
+bool glapi_SetProgramCacheDirectory(gl_app* app, const char* directory) {
+    gl_program_cache* cache = app->programs;
+    if (!cache) {
+        cache = (gl_program_cache*)calloc(1, sizeof(gl_program_cache));
+        if (!cache) {
+            fprintf(stderr, "[%s] - Failure to allocate 'app->programs' to heap in glapi_SetProgramCacheDirectory\n", _FL);
+            return false;
+        }
+        app->programs = cache;
+    }
+    free(cache->directory);
+    cache->directory = NULL;
+
+    if (!directory || !strcmp("", directory))
+        return true;
+    if (!GLAD_GL_ARB_get_program_binary) {
+        fprintf(stderr, "[%s] - Program binaries are unsupported in glapi_SetProgramCacheDirectory\n", _FL);
+        return false;
+    }
+    GLint count = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &count);
+    if (count <= 0) {
+        fprintf(stderr, "[%s] - Driver exposes no program binary formats in glapi_SetProgramCacheDirectory\n", _FL);
+        return false;
+    }
+    if (!glapi_EnsureDirectory(directory))
+        return false;
+
+    cache->directory = (char*)malloc(strlen(directory) + 1);
+    if (!cache->directory) {
+        fprintf(stderr, "[%s] - Failure to allocate cache directory to heap in glapi_SetProgramCacheDirectory\n", _FL);
+        return false;
+    }
+    strcpy(cache->directory, directory);
+    cache->context_hash = program_context_hash();
+    return true;
+}
+
+APIC void program_cache_path(gl_program_cache* cache, uint64_t key, char* fpath, size_t size) {
+    snprintf(fpath, size, "%s/%016llx.bin", cache->directory, (unsigned long long)key);
+}
+
+size_t glapi_BuildShaderPrograms(gl_app* app, gl_program_build* builds, size_t count) {
+    if (!count)
+        return 0;
+    gl_program_cache* cache = app->programs && app->programs->directory ? app->programs : NULL;
+    GLuint* shaders = (GLuint*)calloc(count * 2, sizeof(GLuint));
+    bool* pending = (bool*)calloc(count, sizeof(bool));
+    uint64_t* keys = (uint64_t*)calloc(count, sizeof(uint64_t));
+    if (!shaders || !pending || !keys) {
+        fprintf(stderr, "[%s] - Failure to allocate build state to heap in glapi_BuildShaderPrograms\n", _FL);
+        free(shaders);
+        free(pending);
+        free(keys);
+        return 0;
+    }
+
+    bool parallel = shader_parallel_supported();
+    if (GLAD_GL_KHR_parallel_shader_compile)
+        glMaxShaderCompilerThreadsKHR(0xFFFFFFFFu);
+    else if (GLAD_GL_ARB_parallel_shader_compile)
+        glMaxShaderCompilerThreadsARB(0xFFFFFFFFu);
+
+    glapi_BeginCpuZone("glapi_BuildShaderPrograms");
+    size_t built = 0, remaining = 0;
+    char fpath[1100];
+    for (size_t i = 0; i < count; i++) {
+        gl_program_build* build = &builds[i];
+        build->program = 0;
+        build->log = NULL;
+        build->cached = false;
+        if (cache) {
+            keys[i] = program_key(cache, build->v_source, build->f_source);
+            program_cache_path(cache, keys[i], fpath, sizeof(fpath));
+            build->program = program_load_binary(cache, fpath, keys[i]);
+            if (build->program) {
+                build->cached = true;
+                cache->hits++;
+                built++;
+                continue;
+            }
+            cache->misses++;
+        }
+        shader_submit(build, &shaders[i * 2], cache != NULL);
+        pending[i] = true;
+        remaining++;
+    }
+
+    bool block = false;
+    while (remaining) {
+        size_t collected = 0;
+        for (size_t i = 0; i < count; i++) {
+            if (!pending[i])
+                continue;
+            if (parallel && !block) {
+                int complete = 0;
+                glGetProgramiv(builds[i].program, GL_COMPLETION_STATUS_KHR, &complete);
+                if (!complete)
+                    continue;
+            }
+            block = false;
+            pending[i] = false;
+            remaining--;
+            collected++;
+            if (!shader_collect(&builds[i], &shaders[i * 2]))
+                continue;
+            built++;
+            if (cache) {
+                program_cache_path(cache, keys[i], fpath, sizeof(fpath));
+                program_store_binary(cache, fpath, keys[i], builds[i].program);
+            }
+        }
+        block = parallel && !collected;
+    }
+
+    free(shaders);
+    free(pending);
+    free(keys);
+    glapi_EndCpuZone();
+    return built;
+}
+
+size_t glapi_GenShaderPrograms(gl_app* app, gl_program_build* builds, size_t count) {
+    size_t built = glapi_BuildShaderPrograms(app, builds, count);
+    for (size_t i = 0; i < count; i++) {
+        if (!builds[i].program)
+            continue;
+        GLuint* handle = (GLuint*)malloc(sizeof(GLuint));
+        if (!handle) {
+            fprintf(stderr, "[%s] - Failure to allocate program handle to heap in glapi_GenShaderPrograms\n", _FL);
+            continue;
+        }
+        *handle = builds[i].program;
+        glapi_AppendOpenGLObjects(app, T{handle, SHADER_PROGRAM});
+    }
+    return built;
+}
+
+void glapi_FreeProgramBuildLogs(gl_program_build* builds, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        free(builds[i].log);
+        builds[i].log = NULL;
+    }
+}
+
+GLuint glapi_LinkShaderProgram(gl_app* app, const char* v_source, const char* f_source) {
+    gl_program_build build;
+    memset(&build, 0, sizeof(gl_program_build));
+    build.v_source = v_source;
+    build.f_source = f_source;
+    glapi_BuildShaderPrograms(app, &build, 1);
+    glapi_FreeProgramBuildLogs(&build, 1);
+    return build.program;
+}
+
+void glapi_DestroyProgramCache(gl_app* app) {
+    if (!app->programs)
+        return;
+    free(app->programs->directory);
+    free(app->programs);
+    app->programs = NULL;
+}
+
+APIC bool text_append(shader_text* text, const char* data, size_t length) {
+    if (text->length + length + 1 > text->capacity) {
+        size_t capacity = text->capacity ? text->capacity : SHADER_TEXT_APPEND_AMOUNT;
+        while (text->length + length + 1 > capacity)
+            capacity *= 2;
+        char* grown = (char*)realloc(text->data, capacity);
+        if (!grown) {
+            fprintf(stderr, "[%s] - Failure to reallocate shader text in text_append\n", _FL);
+            return false;
+        }
+        text->data = grown;
+        text->capacity = capacity;
+    }
+    memcpy(text->data + text->length, data, length);
+    text->length += length;
+    text->data[text->length] = '\0';
+    return true;
+}
+
+APIC void shader_resolve_path(const char* base, const char* name, char* out, size_t size) {
+    const char* slash = strrchr(base, '/');
+    const char* backslash = strrchr(base, '\\');
+    if (backslash > slash)
+        slash = backslash;
+    if (name[0] == '/' || !slash || (name[0] && name[1] == ':'))
+        snprintf(out, size, "%s", name);
+    else
+        snprintf(out, size, "%.*s/%s", (int)(slash - base), base, name);
+}
+
+APIC const char* shader_directive(const char* line, const char* end, const char* keyword) {
+    while (line < end && (*line == ' ' || *line == '\t'))
+        line++;
+    if (line >= end || *line != '#')
+        return NULL;
+    line++;
+    while (line < end && (*line == ' ' || *line == '\t'))
+        line++;
+    size_t length = strlen(keyword);
+    if ((size_t)(end - line) < length || strncmp(line, keyword, length))
+        return NULL;
+    line += length;
+    if (line < end && *line != ' ' && *line != '\t')
+        return NULL;
+    while (line < end && (*line == ' ' || *line == '\t'))
+        line++;
+    return line;
+}
+
+APIC char* shader_canonical_path(const char* fpath) {
+#ifdef _WIN32
+    char* path = _fullpath(NULL, fpath, 0);
+#else
+    char* path = realpath(fpath, NULL);
+#endif
+    if (!path && (path = (char*)malloc(strlen(fpath) + 1)))
+        strcpy(path, fpath);
+    return path;
+}
+
+APIC bool shader_scan_comment(const char* line, const char* end, bool comment) {
+    for (; line + 1 < end; line++) {
+        if (comment && line[0] == '*' && line[1] == '/') {
+            comment = false;
+            line++;
+        } else if (!comment && line[0] == '/' && line[1] == '*') {
+            comment = true;
+            line++;
+        } else if (!comment && line[0] == '/' && line[1] == '/') {
+            break;
+        }
+    }
+    return comment;
+}
+
+APIC bool shader_process_file(shader_preprocessor* pp, const char* fpath, int depth) {
+    if (depth > SHADER_MAX_INCLUDE_DEPTH) {
+        fprintf(stderr, "[%s] - Include depth exceeded at '%s' in shader_process_file\n", _FL, fpath);
+        return false;
+    }
+    char* canonical = shader_canonical_path(fpath);
+    if (!canonical) {
+        fprintf(stderr, "[%s] - Failure to allocate path to heap in shader_process_file\n", _FL);
+        return false;
+    }
+    for (size_t i = 0; i < pp->once_count; i++) {
+        if (!strcmp(pp->once[i], canonical)) {
+            free(canonical);
+            return true;
+        }
+    }
+
+    if (pp->stamp) {
+        if (!glapi_FileStamp(canonical, pp->stamp) || !text_append(&pp->files, canonical, strlen(canonical)) || !text_append(&pp->files, "\n", 1)) {
+            free(canonical);
+            return false;
+        }
+    }
+    char* source = (char*)glapi_ReadFile(fpath, NULL);
+    if (!source) {
+        free(canonical);
+        return false;
+    }
+    int file_index = pp->file_count++;
+    char marker[64];
+    snprintf(marker, sizeof(marker), "#line 1 %d\n", file_index);
+    bool ok = text_append(&pp->body, marker, strlen(marker));
+
+    size_t line_number = 0;
+    bool comment = false;
+    int nesting = 0, skip = 0;
+    const char* line = source;
+    while (ok && *line) {
+        const char* end = line;
+        while (*end && *end != '\n')
+            end++;
+        const char* next = *end ? end + 1 : end;
+        const char* line_end = end > line && end[-1] == '\r' ? end - 1 : end;
+        line_number++;
+
+        const char* argument;
+        bool active = !comment && !skip;
+        if (!comment) {
+            if ((argument = shader_directive(line, line_end, "if"))) {
+                nesting++;
+                if (!skip && *argument == '0' && (argument + 1 >= line_end || argument[1] == ' ' || argument[1] == '\t' || argument[1] == '/'))
+                    skip = nesting;
+            } else if (shader_directive(line, line_end, "ifdef") || shader_directive(line, line_end, "ifndef")) {
+                nesting++;
+            } else if (shader_directive(line, line_end, "else") || shader_directive(line, line_end, "elif")) {
+                if (skip == nesting)
+                    skip = 0;
+            } else if (shader_directive(line, line_end, "endif") && nesting > 0) {
+                if (skip == nesting)
+                    skip = 0;
+                nesting--;
+            }
+        }
+        comment = shader_scan_comment(line, line_end, comment);
+
+        if (!active) {
+            ok = text_append(&pp->body, line, (size_t)(line_end - line)) && text_append(&pp->body, "\n", 1);
+        } else if ((argument = shader_directive(line, line_end, "version"))) {
+            size_t length = (size_t)(line_end - line);
+            if (length >= sizeof(pp->version)) {
+                fprintf(stderr, "[%s] - Oversized '#version' at %s:%zu in shader_process_file\n", _FL, fpath, line_number);
+                ok = false;
+                break;
+            }
+            if (!pp->version[0]) {
+                memcpy(pp->version, line, length);
+                pp->version[length] = '\0';
+            } else if (strncmp(pp->version, line, length) || pp->version[length]) {
+                fprintf(stderr, "[%s] - Ignoring conflicting '%.*s' at %s:%zu in shader_process_file\n", _FL, (int)length, line, fpath, line_number);
+            }
+            ok = text_append(&pp->body, "\n", 1);
+        } else if ((argument = shader_directive(line, line_end, "include"))) {
+            char close = *argument == '<' ? '>' : '"';
+            const char* name_end = (*argument == '"' || *argument == '<') ? memchr(argument + 1, close, (size_t)(line_end - argument - 1)) : NULL;
+            if (!name_end) {
+                fprintf(stderr, "[%s] - Malformed #include at %s:%zu in shader_process_file\n", _FL, fpath, line_number);
+                ok = false;
+                break;
+            }
+            char name[512], resolved[1024];
+            snprintf(name, sizeof(name), "%.*s", (int)(name_end - argument - 1), argument + 1);
+            shader_resolve_path(fpath, name, resolved, sizeof(resolved));
+            ok = shader_process_file(pp, resolved, depth + 1);
+            if (!ok) {
+                fprintf(stderr, "[%s] - Failure to include '%s' at %s:%zu in shader_process_file\n", _FL, name, fpath, line_number);
+                break;
+            }
+            snprintf(marker, sizeof(marker), "#line %zu %d\n", line_number + 1, file_index);
+            ok = text_append(&pp->body, marker, strlen(marker));
+        } else if ((argument = shader_directive(line, line_end, "pragma")) && !strncmp(argument, "once", 4)) {
+            if (pp->once_count >= pp->once_capacity) {
+                size_t capacity = pp->once_capacity ? pp->once_capacity * 2 : 8;
+                char** once = (char**)realloc(pp->once, capacity * sizeof(char*));
+                if (!once) {
+                    fprintf(stderr, "[%s] - Failure to reallocate 'pp->once' in shader_process_file\n", _FL);
+                    ok = false;
+                    break;
+                }
+                pp->once = once;
+                pp->once_capacity = capacity;
+            }
+            char* path = (char*)malloc(strlen(canonical) + 1);
+            if (!path) {
+                fprintf(stderr, "[%s] - Failure to allocate path to heap in shader_process_file\n", _FL);
+                ok = false;
+                break;
+            }
+            strcpy(path, canonical);
+            pp->once[pp->once_count++] = path;
+            ok = text_append(&pp->body, "\n", 1);
+        } else {
+            ok = text_append(&pp->body, line, (size_t)(line_end - line)) && text_append(&pp->body, "\n", 1);
+        }
+        line = next;
+    }
+
+    free(canonical);
+    free(source);
+    return ok;
+}
+
+char* glapi_PreprocessShaderFile(const char* fpath, const char** defines, size_t define_count) {
+    return glapi_PreprocessShaderFileDepends(fpath, defines, define_count, NULL, NULL);
+}
+
+char* glapi_PreprocessShaderFileDepends(const char* fpath, const char** defines, size_t define_count, char** depends, uint64_t* stamp) {
+    glapi_BeginCpuZone("glapi_PreprocessShaderFile");
+    shader_preprocessor pp;
+    memset(&pp, 0, sizeof(shader_preprocessor));
+    pp.stamp = depends ? stamp : NULL;
+    bool ok = shader_process_file(&pp, fpath, 0);
+
+    shader_text text;
+    memset(&text, 0, sizeof(shader_text));
+    if (ok && pp.version[0])
+        ok = text_append(&text, pp.version, strlen(pp.version)) && text_append(&text, "\n", 1);
+    for (size_t i = 0; ok && i < define_count; i++) {
+        const char* value = strchr(defines[i], '=');
+        size_t name_length = value ? (size_t)(value - defines[i]) : strlen(defines[i]);
+        ok = text_append(&text, "#define ", 8) && text_append(&text, defines[i], name_length);
+        if (ok && value)
+            ok = text_append(&text, " ", 1) && text_append(&text, value + 1, strlen(value + 1));
+        ok = ok && text_append(&text, "\n", 1);
+    }
+    if (ok && pp.body.length)
+        ok = text_append(&text, pp.body.data, pp.body.length);
+
+    for (size_t i = 0; i < pp.once_count; i++)
+        free(pp.once[i]);
+    free(pp.once);
+    free(pp.body.data);
+    glapi_EndCpuZone();
+    if (!ok) {
+        fprintf(stderr, "[%s] - Failure to preprocess shader '%s' in glapi_PreprocessShaderFile\n", _FL, fpath);
+        free(pp.files.data);
+        free(text.data);
+        return NULL;
+    }
+    if (depends)
+        *depends = pp.files.data;
+    return text.data;
+}
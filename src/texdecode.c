@@ -0,0 +1,635 @@
+#include "graphics.h"
+
+#define _FL "texdecode.c"
+
+#define APIC static
+
+typedef void (*block_decoder)(const unsigned char* block, unsigned char* texels);
+
+typedef struct bc7_mode {
+    int subsets;
+    int partition_bits;
+    int rotation_bits;
+    int index_selection_bits;
+    int color_bits;
+    int alpha_bits;
+    int endpoint_pbits;
+    int shared_pbits;
+    int index_bits;
+    int index2_bits;
+} bc7_mode;
+
+static const bc7_mode bc7_modes[8] = {
+    {3, 4, 0, 0, 4, 0, 1, 0, 3, 0},
+    {2, 6, 0, 0, 6, 0, 0, 1, 3, 0},
+    {3, 6, 0, 0, 5, 0, 0, 0, 2, 0},
+    {2, 6, 0, 0, 7, 0, 1, 0, 2, 0},
+    {1, 0, 2, 1, 5, 6, 0, 0, 2, 3},
+    {1, 0, 2, 0, 7, 8, 0, 0, 2, 2},
+    {1, 0, 0, 0, 7, 7, 1, 0, 4, 0},
+    {2, 6, 0, 0, 5, 5, 1, 0, 2, 0}
+};
+
+const uint16_t bc7_partitions2[64] = {
+    0xCCCC, 0x8888, 0xEEEE, 0xECC8, 0xC880, 0xFEEC, 0xFEC8, 0xEC80,
+    0xC800, 0xFFEC, 0xFE80, 0xE800, 0xFFE8, 0xFF00, 0xFFF0, 0xF000,
+    0xF710, 0x008E, 0x7100, 0x08CE, 0x008C, 0x7310, 0x3100, 0x8CCE,
+    0x088C, 0x3110, 0x6666, 0x366C, 0x17E8, 0x0FF0, 0x718E, 0x399C,
+    0xAAAA, 0xF0F0, 0x5A5A, 0x33CC, 0x3C3C, 0x55AA, 0x9696, 0xA55A,
+    0x73CE, 0x13C8, 0x324C, 0x3BDC, 0x6996, 0xC33C, 0x9966, 0x0660,
+    0x0272, 0x04E4, 0x4E40, 0x2720, 0xC936, 0x936C, 0x39C6, 0x639C,
+    0x9336, 0x9CC6, 0x817E, 0xE718, 0xCCF0, 0x0FCC, 0x7744, 0xEE22
+};
+
+static const uint32_t bc7_partitions3[64] = {
+    0xAA685050, 0x6A5A5040, 0x5A5A4200, 0x5450A0A8, 0xA5A50000, 0xA0A05050, 0x5555A0A0, 0x5A5A5050,
+    0xAA550000, 0xAA555500, 0xAAAA5500, 0x90909090, 0x94949494, 0xA4A4A4A4, 0xA9A59450, 0x2A0A4250,
+    0xA5945040, 0x0A425054, 0xA5A5A500, 0x55A0A0A0, 0xA8A85454, 0x6A6A4040, 0xA4A45000, 0x1A1A0500,
+    0x0050A4A4, 0xAAA59090, 0x14696914, 0x69691400, 0xA08585A0, 0xAA821414, 0x50A4A450, 0x6A5A0200,
+    0xA9A58000, 0x5090A0A8, 0xA8A09050, 0x24242424, 0x00AA5500, 0x24924924, 0x24499224, 0x50A50A50,
+    0x500AA550, 0xAAAA4444, 0x66660000, 0xA5A0A5A0, 0x50A050A0, 0x69286928, 0x44AAAA44, 0x66666600,
+    0xAA444444, 0x54A854A8, 0x95809580, 0x96969600, 0xA85454A8, 0x80959580, 0xAA141414, 0x96960000,
+    0xAAAA1414, 0xA05050A0, 0xA0A5A5A0, 0x96000000, 0x40804080, 0xA9A8A9A8, 0xAAAAAA44, 0x2A4A5254
+};
+
+const unsigned char bc7_anchor2[64] = {
+    15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15,
+    15,  2,  8,  2,  2,  8,  8, 15,  2,  8,  2,  2,  8,  8,  2,  2,
+    15, 15,  6,  8,  2,  8, 15, 15,  2,  8,  2,  2,  2, 15, 15,  6,
+     6,  2,  6,  8, 15, 15,  2,  2, 15, 15, 15, 15, 15,  2,  2, 15
+};
+
+static const unsigned char bc7_anchor3_second[64] = {
+     3,  3, 15, 15,  8,  3, 15, 15,  8,  8,  6,  6,  6,  5,  3,  3,
+     3,  3,  8, 15,  3,  3,  6, 10,  5,  8,  8,  6,  8,  5, 15, 15,
+     8, 15,  3,  5,  6, 10,  8, 15, 15,  3, 15,  5, 15, 15, 15, 15,
+     3, 15,  5,  5,  5,  8,  5, 10,  5, 10,  8, 13, 15, 12,  3,  3
+};
+
+static const unsigned char bc7_anchor3_third[64] = {
+    15,  8,  8,  3, 15, 15,  3,  8, 15, 15, 15, 15, 15, 15, 15,  8,
+    15,  8, 15,  3, 15,  8, 15,  8,  3, 15,  6, 10, 15, 15, 10,  8,
+    15,  3, 15, 10, 10,  8,  9, 10,  6, 15,  8, 15,  3,  6,  6,  8,
+    15,  3, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15,  3, 15, 15,  8
+};
+
+static const unsigned char bc7_weights2[4] = {0, 21, 43, 64};
+static const unsigned char bc7_weights3[8] = {0, 9, 18, 27, 37, 46, 55, 64};
+static const unsigned char bc7_weights4[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+static const int etc1_modifiers[8][2] = {
+    {2, 8}, {5, 17}, {9, 29}, {13, 42}, {18, 60}, {24, 80}, {33, 106}, {47, 183}
+};
+
+static const int etc2_distances[8] = {3, 6, 11, 16, 23, 32, 41, 64};
+
+static const int eac_modifiers[16][8] = {
+    {-3, -6, -9, -15, 2, 5, 8, 14},
+    {-3, -7, -10, -13, 2, 6, 9, 12},
+    {-2, -5, -8, -13, 1, 4, 7, 12},
+    {-2, -4, -6, -13, 1, 3, 5, 12},
+    {-3, -6, -8, -12, 2, 5, 7, 11},
+    {-3, -7, -9, -11, 2, 6, 8, 10},
+    {-4, -7, -8, -11, 3, 6, 7, 10},
+    {-3, -5, -8, -11, 2, 4, 7, 10},
+    {-2, -6, -8, -10, 1, 5, 7, 9},
+    {-2, -5, -8, -10, 1, 4, 7, 9},
+    {-2, -4, -8, -10, 1, 3, 7, 9},
+    {-2, -5, -7, -10, 1, 4, 6, 9},
+    {-3, -4, -7, -10, 2, 3, 6, 9},
+    {-1, -2, -3, -10, 0, 1, 2, 9},
+    {-4, -6, -8, -9, 3, 5, 7, 8},
+    {-3, -5, -7, -9, 2, 4, 6, 8}
+};
+
+APIC unsigned char clamp_byte(int value);
+APIC void decode_bc1_colors(const unsigned char* block, unsigned char* texels, bool force_four_colors, bool transparent_black);
+APIC void decode_bc1_rgb(const unsigned char* block, unsigned char* texels);
+APIC void decode_bc1_rgba(const unsigned char* block, unsigned char* texels);
+APIC void decode_bc2(const unsigned char* block, unsigned char* texels);
+APIC void decode_bc3(const unsigned char* block, unsigned char* texels);
+APIC void decode_bc4_channel(const unsigned char* block, unsigned char* texels, int channel);
+APIC void decode_bc4(const unsigned char* block, unsigned char* texels);
+APIC void decode_bc5(const unsigned char* block, unsigned char* texels);
+APIC uint32_t bc7_read_bits(const unsigned char* block, int* offset, int count);
+APIC void decode_bc7(const unsigned char* block, unsigned char* texels);
+APIC uint64_t read_be64(const unsigned char* bytes);
+APIC void decode_etc2_colors(uint64_t bits, unsigned char* texels, bool punchthrough);
+APIC void decode_etc2_rgb(const unsigned char* block, unsigned char* texels);
+APIC void decode_etc2_rgba1(const unsigned char* block, unsigned char* texels);
+APIC int decode_eac_value(uint64_t bits, int texel, bool eleven_bit);
+APIC void decode_etc2_rgba(const unsigned char* block, unsigned char* texels);
+APIC void decode_eac_r11(const unsigned char* block, unsigned char* texels);
+APIC void decode_eac_rg11(const unsigned char* block, unsigned char* texels);
+APIC block_decoder decoder_for_format(GLenum format, size_t* block_bytes);
+
+APIC unsigned char clamp_byte(int value) {
+    return (unsigned char)(value < 0 ? 0 : (value > 255 ? 255 : value));
+}
+
+APIC void decode_bc1_colors(const unsigned char* block, unsigned char* texels, bool force_four_colors, bool transparent_black) {
+    uint16_t c0 = (uint16_t)(block[0] | (block[1] << 8));
+    uint16_t c1 = (uint16_t)(block[2] | (block[3] << 8));
+    uint32_t indices = (uint32_t)block[4] | ((uint32_t)block[5] << 8) | ((uint32_t)block[6] << 16) | ((uint32_t)block[7] << 24);
+
+    unsigned char palette[4][4];
+    uint16_t colors[2] = {c0, c1};
+    for (int i = 0; i < 2; i++) {
+        int r = (colors[i] >> 11) & 0x1F;
+        int g = (colors[i] >> 5) & 0x3F;
+        int b = colors[i] & 0x1F;
+        palette[i][0] = (unsigned char)((r << 3) | (r >> 2));
+        palette[i][1] = (unsigned char)((g << 2) | (g >> 4));
+        palette[i][2] = (unsigned char)((b << 3) | (b >> 2));
+        palette[i][3] = 255;
+    }
+
+    if (c0 > c1 || force_four_colors) {
+        for (int c = 0; c < 3; c++) {
+            palette[2][c] = (unsigned char)((2 * palette[0][c] + palette[1][c] + 1) / 3);
+            palette[3][c] = (unsigned char)((palette[0][c] + 2 * palette[1][c] + 1) / 3);
+        }
+        palette[2][3] = 255;
+        palette[3][3] = 255;
+    } else {
+        for (int c = 0; c < 3; c++) {
+            palette[2][c] = (unsigned char)((palette[0][c] + palette[1][c] + 1) / 2);
+            palette[3][c] = 0;
+        }
+        palette[2][3] = 255;
+        palette[3][3] = transparent_black ? 0 : 255;
+    }
+
+    for (int i = 0; i < 16; i++)
+        memcpy(texels + i * 4, palette[(indices >> (i * 2)) & 0x3], 4);
+}
+
+APIC void decode_bc1_rgb(const unsigned char* block, unsigned char* texels) {
+    decode_bc1_colors(block, texels, false, false);
+}
+
+APIC void decode_bc1_rgba(const unsigned char* block, unsigned char* texels) {
+    decode_bc1_colors(block, texels, false, true);
+}
+
+APIC void decode_bc2(const unsigned char* block, unsigned char* texels) {
+    decode_bc1_colors(block + 8, texels, true, false);
+    for (int i = 0; i < 16; i++) {
+        int alpha = (block[i / 2] >> ((i & 1) * 4)) & 0xF;
+        texels[i * 4 + 3] = (unsigned char)(alpha * 17);
+    }
+}
+
+APIC void decode_bc3(const unsigned char* block, unsigned char* texels) {
+    decode_bc1_colors(block + 8, texels, true, false);
+    decode_bc4_channel(block, texels, 3);
+}
+
+APIC void decode_bc4_channel(const unsigned char* block, unsigned char* texels, int channel) {
+    int r0 = block[0];
+    int r1 = block[1];
+    unsigned char values[8];
+    values[0] = (unsigned char)r0;
+    values[1] = (unsigned char)r1;
+    if (r0 > r1) {
+        for (int i = 1; i < 7; i++)
+            values[i + 1] = (unsigned char)(((7 - i) * r0 + i * r1 + 3) / 7);
+    } else {
+        for (int i = 1; i < 5; i++)
+            values[i + 1] = (unsigned char)(((5 - i) * r0 + i * r1 + 2) / 5);
+        values[6] = 0;
+        values[7] = 255;
+    }
+
+    uint64_t indices = 0;
+    for (int i = 0; i < 6; i++)
+        indices |= (uint64_t)block[2 + i] << (i * 8);
+    for (int i = 0; i < 16; i++)
+        texels[i * 4 + channel] = values[(indices >> (i * 3)) & 0x7];
+}
+
+APIC void decode_bc4(const unsigned char* block, unsigned char* texels) {
+    memset(texels, 0, 64);
+    decode_bc4_channel(block, texels, 0);
+    for (int i = 0; i < 16; i++)
+        texels[i * 4 + 3] = 255;
+}
+
+APIC void decode_bc5(const unsigned char* block, unsigned char* texels) {
+    memset(texels, 0, 64);
+    decode_bc4_channel(block, texels, 0);
+    decode_bc4_channel(block + 8, texels, 1);
+    for (int i = 0; i < 16; i++)
+        texels[i * 4 + 3] = 255;
+}
+
+APIC uint32_t bc7_read_bits(const unsigned char* block, int* offset, int count) {
+    uint32_t value = 0;
+    for (int i = 0; i < count; i++) {
+        int bit = *offset + i;
+        value |= (uint32_t)((block[bit >> 3] >> (bit & 7)) & 1) << i;
+    }
+    *offset += count;
+    return value;
+}
+
+APIC void decode_bc7(const unsigned char* block, unsigned char* texels) {
+    int mode_index = 0;
+    while (mode_index < 8 && !(block[0] & (1 << mode_index)))
+        mode_index++;
+    if (mode_index == 8) {
+        memset(texels, 0, 64);
+        return;
+    }
+
+    const bc7_mode* mode = &bc7_modes[mode_index];
+    int offset = mode_index + 1;
+    int partition = (int)bc7_read_bits(block, &offset, mode->partition_bits);
+    int rotation = (int)bc7_read_bits(block, &offset, mode->rotation_bits);
+    int index_selection = (int)bc7_read_bits(block, &offset, mode->index_selection_bits);
+
+    int endpoints[3][2][4];
+    for (int c = 0; c < 3; c++)
+        for (int s = 0; s < mode->subsets; s++)
+            for (int e = 0; e < 2; e++)
+                endpoints[s][e][c] = (int)bc7_read_bits(block, &offset, mode->color_bits);
+    for (int s = 0; s < mode->subsets; s++)
+        for (int e = 0; e < 2; e++)
+            endpoints[s][e][3] = mode->alpha_bits ? (int)bc7_read_bits(block, &offset, mode->alpha_bits) : 255;
+
+    int color_precision = mode->color_bits;
+    int alpha_precision = mode->alpha_bits;
+    if (mode->endpoint_pbits || mode->shared_pbits) {
+        for (int s = 0; s < mode->subsets; s++) {
+            int shared = mode->shared_pbits ? (int)bc7_read_bits(block, &offset, 1) : 0;
+            for (int e = 0; e < 2; e++) {
+                int pbit = mode->endpoint_pbits ? (int)bc7_read_bits(block, &offset, 1) : shared;
+                for (int c = 0; c < 3; c++)
+                    endpoints[s][e][c] = (endpoints[s][e][c] << 1) | pbit;
+                if (mode->alpha_bits)
+                    endpoints[s][e][3] = (endpoints[s][e][3] << 1) | pbit;
+            }
+        }
+        color_precision++;
+        if (mode->alpha_bits)
+            alpha_precision++;
+    }
+
+    for (int s = 0; s < mode->subsets; s++) {
+        for (int e = 0; e < 2; e++) {
+            for (int c = 0; c < 3; c++) {
+                int v = endpoints[s][e][c] << (8 - color_precision);
+                endpoints[s][e][c] = v | (v >> color_precision);
+            }
+            if (mode->alpha_bits) {
+                int v = endpoints[s][e][3] << (8 - alpha_precision);
+                endpoints[s][e][3] = v | (v >> alpha_precision);
+            }
+        }
+    }
+
+    int subset_of[16];
+    bool anchor[16];
+    memset(anchor, 0, sizeof(anchor));
+    anchor[0] = true;
+    for (int i = 0; i < 16; i++) {
+        if (mode->subsets == 2)
+            subset_of[i] = (bc7_partitions2[partition] >> i) & 1;
+        else if (mode->subsets == 3)
+            subset_of[i] = (int)((bc7_partitions3[partition] >> (i * 2)) & 0x3);
+        else
+            subset_of[i] = 0;
+    }
+    if (mode->subsets == 2) {
+        anchor[bc7_anchor2[partition]] = true;
+    } else if (mode->subsets == 3) {
+        anchor[bc7_anchor3_second[partition]] = true;
+        anchor[bc7_anchor3_third[partition]] = true;
+    }
+
+    int indices[16], indices2[16];
+    for (int i = 0; i < 16; i++)
+        indices[i] = (int)bc7_read_bits(block, &offset, mode->index_bits - (anchor[i] ? 1 : 0));
+    for (int i = 0; i < 16; i++)
+        indices2[i] = mode->index2_bits ? (int)bc7_read_bits(block, &offset, mode->index2_bits - (i == 0 ? 1 : 0)) : 0;
+
+    for (int i = 0; i < 16; i++) {
+        int* e0 = endpoints[subset_of[i]][0];
+        int* e1 = endpoints[subset_of[i]][1];
+        int color_index = indices[i], color_bits = mode->index_bits;
+        int alpha_index = indices[i], alpha_bits = mode->index_bits;
+        if (mode->index2_bits) {
+            if (index_selection) {
+                color_index = indices2[i];
+                color_bits = mode->index2_bits;
+            } else {
+                alpha_index = indices2[i];
+                alpha_bits = mode->index2_bits;
+            }
+        }
+
+        const unsigned char* color_weights = color_bits == 2 ? bc7_weights2 : (color_bits == 3 ? bc7_weights3 : bc7_weights4);
+        const unsigned char* alpha_weights = alpha_bits == 2 ? bc7_weights2 : (alpha_bits == 3 ? bc7_weights3 : bc7_weights4);
+        int cw = color_weights[color_index];
+        int aw = alpha_weights[alpha_index];
+
+        unsigned char* out = texels + i * 4;
+        for (int c = 0; c < 3; c++)
+            out[c] = (unsigned char)(((64 - cw) * e0[c] + cw * e1[c] + 32) >> 6);
+        out[3] = (unsigned char)(((64 - aw) * e0[3] + aw * e1[3] + 32) >> 6);
+
+        if (rotation) {
+            unsigned char swap = out[3];
+            out[3] = out[rotation - 1];
+            out[rotation - 1] = swap;
+        }
+    }
+}
+
+APIC uint64_t read_be64(const unsigned char* bytes) {
+    uint64_t value = 0;
+    for (int i = 0; i < 8; i++)
+        value = (value << 8) | bytes[i];
+    return value;
+}
+
+APIC void decode_etc2_colors(uint64_t bits, unsigned char* texels, bool punchthrough) {
+    bool differential = punchthrough || ((bits >> 33) & 1);
+    bool opaque = !punchthrough || ((bits >> 33) & 1);
+    bool flip = (bits >> 32) & 1;
+
+    int base[2][3];
+    if (!differential) {
+        for (int c = 0; c < 3; c++) {
+            int v0 = (int)((bits >> (60 - c * 8)) & 0xF);
+            int v1 = (int)((bits >> (56 - c * 8)) & 0xF);
+            base[0][c] = (v0 << 4) | v0;
+            base[1][c] = (v1 << 4) | v1;
+        }
+    } else {
+        int values[3], deltas[3];
+        for (int c = 0; c < 3; c++) {
+            values[c] = (int)((bits >> (59 - c * 8)) & 0x1F);
+            deltas[c] = (int)((bits >> (56 - c * 8)) & 0x7);
+            if (deltas[c] >= 4)
+                deltas[c] -= 8;
+        }
+
+        int r = values[0] + deltas[0];
+        int g = values[1] + deltas[1];
+        int b = values[2] + deltas[2];
+        if (r < 0 || r > 31 || g < 0 || g > 31) {
+            int c1[3], c2[3], paint[4][3];
+            int distance;
+            if (r < 0 || r > 31) {
+                c1[0] = (int)((((bits >> 59) & 0x3) << 2) | ((bits >> 56) & 0x3));
+                c1[1] = (int)((bits >> 52) & 0xF);
+                c1[2] = (int)((bits >> 48) & 0xF);
+                c2[0] = (int)((bits >> 44) & 0xF);
+                c2[1] = (int)((bits >> 40) & 0xF);
+                c2[2] = (int)((bits >> 36) & 0xF);
+                for (int c = 0; c < 3; c++) {
+                    c1[c] = (c1[c] << 4) | c1[c];
+                    c2[c] = (c2[c] << 4) | c2[c];
+                }
+                distance = etc2_distances[(((bits >> 34) & 0x3) << 1) | ((bits >> 32) & 0x1)];
+                for (int c = 0; c < 3; c++) {
+                    paint[0][c] = c1[c];
+                    paint[1][c] = clamp_byte(c2[c] + distance);
+                    paint[2][c] = c2[c];
+                    paint[3][c] = clamp_byte(c2[c] - distance);
+                }
+            } else {
+                c1[0] = (int)((bits >> 59) & 0xF);
+                c1[1] = (int)((((bits >> 56) & 0x7) << 1) | ((bits >> 52) & 0x1));
+                c1[2] = (int)((((bits >> 51) & 0x1) << 3) | ((bits >> 47) & 0x7));
+                c2[0] = (int)((bits >> 43) & 0xF);
+                c2[1] = (int)((bits >> 39) & 0xF);
+                c2[2] = (int)((bits >> 35) & 0xF);
+                int order = ((c1[0] << 8) | (c1[1] << 4) | c1[2]) >= ((c2[0] << 8) | (c2[1] << 4) | c2[2]);
+                for (int c = 0; c < 3; c++) {
+                    c1[c] = (c1[c] << 4) | c1[c];
+                    c2[c] = (c2[c] << 4) | c2[c];
+                }
+                distance = etc2_distances[(((bits >> 34) & 0x1) << 2) | (((bits >> 32) & 0x1) << 1) | order];
+                for (int c = 0; c < 3; c++) {
+                    paint[0][c] = clamp_byte(c1[c] + distance);
+                    paint[1][c] = clamp_byte(c1[c] - distance);
+                    paint[2][c] = clamp_byte(c2[c] + distance);
+                    paint[3][c] = clamp_byte(c2[c] - distance);
+                }
+            }
+
+            for (int x = 0; x < 4; x++) {
+                for (int y = 0; y < 4; y++) {
+                    int k = x * 4 + y;
+                    int index = (int)((((bits >> (16 + k)) & 1) << 1) | ((bits >> k) & 1));
+                    unsigned char* out = texels + (y * 4 + x) * 4;
+                    if (!opaque && index == 2) {
+                        memset(out, 0, 4);
+                        continue;
+                    }
+                    out[0] = (unsigned char)paint[index][0];
+                    out[1] = (unsigned char)paint[index][1];
+                    out[2] = (unsigned char)paint[index][2];
+                    out[3] = 255;
+                }
+            }
+            return;
+        }
+
+        if (b < 0 || b > 31) {
+            int ro = (int)((bits >> 57) & 0x3F);
+            int go = (int)((((bits >> 56) & 0x1) << 6) | ((bits >> 49) & 0x3F));
+            int bo = (int)((((bits >> 48) & 0x1) << 5) | (((bits >> 43) & 0x3) << 3) | ((bits >> 39) & 0x7));
+            int rh = (int)((((bits >> 34) & 0x1F) << 1) | ((bits >> 32) & 0x1));
+            int gh = (int)((bits >> 25) & 0x7F);
+            int bh = (int)((bits >> 19) & 0x3F);
+            int rv = (int)((bits >> 13) & 0x3F);
+            int gv = (int)((bits >> 6) & 0x7F);
+            int bv = (int)(bits & 0x3F);
+            int o[3] = {(ro << 2) | (ro >> 4), (go << 1) | (go >> 6), (bo << 2) | (bo >> 4)};
+            int h[3] = {(rh << 2) | (rh >> 4), (gh << 1) | (gh >> 6), (bh << 2) | (bh >> 4)};
+            int v[3] = {(rv << 2) | (rv >> 4), (gv << 1) | (gv >> 6), (bv << 2) | (bv >> 4)};
+            for (int y = 0; y < 4; y++) {
+                for (int x = 0; x < 4; x++) {
+                    unsigned char* out = texels + (y * 4 + x) * 4;
+                    for (int c = 0; c < 3; c++)
+                        out[c] = clamp_byte((x * (h[c] - o[c]) + y * (v[c] - o[c]) + 4 * o[c] + 2) >> 2);
+                    out[3] = 255;
+                }
+            }
+            return;
+        }
+
+        int deltas_applied[3] = {r, g, b};
+        for (int c = 0; c < 3; c++) {
+            base[0][c] = (values[c] << 3) | (values[c] >> 2);
+            base[1][c] = (deltas_applied[c] << 3) | (deltas_applied[c] >> 2);
+        }
+    }
+
+    int tables[2] = {(int)((bits >> 37) & 0x7), (int)((bits >> 34) & 0x7)};
+    for (int x = 0; x < 4; x++) {
+        for (int y = 0; y < 4; y++) {
+            int k = x * 4 + y;
+            int subblock = flip ? (y >= 2) : (x >= 2);
+            int msb = (int)((bits >> (16 + k)) & 1);
+            int lsb = (int)((bits >> k) & 1);
+            unsigned char* out = texels + (y * 4 + x) * 4;
+
+            int modifier = etc1_modifiers[tables[subblock]][lsb];
+            if (msb)
+                modifier = -modifier;
+            if (!opaque) {
+                if (msb && !lsb) {
+                    memset(out, 0, 4);
+                    continue;
+                }
+                if (!lsb)
+                    modifier = 0;
+            }
+            for (int c = 0; c < 3; c++)
+                out[c] = clamp_byte(base[subblock][c] + modifier);
+            out[3] = 255;
+        }
+    }
+}
+
+APIC void decode_etc2_rgb(const unsigned char* block, unsigned char* texels) {
+    decode_etc2_colors(read_be64(block), texels, false);
+}
+
+APIC void decode_etc2_rgba1(const unsigned char* block, unsigned char* texels) {
+    decode_etc2_colors(read_be64(block), texels, true);
+}
+
+APIC int decode_eac_value(uint64_t bits, int texel, bool eleven_bit) {
+    int base = (int)((bits >> 56) & 0xFF);
+    int multiplier = (int)((bits >> 52) & 0xF);
+    int table = (int)((bits >> 48) & 0xF);
+    int index = (int)((bits >> (45 - texel * 3)) & 0x7);
+    int modifier = eac_modifiers[table][index];
+
+    if (!eleven_bit)
+        return clamp_byte(base + modifier * multiplier);
+
+    int value = base * 8 + 4 + (multiplier ? modifier * multiplier * 8 : modifier);
+    value = value < 0 ? 0 : (value > 2047 ? 2047 : value);
+    return (value * 255 + 1023) / 2047;
+}
+
+APIC void decode_etc2_rgba(const unsigned char* block, unsigned char* texels) {
+    uint64_t alpha = read_be64(block);
+    decode_etc2_colors(read_be64(block + 8), texels, false);
+    for (int x = 0; x < 4; x++)
+        for (int y = 0; y < 4; y++)
+            texels[(y * 4 + x) * 4 + 3] = (unsigned char)decode_eac_value(alpha, x * 4 + y, false);
+}
+
+APIC void decode_eac_r11(const unsigned char* block, unsigned char* texels) {
+    uint64_t red = read_be64(block);
+    memset(texels, 0, 64);
+    for (int x = 0; x < 4; x++) {
+        for (int y = 0; y < 4; y++) {
+            unsigned char* out = texels + (y * 4 + x) * 4;
+            out[0] = (unsigned char)decode_eac_value(red, x * 4 + y, true);
+            out[3] = 255;
+        }
+    }
+}
+
+APIC void decode_eac_rg11(const unsigned char* block, unsigned char* texels) {
+    uint64_t red = read_be64(block);
+    uint64_t green = read_be64(block + 8);
+    memset(texels, 0, 64);
+    for (int x = 0; x < 4; x++) {
+        for (int y = 0; y < 4; y++) {
+            unsigned char* out = texels + (y * 4 + x) * 4;
+            out[0] = (unsigned char)decode_eac_value(red, x * 4 + y, true);
+            out[1] = (unsigned char)decode_eac_value(green, x * 4 + y, true);
+            out[3] = 255;
+        }
+    }
+}
+
+APIC block_decoder decoder_for_format(GLenum format, size_t* block_bytes) {
+    switch (format) {
+        case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+        case GL_COMPRESSED_SRGB_S3TC_DXT1_EXT:
+            *block_bytes = 8;
+            return decode_bc1_rgb;
+        case GL_COMPRESSED_RGBA_S3TC_DXT1_EXT:
+        case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT:
+            *block_bytes = 8;
+            return decode_bc1_rgba;
+        case GL_COMPRESSED_RGBA_S3TC_DXT3_EXT:
+        case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT3_EXT:
+            *block_bytes = 16;
+            return decode_bc2;
+        case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
+        case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT:
+            *block_bytes = 16;
+            return decode_bc3;
+        case GL_COMPRESSED_RED_RGTC1:
+            *block_bytes = 8;
+            return decode_bc4;
+        case GL_COMPRESSED_RG_RGTC2:
+            *block_bytes = 16;
+            return decode_bc5;
+        case GL_COMPRESSED_RGBA_BPTC_UNORM_ARB:
+        case GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM_ARB:
+            *block_bytes = 16;
+            return decode_bc7;
+        case GL_COMPRESSED_RGB8_ETC2:
+        case GL_COMPRESSED_SRGB8_ETC2:
+            *block_bytes = 8;
+            return decode_etc2_rgb;
+        case GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2:
+        case GL_COMPRESSED_SRGB8_PUNCHTHROUGH_ALPHA1_ETC2:
+            *block_bytes = 8;
+            return decode_etc2_rgba1;
+        case GL_COMPRESSED_RGBA8_ETC2_EAC:
+        case GL_COMPRESSED_SRGB8_ALPHA8_ETC2_EAC:
+            *block_bytes = 16;
+            return decode_etc2_rgba;
+        case GL_COMPRESSED_R11_EAC:
+            *block_bytes = 8;
+            return decode_eac_r11;
+        case GL_COMPRESSED_RG11_EAC:
+            *block_bytes = 16;
+            return decode_eac_rg11;
+        default:
+            return NULL;
+    }
+}
+
+bool glapi_CanDecodeCompressedFormat(GLenum format) {
+    size_t block_bytes;
+    return decoder_for_format(format, &block_bytes) != NULL;
+}
+
+bool glapi_DecodeCompressedImage(GLenum format, const void* data, GLsizei width, GLsizei height, unsigned char* rgba) {
+    size_t block_bytes;
+    block_decoder decoder = decoder_for_format(format, &block_bytes);
+    if (!decoder) {
+        fprintf(stderr, "[%s] - No software decoder for format [0x%04X] in glapi_DecodeCompressedImage\n", _FL, format);
+        return false;
+    }
+
+    const unsigned char* block = (const unsigned char*)data;
+    GLsizei blocks_x = (width + 3) / 4;
+    GLsizei blocks_y = (height + 3) / 4;
+    unsigned char texels[64];
+    for (GLsizei by = 0; by < blocks_y; by++) {
+        for (GLsizei bx = 0; bx < blocks_x; bx++) {
+            decoder(block, texels);
+            block += block_bytes;
+            for (int y = 0; y < 4 && by * 4 + y < height; y++) {
+                GLsizei columns = width - bx * 4 < 4 ? width - bx * 4 : 4;
+                memcpy(rgba + ((size_t)(by * 4 + y) * width + bx * 4) * 4, texels + y * 16, (size_t)columns * 4);
+            }
+        }
+    }
+    return true;
+}
@@ -0,0 +1,889 @@
+#include <float.h>
+#include <math.h>
+#include <pthread.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+#include "graphics.h"
+
+#define _FL "texencode.c"
+
+#define APIC static
+#define TEXENCODE_VERSION 1
+#define TEXENCODE_BC7_PARTITION_CANDIDATES 4
+#define TEXENCODE_REFINE_ITERATIONS 2
+
+#define DDS_HEADER_FLAGS 0x000A1007u
+#define DDS_HEADER_CAPS 0x00401008u
+#define DDS_RESOURCE_TEXTURE2D 3
+
+typedef struct encode_job {
+    GLenum format;
+    const unsigned char* rgba;
+    GLsizei width;
+    GLsizei height;
+    unsigned char* out;
+    size_t block_bytes;
+    GLsizei blocks_x;
+    GLsizei blocks_y;
+    GLsizei next_row;
+    pthread_mutex_t lock;
+} encode_job;
+
+typedef struct bit_writer {
+    unsigned char* bytes;
+    int offset;
+} bit_writer;
+
+static const unsigned char encode_weights3[8] = {0, 9, 18, 27, 37, 46, 55, 64};
+static const unsigned char encode_weights4[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+APIC size_t encode_block_bytes(GLenum format);
+APIC uint32_t fit_palette(const unsigned char* texels, const unsigned char* palette, int count, unsigned char* indices);
+APIC void principal_axis(const unsigned char* texels, const bool* mask, int channels, float* mean, float* axis);
+APIC void axis_extents(const unsigned char* texels, const bool* mask, int channels, const float* mean, const float* axis, float* low, float* high);
+APIC bool least_squares_endpoints(const unsigned char* texels, const bool* mask, const unsigned char* indices, const unsigned char* weights, int channels, float* low, float* high);
+APIC uint16_t pack_565(const float* color);
+APIC void unpack_565(uint16_t color, unsigned char* rgb);
+APIC uint32_t bc1_evaluate(const unsigned char* texels, uint16_t c0, uint16_t c1, unsigned char* indices);
+APIC void encode_bc1_color(const unsigned char* rgba, unsigned char* block);
+APIC void encode_bc4_channel(const unsigned char* rgba, int channel, unsigned char* block);
+APIC void bits_write(bit_writer* writer, uint32_t value, int count);
+APIC int quantize_pbit(float value, int bits, int pbit);
+APIC int expand_bits(int value, int bits);
+APIC uint32_t bc7_mode6(const unsigned char* rgba, unsigned char* block);
+APIC float bc7_partition_estimate(const unsigned char* rgba, int partition);
+APIC uint32_t bc7_mode1(const unsigned char* rgba, int partition, unsigned char* block);
+APIC void encode_bc7(const unsigned char* rgba, unsigned char* block);
+APIC void encode_block(GLenum format, const unsigned char* rgba, unsigned char* block);
+APIC void* encode_worker(void* arg);
+APIC uint64_t content_hash(const unsigned char* data, size_t size, GLenum format);
+APIC uint32_t dxgi_format(GLenum format);
+APIC bool write_dds(const char* fpath, GLenum format, GLsizei width, GLsizei height, GLsizei levels, unsigned char** level_data, const size_t* level_size);
+
+APIC size_t encode_block_bytes(GLenum format) {
+    switch (format) {
+        case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+        case GL_COMPRESSED_RGBA_S3TC_DXT1_EXT:
+        case GL_COMPRESSED_SRGB_S3TC_DXT1_EXT:
+        case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT:
+            return 8;
+        case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
+        case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT:
+        case GL_COMPRESSED_RG_RGTC2:
+        case GL_COMPRESSED_RGBA_BPTC_UNORM_ARB:
+        case GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM_ARB:
+            return 16;
+        default:
+            return 0;
+    }
+}
+
+#if defined(__SSE2__)
+APIC uint32_t fit_palette(const unsigned char* texels, const unsigned char* palette, int count, unsigned char* indices) {
+    __m128i zero = _mm_setzero_si128();
+    uint32_t total = 0;
+    for (int v = 0; v < 4; v++) {
+        __m128i pixels = _mm_loadu_si128((const __m128i*)(texels + v * 16));
+        __m128i low = _mm_unpacklo_epi8(pixels, zero);
+        __m128i high = _mm_unpackhi_epi8(pixels, zero);
+        __m128i best = _mm_set1_epi32(0x7FFFFFFF);
+        __m128i best_index = zero;
+        for (int p = 0; p < count; p++) {
+            uint32_t entry;
+            memcpy(&entry, palette + p * 4, 4);
+            __m128i color = _mm_unpacklo_epi8(_mm_set1_epi32((int)entry), zero);
+            __m128i dl = _mm_sub_epi16(low, color);
+            __m128i dh = _mm_sub_epi16(high, color);
+            __m128 sl = _mm_castsi128_ps(_mm_madd_epi16(dl, dl));
+            __m128 sh = _mm_castsi128_ps(_mm_madd_epi16(dh, dh));
+            __m128i even = _mm_castps_si128(_mm_shuffle_ps(sl, sh, _MM_SHUFFLE(2, 0, 2, 0)));
+            __m128i odd = _mm_castps_si128(_mm_shuffle_ps(sl, sh, _MM_SHUFFLE(3, 1, 3, 1)));
+            __m128i error = _mm_add_epi32(even, odd);
+            __m128i better = _mm_cmplt_epi32(error, best);
+            best = _mm_or_si128(_mm_and_si128(better, error), _mm_andnot_si128(better, best));
+            best_index = _mm_or_si128(_mm_and_si128(better, _mm_set1_epi32(p)), _mm_andnot_si128(better, best_index));
+        }
+        uint32_t errors[4], chosen[4];
+        _mm_storeu_si128((__m128i*)errors, best);
+        _mm_storeu_si128((__m128i*)chosen, best_index);
+        for (int i = 0; i < 4; i++) {
+            indices[v * 4 + i] = (unsigned char)chosen[i];
+            total += errors[i];
+        }
+    }
+    return total;
+}
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+APIC uint32_t fit_palette(const unsigned char* texels, const unsigned char* palette, int count, unsigned char* indices) {
+    uint32_t total = 0;
+    for (int v = 0; v < 4; v++) {
+        uint8x16_t pixels = vld1q_u8(texels + v * 16);
+        uint32x4_t best = vdupq_n_u32(0x7FFFFFFF);
+        uint32x4_t best_index = vdupq_n_u32(0);
+        for (int p = 0; p < count; p++) {
+            uint32_t entry;
+            memcpy(&entry, palette + p * 4, 4);
+            uint8x8_t color = vreinterpret_u8_u32(vdup_n_u32(entry));
+            int16x8_t dl = vreinterpretq_s16_u16(vsubl_u8(vget_low_u8(pixels), color));
+            int16x8_t dh = vreinterpretq_s16_u16(vsubl_u8(vget_high_u8(pixels), color));
+            int32x4_t s0 = vmull_s16(vget_low_s16(dl), vget_low_s16(dl));
+            int32x4_t s1 = vmull_s16(vget_high_s16(dl), vget_high_s16(dl));
+            int32x4_t s2 = vmull_s16(vget_low_s16(dh), vget_low_s16(dh));
+            int32x4_t s3 = vmull_s16(vget_high_s16(dh), vget_high_s16(dh));
+            uint32x4_t error = vreinterpretq_u32_s32(vpaddq_s32(vpaddq_s32(s0, s1), vpaddq_s32(s2, s3)));
+            uint32x4_t better = vcltq_u32(error, best);
+            best = vbslq_u32(better, error, best);
+            best_index = vbslq_u32(better, vdupq_n_u32((uint32_t)p), best_index);
+        }
+        uint32_t errors[4], chosen[4];
+        vst1q_u32(errors, best);
+        vst1q_u32(chosen, best_index);
+        for (int i = 0; i < 4; i++) {
+            indices[v * 4 + i] = (unsigned char)chosen[i];
+            total += errors[i];
+        }
+    }
+    return total;
+}
+#else
+APIC uint32_t fit_palette(const unsigned char* texels, const unsigned char* palette, int count, unsigned char* indices) {
+    uint32_t total = 0;
+    for (int i = 0; i < 16; i++) {
+        uint32_t best = UINT32_MAX;
+        for (int p = 0; p < count; p++) {
+            uint32_t error = 0;
+            for (int c = 0; c < 4; c++) {
+                int d = (int)texels[i * 4 + c] - (int)palette[p * 4 + c];
+                error += (uint32_t)(d * d);
+            }
+            if (error < best) {
+                best = error;
+                indices[i] = (unsigned char)p;
+            }
+        }
+        total += best;
+    }
+    return total;
+}
+#endif
+
+APIC void principal_axis(const unsigned char* texels, const bool* mask, int channels, float* mean, float* axis) {
+    float count = 0.0f;
+    for (int c = 0; c < 4; c++)
+        mean[c] = 0.0f;
+    for (int i = 0; i < 16; i++) {
+        if (mask && !mask[i])
+            continue;
+        for (int c = 0; c < channels; c++)
+            mean[c] += texels[i * 4 + c];
+        count += 1.0f;
+    }
+    for (int c = 0; c < channels; c++)
+        mean[c] = count > 0.0f ? mean[c] / count : 0.0f;
+
+    float covariance[4][4];
+    memset(covariance, 0, sizeof(covariance));
+    for (int i = 0; i < 16; i++) {
+        if (mask && !mask[i])
+            continue;
+        float d[4];
+        for (int c = 0; c < channels; c++)
+            d[c] = texels[i * 4 + c] - mean[c];
+        for (int a = 0; a < channels; a++)
+            for (int b = 0; b < channels; b++)
+                covariance[a][b] += d[a] * d[b];
+    }
+
+    for (int c = 0; c < 4; c++)
+        axis[c] = c < channels ? 1.0f : 0.0f;
+    for (int iteration = 0; iteration < 8; iteration++) {
+        float next[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+        for (int a = 0; a < channels; a++)
+            for (int b = 0; b < channels; b++)
+                next[a] += covariance[a][b] * axis[b];
+        float length = 0.0f;
+        for (int c = 0; c < channels; c++)
+            length += next[c] * next[c];
+        if (length < 1e-12f)
+            break;
+        length = 1.0f / sqrtf(length);
+        for (int c = 0; c < channels; c++)
+            axis[c] = next[c] * length;
+    }
+}
+
+APIC void axis_extents(const unsigned char* texels, const bool* mask, int channels, const float* mean, const float* axis, float* low, float* high) {
+    float min_t = FLT_MAX, max_t = -FLT_MAX;
+    for (int i = 0; i < 16; i++) {
+        if (mask && !mask[i])
+            continue;
+        float t = 0.0f;
+        for (int c = 0; c < channels; c++)
+            t += (texels[i * 4 + c] - mean[c]) * axis[c];
+        if (t < min_t)
+            min_t = t;
+        if (t > max_t)
+            max_t = t;
+    }
+    if (min_t > max_t)
+        min_t = max_t = 0.0f;
+    for (int c = 0; c < 4; c++) {
+        low[c] = c < channels ? mean[c] + min_t * axis[c] : 255.0f;
+        high[c] = c < channels ? mean[c] + max_t * axis[c] : 255.0f;
+    }
+}
+
+APIC bool least_squares_endpoints(const unsigned char* texels, const bool* mask, const unsigned char* indices, const unsigned char* weights, int channels, float* low, float* high) {
+    float aa = 0.0f, ab = 0.0f, bb = 0.0f;
+    float ax[4] = {0.0f, 0.0f, 0.0f, 0.0f}, bx[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+    for (int i = 0; i < 16; i++) {
+        if (mask && !mask[i])
+            continue;
+        float t = weights[indices[i]] / 64.0f;
+        float s = 1.0f - t;
+        aa += s * s;
+        ab += s * t;
+        bb += t * t;
+        for (int c = 0; c < channels; c++) {
+            ax[c] += s * texels[i * 4 + c];
+            bx[c] += t * texels[i * 4 + c];
+        }
+    }
+    float determinant = aa * bb - ab * ab;
+    if (fabsf(determinant) < 1e-6f)
+        return false;
+    determinant = 1.0f / determinant;
+    for (int c = 0; c < channels; c++) {
+        float l = (ax[c] * bb - bx[c] * ab) * determinant;
+        float h = (bx[c] * aa - ax[c] * ab) * determinant;
+        low[c] = l < 0.0f ? 0.0f : (l > 255.0f ? 255.0f : l);
+        high[c] = h < 0.0f ? 0.0f : (h > 255.0f ? 255.0f : h);
+    }
+    return true;
+}
+
+APIC uint16_t pack_565(const float* color) {
+    int r = (int)(color[0] * 31.0f / 255.0f + 0.5f);
+    int g = (int)(color[1] * 63.0f / 255.0f + 0.5f);
+    int b = (int)(color[2] * 31.0f / 255.0f + 0.5f);
+    r = r < 0 ? 0 : (r > 31 ? 31 : r);
+    g = g < 0 ? 0 : (g > 63 ? 63 : g);
+    b = b < 0 ? 0 : (b > 31 ? 31 : b);
+    return (uint16_t)((r << 11) | (g << 5) | b);
+}
+
+APIC void unpack_565(uint16_t color, unsigned char* rgb) {
+    int r = (color >> 11) & 0x1F, g = (color >> 5) & 0x3F, b = color & 0x1F;
+    rgb[0] = (unsigned char)((r << 3) | (r >> 2));
+    rgb[1] = (unsigned char)((g << 2) | (g >> 4));
+    rgb[2] = (unsigned char)((b << 3) | (b >> 2));
+}
+
+APIC uint32_t bc1_evaluate(const unsigned char* texels, uint16_t c0, uint16_t c1, unsigned char* indices) {
+    unsigned char palette[16];
+    memset(palette, 0, sizeof(palette));
+    unpack_565(c0, palette);
+    unpack_565(c1, palette + 4);
+    for (int c = 0; c < 3; c++) {
+        palette[8 + c] = (unsigned char)((2 * palette[c] + palette[4 + c] + 1) / 3);
+        palette[12 + c] = (unsigned char)((palette[c] + 2 * palette[4 + c] + 1) / 3);
+    }
+    return fit_palette(texels, palette, c0 == c1 ? 1 : 4, indices);
+}
+
+APIC void encode_bc1_color(const unsigned char* rgba, unsigned char* block) {
+    static const unsigned char bc1_weights[4] = {0, 64, 21, 43};
+    unsigned char texels[64];
+    memcpy(texels, rgba, 64);
+    for (int i = 0; i < 16; i++)
+        texels[i * 4 + 3] = 0;
+
+    float mean[4], axis[4], low[4], high[4];
+    principal_axis(texels, NULL, 3, mean, axis);
+    axis_extents(texels, NULL, 3, mean, axis, low, high);
+
+    unsigned char indices[16], candidate_indices[16];
+    uint16_t c0 = pack_565(high), c1 = pack_565(low);
+    uint32_t error = bc1_evaluate(texels, c0, c1, indices);
+
+    for (int iteration = 0; iteration < TEXENCODE_REFINE_ITERATIONS && c0 != c1; iteration++) {
+        if (!least_squares_endpoints(texels, NULL, indices, bc1_weights, 3, high, low))
+            break;
+        uint16_t n0 = pack_565(high), n1 = pack_565(low);
+        uint32_t candidate = bc1_evaluate(texels, n0, n1, candidate_indices);
+        if (candidate >= error)
+            break;
+        error = candidate;
+        c0 = n0;
+        c1 = n1;
+        memcpy(indices, candidate_indices, 16);
+    }
+
+    if (c0 < c1) {
+        uint16_t swap = c0;
+        c0 = c1;
+        c1 = swap;
+        for (int i = 0; i < 16; i++)
+            indices[i] ^= 1;
+    }
+
+    block[0] = (unsigned char)(c0 & 0xFF);
+    block[1] = (unsigned char)(c0 >> 8);
+    block[2] = (unsigned char)(c1 & 0xFF);
+    block[3] = (unsigned char)(c1 >> 8);
+    uint32_t packed = 0;
+    for (int i = 0; i < 16; i++)
+        packed |= (uint32_t)(c0 == c1 ? 0 : indices[i]) << (i * 2);
+    block[4] = (unsigned char)(packed & 0xFF);
+    block[5] = (unsigned char)((packed >> 8) & 0xFF);
+    block[6] = (unsigned char)((packed >> 16) & 0xFF);
+    block[7] = (unsigned char)(packed >> 24);
+}
+
+APIC void encode_bc4_channel(const unsigned char* rgba, int channel, unsigned char* block) {
+    int low = 255, high = 0;
+    for (int i = 0; i < 16; i++) {
+        int v = rgba[i * 4 + channel];
+        low = v < low ? v : low;
+        high = v > high ? v : high;
+    }
+
+    block[0] = (unsigned char)high;
+    block[1] = (unsigned char)low;
+    uint64_t packed = 0;
+    if (high > low) {
+        int values[8];
+        values[0] = high;
+        values[1] = low;
+        for (int i = 1; i < 7; i++)
+            values[i + 1] = ((7 - i) * high + i * low + 3) / 7;
+        for (int i = 0; i < 16; i++) {
+            int v = rgba[i * 4 + channel];
+            int best = 0, best_error = 256;
+            for (int p = 0; p < 8; p++) {
+                int error = abs(values[p] - v);
+                if (error < best_error) {
+                    best_error = error;
+                    best = p;
+                }
+            }
+            packed |= (uint64_t)best << (i * 3);
+        }
+    }
+    for (int i = 0; i < 6; i++)
+        block[2 + i] = (unsigned char)((packed >> (i * 8)) & 0xFF);
+}
+
+APIC void bits_write(bit_writer* writer, uint32_t value, int count) {
+    for (int i = 0; i < count; i++) {
+        int bit = writer->offset + i;
+        if ((value >> i) & 1)
+            writer->bytes[bit >> 3] |= (unsigned char)(1 << (bit & 7));
+    }
+    writer->offset += count;
+}
+
+APIC int quantize_pbit(float value, int bits, int pbit) {
+    int levels = (1 << (bits + 1)) - 1;
+    int target = (int)(value * levels / 255.0f + 0.5f);
+    int quantized = (target - pbit + 1) >> 1;
+    int max = (1 << bits) - 1;
+    return quantized < 0 ? 0 : (quantized > max ? max : quantized);
+}
+
+APIC int expand_bits(int value, int bits) {
+    value <<= 8 - bits;
+    return value | (value >> bits);
+}
+
+APIC uint32_t bc7_mode6(const unsigned char* rgba, unsigned char* block) {
+    float mean[4], axis[4], low[4], high[4];
+    principal_axis(rgba, NULL, 4, mean, axis);
+    axis_extents(rgba, NULL, 4, mean, axis, low, high);
+
+    uint32_t best_error = UINT32_MAX;
+    int best_q[2][4] = {{0}}, best_p[2] = {0, 0};
+    unsigned char best_indices[16] = {0};
+    for (int iteration = 0; iteration <= TEXENCODE_REFINE_ITERATIONS; iteration++) {
+        bool improved = false;
+        for (int p0 = 0; p0 < 2; p0++) {
+            for (int p1 = 0; p1 < 2; p1++) {
+                int q[2][4];
+                unsigned char palette[64], ends[2][4], indices[16];
+                for (int c = 0; c < 4; c++) {
+                    q[0][c] = quantize_pbit(low[c], 7, p0);
+                    q[1][c] = quantize_pbit(high[c], 7, p1);
+                    ends[0][c] = (unsigned char)((q[0][c] << 1) | p0);
+                    ends[1][c] = (unsigned char)((q[1][c] << 1) | p1);
+                }
+                for (int w = 0; w < 16; w++)
+                    for (int c = 0; c < 4; c++)
+                        palette[w * 4 + c] = (unsigned char)(((64 - encode_weights4[w]) * ends[0][c] + encode_weights4[w] * ends[1][c] + 32) >> 6);
+                uint32_t error = fit_palette(rgba, palette, 16, indices);
+                if (error < best_error) {
+                    best_error = error;
+                    memcpy(best_q, q, sizeof(q));
+                    best_p[0] = p0;
+                    best_p[1] = p1;
+                    memcpy(best_indices, indices, 16);
+                    improved = true;
+                }
+            }
+        }
+        if (!improved || iteration == TEXENCODE_REFINE_ITERATIONS)
+            break;
+        if (!least_squares_endpoints(rgba, NULL, best_indices, encode_weights4, 4, low, high))
+            break;
+    }
+
+    if (best_indices[0] >= 8) {
+        for (int c = 0; c < 4; c++) {
+            int swap = best_q[0][c];
+            best_q[0][c] = best_q[1][c];
+            best_q[1][c] = swap;
+        }
+        int swap = best_p[0];
+        best_p[0] = best_p[1];
+        best_p[1] = swap;
+        for (int i = 0; i < 16; i++)
+            best_indices[i] = (unsigned char)(15 - best_indices[i]);
+    }
+
+    memset(block, 0, 16);
+    bit_writer writer = {block, 0};
+    bits_write(&writer, 1 << 6, 7);
+    for (int c = 0; c < 4; c++) {
+        bits_write(&writer, (uint32_t)best_q[0][c], 7);
+        bits_write(&writer, (uint32_t)best_q[1][c], 7);
+    }
+    bits_write(&writer, (uint32_t)best_p[0], 1);
+    bits_write(&writer, (uint32_t)best_p[1], 1);
+    for (int i = 0; i < 16; i++)
+        bits_write(&writer, best_indices[i], i == 0 ? 3 : 4);
+    return best_error;
+}
+
+APIC float bc7_partition_estimate(const unsigned char* rgba, int partition) {
+    float total = 0.0f;
+    for (int s = 0; s < 2; s++) {
+        bool mask[16];
+        for (int i = 0; i < 16; i++)
+            mask[i] = ((bc7_partitions2[partition] >> i) & 1) == s;
+        float mean[4], axis[4];
+        principal_axis(rgba, mask, 3, mean, axis);
+        for (int i = 0; i < 16; i++) {
+            if (!mask[i])
+                continue;
+            float d[3], t = 0.0f;
+            for (int c = 0; c < 3; c++) {
+                d[c] = rgba[i * 4 + c] - mean[c];
+                t += d[c] * axis[c];
+            }
+            for (int c = 0; c < 3; c++) {
+                float r = d[c] - t * axis[c];
+                total += r * r;
+            }
+        }
+    }
+    return total;
+}
+
+APIC uint32_t bc7_mode1(const unsigned char* rgba, int partition, unsigned char* block) {
+    int q[2][2][3], p[2];
+    unsigned char indices[16];
+    uint32_t total = 0;
+
+    for (int s = 0; s < 2; s++) {
+        bool mask[16];
+        for (int i = 0; i < 16; i++)
+            mask[i] = ((bc7_partitions2[partition] >> i) & 1) == s;
+        float mean[4], axis[4], low[4], high[4];
+        principal_axis(rgba, mask, 3, mean, axis);
+        axis_extents(rgba, mask, 3, mean, axis, low, high);
+
+        uint32_t best_error = UINT32_MAX;
+        unsigned char best_indices[16];
+        for (int iteration = 0; iteration <= TEXENCODE_REFINE_ITERATIONS; iteration++) {
+            bool improved = false;
+            for (int pbit = 0; pbit < 2; pbit++) {
+                unsigned char ends[2][4], palette[32], subset_indices[16];
+                int candidate[2][3];
+                for (int c = 0; c < 3; c++) {
+                    candidate[0][c] = quantize_pbit(low[c], 6, pbit);
+                    candidate[1][c] = quantize_pbit(high[c], 6, pbit);
+                    ends[0][c] = (unsigned char)expand_bits((candidate[0][c] << 1) | pbit, 7);
+                    ends[1][c] = (unsigned char)expand_bits((candidate[1][c] << 1) | pbit, 7);
+                }
+                ends[0][3] = ends[1][3] = 255;
+                for (int w = 0; w < 8; w++)
+                    for (int c = 0; c < 4; c++)
+                        palette[w * 4 + c] = (unsigned char)(((64 - encode_weights3[w]) * ends[0][c] + encode_weights3[w] * ends[1][c] + 32) >> 6);
+                fit_palette(rgba, palette, 8, subset_indices);
+
+                uint32_t error = 0;
+                for (int i = 0; i < 16; i++) {
+                    if (!mask[i])
+                        continue;
+                    for (int c = 0; c < 4; c++) {
+                        int d = (int)rgba[i * 4 + c] - (int)palette[subset_indices[i] * 4 + c];
+                        error += (uint32_t)(d * d);
+                    }
+                }
+                if (error < best_error) {
+                    best_error = error;
+                    memcpy(q[s], candidate, sizeof(candidate));
+                    p[s] = pbit;
+                    memcpy(best_indices, subset_indices, 16);
+                    improved = true;
+                }
+            }
+            if (!improved || iteration == TEXENCODE_REFINE_ITERATIONS)
+                break;
+            if (!least_squares_endpoints(rgba, mask, best_indices, encode_weights3, 3, low, high))
+                break;
+        }
+
+        int anchor = s == 0 ? 0 : bc7_anchor2[partition];
+        bool flip = best_indices[anchor] >= 4;
+        if (flip) {
+            for (int c = 0; c < 3; c++) {
+                int swap = q[s][0][c];
+                q[s][0][c] = q[s][1][c];
+                q[s][1][c] = swap;
+            }
+        }
+        for (int i = 0; i < 16; i++)
+            if (mask[i])
+                indices[i] = (unsigned char)(flip ? 7 - best_indices[i] : best_indices[i]);
+        total += best_error;
+    }
+
+    memset(block, 0, 16);
+    bit_writer writer = {block, 0};
+    bits_write(&writer, 1 << 1, 2);
+    bits_write(&writer, (uint32_t)partition, 6);
+    for (int c = 0; c < 3; c++)
+        for (int s = 0; s < 2; s++)
+            for (int e = 0; e < 2; e++)
+                bits_write(&writer, (uint32_t)q[s][e][c], 6);
+    bits_write(&writer, (uint32_t)p[0], 1);
+    bits_write(&writer, (uint32_t)p[1], 1);
+    int anchor = bc7_anchor2[partition];
+    for (int i = 0; i < 16; i++)
+        bits_write(&writer, indices[i], (i == 0 || i == anchor) ? 2 : 3);
+    return total;
+}
+
+APIC void encode_bc7(const unsigned char* rgba, unsigned char* block) {
+    uint32_t best_error = bc7_mode6(rgba, block);
+    if (!best_error)
+        return;
+    for (int i = 0; i < 16; i++)
+        if (rgba[i * 4 + 3] != 255)
+            return;
+
+    int candidates[TEXENCODE_BC7_PARTITION_CANDIDATES];
+    float candidate_error[TEXENCODE_BC7_PARTITION_CANDIDATES];
+    for (int k = 0; k < TEXENCODE_BC7_PARTITION_CANDIDATES; k++) {
+        candidates[k] = -1;
+        candidate_error[k] = FLT_MAX;
+    }
+    for (int partition = 0; partition < 64; partition++) {
+        float estimate = bc7_partition_estimate(rgba, partition);
+        for (int k = 0; k < TEXENCODE_BC7_PARTITION_CANDIDATES; k++) {
+            if (estimate < candidate_error[k]) {
+                for (int m = TEXENCODE_BC7_PARTITION_CANDIDATES - 1; m > k; m--) {
+                    candidates[m] = candidates[m - 1];
+                    candidate_error[m] = candidate_error[m - 1];
+                }
+                candidates[k] = partition;
+                candidate_error[k] = estimate;
+                break;
+            }
+        }
+    }
+
+    unsigned char candidate_block[16];
+    for (int k = 0; k < TEXENCODE_BC7_PARTITION_CANDIDATES && candidates[k] >= 0; k++) {
+        uint32_t error = bc7_mode1(rgba, candidates[k], candidate_block);
+        if (error < best_error) {
+            best_error = error;
+            memcpy(block, candidate_block, 16);
+        }
+    }
+}
+
+APIC void encode_block(GLenum format, const unsigned char* rgba, unsigned char* block) {
+    switch (format) {
+        case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+        case GL_COMPRESSED_RGBA_S3TC_DXT1_EXT:
+        case GL_COMPRESSED_SRGB_S3TC_DXT1_EXT:
+        case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT:
+            encode_bc1_color(rgba, block);
+            break;
+        case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
+        case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT:
+            encode_bc4_channel(rgba, 3, block);
+            encode_bc1_color(rgba, block + 8);
+            break;
+        case GL_COMPRESSED_RG_RGTC2:
+            encode_bc4_channel(rgba, 0, block);
+            encode_bc4_channel(rgba, 1, block + 8);
+            break;
+        default:
+            encode_bc7(rgba, block);
+            break;
+    }
+}
+
+APIC void* encode_worker(void* arg) {
+    encode_job* job = (encode_job*)arg;
+    unsigned char texels[64];
+    glapi_BeginCpuZone("encode_worker");
+    for (;;) {
+        pthread_mutex_lock(&job->lock);
+        GLsizei by = job->next_row++;
+        pthread_mutex_unlock(&job->lock);
+        if (by >= job->blocks_y)
+            break;
+
+        for (GLsizei bx = 0; bx < job->blocks_x; bx++) {
+            for (int y = 0; y < 4; y++) {
+                GLsizei sy = by * 4 + y < job->height ? by * 4 + y : job->height - 1;
+                for (int x = 0; x < 4; x++) {
+                    GLsizei sx = bx * 4 + x < job->width ? bx * 4 + x : job->width - 1;
+                    memcpy(texels + (y * 4 + x) * 4, job->rgba + ((size_t)sy * job->width + sx) * 4, 4);
+                }
+            }
+            encode_block(job->format, texels, job->out + ((size_t)by * job->blocks_x + bx) * job->block_bytes);
+        }
+    }
+    glapi_EndCpuZone();
+    return NULL;
+}
+
+GLuint glapi_HardwareThreadCount(void) {
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors ? (GLuint)info.dwNumberOfProcessors : 1;
+#else
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? (GLuint)count : 1;
+#endif
+}
+
+size_t glapi_CompressedImageSize(GLenum format, GLsizei width, GLsizei height) {
+    return (size_t)((width + 3) / 4) * ((height + 3) / 4) * encode_block_bytes(format);
+}
+
+bool glapi_CompressImage(GLenum format, const unsigned char* rgba, GLsizei width, GLsizei height, unsigned char* out, GLuint threads) {
+    encode_job job;
+    job.block_bytes = encode_block_bytes(format);
+    if (!job.block_bytes) {
+        fprintf(stderr, "[%s] - No encoder for format [0x%04X] in glapi_CompressImage\n", _FL, format);
+        return false;
+    }
+    job.format = format;
+    job.rgba = rgba;
+    job.width = width;
+    job.height = height;
+    job.out = out;
+    job.blocks_x = (width + 3) / 4;
+    job.blocks_y = (height + 3) / 4;
+    job.next_row = 0;
+    pthread_mutex_init(&job.lock, NULL);
+
+    if (!threads)
+        threads = glapi_HardwareThreadCount();
+    if (threads > (GLuint)job.blocks_y)
+        threads = (GLuint)job.blocks_y;
+
+    pthread_t* workers = threads > 1 ? (pthread_t*)malloc((threads - 1) * sizeof(pthread_t)) : NULL;
+    GLuint started = 0;
+    if (workers) {
+        for (; started < threads - 1; started++)
+            if (pthread_create(&workers[started], NULL, encode_worker, &job))
+                break;
+    }
+    encode_worker(&job);
+    for (GLuint i = 0; i < started; i++)
+        pthread_join(workers[i], NULL);
+
+    free(workers);
+    pthread_mutex_destroy(&job.lock);
+    return true;
+}
+
+APIC uint64_t content_hash(const unsigned char* data, size_t size, GLenum format) {
+    uint64_t hash = 0xCBF29CE484222325ull;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= data[i];
+        hash *= 0x100000001B3ull;
+    }
+    uint32_t salt[2] = {(uint32_t)format, TEXENCODE_VERSION};
+    const unsigned char* bytes = (const unsigned char*)salt;
+    for (size_t i = 0; i < sizeof(salt); i++) {
+        hash ^= bytes[i];
+        hash *= 0x100000001B3ull;
+    }
+    return hash;
+}
+
+APIC uint32_t dxgi_format(GLenum format) {
+    switch (format) {
+        case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+        case GL_COMPRESSED_RGBA_S3TC_DXT1_EXT:         return 71;
+        case GL_COMPRESSED_SRGB_S3TC_DXT1_EXT:
+        case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT:   return 72;
+        case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:         return 77;
+        case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT:   return 78;
+        case GL_COMPRESSED_RG_RGTC2:                   return 83;
+        case GL_COMPRESSED_RGBA_BPTC_UNORM_ARB:        return 98;
+        case GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM_ARB:  return 99;
+        default:                                       return 0;
+    }
+}
+
+APIC bool write_dds(const char* fpath, GLenum format, GLsizei width, GLsizei height, GLsizei levels, unsigned char** level_data, const size_t* level_size) {
+    char temp_path[1024];
+    if (snprintf(temp_path, sizeof(temp_path), "%s.tmp", fpath) >= (int)sizeof(temp_path)) {
+        fprintf(stderr, "[%s] - Path too long for '%s' in write_dds\n", _FL, fpath);
+        return false;
+    }
+    FILE* file = fopen(temp_path, "wb");
+    if (!file) {
+        fprintf(stderr, "[%s] - Failure to open '%s' in write_dds\n", _FL, temp_path);
+        return false;
+    }
+
+    uint32_t header[37];
+    memset(header, 0, sizeof(header));
+    header[0] = 0x20534444u;
+    header[1] = 124;
+    header[2] = DDS_HEADER_FLAGS;
+    header[3] = (uint32_t)height;
+    header[4] = (uint32_t)width;
+    header[5] = (uint32_t)level_size[0];
+    header[7] = (uint32_t)levels;
+    header[19] = 32;
+    header[20] = 0x4;
+    header[21] = 0x30315844u;
+    header[27] = DDS_HEADER_CAPS;
+    header[32] = dxgi_format(format);
+    header[33] = DDS_RESOURCE_TEXTURE2D;
+    header[35] = 1;
+
+    bool written = fwrite(header, sizeof(header), 1, file) == 1;
+    for (GLsizei level = 0; level < levels && written; level++)
+        written = fwrite(level_data[level], level_size[level], 1, file) == 1;
+    written = fclose(file) == 0 && written;
+
+    if (written) {
+        remove(fpath);
+        written = rename(temp_path, fpath) == 0;
+    }
+    if (!written) {
+        fprintf(stderr, "[%s] - Failure to write '%s' in write_dds\n", _FL, fpath);
+        remove(temp_path);
+    }
+    return written;
+}
+
+GLuint glapi_GenTextureFromFpathCompressed(gl_app* app, const char* fpath, GLenum format, const char* cache_dir, GLuint threads, gl_compressed_stats* stats, GLuint* address) {
+    if (!encode_block_bytes(format)) {
+        fprintf(stderr, "[%s] - No encoder for format [0x%04X] in glapi_GenTextureFromFpathCompressed\n", _FL, format);
+        return 0;
+    }
+
+    size_t source_size = 0;
+    unsigned char* source = glapi_ReadFile(fpath, &source_size);
+    if (!source)
+        return 0;
+
+    char cache_path[1024];
+    snprintf(cache_path, sizeof(cache_path), "%s/%016llx.dds", cache_dir, (unsigned long long)content_hash(source, source_size, format));
+
+    FILE* cached = fopen(cache_path, "rb");
+    if (cached) {
+        fclose(cached);
+        free(source);
+        GLuint texture = glapi_GenCompressedTextureFromFpath(app, cache_path, stats, address);
+        if (texture) {
+            if (stats)
+                stats->cache_hit = true;
+            return texture;
+        }
+        fprintf(stderr, "[%s] - Discarding unreadable cache entry '%s' in glapi_GenTextureFromFpathCompressed\n", _FL, cache_path);
+        remove(cache_path);
+        source = glapi_ReadFile(fpath, &source_size);
+        if (!source)
+            return 0;
+    }
+
+    int width, height, channels;
+    stbi_set_flip_vertically_on_load_thread(1);
+    unsigned char* pixels = stbi_load_from_memory(source, (int)source_size, &width, &height, &channels, STBI_rgb_alpha);
+    free(source);
+    if (!pixels) {
+        fprintf(stderr, "[%s] - Texture load failed: %s\n", _FL, stbi_failure_reason());
+        return 0;
+    }
+
+    bool srgb = format == GL_COMPRESSED_SRGB_S3TC_DXT1_EXT || format == GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT ||
+                format == GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT || format == GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM_ARB;
+    GLsizei levels = glapi_TextureMipLevels(width, height);
+    unsigned char* level_data[32];
+    size_t level_size[32];
+    memset(level_data, 0, sizeof(level_data));
+
+    unsigned char* mip = pixels;
+    GLsizei level_width = width, level_height = height;
+    bool encoded = true;
+    for (GLsizei level = 0; level < levels && encoded; level++) {
+        level_size[level] = glapi_CompressedImageSize(format, level_width, level_height);
+        level_data[level] = (unsigned char*)malloc(level_size[level]);
+        encoded = level_data[level] && glapi_CompressImage(format, mip, level_width, level_height, level_data[level], threads);
+
+        if (encoded && level + 1 < levels) {
+            GLsizei next_width = level_width > 1 ? level_width / 2 : 1;
+            GLsizei next_height = level_height > 1 ? level_height / 2 : 1;
+            unsigned char* next = (unsigned char*)malloc((size_t)next_width * next_height * 4);
+            if (next)
+                glapi_DownsampleImage(mip, level_width, level_height, next, next_width, next_height, GL_UNSIGNED_BYTE, 4, srgb);
+            if (mip != pixels)
+                free(mip);
+            mip = next;
+            encoded = next != NULL;
+            level_width = next_width;
+            level_height = next_height;
+        }
+    }
+    if (mip != pixels)
+        free(mip);
+    stbi_image_free(pixels);
+
+    GLuint texture = 0;
+    if (!encoded) {
+        fprintf(stderr, "[%s] - Failure to encode '%s' in glapi_GenTextureFromFpathCompressed\n", _FL, fpath);
+    } else {
+        if (!glapi_EnsureDirectory(cache_dir) || !write_dds(cache_path, format, width, height, levels, level_data, level_size))
+            fprintf(stderr, "[%s] - Failure to write cache entry '%s', uploading without caching in glapi_GenTextureFromFpathCompressed\n", _FL, cache_path);
+        texture = glapi_GenCompressedTexture(app, format, width, height, levels, level_data, level_size, stats, address);
+    }
+
+    for (GLsizei level = 0; level < levels; level++)
+        free(level_data[level]);
+    return texture;
+}
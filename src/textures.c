@@ -0,0 +1,373 @@
+#include <math.h>
+
+#include "graphics.h"
+
+#define _FL "textures.c"
+
+#define APIC static
+#define GL_SAMPLER_CACHE_APPEND_AMOUNT 8
+
+APIC bool texture_upload_format(GLenum internal_format, GLenum* format, GLenum* type, GLuint* channels);
+APIC bool texture_is_srgb(GLenum internal_format);
+APIC float texture_srgb_to_linear(float value);
+APIC float texture_linear_to_srgb(float value);
+APIC void texture_downsample(const void* src, GLsizei src_width, GLsizei src_height, void* dst, GLsizei dst_width, GLsizei dst_height, GLenum type, GLuint channels, bool srgb);
+APIC void texture_generate_cpu_mips(const gl_texture_desc* desc, const void* pixels, GLsizei levels, GLenum format, GLenum type, GLuint channels);
+APIC uint32_t sampler_key(unsigned int filter, unsigned int wrap, float anisotropy);
+
+APIC bool texture_upload_format(GLenum internal_format, GLenum* format, GLenum* type, GLuint* channels) {
+    switch (internal_format) {
+        case GL_R8:           *format = GL_RED;  *type = GL_UNSIGNED_BYTE; *channels = 1; return true;
+        case GL_RG8:          *format = GL_RG;   *type = GL_UNSIGNED_BYTE; *channels = 2; return true;
+        case GL_RGB8:
+        case GL_SRGB8:        *format = GL_RGB;  *type = GL_UNSIGNED_BYTE; *channels = 3; return true;
+        case GL_RGBA8:
+        case GL_SRGB8_ALPHA8: *format = GL_RGBA; *type = GL_UNSIGNED_BYTE; *channels = 4; return true;
+        case GL_R16F:
+        case GL_R32F:         *format = GL_RED;  *type = GL_FLOAT; *channels = 1; return true;
+        case GL_RG16F:
+        case GL_RG32F:        *format = GL_RG;   *type = GL_FLOAT; *channels = 2; return true;
+        case GL_RGB16F:
+        case GL_RGB32F:       *format = GL_RGB;  *type = GL_FLOAT; *channels = 3; return true;
+        case GL_RGBA16F:
+        case GL_RGBA32F:      *format = GL_RGBA; *type = GL_FLOAT; *channels = 4; return true;
+        default:
+            return false;
+    }
+}
+
+APIC bool texture_is_srgb(GLenum internal_format) {
+    return internal_format == GL_SRGB8 || internal_format == GL_SRGB8_ALPHA8;
+}
+
+APIC float texture_srgb_to_linear(float value) {
+    return value <= 0.04045f ? value / 12.92f : powf((value + 0.055f) / 1.055f, 2.4f);
+}
+
+APIC float texture_linear_to_srgb(float value) {
+    return value <= 0.0031308f ? value * 12.92f : 1.055f * powf(value, 1.0f / 2.4f) - 0.055f;
+}
+
+APIC void texture_downsample(const void* src, GLsizei src_width, GLsizei src_height, void* dst, GLsizei dst_width, GLsizei dst_height, GLenum type, GLuint channels, bool srgb) {
+    static float srgb_table[256];
+    static bool srgb_table_ready = false;
+    if (srgb && !srgb_table_ready) {
+        for (int i = 0; i < 256; i++)
+            srgb_table[i] = texture_srgb_to_linear(i / 255.0f);
+        srgb_table_ready = true;
+    }
+
+    for (GLsizei y = 0; y < dst_height; y++) {
+        GLsizei y0 = y * 2 < src_height ? y * 2 : src_height - 1;
+        GLsizei y1 = y * 2 + 1 < src_height ? y * 2 + 1 : y0;
+        for (GLsizei x = 0; x < dst_width; x++) {
+            GLsizei x0 = x * 2 < src_width ? x * 2 : src_width - 1;
+            GLsizei x1 = x * 2 + 1 < src_width ? x * 2 + 1 : x0;
+            size_t taps[4] = {
+                ((size_t)y0 * src_width + x0) * channels,
+                ((size_t)y0 * src_width + x1) * channels,
+                ((size_t)y1 * src_width + x0) * channels,
+                ((size_t)y1 * src_width + x1) * channels
+            };
+            size_t out = ((size_t)y * dst_width + x) * channels;
+
+            for (GLuint c = 0; c < channels; c++) {
+                bool linearize = srgb && !(channels == 4 && c == 3);
+                float sum = 0.0f;
+                for (int t = 0; t < 4; t++) {
+                    if (type == GL_FLOAT) {
+                        sum += ((const float*)src)[taps[t] + c];
+                    } else {
+                        unsigned char v = ((const unsigned char*)src)[taps[t] + c];
+                        sum += linearize ? srgb_table[v] : v / 255.0f;
+                    }
+                }
+                sum *= 0.25f;
+
+                if (type == GL_FLOAT) {
+                    ((float*)dst)[out + c] = sum;
+                } else {
+                    float encoded = linearize ? texture_linear_to_srgb(sum) : sum;
+                    ((unsigned char*)dst)[out + c] = (unsigned char)(encoded * 255.0f + 0.5f);
+                }
+            }
+        }
+    }
+}
+
+APIC void texture_generate_cpu_mips(const gl_texture_desc* desc, const void* pixels, GLsizei levels, GLenum format, GLenum type, GLuint channels) {
+    size_t texel_size = channels * (type == GL_FLOAT ? sizeof(float) : 1);
+    GLsizei width = desc->width;
+    GLsizei height = desc->height;
+    GLsizei next_width = width > 1 ? width / 2 : 1;
+    GLsizei next_height = height > 1 ? height / 2 : 1;
+
+    void* scratch[2];
+    scratch[0] = malloc((size_t)next_width * next_height * texel_size);
+    scratch[1] = malloc((size_t)next_width * next_height * texel_size);
+    if (!scratch[0] || !scratch[1]) {
+        fprintf(stderr, "[%s] - Failure to allocate mip scratch in texture_generate_cpu_mips, falling back to glGenerateMipmap\n", _FL);
+        free(scratch[0]);
+        free(scratch[1]);
+        glGenerateMipmap(GL_TEXTURE_2D);
+        return;
+    }
+
+    bool srgb = texture_is_srgb(desc->internal_format);
+    const void* src = pixels;
+    for (GLsizei level = 1; level < levels; level++) {
+        GLsizei level_width = width > 1 ? width / 2 : 1;
+        GLsizei level_height = height > 1 ? height / 2 : 1;
+        void* dst = scratch[level & 1];
+        texture_downsample(src, width, height, dst, level_width, level_height, type, channels, srgb);
+        glTexSubImage2D(GL_TEXTURE_2D, level, 0, 0, level_width, level_height, format, type, dst);
+        src = dst;
+        width = level_width;
+        height = level_height;
+    }
+
+    free(scratch[0]);
+    free(scratch[1]);
+}
+
+APIC uint32_t sampler_key(unsigned int filter, unsigned int wrap, float anisotropy) {
+    uint32_t aniso = anisotropy > 1.0f ? (uint32_t)(anisotropy * 4.0f + 0.5f) : 4;
+    return (filter & 0x3) | ((wrap & 0x3) << 2) | (aniso << 4);
+}
+
+GLsizei glapi_TextureMipLevels(GLsizei width, GLsizei height) {
+    GLsizei size = width > height ? width : height;
+    GLsizei levels = 1;
+    while (size > 1) {
+        size /= 2;
+        levels++;
+    }
+    return levels;
+}
+
+void glapi_DownsampleImage(const void* src, GLsizei src_width, GLsizei src_height, void* dst, GLsizei dst_width, GLsizei dst_height, GLenum type, GLuint channels, bool srgb) {
+    texture_downsample(src, src_width, src_height, dst, dst_width, dst_height, type, channels, srgb);
+}
+
+GLsizei glapi_TextureTexelSize(GLenum internal_format) {
+    GLenum format, type;
+    GLuint channels;
+    if (!texture_upload_format(internal_format, &format, &type, &channels))
+        return 0;
+    return (GLsizei)(channels * (type == GL_FLOAT ? sizeof(float) : 1));
+}
+
+bool glapi_TextureUploadFormat(GLenum internal_format, GLenum* format, GLenum* type, GLuint* channels) {
+    return texture_upload_format(internal_format, format, type, channels);
+}
+
+GLuint glapi_CreateTexture(const gl_texture_desc* desc, const void* pixels) {
+    GLenum format, type;
+    GLuint channels;
+    if (!texture_upload_format(desc->internal_format, &format, &type, &channels)) {
+        fprintf(stderr, "[%s] - Unsupported internal format [0x%04X] in glapi_CreateTexture\n", _FL, desc->internal_format);
+        return 0;
+    }
+    if (desc->width <= 0 || desc->height <= 0) {
+        fprintf(stderr, "[%s] - Invalid texture size [%d x %d] in glapi_CreateTexture\n", _FL, desc->width, desc->height);
+        return 0;
+    }
+
+    GLsizei max_levels = glapi_TextureMipLevels(desc->width, desc->height);
+    GLsizei levels = desc->mips == TEXTURE_MIPS_NONE ? 1 : max_levels;
+    if (desc->levels > 0 && desc->levels < levels)
+        levels = desc->levels;
+
+    GLuint texture;
+    glGenTextures(1, &texture);
+    glBindTexture(GL_TEXTURE_2D, texture);
+
+    if (GLAD_GL_ARB_texture_storage) {
+        glTexStorage2D(GL_TEXTURE_2D, levels, desc->internal_format, desc->width, desc->height);
+    } else {
+        GLsizei width = desc->width;
+        GLsizei height = desc->height;
+        for (GLsizei level = 0; level < levels; level++) {
+            glTexImage2D(GL_TEXTURE_2D, level, desc->internal_format, width, height, 0, format, type, NULL);
+            width = width > 1 ? width / 2 : 1;
+            height = height > 1 ? height / 2 : 1;
+        }
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levels - 1);
+    }
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+    if (pixels) {
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, desc->width, desc->height, format, type, pixels);
+        if (levels > 1) {
+            if (desc->mips == TEXTURE_MIPS_CPU)
+                texture_generate_cpu_mips(desc, pixels, levels, format, type, channels);
+            else
+                glGenerateMipmap(GL_TEXTURE_2D);
+        }
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    }
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+    check_gl_error("glapi_CreateTexture");
+    return texture;
+}
+
+GLuint glapi_GenTexture(gl_app* app, const gl_texture_desc* desc, const void* pixels, GLuint* address) {
+    GLuint texture = glapi_CreateTexture(desc, pixels);
+    if (texture)
+        glapi_AppendTextureObject(app, texture, address);
+    return texture;
+}
+
+GLuint glapi_GenTextureFromFpathFormat(gl_app* app, const char* fpath, GLenum internal_format, unsigned int mips, GLuint* address) {
+    if (!strcmp("", fpath)) {
+        GLuint texture;
+        unsigned char texel[4] = {0, 0, 0, 0};
+        glGenTextures(1, &texture);
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, texel);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        glapi_AppendTextureObject(app, texture, address);
+        return texture;
+    }
+
+    GLenum format, type;
+    GLuint channels;
+    if (!texture_upload_format(internal_format, &format, &type, &channels) || type != GL_UNSIGNED_BYTE) {
+        fprintf(stderr, "[%s] - Unsupported image internal format [0x%04X] in glapi_GenTextureFromFpathFormat\n", _FL, internal_format);
+        return 0;
+    }
+
+    glapi_BeginCpuZone("glapi_GenTextureFromFpathFormat");
+    int width, height, file_channels;
+    stbi_set_flip_vertically_on_load_thread(1);
+    unsigned char* data = stbi_load(fpath, &width, &height, &file_channels, (int)channels);
+    if (!data) {
+        fprintf(stderr, "[%s] - Texture load failed: %s\n", _FL, stbi_failure_reason());
+        glapi_EndCpuZone();
+        return 0;
+    }
+
+    gl_texture_desc desc;
+    memset(&desc, 0, sizeof(gl_texture_desc));
+    desc.width = width;
+    desc.height = height;
+    desc.internal_format = internal_format;
+    desc.mips = mips;
+
+    GLuint texture = glapi_GenTexture(app, &desc, data, address);
+    stbi_image_free(data);
+    glapi_EndCpuZone();
+    return texture;
+}
+
+GLuint glapi_GetSampler(gl_app* app, unsigned int filter, unsigned int wrap, float anisotropy) {
+    gl_sampler_cache* cache = app->samplers;
+    if (!cache) {
+        cache = (gl_sampler_cache*)calloc(1, sizeof(gl_sampler_cache));
+        if (!cache) {
+            fprintf(stderr, "[%s] - Failure to allocate 'app->samplers' to heap in glapi_GetSampler\n", _FL);
+            return 0;
+        }
+        cache->max_anisotropy = 1.0f;
+        if (GLAD_GL_EXT_texture_filter_anisotropic)
+            glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY_EXT, &cache->max_anisotropy);
+        app->samplers = cache;
+    }
+
+    if (filter != SAMPLER_FILTER_TRILINEAR)
+        anisotropy = 1.0f;
+    if (anisotropy > cache->max_anisotropy)
+        anisotropy = cache->max_anisotropy;
+
+    uint32_t key = sampler_key(filter, wrap, anisotropy);
+    for (size_t i = 0; i < cache->count; i++) {
+        if (cache->keys[i] == key)
+            return cache->samplers[i];
+    }
+
+    if (cache->count >= cache->capacity) {
+        size_t capacity = cache->capacity ? cache->capacity * 2 : GL_SAMPLER_CACHE_APPEND_AMOUNT;
+        uint32_t* keys = (uint32_t*)realloc(cache->keys, capacity * sizeof(uint32_t));
+        if (keys)
+            cache->keys = keys;
+        GLuint* samplers = (GLuint*)realloc(cache->samplers, capacity * sizeof(GLuint));
+        if (samplers)
+            cache->samplers = samplers;
+        if (!keys || !samplers) {
+            fprintf(stderr, "[%s] - Failure to reallocate sampler cache in glapi_GetSampler\n", _FL);
+            return 0;
+        }
+        cache->capacity = capacity;
+    }
+
+    GLint min_filter, mag_filter;
+    switch (filter) {
+        case SAMPLER_FILTER_NEAREST:
+            min_filter = GL_NEAREST_MIPMAP_NEAREST;
+            mag_filter = GL_NEAREST;
+            break;
+        case SAMPLER_FILTER_BILINEAR:
+            min_filter = GL_LINEAR_MIPMAP_NEAREST;
+            mag_filter = GL_LINEAR;
+            break;
+        default:
+            min_filter = GL_LINEAR_MIPMAP_LINEAR;
+            mag_filter = GL_LINEAR;
+            break;
+    }
+
+    GLint wrap_mode;
+    switch (wrap) {
+        case SAMPLER_WRAP_CLAMP:  wrap_mode = GL_CLAMP_TO_EDGE; break;
+        case SAMPLER_WRAP_MIRROR: wrap_mode = GL_MIRRORED_REPEAT; break;
+        default:                  wrap_mode = GL_REPEAT; break;
+    }
+
+    GLuint sampler;
+    glGenSamplers(1, &sampler);
+    glSamplerParameteri(sampler, GL_TEXTURE_MIN_FILTER, min_filter);
+    glSamplerParameteri(sampler, GL_TEXTURE_MAG_FILTER, mag_filter);
+    glSamplerParameteri(sampler, GL_TEXTURE_WRAP_S, wrap_mode);
+    glSamplerParameteri(sampler, GL_TEXTURE_WRAP_T, wrap_mode);
+    glSamplerParameteri(sampler, GL_TEXTURE_WRAP_R, wrap_mode);
+    if (GLAD_GL_EXT_texture_filter_anisotropic && anisotropy > 1.0f)
+        glSamplerParameterf(sampler, GL_TEXTURE_MAX_ANISOTROPY_EXT, anisotropy);
+    check_gl_error("glapi_GetSampler");
+
+    cache->keys[cache->count] = key;
+    cache->samplers[cache->count] = sampler;
+    cache->count++;
+    return sampler;
+}
+
+void glapi_DestroySamplerCache(gl_app* app) {
+    gl_sampler_cache* cache = app->samplers;
+    if (!cache)
+        return;
+    if (cache->count)
+        glDeleteSamplers((GLsizei)cache->count, cache->samplers);
+    free(cache->keys);
+    free(cache->samplers);
+    free(cache);
+    app->samplers = NULL;
+}
+
+void glapi_BindTextureUnit(GLuint unit, gl_texture texture, GLuint sampler) {
+    glActiveTexture(GL_TEXTURE0 + unit);
+    glBindTexture(GL_TEXTURE_2D, texture);
+    glBindSampler(unit, sampler);
+}
+
+void glapi_PushSampledTexture2DToShader(const char* varname, gl_texture value, GLuint sampler, GLuint unit, gl_shader shader) {
+    glapi_BindTextureUnit(unit, value, sampler);
+    glUseProgram(shader);
+    glUniform1i(glGetUniformLocation(shader, varname), (GLint)unit);
+    glActiveTexture(GL_TEXTURE0);
+}